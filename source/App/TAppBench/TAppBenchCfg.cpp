@@ -0,0 +1,119 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.  
+ *
+ * Copyright (c) 2010-2012, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** \file     TAppBenchCfg.cpp
+    \brief    Kernel benchmark configuration class
+*/
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include "TAppBenchCfg.h"
+#include "TAppCommon/program_options_lite.h"
+
+#ifdef WIN32
+#define strdup _strdup
+#endif
+
+using namespace std;
+namespace po = df::program_options_lite;
+
+//! \ingroup TAppBench
+//! \{
+
+// ====================================================================================================================
+// Public member functions
+// ====================================================================================================================
+
+/** \param argc number of arguments
+    \param argv array of arguments
+ */
+Bool TAppBenchCfg::parseCfg( Int argc, Char* argv[] )
+{
+  bool do_help = false;
+  string cfg_Kernels;
+  string cfg_TempFile;
+
+  po::Options opts;
+  opts.addOptions()
+  ("help", do_help, false, "this help text")
+  ("Kernels,k", cfg_Kernels, string(""), "comma separated list of kernel groups to run, all if omitted:\n"
+                                         "\tdist, sadcache, interp, trans, quant, deblock, sao, cabac, yuvio")
+  ("MinTime,t", m_dMinTime, 100.0, "minimum measuring time per kernel in milliseconds")
+  ("Check,c", m_bCheck, true, "cross-check the kernels bit-exactly against the scalar references")
+  ("Seed", m_uiSeed, 1u, "seed of the synthetic content")
+  ("SourceWidth,-wdt", m_iSourceWidth, 1920, "width of the synthetic picture used by the picture level kernels")
+  ("SourceHeight,-hgt", m_iSourceHeight, 1080, "height of the synthetic picture used by the picture level kernels")
+  ("InternalBitDepth", m_uiInternalBitDepth, 8u, "internal bit depth of the kernels")
+  ("NumBins", m_iNumBins, 1<<20, "number of bins of the CABAC bin stream")
+  ("TempFile", cfg_TempFile, string("TAppBench.yuv"), "scratch file for the YUV file I/O kernels, removed afterwards")
+  ;
+  po::setDefaults(opts);
+  const list<const char*>& argv_unhandled = po::scanArgv(opts, argc, (const char**) argv);
+
+  for (list<const char*>::const_iterator it = argv_unhandled.begin(); it != argv_unhandled.end(); it++)
+  {
+    fprintf(stderr, "Unhandled argument ignored: `%s'\n", *it);
+  }
+
+  if (do_help)
+  {
+    po::doHelp(cout, opts);
+    return false;
+  }
+
+  /* convert std::string to c string for compatability */
+  m_pchKernels  = cfg_Kernels.empty() ? NULL : strdup(cfg_Kernels.c_str());
+  m_pchTempFile = strdup(cfg_TempFile.c_str());
+
+  if (m_iSourceWidth < 3*BENCH_CTU_SIZE || m_iSourceHeight < 3*BENCH_CTU_SIZE || m_iSourceWidth % 8 || m_iSourceHeight % 8)
+  {
+    fprintf(stderr, "The synthetic picture must be a multiple of 8 and hold at least 3x3 CTUs, aborting\n");
+    return false;
+  }
+  if (m_uiInternalBitDepth < 8 || m_uiInternalBitDepth > 12)
+  {
+    fprintf(stderr, "Internal bit depth must be in the range 8..12, aborting\n");
+    return false;
+  }
+  if (m_dMinTime <= 0 || m_iNumBins <= 0)
+  {
+    fprintf(stderr, "MinTime and NumBins must be positive, aborting\n");
+    return false;
+  }
+
+  return true;
+}
+
+//! \}
+
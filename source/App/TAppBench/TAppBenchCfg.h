@@ -0,0 +1,85 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.  
+ *
+ * Copyright (c) 2010-2012, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** \file     TAppBenchCfg.h
+    \brief    Kernel benchmark configuration class (header)
+*/
+
+#ifndef __TAPPBENCHCFG__
+#define __TAPPBENCHCFG__
+
+#if _MSC_VER > 1000
+#pragma once
+#endif // _MSC_VER > 1000
+
+#include "TLibCommon/CommonDef.h"
+
+//! \ingroup TAppBench
+//! \{
+
+// ====================================================================================================================
+// Constants
+// ====================================================================================================================
+
+#define BENCH_CTU_SIZE            64      ///< CTU size of the synthetic picture
+#define BENCH_CTU_DEPTH           4       ///< CU depth of the synthetic picture (8x8 luma CUs at the deepest level)
+
+// ====================================================================================================================
+// Class definition
+// ====================================================================================================================
+
+/// kernel benchmark configuration class
+class TAppBenchCfg
+{
+protected:
+  char*         m_pchKernels;                         ///< comma separated list of kernel groups to run, NULL for all
+  char*         m_pchTempFile;                        ///< scratch file for the YUV file I/O kernels
+  Double        m_dMinTime;                           ///< minimum measuring time per kernel in milliseconds
+  Bool          m_bCheck;                             ///< cross-check the kernels against the scalar references
+  UInt          m_uiSeed;                             ///< seed of the synthetic content
+  Int           m_iSourceWidth;                       ///< width of the synthetic picture
+  Int           m_iSourceHeight;                      ///< height of the synthetic picture
+  UInt          m_uiInternalBitDepth;                 ///< internal bit depth of the kernels
+  Int           m_iNumBins;                           ///< number of bins of the CABAC bin stream
+
+public:
+  TAppBenchCfg()          {}
+  virtual ~TAppBenchCfg() {}
+
+  Bool  parseCfg        ( Int argc, Char* argv[] );   ///< initialize option class from configuration
+};
+
+//! \}
+
+#endif
+
@@ -0,0 +1,1505 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.  
+ *
+ * Copyright (c) 2010-2012, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** \file     TAppBenchTop.cpp
+    \brief    Kernel benchmark application class
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <sys/time.h>
+#endif
+
+#include "TAppBenchTop.h"
+#include "TLibCommon/TComRom.h"
+#include "TLibCommon/TComPattern.h"
+#include "TLibDecoder/TDecBinCoderCABAC.h"
+#include "TLibVideoIO/TVideoIOYuv.h"
+
+//! \ingroup TAppBench
+//! \{
+
+// ====================================================================================================================
+// Constants
+// ====================================================================================================================
+
+#define BLK_PLANE_SIZE            256     ///< width, height and stride of the synthetic block planes
+#define BLK_PLANE_MARGIN          64      ///< position of the benchmarked blocks inside the block planes
+#define BENCH_QP                  32      ///< QP of the quantization and deblocking kernels
+#define BENCH_YUV_FRAMES          4       ///< frames written or read per call of the file I/O kernels
+#define BENCH_NUM_CTX             8       ///< context models of the CABAC bin stream
+
+enum BenchCheck
+{
+  CHECK_NONE = 0,                         ///< kernel without a scalar reference
+  CHECK_OK,
+  CHECK_FAIL
+};
+
+// ====================================================================================================================
+// Local functions
+// ====================================================================================================================
+
+/// wall clock time in seconds
+static Double xGetTime()
+{
+#ifdef _WIN32
+  LARGE_INTEGER cCount, cFreq;
+  QueryPerformanceCounter( &cCount );
+  QueryPerformanceFrequency( &cFreq );
+  return (Double)cCount.QuadPart / (Double)cFreq.QuadPart;
+#else
+  struct timeval cTime;
+  gettimeofday( &cTime, NULL );
+  return cTime.tv_sec + cTime.tv_usec * 1e-6;
+#endif
+}
+
+/// deterministic pseudo random numbers (xorshift32)
+static inline UInt xRand( UInt& ruiState )
+{
+  ruiState ^= ruiState << 13;
+  ruiState ^= ruiState >> 17;
+  ruiState ^= ruiState << 5;
+  return ruiState;
+}
+
+/// uniformly distributed integer in [-iRange, iRange]
+static inline Int xRandRange( UInt& ruiState, Int iRange )
+{
+  return Int( xRand( ruiState ) % UInt( 2 * iRange + 1 ) ) - iRange;
+}
+
+/** Fill a plane with natural looking content: a diagonal gradient, a blocky texture and noise
+ * \param piDst      destination samples
+ * \param iStride    stride of the destination
+ * \param iWidth     width of the plane
+ * \param iHeight    height of the plane
+ * \param ruiState   state of the random number generator
+ * \param iNoise     amplitude of the noise in 8-bit units
+ */
+static Void xFillPlane( Pel* piDst, Int iStride, Int iWidth, Int iHeight, UInt& ruiState, Int iNoise )
+{
+  for ( Int y = 0; y < iHeight; y++ )
+  {
+    for ( Int x = 0; x < iWidth; x++ )
+    {
+      Int iVal = 32 + ( ( x + 2 * y ) % 160 ) + ( ( ( ( x >> 2 ) ^ ( y >> 2 ) ) & 3 ) << 4 ) + xRandRange( ruiState, iNoise );
+      iVal     = ( Clip3( 0, 255, iVal ) << g_uiBitIncrement ) + ( g_uiBitIncrement ? Int( xRand( ruiState ) & ( ( 1 << g_uiBitIncrement ) - 1 ) ) : 0 );
+      piDst[x] = (Pel)iVal;
+    }
+    piDst += iStride;
+  }
+}
+
+/// copy a plane while adding noise, e.g. to derive a reconstruction or reference from an original
+static Void xNoisyCopy( const Pel* piSrc, Pel* piDst, Int iStride, Int iWidth, Int iHeight, UInt& ruiState, Int iNoise )
+{
+  for ( Int y = 0; y < iHeight; y++ )
+  {
+    for ( Int x = 0; x < iWidth; x++ )
+    {
+      piDst[x] = (Pel)Clip3( 0, (Int)g_uiIBDI_MAX, piSrc[x] + ( xRandRange( ruiState, iNoise ) << g_uiBitIncrement ) );
+    }
+    piSrc += iStride;
+    piDst += iStride;
+  }
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+// Scalar references
+// --------------------------------------------------------------------------------------------------------------------
+
+static UInt xRefSse( const Pel* piOrg, const Pel* piCur, Int iStride, Int iWidth, Int iHeight )
+{
+  UInt uiSum = 0;
+  for ( Int y = 0; y < iHeight; y++, piOrg += iStride, piCur += iStride )
+  {
+    for ( Int x = 0; x < iWidth; x++ )
+    {
+      Int iDiff = piOrg[x] - piCur[x];
+      uiSum += ( iDiff * iDiff ) >> ( g_uiBitIncrement << 1 );
+    }
+  }
+  return uiSum;
+}
+
+/// SAD of every (1 << iSubShift)-th row, scaled back to the full block
+static UInt xRefSad( const Pel* piOrg, const Pel* piCur, Int iStride, Int iWidth, Int iHeight, Int iSubShift )
+{
+  UInt uiSum = 0;
+  for ( Int y = 0; y < iHeight; y += 1 << iSubShift )
+  {
+    for ( Int x = 0; x < iWidth; x++ )
+    {
+      uiSum += abs( piOrg[y * iStride + x] - piCur[y * iStride + x] );
+    }
+  }
+  return ( uiSum << iSubShift ) >> g_uiBitIncrement;
+}
+
+/** Separable interpolation computed directly from the filter definition
+ * \param piSrc      source samples at the block position
+ * \param iStride    stride of the source
+ * \param psDst      destination, iWidth samples per row
+ * \param iWidth     width of the block
+ * \param iHeight    height of the block
+ * \param piCoeffH   horizontal taps, NULL for vertical filtering only
+ * \param piCoeffV   vertical taps, NULL for horizontal filtering only
+ * \param iTaps      number of taps
+ */
+static Void xRefInterpolate( const Pel* piSrc, Int iStride, Short* psDst, Int iWidth, Int iHeight, const Int* piCoeffH, const Int* piCoeffV, Int iTaps )
+{
+  Int iHeadRoom = IF_INTERNAL_PREC - ( g_uiBitDepth + g_uiBitIncrement );
+  Int iHalf     = iTaps / 2 - 1;
+  for ( Int y = 0; y < iHeight; y++ )
+  {
+    for ( Int x = 0; x < iWidth; x++ )
+    {
+      Int iVal;
+      if ( piCoeffH && piCoeffV )
+      {
+        // the first stage keeps IF_INTERNAL_PREC bits around zero, the second one rounds to the sample range
+        Int iSum = 0;
+        for ( Int k = 0; k < iTaps; k++ )
+        {
+          const Pel* piRow = piSrc + ( y + k - iHalf ) * iStride + x - iHalf;
+          Int iRow = 0;
+          for ( Int l = 0; l < iTaps; l++ )
+          {
+            iRow += piCoeffH[l] * piRow[l];
+          }
+          Int iShift = IF_FILTER_PREC - iHeadRoom;
+          iSum += piCoeffV[k] * (Short)( ( iRow - ( IF_INTERNAL_OFFS << iShift ) ) >> iShift );
+        }
+        Int iShift = IF_FILTER_PREC + iHeadRoom;
+        iVal = ( iSum + ( 1 << ( iShift - 1 ) ) + ( IF_INTERNAL_OFFS << IF_FILTER_PREC ) ) >> iShift;
+      }
+      else
+      {
+        const Int* piCoeff = piCoeffH ? piCoeffH : piCoeffV;
+        Int        iStep   = piCoeffH ? 1 : iStride;
+        Int iSum = 0;
+        for ( Int k = 0; k < iTaps; k++ )
+        {
+          iSum += piCoeff[k] * piSrc[y * iStride + x + ( k - iHalf ) * iStep];
+        }
+        iVal = ( iSum + ( 1 << ( IF_FILTER_PREC - 1 ) ) ) >> IF_FILTER_PREC;
+      }
+      psDst[y * iWidth + x] = (Short)Clip3( 0, (Int)g_uiIBDI_MAX, iVal );
+    }
+  }
+}
+
+/// transform matrix of a square block size, the DST for 4x4 blocks of other modes than REG_DCT
+static const Short* xGetTransformMatrix( Int iSize, UInt uiMode )
+{
+  switch ( iSize )
+  {
+    case 4:  return uiMode != REG_DCT ? &g_as_DST_MAT_4[0][0] : &g_aiT4[0][0];
+    case 8:  return &g_aiT8[0][0];
+    case 16: return &g_aiT16[0][0];
+    default: return &g_aiT32[0][0];
+  }
+}
+
+/// 2D forward transform as two matrix multiplications with the rounding of xTrMxN
+static Void xRefTransform( const Short* psBlock, Short* psCoeff, Int iSize, UInt uiMode )
+{
+  const Short* psT   = xGetTransformMatrix( iSize, uiMode );
+  Int          iShift1 = g_aucConvertToBit[iSize] + 1 + g_uiBitIncrement;
+  Int          iShift2 = g_aucConvertToBit[iSize] + 8;
+  std::vector<Short> cTmp( iSize * iSize );
+  for ( Int j = 0; j < iSize; j++ )
+  {
+    for ( Int k = 0; k < iSize; k++ )
+    {
+      Int iSum = 0;
+      for ( Int n = 0; n < iSize; n++ )
+      {
+        iSum += psT[k * iSize + n] * psBlock[j * iSize + n];
+      }
+      cTmp[k * iSize + j] = (Short)( ( iSum + ( 1 << ( iShift1 - 1 ) ) ) >> iShift1 );
+    }
+  }
+  for ( Int j = 0; j < iSize; j++ )
+  {
+    for ( Int k = 0; k < iSize; k++ )
+    {
+      Int iSum = 0;
+      for ( Int n = 0; n < iSize; n++ )
+      {
+        iSum += psT[k * iSize + n] * cTmp[j * iSize + n];
+      }
+      psCoeff[k * iSize + j] = (Short)( ( iSum + ( 1 << ( iShift2 - 1 ) ) ) >> iShift2 );
+    }
+  }
+}
+
+/// 2D inverse transform as two matrix multiplications with the rounding and clipping of xITrMxN
+static Void xRefInvTransform( const Short* psCoeff, Short* psBlock, Int iSize, UInt uiMode )
+{
+  const Short* psT     = xGetTransformMatrix( iSize, uiMode );
+  Int          iShift1 = SHIFT_INV_1ST;
+  Int          iShift2 = SHIFT_INV_2ND - g_uiBitIncrement;
+  std::vector<Short> cTmp( iSize * iSize );
+  for ( Int j = 0; j < iSize; j++ )
+  {
+    for ( Int n = 0; n < iSize; n++ )
+    {
+      Int iSum = 0;
+      for ( Int k = 0; k < iSize; k++ )
+      {
+        iSum += psT[k * iSize + n] * psCoeff[k * iSize + j];
+      }
+      cTmp[j * iSize + n] = (Short)Clip3( -32768, 32767, ( iSum + ( 1 << ( iShift1 - 1 ) ) ) >> iShift1 );
+    }
+  }
+  for ( Int j = 0; j < iSize; j++ )
+  {
+    for ( Int n = 0; n < iSize; n++ )
+    {
+      Int iSum = 0;
+      for ( Int k = 0; k < iSize; k++ )
+      {
+        iSum += psT[k * iSize + n] * cTmp[k * iSize + j];
+      }
+      psBlock[j * iSize + n] = (Short)Clip3( -32768, 32767, ( iSum + ( 1 << ( iShift2 - 1 ) ) ) >> iShift2 );
+    }
+  }
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+// Kernel functors: one call of the kernel under test, returning a value that keeps the call alive
+// --------------------------------------------------------------------------------------------------------------------
+
+struct TDistKernel
+{
+  DistParam* pcDtParam;
+  UInt operator() () { return pcDtParam->DistFunc( pcDtParam ); }
+};
+
+struct TSadCacheKernel
+{
+  TEncSadCache* pcCache;
+  const Int*    piMv;                     ///< motion vector pairs
+  Int           iNumMv;
+  Int           iIdx;
+  UInt operator() ()
+  {
+    iIdx = ( iIdx + 1 ) % iNumMv;
+    return pcCache->getSad( piMv[2 * iIdx], piMv[2 * iIdx + 1] );
+  }
+};
+
+/// SAD cache on a new CU: sets up the CU and probes every motion vector once
+struct TSadCacheColdKernel
+{
+  TEncSadCache* pcCache;
+  Pel*          piOrg;
+  Pel*          piRef;
+  Int           iStride;
+  Int           iSize;
+  const Int*    piMv;
+  Int           iNumMv;
+  UInt operator() ()
+  {
+    pcCache->initCU( 0, 0, 0, iSize, piOrg, iStride );
+    pcCache->setReference( REF_PIC_LIST_0, 0, piRef, iStride );
+    pcCache->setPartition( 0, 0, iSize, iSize, 0 );
+    UInt uiSum = 0;
+    for ( Int i = 0; i < iNumMv; i++ )
+    {
+      uiSum += pcCache->getSad( piMv[2 * i], piMv[2 * i + 1] );
+    }
+    return uiSum;
+  }
+};
+
+struct TInterpKernel
+{
+  TComInterpolationFilter* pcIf;
+  Pel*   piSrc;
+  Int    iStride;
+  Short* psTmp;
+  Short* psDst;
+  Int    iSize;
+  Bool   bChroma;
+  Bool   bHor;
+  Bool   bVer;
+  Int    iFracX;
+  Int    iFracY;
+  UInt operator() ()
+  {
+    Int iHalf = ( bChroma ? NTAPS_CHROMA : NTAPS_LUMA ) / 2 - 1;
+    Int iTaps = bChroma ? NTAPS_CHROMA : NTAPS_LUMA;
+    if ( bHor && bVer )
+    {
+      if ( bChroma )
+      {
+        pcIf->filterHorChroma( piSrc - iHalf * iStride, iStride, psTmp, iSize, iSize, iSize + iTaps - 1, iFracX, false );
+        pcIf->filterVerChroma( (Pel*)psTmp + iHalf * iSize, iSize, psDst, iSize, iSize, iSize, iFracY, false, true );
+      }
+      else
+      {
+        pcIf->filterHorLuma( piSrc - iHalf * iStride, iStride, psTmp, iSize, iSize, iSize + iTaps - 1, iFracX, false );
+        pcIf->filterVerLuma( (Pel*)psTmp + iHalf * iSize, iSize, psDst, iSize, iSize, iSize, iFracY, false, true );
+      }
+    }
+    else if ( bHor )
+    {
+      if ( bChroma )
+      {
+        pcIf->filterHorChroma( piSrc, iStride, psDst, iSize, iSize, iSize, iFracX, true );
+      }
+      else
+      {
+        pcIf->filterHorLuma( piSrc, iStride, psDst, iSize, iSize, iSize, iFracX, true );
+      }
+    }
+    else
+    {
+      if ( bChroma )
+      {
+        pcIf->filterVerChroma( piSrc, iStride, psDst, iSize, iSize, iSize, iFracY, true, true );
+      }
+      else
+      {
+        pcIf->filterVerLuma( piSrc, iStride, psDst, iSize, iSize, iSize, iFracY, true, true );
+      }
+    }
+    return psDst[0];
+  }
+};
+
+struct TTransformKernel
+{
+  Short* psSrc;
+  Short* psDst;
+  Int    iSize;
+  UInt   uiMode;
+  Bool   bInverse;
+  Int    iSigSize;
+  UInt operator() ()
+  {
+    if ( bInverse )
+    {
+      xITrMxN( psSrc, psDst, iSize, iSize, uiMode, iSigSize, iSigSize );
+    }
+    else
+    {
+      xTrMxN( psSrc, psDst, iSize, iSize, uiMode );
+    }
+    return psDst[0];
+  }
+};
+
+struct TQuantKernel
+{
+  TComTrQuant* pcTrQuant;
+  TComDataCU*  pcCU;
+  Pel*         piResi;
+  TCoeff*      pcCoeff;
+  Int*         piArlCoeff;
+  Int          iSize;
+  UInt operator() ()
+  {
+    UInt uiAbsSum = 0;
+    pcTrQuant->transformNxN( pcCU, piResi, iSize, pcCoeff,
+#if ADAPTIVE_QP_SELECTION
+                             piArlCoeff,
+#endif
+                             iSize, iSize, uiAbsSum, TEXT_LUMA, 0 );
+    return uiAbsSum;
+  }
+};
+
+struct TDeQuantKernel
+{
+  TComTrQuant* pcTrQuant;
+  Pel*         piResi;
+  TCoeff*      pcCoeff;
+  Int          iSize;
+  UInt operator() ()
+  {
+    pcTrQuant->invtransformNxN( false, TEXT_LUMA, DC_IDX, piResi, iSize, pcCoeff, iSize, iSize, 0 );
+    return piResi[0];
+  }
+};
+
+struct TDeblockKernel
+{
+  TComLoopFilter* pcLoopFilter;
+  TComPic*        pcPic;
+  TComPicYuv*     pcBackup;
+  Bool            bFilter;                ///< false to measure the restore of the reconstruction alone
+  UInt operator() ()
+  {
+    pcBackup->copyToPic( pcPic->getPicYuvRec() );
+    if ( bFilter )
+    {
+      pcLoopFilter->loopFilterPic( pcPic );
+    }
+    return pcPic->getPicYuvRec()->getLumaAddr()[0];
+  }
+};
+
+struct TSaoStatsKernel
+{
+  TAppBenchSao* pcSao;
+  Int           iAddr;                    ///< >= 0: single pass over a CTU, < 0: reference over a block
+  Pel*          piRec;
+  Pel*          piOrg;
+  Int           iStride;
+  Int64**       ppStats;
+  Int64**       ppCount;
+  Bool*         pbBorderAvail;
+  UInt operator() ()
+  {
+    if ( iAddr >= 0 )
+    {
+      pcSao->calcSaoStatsCuOrg( iAddr, 0, 0 );
+    }
+    else
+    {
+      pcSao->calcSaoStatsBlock( piRec, piOrg, iStride, ppStats, ppCount, BENCH_CTU_SIZE, BENCH_CTU_SIZE, pbBorderAvail );
+    }
+    return 0;
+  }
+};
+
+struct TSaoFilterKernel
+{
+  TAppBenchSao* pcSao;
+  Pel*          piDec;
+  Pel*          piRest;
+  Int           iStride;
+  Int           iSaoType;
+  Bool*         pbBorderAvail;
+  UInt operator() ()
+  {
+    pcSao->processSaoBlock( piDec, piRest, iStride, iSaoType, 0, 0, BENCH_CTU_SIZE, BENCH_CTU_SIZE, pbBorderAvail );
+    return piRest[0];
+  }
+};
+
+/// bin stream: context index per bin, or BENCH_NUM_CTX for bypass bins
+struct TCabacEncKernel
+{
+  TComOutputBitstream* pcBitstream;
+  TEncBinCABAC*        pcBinCABAC;
+  ContextModel*        pcCtx;
+  const UChar*         pucCtxIdx;
+  const UChar*         pucBin;
+  Int                  iNumBins;
+  UInt operator() ()
+  {
+    pcBitstream->clear();
+    pcBinCABAC->init( pcBitstream );
+    pcBinCABAC->start();
+    for ( Int i = 0; i < BENCH_NUM_CTX; i++ )
+    {
+      pcCtx[i].init( BENCH_QP, 154 );
+    }
+    for ( Int i = 0; i < iNumBins; i++ )
+    {
+      if ( pucCtxIdx[i] < BENCH_NUM_CTX )
+      {
+        pcBinCABAC->encodeBin( pucBin[i], pcCtx[pucCtxIdx[i]] );
+      }
+      else
+      {
+        pcBinCABAC->encodeBinEP( pucBin[i] );
+      }
+    }
+    pcBinCABAC->encodeBinTrm( 1 );
+    pcBinCABAC->finish();
+    pcBitstream->write( 1, 1 );
+    pcBitstream->writeAlignZero();
+    return pcBitstream->getNumberOfWrittenBits();
+  }
+};
+
+struct TCabacDecKernel
+{
+  std::vector<uint8_t>* pcBytes;
+  ContextModel*         pcCtx;
+  const UChar*          pucCtxIdx;
+  UChar*                pucBin;               ///< decoded bins
+  Int                   iNumBins;
+  UInt operator() ()
+  {
+    TComInputBitstream cBitstream( pcBytes );
+    TDecBinCABAC       cBinCABAC;
+    cBinCABAC.init( &cBitstream );
+    cBinCABAC.start();
+    for ( Int i = 0; i < BENCH_NUM_CTX; i++ )
+    {
+      pcCtx[i].init( BENCH_QP, 154 );
+    }
+    UInt uiBin;
+    for ( Int i = 0; i < iNumBins; i++ )
+    {
+      if ( pucCtxIdx[i] < BENCH_NUM_CTX )
+      {
+        cBinCABAC.decodeBin( uiBin, pcCtx[pucCtxIdx[i]] );
+      }
+      else
+      {
+        cBinCABAC.decodeBinEP( uiBin );
+      }
+      pucBin[i] = (UChar)uiBin;
+    }
+    cBinCABAC.decodeBinTrm( uiBin );
+    return uiBin;
+  }
+};
+
+struct TVideoIOKernel
+{
+  char*        pchFile;
+  TComPicYuv*  pcPicYuv;
+  Bool         bWrite;
+  UInt operator() ()
+  {
+    TVideoIOYuv cFile;
+    UInt        uiBitDepth = g_uiBitDepth + g_uiBitIncrement;
+    Int         aiPad[2]   = { 0, 0 };
+    cFile.open( pchFile, bWrite, uiBitDepth, uiBitDepth );
+    for ( Int i = 0; i < BENCH_YUV_FRAMES; i++ )
+    {
+      if ( bWrite )
+      {
+        cFile.write( pcPicYuv );
+      }
+      else
+      {
+        cFile.read( pcPicYuv, aiPad );
+      }
+    }
+    cFile.close();
+    return pcPicYuv->getLumaAddr()[0];
+  }
+};
+
+// ====================================================================================================================
+// TAppBenchSao
+// ====================================================================================================================
+
+/** Set the offsets used by processSaoBlock() as SAOProcess() does for a CTU
+ * \param piEoOffset    offset per edge class 1..4 of the edge offset types, index 0 is unused
+ * \param piBandOffset  offset per band 1..32 of the band offset type, index 0 is unused
+ */
+Void TAppBenchSao::setOffsets( const Int* piEoOffset, const Int* piBandOffset )
+{
+  for ( Int iEdgeType = 0; iEdgeType < 6; iEdgeType++ )
+  {
+    m_iOffsetEo[iEdgeType] = m_auiEoTable[iEdgeType] ? piEoOffset[m_auiEoTable[iEdgeType]] << g_uiBitIncrement : 0;
+  }
+  for ( Int i = 0; i <= (Int)g_uiIBDI_MAX; i++ )
+  {
+    m_iOffsetBo[i] = m_pClipTable[i + ( piBandOffset[m_lumaTableBo[i]] << g_uiBitIncrement )];
+  }
+}
+
+// ====================================================================================================================
+// Constructor / destructor / initialization / destroy
+// ====================================================================================================================
+
+TAppBenchTop::TAppBenchTop()
+: m_pcPic( NULL )
+, m_pcPicYuvBackup( NULL )
+, m_pcPicYuvSao( NULL )
+, m_piPlaneOrg( NULL )
+, m_piPlaneRef( NULL )
+, m_uiRandState( 1 )
+, m_uiNumKernels( 0 )
+, m_uiNumChecks( 0 )
+, m_uiNumMismatches( 0 )
+, m_uiSink( 0 )
+{
+}
+
+Void TAppBenchTop::create()
+{
+}
+
+Void TAppBenchTop::destroy()
+{
+  if ( m_pchKernels )
+  {
+    free( m_pchKernels );
+    m_pchKernels = NULL;
+  }
+  if ( m_pchTempFile )
+  {
+    free( m_pchTempFile );
+    m_pchTempFile = NULL;
+  }
+}
+
+// ====================================================================================================================
+// Public member functions
+// ====================================================================================================================
+
+/** Run the selected kernel groups
+ * \returns number of failed cross-checks
+ */
+UInt TAppBenchTop::bench()
+{
+  xInitROM();
+  m_uiRandState = m_uiSeed ? m_uiSeed : 1;
+
+  m_piPlaneOrg = new Pel[BLK_PLANE_SIZE * BLK_PLANE_SIZE];
+  m_piPlaneRef = new Pel[BLK_PLANE_SIZE * BLK_PLANE_SIZE];
+  xFillPlane( m_piPlaneOrg, BLK_PLANE_SIZE, BLK_PLANE_SIZE, BLK_PLANE_SIZE, m_uiRandState, 4 );
+  // the reference is the original moved by (3, 2) with coding noise
+  for ( Int y = 0; y < BLK_PLANE_SIZE; y++ )
+  {
+    for ( Int x = 0; x < BLK_PLANE_SIZE; x++ )
+    {
+      Pel iSrc = m_piPlaneOrg[( ( y + 2 ) % BLK_PLANE_SIZE ) * BLK_PLANE_SIZE + ( x + 3 ) % BLK_PLANE_SIZE];
+      m_piPlaneRef[y * BLK_PLANE_SIZE + x] = (Pel)Clip3( 0, (Int)g_uiIBDI_MAX, iSrc + ( xRandRange( m_uiRandState, 6 ) << g_uiBitIncrement ) );
+    }
+  }
+  xCreatePicture();
+
+  printf( "\nInternal bit depth %d, picture %dx%d, minimum time %.0f ms per kernel\n\n",
+         g_uiBitDepth + g_uiBitIncrement, m_iSourceWidth, m_iSourceHeight, m_dMinTime );
+  printf( "%-32s %12s %14s        %s\n", "kernel", "ns/call", "throughput", "check" );
+
+  if ( xIsSelected( "dist" ) )     xBenchDistortion();
+  if ( xIsSelected( "sadcache" ) ) xBenchSadCache();
+  if ( xIsSelected( "interp" ) )   xBenchInterpolation();
+  if ( xIsSelected( "trans" ) )    xBenchTransform();
+  if ( xIsSelected( "quant" ) )    xBenchQuant();
+  if ( xIsSelected( "deblock" ) )  xBenchDeblocking();
+  if ( xIsSelected( "sao" ) )      xBenchSao();
+  if ( xIsSelected( "cabac" ) )    xBenchCabac();
+  if ( xIsSelected( "yuvio" ) )    xBenchVideoIO();
+
+  printf( "\n%d kernels measured, %d cross-checks, %d mismatches\n", m_uiNumKernels, m_uiNumChecks, m_uiNumMismatches );
+
+  xDestroyPicture();
+  delete [] m_piPlaneOrg;
+  delete [] m_piPlaneRef;
+  m_piPlaneOrg = NULL;
+  m_piPlaneRef = NULL;
+  destroyROM();
+
+  return m_uiNumMismatches;
+}
+
+// ====================================================================================================================
+// Protected member functions
+// ====================================================================================================================
+
+Void TAppBenchTop::xInitROM()
+{
+  g_uiMaxCUWidth   = BENCH_CTU_SIZE;
+  g_uiMaxCUHeight  = BENCH_CTU_SIZE;
+  g_uiMaxCUDepth   = BENCH_CTU_DEPTH;
+  g_uiAddCUDepth   = 0;
+#if FULL_NBIT
+  g_uiBitDepth     = m_uiInternalBitDepth;
+  g_uiBitIncrement = 0;
+#else
+  g_uiBitDepth     = 8;
+  g_uiBitIncrement = m_uiInternalBitDepth - g_uiBitDepth;
+#endif
+  g_uiBASE_MAX     = ( 1 << g_uiBitDepth ) - 1;
+#if IBDI_NOCLIP_RANGE
+  g_uiIBDI_MAX     = g_uiBASE_MAX << g_uiBitIncrement;
+#else
+  g_uiIBDI_MAX     = ( 1 << ( g_uiBitDepth + g_uiBitIncrement ) ) - 1;
+#endif
+
+  initROM();
+  UInt* puiZscanToRaster = &g_auiZscanToRaster[0];
+  initZscanToRaster ( BENCH_CTU_DEPTH + 1, 1, 0, puiZscanToRaster );
+  initRasterToZscan ( BENCH_CTU_SIZE, BENCH_CTU_SIZE, BENCH_CTU_DEPTH + 1 );
+  initRasterToPelXY ( BENCH_CTU_SIZE, BENCH_CTU_SIZE, BENCH_CTU_DEPTH + 1 );
+  initMotionReferIdx( BENCH_CTU_SIZE, BENCH_CTU_SIZE, BENCH_CTU_DEPTH + 1 );
+  ContextModel::buildNextStateTable();
+}
+
+/** Create an intra picture of 8x8 CUs with a textured original and a blocky reconstruction
+ */
+Void TAppBenchTop::xCreatePicture()
+{
+  m_cSPS.setPicWidthInLumaSamples ( m_iSourceWidth );
+  m_cSPS.setPicHeightInLumaSamples( m_iSourceHeight );
+  m_cSPS.setMaxCUWidth            ( BENCH_CTU_SIZE );
+  m_cSPS.setMaxCUHeight           ( BENCH_CTU_SIZE );
+  m_cSPS.setMaxCUDepth            ( BENCH_CTU_DEPTH );
+  m_cSPS.setMaxTrSize             ( 32 );
+  m_cSPS.setQpBDOffsetY           ( 6 * g_uiBitIncrement );
+  m_cSPS.setQpBDOffsetC           ( 6 * g_uiBitIncrement );
+  m_cSPS.setUsePCM                ( false );
+
+  m_pcPic = new TComPic;
+  m_pcPic->create( m_iSourceWidth, m_iSourceHeight, BENCH_CTU_SIZE, BENCH_CTU_SIZE, BENCH_CTU_DEPTH );
+  m_pcPic->setCurrSliceIdx( 0 );
+
+  // a single tile covering the picture
+  TComPicSym* pcPicSym = m_pcPic->getPicSym();
+  pcPicSym->setNumColumnsMinus1( 0 );
+  pcPicSym->setNumRowsMinus1( 0 );
+  pcPicSym->xCreateTComTileArray();
+  pcPicSym->getTComTile( 0 )->setTileWidth ( pcPicSym->getFrameWidthInCU() );
+  pcPicSym->getTComTile( 0 )->setTileHeight( pcPicSym->getFrameHeightInCU() );
+  pcPicSym->xInitTiles();
+
+  UInt       uiNumPart = m_pcPic->getNumPartInCU();
+  TComSlice* pcSlice   = m_pcPic->getSlice( 0 );
+  pcSlice->setSPS                        ( &m_cSPS );
+  pcSlice->setPPS                        ( &m_cPPS );
+  pcSlice->setSliceType                  ( I_SLICE );
+  pcSlice->setSliceQp                    ( BENCH_QP );
+  pcSlice->setSliceQpBase                ( BENCH_QP );
+  pcSlice->setSliceCurEndCUAddr          ( m_pcPic->getNumCUsInFrame() * uiNumPart );
+  pcSlice->setDependentSliceCurEndCUAddr ( m_pcPic->getNumCUsInFrame() * uiNumPart );
+  pcSlice->setLFCrossSliceBoundaryFlag   ( true );
+
+  const UInt uiCUDepth    = BENCH_CTU_DEPTH - 1;
+  const UInt uiCUNumPart  = uiNumPart >> ( uiCUDepth << 1 );
+  const UInt uiCUSize     = BENCH_CTU_SIZE >> uiCUDepth;
+  for ( UInt uiAddr = 0; uiAddr < m_pcPic->getNumCUsInFrame(); uiAddr++ )
+  {
+    TComDataCU* pcCU = m_pcPic->getCU( uiAddr );
+    pcCU->initCU( m_pcPic, uiAddr );
+    for ( UInt uiIdx = 0; uiIdx < uiNumPart; uiIdx += uiCUNumPart )
+    {
+      pcCU->setDepthSubParts       ( uiCUDepth, uiIdx );
+      pcCU->setSizeSubParts        ( uiCUSize, uiCUSize, uiIdx, uiCUDepth );
+      pcCU->setPartSizeSubParts    ( SIZE_2Nx2N, uiIdx, uiCUDepth );
+      pcCU->setPredModeSubParts    ( MODE_INTRA, uiIdx, uiCUDepth );
+      pcCU->setLumaIntraDirSubParts( DC_IDX, uiIdx, uiCUDepth );
+      pcCU->setTrIdxSubParts       ( 0, uiIdx, uiCUDepth );
+      pcCU->setCbfSubParts         ( 1, 1, 1, uiIdx, uiCUDepth );
+      pcCU->setQPSubParts          ( BENCH_QP, uiIdx, uiCUDepth );
+    }
+  }
+
+  // blocky reconstruction: every 8x8 block gets its own DC error, so that the deblocking filter has work to do
+  TComPicYuv* pcOrg = m_pcPic->getPicYuvOrg();
+  TComPicYuv* pcRec = m_pcPic->getPicYuvRec();
+  for ( Int iComp = 0; iComp < 3; iComp++ )
+  {
+    Int  iStride = iComp ? pcOrg->getCStride() : pcOrg->getStride();
+    Int  iWidth  = m_iSourceWidth  >> ( iComp ? 1 : 0 );
+    Int  iHeight = m_iSourceHeight >> ( iComp ? 1 : 0 );
+    Int  iBlk    = iComp ? 4 : 8;
+    Pel* piOrg   = iComp == 0 ? pcOrg->getLumaAddr() : iComp == 1 ? pcOrg->getCbAddr() : pcOrg->getCrAddr();
+    Pel* piRec   = iComp == 0 ? pcRec->getLumaAddr() : iComp == 1 ? pcRec->getCbAddr() : pcRec->getCrAddr();
+    xFillPlane( piOrg, iStride, iWidth, iHeight, m_uiRandState, 2 );
+    xNoisyCopy( piOrg, piRec, iStride, iWidth, iHeight, m_uiRandState, 2 );
+    for ( Int y = 0; y < iHeight; y += iBlk )
+    {
+      for ( Int x = 0; x < iWidth; x += iBlk )
+      {
+        Int iDC = xRandRange( m_uiRandState, 3 ) << g_uiBitIncrement;
+        for ( Int j = y; j < y + iBlk; j++ )
+        {
+          for ( Int i = x; i < x + iBlk; i++ )
+          {
+            piRec[j * iStride + i] = (Pel)Clip3( 0, (Int)g_uiIBDI_MAX, piRec[j * iStride + i] + iDC );
+          }
+        }
+      }
+    }
+  }
+  pcOrg->extendPicBorder();
+  pcRec->extendPicBorder();
+
+  m_pcPicYuvBackup = new TComPicYuv;
+  m_pcPicYuvBackup->create( m_iSourceWidth, m_iSourceHeight, BENCH_CTU_SIZE, BENCH_CTU_SIZE, BENCH_CTU_DEPTH );
+  pcRec->copyToPic( m_pcPicYuvBackup );
+  m_pcPicYuvSao = new TComPicYuv;
+  m_pcPicYuvSao->create( m_iSourceWidth, m_iSourceHeight, BENCH_CTU_SIZE, BENCH_CTU_SIZE, BENCH_CTU_DEPTH );
+}
+
+Void TAppBenchTop::xDestroyPicture()
+{
+  if ( m_pcPicYuvSao )
+  {
+    m_pcPicYuvSao->destroy();
+    delete m_pcPicYuvSao;
+    m_pcPicYuvSao = NULL;
+  }
+  if ( m_pcPicYuvBackup )
+  {
+    m_pcPicYuvBackup->destroy();
+    delete m_pcPicYuvBackup;
+    m_pcPicYuvBackup = NULL;
+  }
+  if ( m_pcPic )
+  {
+    m_pcPic->destroy();
+    delete m_pcPic;
+    m_pcPic = NULL;
+  }
+}
+
+/** \param pchGroup name of a kernel group
+ * \returns true when the group is in the --Kernels list or no list was given
+ */
+Bool TAppBenchTop::xIsSelected( const Char* pchGroup )
+{
+  if ( m_pchKernels == NULL )
+  {
+    return true;
+  }
+  size_t uiLen = strlen( pchGroup );
+  for ( const Char* pch = m_pchKernels; pch; pch = strchr( pch, ',' ) ? strchr( pch, ',' ) + 1 : NULL )
+  {
+    if ( strncmp( pch, pchGroup, uiLen ) == 0 && ( pch[uiLen] == ',' || pch[uiLen] == '\0' ) )
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+/** Call a kernel in batches of doubling size until the minimum measuring time has passed
+ * \param rcKernel functor running one call of the kernel
+ * \returns nanoseconds per call
+ */
+template <class T>
+Double TAppBenchTop::xMeasure( T& rcKernel )
+{
+  Double dMinTime  = m_dMinTime * 1e-3;
+  UInt   uiSink    = rcKernel();                    // warm up caches and lazily allocated state
+  UInt64 uiCalls   = 0;
+  UInt   uiBatch   = 1;
+  Double dStart    = xGetTime();
+  Double dElapsed  = 0;
+  while ( dElapsed < dMinTime )
+  {
+    for ( UInt i = 0; i < uiBatch; i++ )
+    {
+      uiSink += rcKernel();
+    }
+    uiCalls += uiBatch;
+    dElapsed = xGetTime() - dStart;
+    if ( dElapsed < dMinTime / 8 )
+    {
+      uiBatch <<= 1;
+    }
+  }
+  m_uiSink += uiSink;
+  return dElapsed * 1e9 / (Double)uiCalls;
+}
+
+/** Print one result line
+ * \param pchName       kernel name
+ * \param dNsPerCall    nanoseconds per call
+ * \param dItemsPerCall work items (samples, bins, bytes) per call
+ * \param pchUnit       unit of the throughput, the work items in millions per second
+ * \param iCheck        result of the cross-check, one of BenchCheck
+ */
+Void TAppBenchTop::xReport( const Char* pchName, Double dNsPerCall, Double dItemsPerCall, const Char* pchUnit, Int iCheck )
+{
+  static const Char* s_apchCheck[] = { "-", "ok", "MISMATCH" };
+  m_uiNumKernels++;
+  printf( "%-32s %12.1f %14.1f %-6s %s\n", pchName, dNsPerCall, dItemsPerCall * 1e3 / dNsPerCall, pchUnit, s_apchCheck[iCheck] );
+  fflush( stdout );
+}
+
+Int TAppBenchTop::xCheck( Bool bMatch )
+{
+  m_uiNumChecks++;
+  if ( !bMatch )
+  {
+    m_uiNumMismatches++;
+  }
+  return bMatch ? CHECK_OK : CHECK_FAIL;
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+// Kernel groups
+// --------------------------------------------------------------------------------------------------------------------
+
+/** SSE, SAD and Hadamard distortion functions of TComRdCost per block size. The SAD functions are selected as in the
+ *  motion search, so the AMP widths use their dedicated functions.
+ */
+Void TAppBenchTop::xBenchDistortion()
+{
+  static const Int s_aiSize[][2] =
+  {
+    { 4, 4 }, { 8, 8 }, { 16, 16 }, { 32, 32 }, { 64, 64 },
+    { 8, 4 }, { 16, 8 }, { 32, 16 }, { 64, 32 },
+    { 16, 4 }, { 32, 8 }, { 64, 16 },
+    { 12, 16 }, { 24, 32 }, { 48, 64 },
+  };
+  m_cRdCost.init();
+
+  Pel* piOrg = m_piPlaneOrg + BLK_PLANE_MARGIN * BLK_PLANE_SIZE + BLK_PLANE_MARGIN;
+  Pel* piCur = m_piPlaneRef + BLK_PLANE_MARGIN * BLK_PLANE_SIZE + BLK_PLANE_MARGIN;
+  for ( Int iType = 0; iType < 3; iType++ )
+  {
+    for ( Int i = 0; i < Int( sizeof( s_aiSize ) / sizeof( s_aiSize[0] ) ); i++ )
+    {
+      Int iWidth  = s_aiSize[i][0];
+      Int iHeight = s_aiSize[i][1];
+      DistParam cDtParam;
+      UInt      uiRef;
+      const Char* pchType;
+      if ( iType == 1 )
+      {
+        TComPattern cPattern;
+        cPattern.initPattern( piOrg, NULL, NULL, iWidth, iHeight, BLK_PLANE_SIZE, 0, 0, 0, 0 );
+        m_cRdCost.setDistParam( &cPattern, piCur, BLK_PLANE_SIZE, cDtParam );
+        pchType = "SAD";
+        uiRef   = xRefSad( piOrg, piCur, BLK_PLANE_SIZE, iWidth, iHeight, 0 );
+      }
+      else
+      {
+        m_cRdCost.setDistParam( iWidth, iHeight, iType == 0 ? DF_SSE : DF_HADS, cDtParam );
+        cDtParam.pOrg       = piOrg;
+        cDtParam.pCur       = piCur;
+        cDtParam.iStrideOrg = BLK_PLANE_SIZE;
+        cDtParam.iStrideCur = BLK_PLANE_SIZE;
+        pchType = iType == 0 ? "SSE" : "HAD";
+        uiRef   = iType == 0 ? xRefSse( piOrg, piCur, BLK_PLANE_SIZE, iWidth, iHeight )
+                             : m_cRdCost.calcHAD( piOrg, BLK_PLANE_SIZE, piCur, BLK_PLANE_SIZE, iWidth, iHeight );
+      }
+      cDtParam.iStep        = 1;
+      cDtParam.bApplyWeight = false;
+
+      TDistKernel cKernel;
+      cKernel.pcDtParam = &cDtParam;
+      Int iCheck = m_bCheck ? xCheck( cKernel() == uiRef ) : CHECK_NONE;
+
+      Char achName[64];
+      sprintf( achName, "%s %dx%d", pchType, iWidth, iHeight );
+      xReport( achName, xMeasure( cKernel ), iWidth * iHeight, "Mpel/s", iCheck );
+    }
+  }
+}
+
+/** Integer-pel SAD cache of the motion search, cross-checked against the SAD of every partition shape
+ */
+Void TAppBenchTop::xBenchSadCache()
+{
+  static const Int s_aiPart[][4] =
+  {
+    { 0, 0, 64, 64 }, { 0, 0, 64, 32 }, { 0, 32, 64, 32 }, { 32, 0, 32, 64 },
+    { 0, 0, 64, 16 }, { 0, 16, 64, 48 }, { 0, 0, 16, 64 }, { 16, 0, 48, 64 }, { 32, 32, 32, 32 },
+  };
+  const Int iNumMv = 64;
+  Int aiMv[2 * iNumMv];
+  for ( Int i = 0; i < iNumMv; i++ )
+  {
+    aiMv[2 * i]     = ( i % 8 ) * 5 - 20;
+    aiMv[2 * i + 1] = ( i / 8 ) * 5 - 20;
+  }
+
+  Pel* piOrg = m_piPlaneOrg + BLK_PLANE_MARGIN * BLK_PLANE_SIZE + BLK_PLANE_MARGIN;
+  Pel* piRef = m_piPlaneRef + BLK_PLANE_MARGIN * BLK_PLANE_SIZE + BLK_PLANE_MARGIN;
+  m_cSadCache.create();
+  m_cSadCache.initCU( 0, 0, 0, BENCH_CTU_SIZE, piOrg, BLK_PLANE_SIZE );
+  Bool bActive = m_cSadCache.setReference( REF_PIC_LIST_0, 0, piRef, BLK_PLANE_SIZE );
+
+  Bool bMatch = bActive;
+  for ( Int iSubShift = 0; iSubShift < 2 && bActive; iSubShift++ )
+  {
+    for ( Int p = 0; p < Int( sizeof( s_aiPart ) / sizeof( s_aiPart[0] ) ); p++ )
+    {
+      Int iOffset = s_aiPart[p][1] * BLK_PLANE_SIZE + s_aiPart[p][0];
+      m_cSadCache.setPartition( s_aiPart[p][0], s_aiPart[p][1], s_aiPart[p][2], s_aiPart[p][3], iSubShift );
+      for ( Int i = 0; i < iNumMv; i++ )
+      {
+        UInt uiRef = xRefSad( piOrg + iOffset, piRef + iOffset + aiMv[2 * i + 1] * BLK_PLANE_SIZE + aiMv[2 * i], BLK_PLANE_SIZE,
+                              s_aiPart[p][2], s_aiPart[p][3], iSubShift );
+        bMatch = bMatch && m_cSadCache.getSad( aiMv[2 * i], aiMv[2 * i + 1] ) == uiRef;
+      }
+    }
+  }
+  Int iCheck = m_bCheck ? xCheck( bMatch ) : CHECK_NONE;
+
+  TSadCacheKernel cHit;
+  cHit.pcCache = &m_cSadCache;
+  cHit.piMv    = aiMv;
+  cHit.iNumMv  = iNumMv;
+  cHit.iIdx    = 0;
+  m_cSadCache.setPartition( 0, 0, 64, 64, 0 );
+  xReport( "SAD cache 64x64 hit", xMeasure( cHit ), 64 * 64, "Mpel/s", iCheck );
+  m_cSadCache.setPartition( 0, 16, 64, 48, 0 );
+  xReport( "SAD cache 64x48 hit", xMeasure( cHit ), 64 * 48, "Mpel/s", iCheck );
+
+  TSadCacheColdKernel cCold;
+  cCold.pcCache = &m_cSadCache;
+  cCold.piOrg   = piOrg;
+  cCold.piRef   = piRef;
+  cCold.iStride = BLK_PLANE_SIZE;
+  cCold.iSize   = BENCH_CTU_SIZE;
+  cCold.piMv    = aiMv;
+  cCold.iNumMv  = iNumMv;
+  xReport( "SAD cache 64x64 miss", xMeasure( cCold ) / iNumMv, 64 * 64, "Mpel/s", iCheck );
+
+  m_cSadCache.destroy();
+}
+
+/** Luma and chroma interpolation filters, one dimensional and separable
+ */
+Void TAppBenchTop::xBenchInterpolation()
+{
+  static const Int s_aiLumaTaps  [4][NTAPS_LUMA]   =
+  {
+    { 0, 0, 0, 64, 0, 0, 0, 0 }, { -1, 4, -10, 58, 17, -5, 1, 0 }, { -1, 4, -11, 40, 40, -11, 4, -1 }, { 0, 1, -5, 17, 58, -10, 4, -1 }
+  };
+  static const Int s_aiChromaTaps[8][NTAPS_CHROMA] =
+  {
+    { 0, 64, 0, 0 }, { -2, 58, 10, -2 }, { -4, 54, 16, -2 }, { -6, 46, 28, -4 },
+    { -4, 36, 36, -4 }, { -4, 28, 46, -6 }, { -2, 16, 54, -4 }, { -2, 10, 58, -2 }
+  };
+
+  Pel*   piSrc = m_piPlaneRef + BLK_PLANE_MARGIN * BLK_PLANE_SIZE + BLK_PLANE_MARGIN;
+  Short* psTmp = new Short[( BENCH_CTU_SIZE + NTAPS_LUMA ) * BENCH_CTU_SIZE];
+  Short* psDst = new Short[BENCH_CTU_SIZE * BENCH_CTU_SIZE];
+  Short* psRef = new Short[BENCH_CTU_SIZE * BENCH_CTU_SIZE];
+
+  for ( Int iChroma = 0; iChroma < 2; iChroma++ )
+  {
+    for ( Int iDir = 0; iDir < 3; iDir++ )
+    {
+      for ( Int iSize = iChroma ? 4 : 8; iSize <= ( BENCH_CTU_SIZE >> iChroma ); iSize <<= 1 )
+      {
+        TInterpKernel cKernel;
+        cKernel.pcIf    = &m_cIf;
+        cKernel.piSrc   = piSrc;
+        cKernel.iStride = BLK_PLANE_SIZE;
+        cKernel.psTmp   = psTmp;
+        cKernel.psDst   = psDst;
+        cKernel.iSize   = iSize;
+        cKernel.bChroma = iChroma != 0;
+        cKernel.bHor    = iDir != 1;
+        cKernel.bVer    = iDir != 0;
+        cKernel.iFracX  = iChroma ? 3 : 1;
+        cKernel.iFracY  = iChroma ? 4 : 2;
+
+        Int iCheck = CHECK_NONE;
+        if ( m_bCheck )
+        {
+          const Int* piCoeffH = iChroma ? s_aiChromaTaps[cKernel.iFracX] : s_aiLumaTaps[cKernel.iFracX];
+          const Int* piCoeffV = iChroma ? s_aiChromaTaps[cKernel.iFracY] : s_aiLumaTaps[cKernel.iFracY];
+          cKernel();
+          xRefInterpolate( piSrc, BLK_PLANE_SIZE, psRef, iSize, iSize, cKernel.bHor ? piCoeffH : NULL, cKernel.bVer ? piCoeffV : NULL,
+                           iChroma ? NTAPS_CHROMA : NTAPS_LUMA );
+          iCheck = xCheck( memcmp( psDst, psRef, sizeof( Short ) * iSize * iSize ) == 0 );
+        }
+
+        Char achName[64];
+        sprintf( achName, "IF %s %s %dx%d", iChroma ? "chroma" : "luma", iDir == 0 ? "H" : iDir == 1 ? "V" : "HV", iSize, iSize );
+        xReport( achName, xMeasure( cKernel ), iSize * iSize, "Mpel/s", iCheck );
+      }
+    }
+  }
+
+  delete [] psTmp;
+  delete [] psDst;
+  delete [] psRef;
+}
+
+/** Partial butterfly transforms, cross-checked against matrix multiplication. The inverse transform is also measured
+ *  with only the top-left 4x4 coefficients and only the DC coefficient non-zero.
+ */
+Void TAppBenchTop::xBenchTransform()
+{
+  const Int iMaxSize = 32;
+  Short* psResi  = new Short[iMaxSize * iMaxSize];
+  Short* psCoeff = new Short[iMaxSize * iMaxSize];
+  Short* psOut   = new Short[iMaxSize * iMaxSize];
+  Short* psRef   = new Short[iMaxSize * iMaxSize];
+
+  for ( Int iKind = 0; iKind < 4; iKind++ )
+  {
+    for ( Int iSize = 4; iSize <= iMaxSize; iSize <<= 1 )
+    {
+      // 0: forward, 1: inverse of all coefficients, 2: inverse of the top-left 4x4 coefficients, 3: inverse DC only
+      Int iSigSize = iKind < 2 ? iSize : iKind == 2 ? 4 : 1;
+      if ( iKind >= 2 && iSize == 4 )
+      {
+        continue;
+      }
+      for ( Int iDst = 0; iDst < ( iSize == 4 && iKind < 2 ? 2 : 1 ); iDst++ )
+      {
+        UInt uiMode = iDst ? DC_IDX : REG_DCT;
+        for ( Int n = 0; n < iSize * iSize; n++ )
+        {
+          psResi[n] = (Short)( xRandRange( m_uiRandState, 48 ) << g_uiBitIncrement );
+        }
+        xTrMxN( psResi, psCoeff, iSize, iSize, uiMode );
+        for ( Int y = 0; y < iSize; y++ )
+        {
+          for ( Int x = 0; x < iSize; x++ )
+          {
+            if ( x >= iSigSize || y >= iSigSize )
+            {
+              psCoeff[y * iSize + x] = 0;
+            }
+          }
+        }
+
+        TTransformKernel cKernel;
+        cKernel.psSrc    = iKind ? psCoeff : psResi;
+        cKernel.psDst    = psOut;
+        cKernel.iSize    = iSize;
+        cKernel.uiMode   = uiMode;
+        cKernel.bInverse = iKind != 0;
+        cKernel.iSigSize = iSigSize;
+
+        Int iCheck = CHECK_NONE;
+        if ( m_bCheck )
+        {
+          cKernel();
+          if ( iKind )
+          {
+            xRefInvTransform( psCoeff, psRef, iSize, uiMode );
+          }
+          else
+          {
+            xRefTransform( psResi, psRef, iSize, uiMode );
+          }
+          iCheck = xCheck( memcmp( psOut, psRef, sizeof( Short ) * iSize * iSize ) == 0 );
+        }
+
+        static const Char* s_apchKind[] = { "fwd", "inv", "inv sig4x4", "inv DC" };
+        Char achName[64];
+        sprintf( achName, "%s %s %dx%d", iDst ? "DST" : "DCT", s_apchKind[iKind], iSize, iSize );
+        xReport( achName, xMeasure( cKernel ), iSize * iSize, "Mpel/s", iCheck );
+      }
+    }
+  }
+
+  delete [] psResi;
+  delete [] psCoeff;
+  delete [] psOut;
+  delete [] psRef;
+}
+
+/** Forward transform with quantization or RDOQ, and dequantization with inverse transform, on an intra CU
+ */
+Void TAppBenchTop::xBenchQuant()
+{
+  const Int iMaxSize = 32;
+  Pel*    piResi     = new Pel   [iMaxSize * iMaxSize];
+  Pel*    piRecResi  = new Pel   [iMaxSize * iMaxSize];
+  TCoeff* pcCoeff    = new TCoeff[iMaxSize * iMaxSize];
+  Int*    piArlCoeff = new Int   [iMaxSize * iMaxSize];
+  TComDataCU* pcCU   = m_pcPic->getCU( 0 );
+
+  m_cEstBinCABAC.init( &m_cEstBitstream );
+  m_cEstSbac.init( &m_cEstBinCABAC );
+  m_cEstSbac.setSlice( m_pcPic->getSlice( 0 ) );
+  m_cEstSbac.resetEntropy();
+
+  m_cTrQuant.setFlatScalingList();
+  m_cTrQuant.setUseScalingList( false );
+  for ( Int iRdoq = 0; iRdoq < 3; iRdoq++ )
+  {
+    m_cTrQuant.init( BENCH_CTU_SIZE, BENCH_CTU_SIZE, iMaxSize, 0, NULL, NULL, NULL, iRdoq == 1, true, false
+#if ADAPTIVE_QP_SELECTION
+                     , false
+#endif
+                     );
+    m_cTrQuant.setQPforQuant( BENCH_QP, TEXT_LUMA, m_cSPS.getQpBDOffsetY(), 0 );
+#if RDOQ_CHROMA_LAMBDA
+    m_cTrQuant.setLambda( 57.0, 57.0 );
+#else
+    m_cTrQuant.setLambda( 57.0 );
+#endif
+    for ( Int iSize = 4; iSize <= iMaxSize; iSize <<= 1 )
+    {
+      for ( Int n = 0; n < iSize * iSize; n++ )
+      {
+        piResi[n] = (Pel)( xRandRange( m_uiRandState, 24 ) << g_uiBitIncrement );
+      }
+      m_cEstSbac.estBit( m_cTrQuant.m_pcEstBitsSbac, iSize, iSize, TEXT_LUMA );
+
+      TQuantKernel cQuant;
+      cQuant.pcTrQuant  = &m_cTrQuant;
+      cQuant.pcCU       = pcCU;
+      cQuant.piResi     = piResi;
+      cQuant.pcCoeff    = pcCoeff;
+      cQuant.piArlCoeff = piArlCoeff;
+      cQuant.iSize      = iSize;
+
+      Char achName[64];
+      if ( iRdoq < 2 )
+      {
+        sprintf( achName, "TQ %s %dx%d", iRdoq ? "fwd+RDOQ" : "fwd+quant", iSize, iSize );
+        xReport( achName, xMeasure( cQuant ), iSize * iSize, "Mpel/s", CHECK_NONE );
+      }
+      else
+      {
+        cQuant();
+        TDeQuantKernel cDeQuant;
+        cDeQuant.pcTrQuant = &m_cTrQuant;
+        cDeQuant.piResi    = piRecResi;
+        cDeQuant.pcCoeff   = pcCoeff;
+        cDeQuant.iSize     = iSize;
+        sprintf( achName, "TQ dequant+inv %dx%d", iSize, iSize );
+        xReport( achName, xMeasure( cDeQuant ), iSize * iSize, "Mpel/s", CHECK_NONE );
+      }
+    }
+  }
+
+  delete [] piResi;
+  delete [] piRecResi;
+  delete [] pcCoeff;
+  delete [] piArlCoeff;
+}
+
+/** Deblocking of the whole picture. The picture level entry point is measured because the edge filters are inlined
+ *  into it; the time to restore the unfiltered reconstruction before every call is subtracted.
+ */
+Void TAppBenchTop::xBenchDeblocking()
+{
+  m_cLoopFilter.create( BENCH_CTU_DEPTH );
+  m_cLoopFilter.setCfg( false, 0, 0, 0, true );
+
+  TDeblockKernel cKernel;
+  cKernel.pcLoopFilter = &m_cLoopFilter;
+  cKernel.pcPic        = m_pcPic;
+  cKernel.pcBackup     = m_pcPicYuvBackup;
+  cKernel.bFilter      = false;
+  Double dRestore = xMeasure( cKernel );
+  cKernel.bFilter      = true;
+  Double dTotal   = xMeasure( cKernel );
+
+  Char achName[64];
+  sprintf( achName, "Deblock %dx%d", m_iSourceWidth, m_iSourceHeight );
+  xReport( achName, dTotal - dRestore, m_iSourceWidth * m_iSourceHeight, "Mpel/s", CHECK_NONE );
+
+  m_pcPicYuvBackup->copyToPic( m_pcPic->getPicYuvRec() );
+  m_cLoopFilter.destroy();
+}
+
+/** SAO statistics and filter of one luma CTU. The single pass statistics of a CTU inside the picture are
+ *  cross-checked against the per-type block statistics.
+ */
+Void TAppBenchTop::xBenchSao()
+{
+  static const Int s_aiEoOffset[MAX_NUM_SAO_OFFSETS + 1] = { 0, 3, 1, -1, -3 };
+  Int aiBandOffset[SAO_MAX_BO_CLASSES + 1];
+  for ( Int i = 0; i <= SAO_MAX_BO_CLASSES; i++ )
+  {
+    aiBandOffset[i] = ( i % 5 ) - 2;
+  }
+
+  m_cSao.setSaoLcuBasedOptimization( false );
+  m_cSao.create( m_iSourceWidth, m_iSourceHeight, BENCH_CTU_SIZE, BENCH_CTU_SIZE, BENCH_CTU_DEPTH );
+  m_cSao.createEncBuffer();
+  m_cSao.setPic( m_pcPic );
+  m_cSao.setOffsets( s_aiEoOffset, aiBandOffset );
+
+  Int   iWidthInCU = m_pcPic->getFrameWidthInCU();
+  Int   iAddr      = iWidthInCU + 1;
+  Int   iStride    = m_pcPic->getStride();
+  Pel*  piRec      = m_pcPic->getPicYuvRec()->getLumaAddr( iAddr );
+  Pel*  piOrg      = m_pcPic->getPicYuvOrg()->getLumaAddr( iAddr );
+  Pel*  piRest     = m_pcPicYuvSao->getLumaAddr( iAddr );
+  Bool  abBorderAvail[NUM_SGU_BORDER];
+  for ( Int i = 0; i < NUM_SGU_BORDER; i++ )
+  {
+    abBorderAvail[i] = true;
+  }
+
+  Int64  aaiStats[MAX_NUM_SAO_TYPE][MAX_NUM_SAO_CLASS];
+  Int64  aaiCount[MAX_NUM_SAO_TYPE][MAX_NUM_SAO_CLASS];
+  Int64* apiStats[MAX_NUM_SAO_TYPE];
+  Int64* apiCount[MAX_NUM_SAO_TYPE];
+  memset( aaiStats, 0, sizeof( aaiStats ) );
+  memset( aaiCount, 0, sizeof( aaiCount ) );
+  for ( Int i = 0; i < MAX_NUM_SAO_TYPE; i++ )
+  {
+    apiStats[i] = aaiStats[i];
+    apiCount[i] = aaiCount[i];
+  }
+
+  Int iCheck = CHECK_NONE;
+  if ( m_bCheck )
+  {
+    m_cSao.resetStats();
+    m_cSao.calcSaoStatsCuOrg( iAddr, 0, 0 );
+    m_cSao.calcSaoStatsBlock( piRec, piOrg, iStride, apiStats, apiCount, BENCH_CTU_SIZE, BENCH_CTU_SIZE, abBorderAvail );
+    Bool bMatch = true;
+    for ( Int iType = 0; iType < MAX_NUM_SAO_TYPE; iType++ )
+    {
+      for ( Int iClass = 0; iClass < MAX_NUM_SAO_CLASS; iClass++ )
+      {
+        bMatch = bMatch && m_cSao.getStatsOffsetOrg( 0 )[iType][iClass] == aaiStats[iType][iClass]
+                        && m_cSao.getStatsCount    ( 0 )[iType][iClass] == aaiCount[iType][iClass];
+      }
+    }
+    iCheck = xCheck( bMatch );
+  }
+
+  TSaoStatsKernel cStats;
+  cStats.pcSao         = &m_cSao;
+  cStats.iAddr         = iAddr;
+  cStats.piRec         = piRec;
+  cStats.piOrg         = piOrg;
+  cStats.iStride       = iStride;
+  cStats.ppStats       = apiStats;
+  cStats.ppCount       = apiCount;
+  cStats.pbBorderAvail = abBorderAvail;
+  xReport( "SAO stats CTU 64x64", xMeasure( cStats ), BENCH_CTU_SIZE * BENCH_CTU_SIZE, "Mpel/s", iCheck );
+  cStats.iAddr         = -1;
+  xReport( "SAO stats block 64x64 (ref)", xMeasure( cStats ), BENCH_CTU_SIZE * BENCH_CTU_SIZE, "Mpel/s", CHECK_NONE );
+
+  static const Char* s_apchType[] = { "EO_0", "EO_1", "EO_2", "EO_3", "BO" };
+  for ( Int iType = SAO_EO_0; iType <= SAO_BO; iType++ )
+  {
+    TSaoFilterKernel cFilter;
+    cFilter.pcSao         = &m_cSao;
+    cFilter.piDec         = piRec;
+    cFilter.piRest        = piRest;
+    cFilter.iStride       = iStride;
+    cFilter.iSaoType      = iType;
+    cFilter.pbBorderAvail = abBorderAvail;
+    Char achName[64];
+    sprintf( achName, "SAO filter %s 64x64", s_apchType[iType - SAO_EO_0] );
+    xReport( achName, xMeasure( cFilter ), BENCH_CTU_SIZE * BENCH_CTU_SIZE, "Mpel/s", CHECK_NONE );
+  }
+
+  m_cSao.destroyEncBuffer();
+  m_cSao.destroy();
+}
+
+/** CABAC encoding and decoding of a bin stream with skewed context coded bins and bypass bins
+ */
+Void TAppBenchTop::xBenchCabac()
+{
+  static const Int s_aiProbOne[BENCH_NUM_CTX] = { 2, 10, 25, 50, 75, 90, 98, 40 };   ///< percentage of ones per context
+  std::vector<UChar> cCtxIdx( m_iNumBins );
+  std::vector<UChar> cBins  ( m_iNumBins );
+  std::vector<UChar> cDecBins( m_iNumBins );
+  for ( Int i = 0; i < m_iNumBins; i++ )
+  {
+    UInt uiRand = xRand( m_uiRandState );
+    cCtxIdx[i] = ( uiRand & 7 ) < 2 ? BENCH_NUM_CTX : UChar( ( uiRand >> 3 ) % BENCH_NUM_CTX );
+    Int  iProb = cCtxIdx[i] < BENCH_NUM_CTX ? s_aiProbOne[cCtxIdx[i]] : 50;
+    cBins[i]   = ( xRand( m_uiRandState ) % 100 ) < UInt( iProb ) ? 1 : 0;
+  }
+
+  ContextModel        acCtx[BENCH_NUM_CTX];
+  TComOutputBitstream cBitstream;
+  TEncBinCABAC        cBinCABAC;
+
+  TCabacEncKernel cEnc;
+  cEnc.pcBitstream = &cBitstream;
+  cEnc.pcBinCABAC  = &cBinCABAC;
+  cEnc.pcCtx       = acCtx;
+  cEnc.pucCtxIdx   = &cCtxIdx[0];
+  cEnc.pucBin      = &cBins[0];
+  cEnc.iNumBins    = m_iNumBins;
+  cEnc();
+  std::vector<uint8_t> cBytes( cBitstream.getFIFO() );
+
+  TCabacDecKernel cDec;
+  cDec.pcBytes     = &cBytes;
+  cDec.pcCtx       = acCtx;
+  cDec.pucCtxIdx   = &cCtxIdx[0];
+  cDec.pucBin      = &cDecBins[0];
+  cDec.iNumBins    = m_iNumBins;
+  Int iCheck = m_bCheck ? xCheck( cDec() == 1 && cDecBins == cBins ) : CHECK_NONE;
+
+  xReport( "CABAC encode", xMeasure( cEnc ), m_iNumBins, "Mbin/s", iCheck );
+  xReport( "CABAC decode", xMeasure( cDec ), m_iNumBins, "Mbin/s", iCheck );
+}
+
+/** Writing and reading of YUV files, cross-checked by comparing the read picture with the written one
+ */
+Void TAppBenchTop::xBenchVideoIO()
+{
+  TComPicYuv cPicWrite;
+  TComPicYuv cPicRead;
+  cPicWrite.create( m_iSourceWidth, m_iSourceHeight, BENCH_CTU_SIZE, BENCH_CTU_SIZE, BENCH_CTU_DEPTH );
+  cPicRead .create( m_iSourceWidth, m_iSourceHeight, BENCH_CTU_SIZE, BENCH_CTU_SIZE, BENCH_CTU_DEPTH );
+  m_pcPic->getPicYuvOrg()->copyToPic( &cPicWrite );
+
+  TVideoIOKernel cWrite;
+  cWrite.pchFile  = m_pchTempFile;
+  cWrite.pcPicYuv = &cPicWrite;
+  cWrite.bWrite   = true;
+  TVideoIOKernel cRead;
+  cRead.pchFile   = m_pchTempFile;
+  cRead.pcPicYuv  = &cPicRead;
+  cRead.bWrite    = false;
+
+  Int iCheck = CHECK_NONE;
+  if ( m_bCheck )
+  {
+    cWrite();
+    cRead();
+    Bool bMatch = true;
+    for ( Int iComp = 0; iComp < 3; iComp++ )
+    {
+      Int  iStride = iComp ? cPicRead.getCStride() : cPicRead.getStride();
+      Int  iWidth  = m_iSourceWidth  >> ( iComp ? 1 : 0 );
+      Int  iHeight = m_iSourceHeight >> ( iComp ? 1 : 0 );
+      Pel* piSrc   = iComp == 0 ? cPicWrite.getLumaAddr() : iComp == 1 ? cPicWrite.getCbAddr() : cPicWrite.getCrAddr();
+      Pel* piDst   = iComp == 0 ? cPicRead .getLumaAddr() : iComp == 1 ? cPicRead .getCbAddr() : cPicRead .getCrAddr();
+      for ( Int y = 0; y < iHeight; y++ )
+      {
+        bMatch = bMatch && memcmp( piSrc + y * iStride, piDst + y * iStride, sizeof( Pel ) * iWidth ) == 0;
+      }
+    }
+    iCheck = xCheck( bMatch );
+  }
+
+  Double dBytes = BENCH_YUV_FRAMES * m_iSourceWidth * m_iSourceHeight * 3 / 2 * ( g_uiBitDepth + g_uiBitIncrement > 8 ? 2 : 1 );
+  Char achName[64];
+  sprintf( achName, "YUV write %dx%d", m_iSourceWidth, m_iSourceHeight );
+  xReport( achName, xMeasure( cWrite ), dBytes, "MB/s", iCheck );
+  sprintf( achName, "YUV read %dx%d", m_iSourceWidth, m_iSourceHeight );
+  xReport( achName, xMeasure( cRead ), dBytes, "MB/s", iCheck );
+
+  remove( m_pchTempFile );
+  cPicWrite.destroy();
+  cPicRead.destroy();
+}
+
+//! \}
+
@@ -0,0 +1,136 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.  
+ *
+ * Copyright (c) 2010-2012, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** \file     TAppBenchTop.h
+    \brief    Kernel benchmark application class (header)
+*/
+
+#ifndef __TAPPBENCHTOP__
+#define __TAPPBENCHTOP__
+
+#if _MSC_VER > 1000
+#pragma once
+#endif // _MSC_VER > 1000
+
+#include "TLibCommon/TComRdCost.h"
+#include "TLibCommon/TComInterpolationFilter.h"
+#include "TLibCommon/TComTrQuant.h"
+#include "TLibCommon/TComLoopFilter.h"
+#include "TLibCommon/TComPic.h"
+#include "TLibCommon/TComBitStream.h"
+#include "TLibEncoder/TEncSampleAdaptiveOffset.h"
+#include "TLibEncoder/TEncSadCache.h"
+#include "TLibEncoder/TEncBinCoderCABAC.h"
+#include "TLibEncoder/TEncSbac.h"
+#include "TAppBenchCfg.h"
+
+//! \ingroup TAppBench
+//! \{
+
+// ====================================================================================================================
+// Class definition
+// ====================================================================================================================
+
+/// SAO encoder whose picture and offsets are set directly by the benchmark
+class TAppBenchSao : public TEncSampleAdaptiveOffset
+{
+public:
+  Void  setPic      ( TComPic* pcPic ) { m_pcPic = pcPic; }
+  Void  setOffsets  ( const Int* piEoOffset, const Int* piBandOffset );
+};
+
+/// kernel benchmark application class
+class TAppBenchTop : public TAppBenchCfg
+{
+private:
+  // kernels under test
+  TComRdCost                      m_cRdCost;                      ///< distortion functions
+  TComInterpolationFilter         m_cIf;                          ///< motion compensation filters
+  TComTrQuant                     m_cTrQuant;                     ///< quantization and RDOQ
+  TComLoopFilter                  m_cLoopFilter;                  ///< deblocking filter
+  TAppBenchSao                    m_cSao;                         ///< SAO statistics and filter
+  TEncSadCache                    m_cSadCache;                    ///< integer-pel SAD cache of the motion search
+  TComOutputBitstream             m_cEstBitstream;                ///< sink of the bit estimation coder
+  TEncBinCABAC                    m_cEstBinCABAC;                 ///< bin coder of the bit estimation coder
+  TEncSbac                        m_cEstSbac;                     ///< bit estimates used by RDOQ
+
+  // synthetic content
+  TComSPS                         m_cSPS;
+  TComPPS                         m_cPPS;
+  TComPic*                        m_pcPic;                        ///< intra picture of 8x8 CUs, original and reconstruction
+  TComPicYuv*                     m_pcPicYuvBackup;               ///< reconstruction of m_pcPic before deblocking
+  TComPicYuv*                     m_pcPicYuvSao;                  ///< destination of the SAO filter
+  Pel*                            m_piPlaneOrg;                   ///< block plane holding the original samples
+  Pel*                            m_piPlaneRef;                   ///< block plane holding the reference samples
+  UInt                            m_uiRandState;                  ///< state of the content generator
+
+  // results
+  UInt                            m_uiNumKernels;                 ///< number of measured kernels
+  UInt                            m_uiNumChecks;                  ///< number of cross-checks
+  UInt                            m_uiNumMismatches;              ///< number of failed cross-checks
+  UInt                            m_uiSink;                       ///< keeps the kernel results alive
+
+public:
+  TAppBenchTop();
+  virtual ~TAppBenchTop() {}
+
+  Void  create            (); ///< create internal members
+  Void  destroy           (); ///< destroy internal members
+  UInt  bench             (); ///< run the selected kernels, returns the number of failed cross-checks
+
+protected:
+  Void  xInitROM          (); ///< set up the global tables for the synthetic CTU size and bit depth
+  Void  xCreatePicture    (); ///< create the synthetic picture and its CUs
+  Void  xDestroyPicture   ();
+  Bool  xIsSelected       ( const Char* pchGroup );
+
+  template <class T>
+  Double xMeasure         ( T& rcKernel );                        ///< nanoseconds per call of a kernel functor
+  Void  xReport           ( const Char* pchName, Double dNsPerCall, Double dItemsPerCall, const Char* pchUnit, Int iCheck );
+  Int   xCheck            ( Bool bMatch );                        ///< count a cross-check, returns the status passed to xReport
+
+  Void  xBenchDistortion  ();
+  Void  xBenchSadCache    ();
+  Void  xBenchInterpolation();
+  Void  xBenchTransform   ();
+  Void  xBenchQuant       ();
+  Void  xBenchDeblocking  ();
+  Void  xBenchSao         ();
+  Void  xBenchCabac       ();
+  Void  xBenchVideoIO     ();
+};
+
+//! \}
+
+#endif
+
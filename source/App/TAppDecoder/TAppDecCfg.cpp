@@ -63,6 +63,7 @@ Bool TAppDecCfg::parseCfg( Int argc, Char* argv[] )
   bool do_help = false;
   string cfg_BitstreamFile;
   string cfg_ReconFile;
+  string cfg_IndexFile;
 
   po::Options opts;
   opts.addOptions()
@@ -71,13 +72,29 @@ Bool TAppDecCfg::parseCfg( Int argc, Char* argv[] )
   ("ReconFile,o",     cfg_ReconFile,     string(""), "reconstructed YUV output file name\n"
                                                      "YUV writing is skipped if omitted")
   ("SkipFrames,s", m_iSkipFrame, 0, "number of frames to skip before random access")
+  ("IndexFile,x",  cfg_IndexFile,   string(""), "random access index file of the bitstream")
+  ("BuildIndex",   m_bBuildIndex,   false, "scan the bitstream once and write its random access index to IndexFile, without decoding")
+  ("SeekPOC,p",    m_iSeekPOC,      -1, "start decoding at the IRAP access unit before this POC, found in IndexFile, and output from this POC on\n"
+                                        "-1 decodes from the start")
   ("OutputBitDepth,d", m_outputBitDepth, 0u, "bit depth of YUV output file (use 0 for native depth)")
   ("MaxTemporalLayer,t", m_iMaxTemporalLayer, -1, "Maximum Temporal Layer to be decoded. -1 to decode all layers")
+  ("IrapOnly", m_bIrapOnly, false, "decode and output IDR, CRA and BLA pictures only, e.g. for previews\n"
+                                   "other slices are dropped after reading their NAL unit header")
+  ("SkipLoopFilters", m_iSkipLoopFilters, 0, "skip deblocking and SAO on some pictures, the output is not conforming\n"
+                                             "\t0: filter all pictures\n"
+                                             "\t1: non-reference pictures, no drift\n"
+                                             "\t2: also pictures of the highest temporal layer, may drift")
   ("SEIpictureDigest", m_pictureDigestEnabled, 1, "Control handling of picture_digest SEI messages\n"
                                               "\t3: checksum\n"
                                               "\t2: CRC\n"
                                               "\t1: MD5\n"
                                               "\t0: ignore")
+  ("AsyncHash", m_bUseAsyncHash, true, "Compute picture hashes on a background thread")
+  ("HugePages", m_iHugePages, 1, "huge pages for picture planes of 2 MB and more\n"
+                                 "\t0: off\n"
+                                 "\t1: transparent huge pages\n"
+                                 "\t2: explicit huge pages, transparent ones if the pool is empty")
+  ("NumaNode", m_iNumaNode, -1, "preferred NUMA node of the picture planes, -1: node of the thread that fills them")
   ;
   po::setDefaults(opts);
   const list<const char*>& argv_unhandled = po::scanArgv(opts, argc, (const char**) argv);
@@ -96,12 +113,18 @@ Bool TAppDecCfg::parseCfg( Int argc, Char* argv[] )
   /* convert std::string to c string for compatability */
   m_pchBitstreamFile = cfg_BitstreamFile.empty() ? NULL : strdup(cfg_BitstreamFile.c_str());
   m_pchReconFile = cfg_ReconFile.empty() ? NULL : strdup(cfg_ReconFile.c_str());
+  m_pchIndexFile = cfg_IndexFile.empty() ? NULL : strdup(cfg_IndexFile.c_str());
 
   if (!m_pchBitstreamFile)
   {
     fprintf(stderr, "No input file specifed, aborting\n");
     return false;
   }
+  if ((m_bBuildIndex || m_iSeekPOC >= 0) && !m_pchIndexFile)
+  {
+    fprintf(stderr, "BuildIndex and SeekPOC need an IndexFile, aborting\n");
+    return false;
+  }
 
   return true;
 }
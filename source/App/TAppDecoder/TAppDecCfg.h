@@ -57,11 +57,19 @@ class TAppDecCfg
 protected:
   char*         m_pchBitstreamFile;                   ///< input bitstream file name
   char*         m_pchReconFile;                       ///< output reconstruction file name
+  char*         m_pchIndexFile;                       ///< random access index file name
+  Bool          m_bBuildIndex;                        ///< write the random access index of the bitstream instead of decoding
+  Int           m_iSeekPOC;                           ///< POC to start the output at, using the random access index (-1: from the start)
   Int           m_iSkipFrame;                         ///< counter for frames prior to the random access point to skip
   UInt          m_outputBitDepth;                     ///< bit depth used for writing output
 
   Int           m_iMaxTemporalLayer;                  ///< maximum temporal layer to be decoded
+  Bool          m_bIrapOnly;                          ///< decode and output IRAP pictures only
+  Int           m_iSkipLoopFilters;                   ///< pictures decoded without deblocking and SAO (0: none, 1: non-reference, 2: also highest temporal layer)
   Int m_pictureDigestEnabled;                         ///< Checksum(3)/CRC(2)/MD5(1)/disable(0) acting on SEI picture_digest message
+  Bool m_bUseAsyncHash;                               ///< compute picture hashes on a background thread
+  Int           m_iHugePages;                         ///< huge page mode of the picture planes (0: off, 1: transparent, 2: explicit)
+  Int           m_iNumaNode;                          ///< preferred NUMA node of the picture planes (-1: first touch)
   
 public:
   TAppDecCfg()          {}
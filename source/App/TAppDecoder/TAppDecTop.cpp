@@ -44,6 +44,8 @@
 #include "TAppDecTop.h"
 #include "TLibDecoder/AnnexBread.h"
 #include "TLibDecoder/NALread.h"
+#include "TLibDecoder/TDecSeekIndex.h"
+#include "TLibCommon/TComPicAlloc.h"
 
 //! \ingroup TAppDecoder
 //! \{
@@ -55,7 +57,10 @@
 TAppDecTop::TAppDecTop()
 {
   ::memset (m_abDecFlag, 0, sizeof (m_abDecFlag));
-  m_iPOCLastDisplay  = -MAX_INT;
+  m_bReconOpened = false;
+  m_iSeekPOCDelta = 0;
+  m_iFirstOutputPOC = MAX_INT;
+  m_bSeekReached = true;
 }
 
 Void TAppDecTop::create()
@@ -74,6 +79,11 @@ Void TAppDecTop::destroy()
     free (m_pchReconFile);
     m_pchReconFile = NULL;
   }
+  if (m_pchIndexFile)
+  {
+    free (m_pchIndexFile);
+    m_pchIndexFile = NULL;
+  }
 }
 
 // ====================================================================================================================
@@ -83,16 +93,13 @@ Void TAppDecTop::destroy()
 /**
  - create internal class
  - initialize internal class
- - until the end of the bitstream, call decoding function in TDecTop class
+ - until the end of the bitstream, call decoding function in TDecStream class
  - delete allocated buffers
  - destroy internal class
  .
  */
 Void TAppDecTop::decode()
 {
-  UInt                uiPOC;
-  TComList<TComPic*>* pcListPic = NULL;
-
   ifstream bitstreamFile(m_pchBitstreamFile, ifstream::in | ifstream::binary);
   if (!bitstreamFile)
   {
@@ -100,111 +107,34 @@ Void TAppDecTop::decode()
     exit(EXIT_FAILURE);
   }
 
-  InputByteStream bytestream(bitstreamFile);
+  if (m_bBuildIndex)
+  {
+    xBuildIndex(bitstreamFile);
+    return;
+  }
 
   // create & initialize internal classes
   xCreateDecLib();
   xInitDecLib  ();
-  m_iPOCLastDisplay += m_iSkipFrame;      // set the last displayed POC correctly for skip forward.
 
-  // main decoder loop
-  bool recon_opened = false; // reconstruction file not yet opened. (must be performed after SPS is seen)
+  if (m_iSeekPOC >= 0)
+  {
+    xSeek(bitstreamFile);
+  }
+  InputByteStream bytestream(bitstreamFile);
 
+  // main decoder loop
   while (!!bitstreamFile)
   {
-    /* location serves to work around a design fault in the decoder, whereby
-     * the process of reading a new slice that is the first slice of a new frame
-     * requires the TDecTop::decode() method to be called again with the same
-     * nal unit. */
-    streampos location = bitstreamFile.tellg();
     AnnexBStats stats = AnnexBStats();
-    bool bPreviousPictureDecoded = false;
-
     vector<uint8_t> nalUnit;
-    InputNALUnit nalu;
     byteStreamNALUnit(bytestream, nalUnit, stats);
 
-    // call actual decoding function
-    bool bNewPicture = false;
-    if (nalUnit.empty())
-    {
-      /* this can happen if the following occur:
-       *  - empty input file
-       *  - two back-to-back start_code_prefixes
-       *  - start_code_prefix immediately followed by EOF
-       */
-      fprintf(stderr, "Warning: Attempt to decode an empty NAL unit\n");
-    }
-    else
-    {
-      read(nalu, nalUnit);
-      if(nalu.m_nalUnitType == NAL_UNIT_SPS)
-      {
-        assert(nalu.m_temporalId == 0);
-      }
-      if(m_iMaxTemporalLayer >= 0 && nalu.m_temporalId > m_iMaxTemporalLayer)
-      {
-        if(bPreviousPictureDecoded)
-        {
-          bNewPicture = true;
-          bPreviousPictureDecoded = false;
-        }
-        else
-        {
-          bNewPicture = false;
-        }
-      }
-      else
-      {
-        bNewPicture = m_cTDecTop.decode(nalu, m_iSkipFrame, m_iPOCLastDisplay);
-        if (bNewPicture)
-        {
-          bitstreamFile.clear();
-          /* location points to the current nalunit payload[1] due to the
-           * need for the annexB parser to read three extra bytes.
-           * [1] except for the first NAL unit in the file
-           *     (but bNewPicture doesn't happen then) */
-          bitstreamFile.seekg(location-streamoff(3));
-          bytestream.reset();
-        }
-        bPreviousPictureDecoded = true; 
-      }
-    }
-    if (bNewPicture || !bitstreamFile)
-    {
-      m_cTDecTop.executeDeblockAndAlf(uiPOC, pcListPic, m_iSkipFrame, m_iPOCLastDisplay);
-    }
-
-    if( pcListPic )
-    {
-      if ( m_pchReconFile && !recon_opened )
-      {
-        if ( m_outputBitDepth == 0 )
-        {
-          m_outputBitDepth = g_uiBitDepth + g_uiBitIncrement;
-        }
-
-        m_cTVideoIOYuvReconFile.open( m_pchReconFile, true, m_outputBitDepth, g_uiBitDepth + g_uiBitIncrement ); // write mode
-        recon_opened = true;
-      }
-      if ( bNewPicture && 
-           (   nalu.m_nalUnitType == NAL_UNIT_CODED_SLICE_IDR
-            || nalu.m_nalUnitType == NAL_UNIT_CODED_SLICE_BLANT
-            || nalu.m_nalUnitType == NAL_UNIT_CODED_SLICE_BLA ) )
-      {
-        xFlushOutput( pcListPic );
-      }
-      // write reconstruction to file
-      if(bNewPicture)
-      {
-        xWriteOutput( pcListPic, nalu.m_temporalId );
-      }
-    }
+    // call actual decoding function, the pictures are written by pictureOutput() in bumping order
+    m_cTDecStream.decodeNalUnit( nalUnit.empty() ? NULL : &nalUnit[0], UInt(nalUnit.size()) );
   }
   
-  xFlushOutput( pcListPic );
-  // delete buffers
-  m_cTDecTop.deletePicBuffer();
+  m_cTDecStream.flush();
   
   // destroy internal classes
   xDestroyDecLib();
@@ -217,145 +147,132 @@ Void TAppDecTop::decode()
 Void TAppDecTop::xCreateDecLib()
 {
   // create decoder class
-  m_cTDecTop.create();
+  m_cTDecStream.create();
 }
 
 Void TAppDecTop::xDestroyDecLib()
 {
-  if ( m_pchReconFile )
+  if ( m_bReconOpened )
   {
     m_cTVideoIOYuvReconFile. close();
   }
   
   // destroy decoder class
-  m_cTDecTop.destroy();
+  m_cTDecStream.destroy();
 }
 
 Void TAppDecTop::xInitDecLib()
 {
+  TComPicAlloc::setHugePages(m_iHugePages);
+  TComPicAlloc::setNumaNode(m_iNumaNode);
+  
   // initialize decoder class
-  m_cTDecTop.init();
-  m_cTDecTop.setPictureDigestEnabled(m_pictureDigestEnabled);
+  m_cTDecStream.init();
+  m_cTDecStream.setPictureDigestEnabled(m_pictureDigestEnabled);
+  m_cTDecStream.setUseAsyncHash(m_bUseAsyncHash);
+  m_cTDecStream.setSkipFrame(m_iSkipFrame);
+  m_cTDecStream.setMaxTemporalLayer(m_iMaxTemporalLayer);
+  m_cTDecStream.setIrapOnly(m_bIrapOnly);
+  m_cTDecStream.setSkipLoopFilters(m_iSkipLoopFilters);
+  m_cTDecStream.setOutputIf(this);
 }
 
-/** \param pcListPic list of pictures to be written to file
-    \todo            DYN_REF_FREE should be revised
+/** Scan the bitstream once and write its random access index to IndexFile
+ * \param rcBitstream bitstream file
  */
-Void TAppDecTop::xWriteOutput( TComList<TComPic*>* pcListPic, UInt tId )
+Void TAppDecTop::xBuildIndex( istream& rcBitstream )
 {
-  TComList<TComPic*>::iterator iterPic   = pcListPic->begin();
-  Int not_displayed = 0;
+  TDecSeekIndex cIndex;
+  cIndex.build( rcBitstream );
+  if ( !cIndex.write( m_pchIndexFile ) )
+  {
+    fprintf(stderr, "\nfailed to write index file `%s'\n", m_pchIndexFile);
+    exit(EXIT_FAILURE);
+  }
+  printf("Indexed %d IRAP access units\n", cIndex.getNumEntries());
+  for ( UInt ui = 0; ui < cIndex.getNumEntries(); ui++ )
+  {
+    const TDecSeekIndex::Entry& rcEntry = cIndex.getEntry( ui );
+    printf("  POC %4d..%-4d NAL type %2d at byte %llu\n", rcEntry.m_iPOC, rcEntry.m_iLastPOC, rcEntry.m_eNalUnitType, (unsigned long long) rcEntry.m_uiOffset);
+  }
+}
 
-  while (iterPic != pcListPic->end())
+/** Look up SeekPOC in IndexFile, decode the parameter sets active there and move the bitstream to its IRAP access unit
+ * \param rcBitstream bitstream file
+ *
+ * Pictures before SeekPOC are decoded as references but not output. POCs are compared relative to the IRAP picture,
+ * since its POC MSBs are not known to a decoder starting at it.
+ */
+Void TAppDecTop::xSeek( istream& rcBitstream )
+{
+  TDecSeekIndex cIndex;
+  if ( !cIndex.read( m_pchIndexFile ) )
   {
-    TComPic* pcPic = *(iterPic);
-    if(pcPic->getOutputMark() && pcPic->getPOC() > m_iPOCLastDisplay)
-    {
-       not_displayed++;
-    }
-    iterPic++;
+    fprintf(stderr, "\nfailed to read index file `%s'\n", m_pchIndexFile);
+    exit(EXIT_FAILURE);
+  }
+  // POCs between the index entries, as leading pictures of a CRA, are reached from the preceding entry
+  Int iLastPOC = -MAX_INT;
+  for ( UInt ui = 0; ui < cIndex.getNumEntries(); ui++ )
+  {
+    iLastPOC = max( iLastPOC, cIndex.getEntry( ui ).m_iLastPOC );
+  }
+  const TDecSeekIndex::Entry* pcEntry = cIndex.findEntry( m_iSeekPOC );
+  if ( !pcEntry || m_iSeekPOC < pcEntry->m_iPOC || m_iSeekPOC > iLastPOC )
+  {
+    fprintf(stderr, "\nPOC %d is not in index file `%s'\n", m_iSeekPOC, m_pchIndexFile);
+    exit(EXIT_FAILURE);
   }
-  iterPic   = pcListPic->begin();
   
-  while (iterPic != pcListPic->end())
+  for ( UInt ui = 0; ui < pcEntry->m_cParamSets.size(); ui++ )
   {
-    TComPic* pcPic = *(iterPic);
-    TComSPS *sps = pcPic->getSlice(0)->getSPS();
-    
-    if ( pcPic->getOutputMark() && (not_displayed >  pcPic->getSlice(0)->getSPS()->getNumReorderPics(tId) && pcPic->getPOC() > m_iPOCLastDisplay))
-    {
-      // write to file
-       not_displayed--;
-      if ( m_pchReconFile )
-      {
-        m_cTVideoIOYuvReconFile.write( pcPic->getPicYuvRec(), sps->getPicCropLeftOffset(), sps->getPicCropRightOffset(), sps->getPicCropTopOffset(), sps->getPicCropBottomOffset() );
-      }
-      
-      // update POC of display order
-      m_iPOCLastDisplay = pcPic->getPOC();
-      
-      // erase non-referenced picture in the reference picture list after display
-      if ( !pcPic->getSlice(0)->isReferenced() && pcPic->getReconMark() == true )
-      {
-#if !DYN_REF_FREE
-        pcPic->setReconMark(false);
-        
-        // mark it should be extended later
-        pcPic->getPicYuvRec()->setBorderExtension( false );
-        
-#else
-        pcPic->destroy();
-        pcListPic->erase( iterPic );
-        iterPic = pcListPic->begin(); // to the beginning, non-efficient way, have to be revised!
-        continue;
-#endif
-      }
-      pcPic->setOutputMark(false);
-    }
-    
-    iterPic++;
+    const vector<UChar>& rcParamSet = cIndex.getParamSet( pcEntry->m_cParamSets[ ui ] );
+    m_cTDecStream.decodeNalUnit( &rcParamSet[0], UInt(rcParamSet.size()) );
   }
+  rcBitstream.seekg( streamoff( pcEntry->m_uiOffset ) );
+  
+  m_iSeekPOCDelta = m_iSeekPOC - pcEntry->m_iPOC;
+  m_bSeekReached  = m_iSeekPOCDelta <= 0;
+  printf("Seeking to POC %d at byte %llu for POC %d\n", pcEntry->m_iPOC, (unsigned long long) pcEntry->m_uiOffset, m_iSeekPOC);
 }
 
-/** \param pcListPic list of pictures to be written to file
-    \todo            DYN_REF_FREE should be revised
+/** Write an output picture to the reconstruction file and release it
+ * \param rcPic output picture of the decoder
  */
-Void TAppDecTop::xFlushOutput( TComList<TComPic*>* pcListPic )
+Void TAppDecTop::pictureOutput( const TDecOutputPic& rcPic )
 {
-  if(!pcListPic)
+  if ( m_iFirstOutputPOC == MAX_INT )
   {
-    return;
-  } 
-  TComList<TComPic*>::iterator iterPic   = pcListPic->begin();
-
-  iterPic   = pcListPic->begin();
+    m_iFirstOutputPOC = rcPic.m_iPOC;
+  }
+  if ( !m_bSeekReached )
+  {
+    if ( rcPic.m_iPOC - m_iFirstOutputPOC < m_iSeekPOCDelta )
+    {
+      m_cTDecStream.releasePicture( rcPic.m_pcHandle );
+      return;
+    }
+    m_bSeekReached = true;
+  }
   
-  while (iterPic != pcListPic->end())
+  if ( m_pchReconFile )
   {
-    TComPic* pcPic = *(iterPic);
-    TComSPS *sps = pcPic->getSlice(0)->getSPS();
-
-    if ( pcPic->getOutputMark() )
+    if ( !m_bReconOpened )
     {
-      // write to file
-      if ( m_pchReconFile )
+      if ( m_outputBitDepth == 0 )
       {
-        m_cTVideoIOYuvReconFile.write( pcPic->getPicYuvRec(), sps->getPicCropLeftOffset(), sps->getPicCropRightOffset(), sps->getPicCropTopOffset(), sps->getPicCropBottomOffset() );
+        m_outputBitDepth = rcPic.m_uiBitDepth;
       }
       
-      // update POC of display order
-      m_iPOCLastDisplay = pcPic->getPOC();
-      
-      // erase non-referenced picture in the reference picture list after display
-      if ( !pcPic->getSlice(0)->isReferenced() && pcPic->getReconMark() == true )
-      {
-#if !DYN_REF_FREE
-        pcPic->setReconMark(false);
-        
-        // mark it should be extended later
-        pcPic->getPicYuvRec()->setBorderExtension( false );
-        
-#else
-        pcPic->destroy();
-        pcListPic->erase( iterPic );
-        iterPic = pcListPic->begin(); // to the beginning, non-efficient way, have to be revised!
-        continue;
-#endif
-      }
-      pcPic->setOutputMark(false);
-    }
-#if !DYN_REF_FREE
-    if(pcPic)
-    {
-      pcPic->destroy();
-      delete pcPic;
-      pcPic = NULL;
+      m_cTVideoIOYuvReconFile.open( m_pchReconFile, true, m_outputBitDepth, rcPic.m_uiBitDepth ); // write mode
+      m_bReconOpened = true;
     }
-#endif    
-    iterPic++;
+    
+    TComSPS* sps = rcPic.m_pcHandle->getSlice(0)->getSPS();
+    m_cTVideoIOYuvReconFile.write( rcPic.m_pcPicYuv, sps->getPicCropLeftOffset(), sps->getPicCropRightOffset(), sps->getPicCropTopOffset(), sps->getPicCropBottomOffset() );
   }
-  pcListPic->clear();
-  m_iPOCLastDisplay = -MAX_INT;
+  
+  m_cTDecStream.releasePicture( rcPic.m_pcHandle );
 }
 
 //! \}
@@ -45,7 +45,7 @@
 #include "TLibVideoIO/TVideoIOYuv.h"
 #include "TLibCommon/TComList.h"
 #include "TLibCommon/TComPicYuv.h"
-#include "TLibDecoder/TDecTop.h"
+#include "TLibDecoder/TDecStream.h"
 #include "TAppDecCfg.h"
 
 //! \ingroup TAppDecoder
@@ -56,16 +56,19 @@
 // ====================================================================================================================
 
 /// decoder application class
-class TAppDecTop : public TAppDecCfg
+class TAppDecTop : public TAppDecCfg, public TDecOutputIf
 {
 private:
   // class interface
-  TDecTop                         m_cTDecTop;                     ///< decoder class
+  TDecStream                      m_cTDecStream;                  ///< decoder class
   TVideoIOYuv                     m_cTVideoIOYuvReconFile;        ///< reconstruction YUV class
+  Bool                            m_bReconOpened;                 ///< reconstruction file opened (after the first SPS)
   
   // for output control
   Bool                            m_abDecFlag[ MAX_GOP ];         ///< decoded flag in one GOP
-  Int                             m_iPOCLastDisplay;              ///< last POC in display order
+  Int                             m_iSeekPOCDelta;                ///< POCs between the IRAP picture decoding starts at and SeekPOC
+  Int                             m_iFirstOutputPOC;              ///< POC of the first output picture, MAX_INT before
+  Bool                            m_bSeekReached;                 ///< a picture at or after SeekPOC has been output
   
 public:
   TAppDecTop();
@@ -79,9 +82,10 @@ protected:
   Void  xCreateDecLib     (); ///< create internal classes
   Void  xDestroyDecLib    (); ///< destroy internal classes
   Void  xInitDecLib       (); ///< initialize decoder class
+  Void  xBuildIndex       ( std::istream& rcBitstream ); ///< write the random access index of the bitstream
+  Void  xSeek             ( std::istream& rcBitstream ); ///< start decoding at the IRAP access unit before SeekPOC
   
-  Void  xWriteOutput      ( TComList<TComPic*>* pcListPic , UInt tId); ///< write YUV to file
-  Void  xFlushOutput      ( TComList<TComPic*>* pcListPic ); ///< flush all remaining decoded pictures to file
+  Void  pictureOutput     ( const TDecOutputPic& rcPic ); ///< write YUV to file
 };
 
 //! \}
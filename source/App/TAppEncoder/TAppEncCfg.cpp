@@ -39,6 +39,7 @@
 #include <cassert>
 #include <cstring>
 #include <string>
+#include <algorithm>
 #include "TLibCommon/TComRom.h"
 #include "TAppEncCfg.h"
 #include "TAppCommon/program_options_lite.h"
@@ -61,6 +62,7 @@ TAppEncCfg::TAppEncCfg()
 : m_pchInputFile()
 , m_pchBitstreamFile()
 , m_pchReconFile()
+, m_pchStatsFile()
 , m_pchdQPFile()
 , m_pchColumnWidth()
 , m_pchRowHeight()
@@ -78,6 +80,7 @@ TAppEncCfg::~TAppEncCfg()
   free(m_pchInputFile);
   free(m_pchBitstreamFile);
   free(m_pchReconFile);
+  free(m_pchStatsFile);
   free(m_pchdQPFile);
   free(m_pchColumnWidth);
   free(m_pchRowHeight);
@@ -92,6 +95,23 @@ Void TAppEncCfg::destroy()
 {
 }
 
+/** Read a list of integers separated by spaces or commas
+ * \param cList list as given in the configuration
+ * \param raiValues receives the values
+ * \returns false if the list holds something else than integers
+ */
+static Bool readIntList( string cList, vector<Int>& raiValues )
+{
+  replace( cList.begin(), cList.end(), ',', ' ' );
+  istringstream cStream( cList );
+  Int iValue;
+  while ( cStream >> iValue )
+  {
+    raiValues.push_back( iValue );
+  }
+  return cStream.eof();
+}
+
 std::istringstream &operator>>(std::istringstream &in, GOPEntry &entry)     //input
 {
   in>>entry.m_sliceType;
@@ -158,11 +178,14 @@ Bool TAppEncCfg::parseCfg( Int argc, Char* argv[] )
   
   string cfg_InputFile;
   string cfg_BitstreamFile;
+  string cfg_StatsFile;
   string cfg_ReconFile;
   string cfg_dQPFile;
   string cfg_ColumnWidth;
   string cfg_RowHeight;
   string cfg_ScalingListFile;
+  string cfg_RenditionQPs;
+  string cfg_RenditionBitrates;
   po::Options opts;
   opts.addOptions()
   ("help", do_help, false, "this help text")
@@ -172,6 +195,12 @@ Bool TAppEncCfg::parseCfg( Int argc, Char* argv[] )
   ("InputFile,i",           cfg_InputFile,     string(""), "Original YUV input file name")
   ("BitstreamFile,b",       cfg_BitstreamFile, string(""), "Bitstream output file name")
   ("ReconFile,o",           cfg_ReconFile,     string(""), "Reconstructed YUV output file name")
+  ("StatsFile",             cfg_StatsFile,     string(""), "Per-picture and per-temporal-layer rate/lambda statistics output file name")
+  ("LowLatencyOutput",      m_bLowLatencyOutput,   false, "Code the pictures of a GOP as they arrive and write each access unit as soon as it is coded")
+  ("RenditionQPs",          cfg_RenditionQPs,      string(""), "QPs of further renditions coded in parallel from the same source and analysis, each into BitstreamFile with the suffix _r<n>")
+  ("RenditionBitrates",     cfg_RenditionBitrates, string(""), "Target bitrates of further renditions with RateCtrl, each coded into BitstreamFile with the suffix _r<n>")
+  ("RenditionThreads",      m_iRenditionThreads,   -1, "Threads coding the further renditions next to the first one, -1: one per rendition, 0: one after another")
+  ("RenditionMotionSeeds",  m_bUseRenditionMotionSeeds, true, "Add the motion estimated once on the source as start point of the fast motion search of the further renditions; the first one stays as coded on its own")
   ("SourceWidth,-wdt",      m_iSourceWidth,        0, "Source picture width")
   ("SourceHeight,-hgt",     m_iSourceHeight,       0, "Source picture height")
   ("InputBitDepth",         m_uiInputBitDepth,    8u, "Bit-depth of input file")
@@ -269,6 +298,7 @@ Bool TAppEncCfg::parseCfg( Int argc, Char* argv[] )
   ("SAO",                     m_bUseSAO,                 true, "Enable Sample Adaptive Offset")
   ("MaxNumOffsetsPerPic",     m_maxNumOffsetsPerPic,     2048, "Max number of SAO offset per picture (Default: 2048)")   
   ("SAOLcuBasedOptimization", m_saoLcuBasedOptimization, true, "0: SAO picture-based optimization, 1: SAO LCU-based optimization ")
+  ("SAOStatsThreads",         m_saoStatsThreads,         0, "Number of threads gathering SAO statistics per CTU row before the LCU-based SAO decisions (0: gather during the decisions)")
 #if !REMOVE_ALF
   ("ALFLowLatencyEncode", m_alfLowLatencyEncoding, false, "Low-latency ALF encoding, 0: picture latency (trained from current frame), 1: LCU latency(trained from previous frame)")
 #endif
@@ -311,15 +341,26 @@ Bool TAppEncCfg::parseCfg( Int argc, Char* argv[] )
                                               "\t2: CRC\n"
                                               "\t1: use MD5\n"
                                               "\t0: disable")
+  ("AsyncMetrics", m_bUseAsyncMetrics, true, "Compute PSNR and picture digests on a background thread")
+  ("HugePages", m_iHugePages, 1, "huge pages for picture planes of 2 MB and more\n"
+                                 "\t0: off\n"
+                                 "\t1: transparent huge pages\n"
+                                 "\t2: explicit huge pages, transparent ones if the pool is empty")
+  ("NumaNode", m_iNumaNode, -1, "preferred NUMA node of the picture planes, -1: node of the thread that fills them")
   ("TMVPMode", m_TMVPModeId, 1, "TMVP mode 0: TMVP disable for all slices. 1: TMVP enable for all slices (default) 2: TMVP enable for certain slices only")
   ("FEN", m_bUseFastEnc, false, "fast encoder setting")
   ("ECU", m_bUseEarlyCU, false, "Early CU setting") 
   ("FDM", m_useFastDecisionForMerge, true, "Fast decision for Merge RD Cost") 
+  ("MergeRDCands", m_iMergeRDCands, 0, "Number of 2Nx2N merge candidates checked with full RD cost after SATD pre-screening (0: all, no pre-screening)")
   ("CFM", m_bUseCbfFastMode, false, "Cbf fast mode setting")
   ("ESD", m_useEarlySkipDetection, false, "Early SKIP detection setting")
+  ("AnalysisPass", m_bUseAnalysisPass, false, "Reduced search pass for collecting rate/lambda statistics (no RDOQ, restricted CU depth, fast ME)")
+  ("ParallelIntraSearch", m_bUseParallelIntraSearch, false, "Search the intra modes of each CU of inter slices on a second thread while its inter modes are searched (identical output; needs SBACRD, ignored with AdaptiveQpSelection)")
+  ("TableRateEst", m_bUseTableRateEst, false, "Estimate the coefficient rates of intra mode and RQT decisions from context bit tables instead of CABAC coding them (needs SBACRD; final CU costs stay exact)")
   ("RateCtrl,-rc", m_enableRateCtrl, false, "Rate control on/off")
   ("TargetBitrate,-tbr", m_targetBitrate, 0, "Input target bitrate")
   ("NumLCUInUnit,-nu", m_numLCUInUnit, 0, "Number of LCUs in an Unit")
+  ("RCLookahead", m_iRCLookahead, 0, "Number of pictures analyzed ahead of the coded GOP for the rate control (0: off)")
 
   ("TransquantBypassEnableFlag", m_TransquantBypassEnableFlag, false, "transquant_bypass_enable_flag indicator in PPS")
   ("CUTransquantBypassFlagValue", m_CUTransquantBypassFlagValue, false, "Fixed cu_transquant_bypass_flag value, when transquant_bypass_enable_flag is enabled")
@@ -355,12 +396,30 @@ Bool TAppEncCfg::parseCfg( Int argc, Char* argv[] )
   m_pchInputFile = cfg_InputFile.empty() ? NULL : strdup(cfg_InputFile.c_str());
   m_pchBitstreamFile = cfg_BitstreamFile.empty() ? NULL : strdup(cfg_BitstreamFile.c_str());
   m_pchReconFile = cfg_ReconFile.empty() ? NULL : strdup(cfg_ReconFile.c_str());
+  m_pchStatsFile = cfg_StatsFile.empty() ? NULL : strdup(cfg_StatsFile.c_str());
   m_pchdQPFile = cfg_dQPFile.empty() ? NULL : strdup(cfg_dQPFile.c_str());
   
   m_pchColumnWidth = cfg_ColumnWidth.empty() ? NULL: strdup(cfg_ColumnWidth.c_str());
   m_pchRowHeight = cfg_RowHeight.empty() ? NULL : strdup(cfg_RowHeight.c_str());
   m_scalingListFile = cfg_ScalingListFile.empty() ? NULL : strdup(cfg_ScalingListFile.c_str());
+  if ( !readIntList( cfg_RenditionQPs, m_aiRenditionQP ) || !readIntList( cfg_RenditionBitrates, m_aiRenditionBitrate ) )
+  {
+    fprintf(stderr, "Error: RenditionQPs and RenditionBitrates take lists of integers\n");
+    return false;
+  }
   
+  if ( m_bUseAnalysisPass )
+  {
+    // only the rate/lambda statistics of this pass are used, trade quality for speed
+    m_bUseRDOQ              = false;
+    m_iFastSearch           = 1;
+    m_iSearchRange          = min( m_iSearchRange, 32 );
+    m_bUseFastEnc           = true;
+    m_bUseEarlyCU           = true;
+    m_bUseCbfFastMode       = true;
+    m_useEarlySkipDetection = true;
+  }
+
   // TODO:ChromaFmt assumes 4:2:0 below
   switch (m_croppingMode)
   {
@@ -510,6 +569,10 @@ Void TAppEncCfg::xCheckParameter()
   xConfirmPara( m_crQpOffset >  12,   "Max. Chroma Cr QP Offset is  12" );
 
   xConfirmPara( m_iQPAdaptationRange <= 0,                                                  "QP Adaptation Range must be more than 0" );
+  xConfirmPara( m_iMergeRDCands < 0 || m_iMergeRDCands > MRG_MAX_NUM_CANDS,               "MergeRDCands must be in the range 0 to 5" );
+  xConfirmPara( m_saoStatsThreads < 0,                                                      "SAOStatsThreads must not be negative" );
+  xConfirmPara( m_iHugePages < 0 || m_iHugePages > 2,                                       "HugePages must be in the range 0 to 2" );
+  xConfirmPara( m_iNumaNode < -1,                                                           "NumaNode must be -1 or a node number" );
   if (m_iDecodingRefreshType == 2)
   {
     xConfirmPara( m_iIntraPeriod > 0 && m_iIntraPeriod <= m_iGOPSize ,                      "Intra period must be larger than GOP size for periodic IDR pictures");
@@ -538,6 +601,7 @@ Void TAppEncCfg::xCheckParameter()
 #if ADAPTIVE_QP_SELECTION
   xConfirmPara( m_bUseAdaptQpSelect == true && m_iQP < 0,                                              "AdaptiveQpSelection must be disabled when QP < 0.");
   xConfirmPara( m_bUseAdaptQpSelect == true && (m_cbQpOffset !=0 || m_crQpOffset != 0 ),               "AdaptiveQpSelection must be disabled when ChromaQpOffset is not equal to 0.");
+  xConfirmPara( m_bUseAdaptQpSelect == true && xGetNumRenditions() > 1,                               "AdaptiveQpSelection must be disabled with renditions, its coefficient buffers are shared by all encoders of the process.");
 #endif
 
   if( m_usePCM)
@@ -893,6 +957,18 @@ Void TAppEncCfg::xCheckParameter()
 
   xConfirmPara( m_pictureDigestEnabled<0 || m_pictureDigestEnabled>3, "this hash type is not correct!\n");
 
+  xConfirmPara( m_iRCLookahead < 0, "RCLookahead must be greater than or equal to 0" );
+  xConfirmPara( m_iRCLookahead > 0 && !m_enableRateCtrl, "RCLookahead requires RateCtrl" );
+  xConfirmPara( m_enableRateCtrl ? !m_aiRenditionQP.empty() : !m_aiRenditionBitrate.empty(), "Renditions are set by RenditionBitrates with RateCtrl and by RenditionQPs without" );
+  for ( i = 0; i < (Int)m_aiRenditionQP.size(); i++ )
+  {
+    xConfirmPara( m_aiRenditionQP[i] < -6 * ((Int)m_uiInternalBitDepth - 8) || m_aiRenditionQP[i] > 51, "RenditionQPs exceed supported range (-QpBDOffsety to 51)" );
+  }
+  for ( i = 0; i < (Int)m_aiRenditionBitrate.size(); i++ )
+  {
+    xConfirmPara( m_aiRenditionBitrate[i] <= 0, "RenditionBitrates must be positive" );
+  }
+  xConfirmPara( m_iRenditionThreads < -1, "RenditionThreads must be -1 or greater" );
   if(m_enableRateCtrl)
   {
     Int numLCUInWidth  = (m_iSourceWidth  / m_uiMaxCUWidth) + (( m_iSourceWidth  %  m_uiMaxCUWidth ) ? 1 : 0);
@@ -964,6 +1040,24 @@ Void TAppEncCfg::xPrintParameter()
   printf("Input          File          : %s\n", m_pchInputFile          );
   printf("Bitstream      File          : %s\n", m_pchBitstreamFile      );
   printf("Reconstruction File          : %s\n", m_pchReconFile          );
+  if ( m_pchStatsFile )
+  {
+    printf("Statistics     File          : %s\n", m_pchStatsFile          );
+  }
+  if ( m_bLowLatencyOutput )
+  {
+    printf("Output                       : per access unit\n");
+  }
+  if ( xGetNumRenditions() > 1 )
+  {
+    const vector<Int>& raiValues = m_enableRateCtrl ? m_aiRenditionBitrate : m_aiRenditionQP;
+    printf("Renditions                   : %d (%s", xGetNumRenditions(), m_enableRateCtrl ? "TargetBitrate" : "QP" );
+    for ( UInt i = 0; i < raiValues.size(); i++ )
+    {
+      printf(" %d", raiValues[i] );
+    }
+    printf(", motion seeds %d)\n", m_bUseRenditionMotionSeeds ? 1 : 0 );
+  }
   printf("Real     Format              : %dx%d %dHz\n", m_iSourceWidth - m_cropLeft - m_cropRight, m_iSourceHeight - m_cropTop - m_cropBottom, m_iFrameRate );
   printf("Internal Format              : %dx%d %dHz\n", m_iSourceWidth, m_iSourceHeight, m_iFrameRate );
   printf("Frame index                  : %u - %d (%d frames)\n", m_FrameSkip, m_FrameSkip+m_iFrameToBeEncoded-1, m_iFrameToBeEncoded );
@@ -990,6 +1084,7 @@ Void TAppEncCfg::xPrintParameter()
   {
     printf("TargetBitrate                : %d\n", m_targetBitrate);
     printf("NumLCUInUnit                 : %d\n", m_numLCUInUnit);
+    printf("RCLookahead                  : %d\n", m_iRCLookahead);
   }
   printf("\n");
   
@@ -1008,8 +1103,12 @@ Void TAppEncCfg::xPrintParameter()
   printf("FEN:%d ", m_bUseFastEnc         );
   printf("ECU:%d ", m_bUseEarlyCU         );
   printf("FDM:%d ", m_useFastDecisionForMerge );
+  printf("MergeRDCands:%d ", m_iMergeRDCands );
   printf("CFM:%d ", m_bUseCbfFastMode         );
   printf("ESD:%d ", m_useEarlySkipDetection  );
+  printf("Analysis:%d ", m_bUseAnalysisPass ? 1 : 0 );
+  printf("PIS:%d ", m_bUseParallelIntraSearch ? 1 : 0 );
+  printf("TRE:%d ", m_bUseTableRateEst ? 1 : 0 );
   printf("RQT:%d ", 1     );
 #if !REMOVE_LMCHROMA
   printf("LMC:%d ", m_bUseLMChroma        );
@@ -1034,6 +1133,7 @@ Void TAppEncCfg::xPrintParameter()
   printf("SAO:%d ", (m_bUseSAO)?(1):(0));
   printf("PCM:%d ", (m_usePCM && (1<<m_uiPCMLog2MinSize) <= m_uiMaxCUWidth)? 1 : 0);
   printf("SAOLcuBasedOptimization:%d ", (m_saoLcuBasedOptimization)?(1):(0));
+  printf("SAOStatsThreads:%d ", m_saoStatsThreads);
 
   printf("LosslessCuEnabled:%d ", (m_useLossless)? 1:0 );
   printf("WPP:%d ", (Int)m_bUseWeightPred);
@@ -1051,6 +1151,8 @@ Void TAppEncCfg::xPrintParameter()
 #if RECALCULATE_QP_ACCORDING_LAMBDA
   printf("RecalQP:%d", m_recalculateQPAccordingToLambda ? 1 : 0 );
 #endif
+  printf(" AsyncMetrics:%d", m_bUseAsyncMetrics ? 1 : 0 );
+  printf(" HugePages:%d NumaNode:%d", m_iHugePages, m_iNumaNode );
   printf("\n\n");
   
   fflush(stdout);
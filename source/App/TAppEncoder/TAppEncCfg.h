@@ -42,6 +42,7 @@
 
 #include "TLibEncoder/TEncCfg.h"
 #include <sstream>
+#include <vector>
 //! \ingroup TAppEncoder
 //! \{
 
@@ -57,6 +58,12 @@ protected:
   char*     m_pchInputFile;                                   ///< source file name
   char*     m_pchBitstreamFile;                               ///< output bitstream file
   char*     m_pchReconFile;                                   ///< output reconstruction file
+  char*     m_pchStatsFile;                                   ///< output rate/lambda statistics file
+  Bool      m_bLowLatencyOutput;                              ///< write each access unit as soon as it is coded
+  std::vector<Int> m_aiRenditionQP;                           ///< QPs of the further renditions of the source
+  std::vector<Int> m_aiRenditionBitrate;                      ///< target bitrates of the further renditions with the rate control
+  Int       m_iRenditionThreads;                              ///< threads coding the further renditions (-1: one per rendition)
+  Bool      m_bUseRenditionMotionSeeds;                       ///< start the fast motion search of the further renditions at the shared source motion
   Double    m_adLambdaModifier[ MAX_TLAYER ];                 ///< Lambda modifier array for each temporal layer
   // source specification
   Int       m_iFrameRate;                                     ///< source frame-rates (Hz)
@@ -133,6 +140,7 @@ protected:
   Bool      m_bUseSAO; 
   Int       m_maxNumOffsetsPerPic;                            ///< SAO maximun number of offset per picture
   Bool      m_saoLcuBasedOptimization;                        ///< SAO LCU-based optimization
+  Int       m_saoStatsThreads;                                ///< number of threads gathering SAO statistics per CTU row
   // coding tools (loop filter)
 #if !REMOVE_ALF
   Bool      m_bUseALF;                                        ///< flag for using adaptive loop filter
@@ -165,8 +173,12 @@ protected:
   Bool      m_bUseFastEnc;                                    ///< flag for using fast encoder setting
   Bool      m_bUseEarlyCU;                                    ///< flag for using Early CU setting
   Bool      m_useFastDecisionForMerge;                        ///< flag for using Fast Decision Merge RD-Cost 
+  Int       m_iMergeRDCands;                                  ///< number of merge candidates checked with full RD after SATD pre-screening
   Bool      m_bUseCbfFastMode;                              ///< flag for using Cbf Fast PU Mode Decision
   Bool      m_useEarlySkipDetection;                         ///< flag for using Early SKIP Detection
+  Bool      m_bUseAnalysisPass;                               ///< reduced search pass for collecting rate/lambda statistics
+  Bool      m_bUseParallelIntraSearch;                        ///< search the intra modes of inter slices in parallel to the inter modes
+  Bool      m_bUseTableRateEst;                               ///< table-driven coefficient rates for rough RD decisions
   Int       m_iSliceMode;           ///< 0: Disable all Recon slice limits, 1 : Maximum number of largest coding units per slice, 2: Maximum number of bytes in a slice
   Int       m_iSliceArgument;       ///< If m_iSliceMode==1, m_iSliceArgument=max. # of largest coding units. If m_iSliceMode==2, m_iSliceArgument=max. # of bytes.
   Int       m_iDependentSliceMode;    ///< 0: Disable all dependent slice limits, 1 : Maximum number of largest coding units per slice, 2: Constraint based dependent slice
@@ -191,6 +203,9 @@ protected:
   Bool      m_bUseConstrainedIntraPred;                       ///< flag for using constrained intra prediction
   
   Int       m_pictureDigestEnabled;                          ///< Checksum(3)/CRC(2)/MD5(1)/disable(0) acting on SEI picture_digest message
+  Bool      m_bUseAsyncMetrics;                               ///< compute PSNR and picture digests on a background thread
+  Int       m_iHugePages;                                     ///< huge page mode of the picture planes (0: off, 1: transparent, 2: explicit)
+  Int       m_iNumaNode;                                      ///< preferred NUMA node of the picture planes (-1: first touch)
 
   // weighted prediction
   Bool      m_bUseWeightPred;                                 ///< Use of explicit Weighting Prediction for P_SLICE
@@ -203,6 +218,7 @@ protected:
   Bool      m_enableRateCtrl;                                   ///< Flag for using rate control algorithm
   Int       m_targetBitrate;                                 ///< target bitrate
   Int       m_numLCUInUnit;                                  ///< Total number of LCUs in a frame should be completely divided by the NumLCUInUnit
+  Int       m_iRCLookahead;                                  ///< number of pictures analyzed ahead of the coded GOP by the rate control
   Int       m_useScalingListId;                               ///< using quantization matrix
   char*     m_scalingListFile;                                ///< quantization matrix file name
 
@@ -218,6 +234,7 @@ protected:
   Void  xCheckParameter ();                                   ///< check validity of configuration values
   Void  xPrintParameter ();                                   ///< print configuration values
   Void  xPrintUsage     ();                                   ///< print usage
+  Int   xGetNumRenditions() { return 1 + Int( m_enableRateCtrl ? m_aiRenditionBitrate.size() : m_aiRenditionQP.size() ); }  ///< number of renditions including the first one
   
 public:
   TAppEncCfg();
@@ -39,11 +39,13 @@
 #include <fstream>
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
 #include <fcntl.h>
 #include <assert.h>
 
 #include "TAppEncTop.h"
 #include "TLibEncoder/AnnexBwrite.h"
+#include "TLibCommon/TComPicAlloc.h"
 
 using namespace std;
 
@@ -57,15 +59,71 @@ using namespace std;
 TAppEncTop::TAppEncTop()
 {
   m_iFrameRcvd = 0;
+  m_iFrameEncoded = 0;
   m_totalBytes = 0;
   m_essentialBytes = 0;
+  m_pcBitstreamFile = NULL;
+  m_iNextReconPOC = 0;
 }
 
 TAppEncTop::~TAppEncTop()
 {
 }
 
-Void TAppEncTop::xInitLibCfg()
+TAppEncRendition::TAppEncRendition()
+: m_pchBitstreamFile( NULL )
+, m_pchStatsFile( NULL )
+, m_bEos( false )
+, m_iFrameEncoded( 0 )
+, m_essentialBytes( 0 )
+, m_totalBytes( 0 )
+{
+}
+
+TAppEncRendition::~TAppEncRendition()
+{
+  free( m_pchBitstreamFile );
+  free( m_pchStatsFile );
+}
+
+/** Code the pictures of the rendition that are due after the receipt of a source picture and write their access units
+ */
+Void TAppEncRendition::execute()
+{
+  list<AccessUnit> outputAccessUnits;
+  Int iNumEncoded = 0;
+  
+  m_cTEncTop.encode( m_bEos, NULL, m_cListPicYuvRec, outputAccessUnits, iNumEncoded );
+  
+  m_iFrameEncoded += iNumEncoded;
+  for ( list<AccessUnit>::const_iterator it = outputAccessUnits.begin(); it != outputAccessUnits.end(); it++ )
+  {
+    const vector<unsigned>& stats = writeAnnexB( m_cBitstreamFile, *it );
+    TAppEncTop::rateStatsAccum( *it, stats, m_essentialBytes, m_totalBytes );
+  }
+}
+
+/** Derive the name of an output file of a further rendition by inserting "_r<index>" before the extension
+ * \param pchFile output file of the first rendition
+ * \param iRendition index of the rendition
+ * \returns file name allocated with malloc()
+ */
+static char* getRenditionFileName( const char* pchFile, Int iRendition )
+{
+  string cName( pchFile );
+  string::size_type uiDot   = cName.rfind( '.' );
+  string::size_type uiSlash = cName.find_last_of( "/\\" );
+  if ( uiDot == string::npos || ( uiSlash != string::npos && uiDot < uiSlash ) )
+  {
+    uiDot = cName.size();
+  }
+  char acSuffix[16];
+  snprintf( acSuffix, sizeof(acSuffix), "_r%d", iRendition );
+  cName.insert( uiDot, acSuffix );
+  return strdup( cName.c_str() );
+}
+
+Void TAppEncTop::xInitLibCfg( TEncTop& rcTEncTop )
 {
   TComVPS vps;
   Int i;
@@ -77,66 +135,66 @@ Void TAppEncTop::xInitLibCfg()
     vps.setNumReorderPics                 ( m_numReorderPics[i], i );
     vps.setMaxDecPicBuffering             ( m_maxDecPicBuffering[i], i );
   }
-  m_cTEncTop.setVPS(&vps);
-  m_cTEncTop.setFrameRate                    ( m_iFrameRate );
-  m_cTEncTop.setFrameSkip                    ( m_FrameSkip );
-  m_cTEncTop.setSourceWidth                  ( m_iSourceWidth );
-  m_cTEncTop.setSourceHeight                 ( m_iSourceHeight );
-  m_cTEncTop.setCroppingMode                 ( m_croppingMode );
-  m_cTEncTop.setCropLeft                     ( m_cropLeft );
-  m_cTEncTop.setCropRight                    ( m_cropRight );
-  m_cTEncTop.setCropTop                      ( m_cropTop );
-  m_cTEncTop.setCropBottom                   ( m_cropBottom );
-  m_cTEncTop.setFrameToBeEncoded             ( m_iFrameToBeEncoded );
+  rcTEncTop.setVPS(&vps);
+  rcTEncTop.setFrameRate                    ( m_iFrameRate );
+  rcTEncTop.setFrameSkip                    ( m_FrameSkip );
+  rcTEncTop.setSourceWidth                  ( m_iSourceWidth );
+  rcTEncTop.setSourceHeight                 ( m_iSourceHeight );
+  rcTEncTop.setCroppingMode                 ( m_croppingMode );
+  rcTEncTop.setCropLeft                     ( m_cropLeft );
+  rcTEncTop.setCropRight                    ( m_cropRight );
+  rcTEncTop.setCropTop                      ( m_cropTop );
+  rcTEncTop.setCropBottom                   ( m_cropBottom );
+  rcTEncTop.setFrameToBeEncoded             ( m_iFrameToBeEncoded );
   
   //====== Coding Structure ========
-  m_cTEncTop.setIntraPeriod                  ( m_iIntraPeriod );
-  m_cTEncTop.setDecodingRefreshType          ( m_iDecodingRefreshType );
-  m_cTEncTop.setGOPSize                      ( m_iGOPSize );
-  m_cTEncTop.setGopList                      ( m_GOPList );
-  m_cTEncTop.setExtraRPSs                    ( m_extraRPSs );
+  rcTEncTop.setIntraPeriod                  ( m_iIntraPeriod );
+  rcTEncTop.setDecodingRefreshType          ( m_iDecodingRefreshType );
+  rcTEncTop.setGOPSize                      ( m_iGOPSize );
+  rcTEncTop.setGopList                      ( m_GOPList );
+  rcTEncTop.setExtraRPSs                    ( m_extraRPSs );
   for(i = 0; i < MAX_TLAYER; i++)
   {
-    m_cTEncTop.setNumReorderPics             ( m_numReorderPics[i], i );
-    m_cTEncTop.setMaxDecPicBuffering         ( m_maxDecPicBuffering[i], i );
+    rcTEncTop.setNumReorderPics             ( m_numReorderPics[i], i );
+    rcTEncTop.setMaxDecPicBuffering         ( m_maxDecPicBuffering[i], i );
   }
   for( UInt uiLoop = 0; uiLoop < MAX_TLAYER; ++uiLoop )
   {
-    m_cTEncTop.setLambdaModifier( uiLoop, m_adLambdaModifier[ uiLoop ] );
+    rcTEncTop.setLambdaModifier( uiLoop, m_adLambdaModifier[ uiLoop ] );
   }
-  m_cTEncTop.setQP                           ( m_iQP );
+  rcTEncTop.setQP                           ( m_iQP );
   
-  m_cTEncTop.setPad                          ( m_aiPad );
+  rcTEncTop.setPad                          ( m_aiPad );
     
-  m_cTEncTop.setMaxTempLayer                 ( m_maxTempLayer );
+  rcTEncTop.setMaxTempLayer                 ( m_maxTempLayer );
 #if !REMOVE_NSQT
-  m_cTEncTop.setUseNSQT( m_enableNSQT );
+  rcTEncTop.setUseNSQT( m_enableNSQT );
 #endif
-  m_cTEncTop.setUseAMP( m_enableAMP );
+  rcTEncTop.setUseAMP( m_enableAMP );
   
   //===== Slice ========
   
   //====== Loop/Deblock Filter ========
-  m_cTEncTop.setLoopFilterDisable            ( m_bLoopFilterDisable       );
-  m_cTEncTop.setLoopFilterOffsetInPPS        ( m_loopFilterOffsetInPPS );
-  m_cTEncTop.setLoopFilterBetaOffset         ( m_loopFilterBetaOffsetDiv2  );
-  m_cTEncTop.setLoopFilterTcOffset           ( m_loopFilterTcOffsetDiv2    );
-  m_cTEncTop.setDeblockingFilterControlPresent( m_DeblockingFilterControlPresent);
+  rcTEncTop.setLoopFilterDisable            ( m_bLoopFilterDisable       );
+  rcTEncTop.setLoopFilterOffsetInPPS        ( m_loopFilterOffsetInPPS );
+  rcTEncTop.setLoopFilterBetaOffset         ( m_loopFilterBetaOffsetDiv2  );
+  rcTEncTop.setLoopFilterTcOffset           ( m_loopFilterTcOffsetDiv2    );
+  rcTEncTop.setDeblockingFilterControlPresent( m_DeblockingFilterControlPresent);
 
   //====== Motion search ========
-  m_cTEncTop.setFastSearch                   ( m_iFastSearch  );
-  m_cTEncTop.setSearchRange                  ( m_iSearchRange );
-  m_cTEncTop.setBipredSearchRange            ( m_bipredSearchRange );
+  rcTEncTop.setFastSearch                   ( m_iFastSearch  );
+  rcTEncTop.setSearchRange                  ( m_iSearchRange );
+  rcTEncTop.setBipredSearchRange            ( m_bipredSearchRange );
 
   //====== Quality control ========
-  m_cTEncTop.setMaxDeltaQP                   ( m_iMaxDeltaQP  );
-  m_cTEncTop.setMaxCuDQPDepth                ( m_iMaxCuDQPDepth  );
+  rcTEncTop.setMaxDeltaQP                   ( m_iMaxDeltaQP  );
+  rcTEncTop.setMaxCuDQPDepth                ( m_iMaxCuDQPDepth  );
 
-  m_cTEncTop.setChromaCbQpOffset               ( m_cbQpOffset     );
-  m_cTEncTop.setChromaCrQpOffset            ( m_crQpOffset  );
+  rcTEncTop.setChromaCbQpOffset               ( m_cbQpOffset     );
+  rcTEncTop.setChromaCrQpOffset            ( m_crQpOffset  );
 
 #if ADAPTIVE_QP_SELECTION
-  m_cTEncTop.setUseAdaptQpSelect             ( m_bUseAdaptQpSelect   );
+  rcTEncTop.setUseAdaptQpSelect             ( m_bUseAdaptQpSelect   );
 #endif
 
   Int lowestQP;
@@ -146,131 +204,145 @@ Void TAppEncTop::xInitLibCfg()
   {
     m_bUseAdaptiveQP = false;
   }
-  m_cTEncTop.setUseAdaptiveQP                ( m_bUseAdaptiveQP  );
-  m_cTEncTop.setQPAdaptationRange            ( m_iQPAdaptationRange );
+  rcTEncTop.setUseAdaptiveQP                ( m_bUseAdaptiveQP  );
+  rcTEncTop.setQPAdaptationRange            ( m_iQPAdaptationRange );
   
   //====== Tool list ========
-  m_cTEncTop.setUseSBACRD                    ( m_bUseSBACRD   );
-  m_cTEncTop.setDeltaQpRD                    ( m_uiDeltaQpRD  );
-  m_cTEncTop.setUseASR                       ( m_bUseASR      );
-  m_cTEncTop.setUseHADME                     ( m_bUseHADME    );
+  rcTEncTop.setUseSBACRD                    ( m_bUseSBACRD   );
+  rcTEncTop.setDeltaQpRD                    ( m_uiDeltaQpRD  );
+  rcTEncTop.setUseASR                       ( m_bUseASR      );
+  rcTEncTop.setUseHADME                     ( m_bUseHADME    );
 #if !REMOVE_ALF
-  m_cTEncTop.setUseALF                       ( m_bUseALF      );
+  rcTEncTop.setUseALF                       ( m_bUseALF      );
 #endif
-  m_cTEncTop.setUseLossless                  ( m_useLossless );
-  m_cTEncTop.setUseLComb                     ( m_bUseLComb    );
-  m_cTEncTop.setdQPs                         ( m_aidQP        );
-  m_cTEncTop.setUseRDOQ                      ( m_bUseRDOQ     );
-  m_cTEncTop.setQuadtreeTULog2MaxSize        ( m_uiQuadtreeTULog2MaxSize );
-  m_cTEncTop.setQuadtreeTULog2MinSize        ( m_uiQuadtreeTULog2MinSize );
-  m_cTEncTop.setQuadtreeTUMaxDepthInter      ( m_uiQuadtreeTUMaxDepthInter );
-  m_cTEncTop.setQuadtreeTUMaxDepthIntra      ( m_uiQuadtreeTUMaxDepthIntra );
-  m_cTEncTop.setUseFastEnc                   ( m_bUseFastEnc  );
-  m_cTEncTop.setUseEarlyCU                   ( m_bUseEarlyCU  ); 
-  m_cTEncTop.setUseFastDecisionForMerge      ( m_useFastDecisionForMerge  );
-  m_cTEncTop.setUseCbfFastMode            ( m_bUseCbfFastMode  );
-  m_cTEncTop.setUseEarlySkipDetection            ( m_useEarlySkipDetection );
+  rcTEncTop.setUseLossless                  ( m_useLossless );
+  rcTEncTop.setUseLComb                     ( m_bUseLComb    );
+  rcTEncTop.setdQPs                         ( m_aidQP        );
+  rcTEncTop.setUseRDOQ                      ( m_bUseRDOQ     );
+  rcTEncTop.setQuadtreeTULog2MaxSize        ( m_uiQuadtreeTULog2MaxSize );
+  rcTEncTop.setQuadtreeTULog2MinSize        ( m_uiQuadtreeTULog2MinSize );
+  rcTEncTop.setQuadtreeTUMaxDepthInter      ( m_uiQuadtreeTUMaxDepthInter );
+  rcTEncTop.setQuadtreeTUMaxDepthIntra      ( m_uiQuadtreeTUMaxDepthIntra );
+  rcTEncTop.setUseFastEnc                   ( m_bUseFastEnc  );
+  rcTEncTop.setUseEarlyCU                   ( m_bUseEarlyCU  ); 
+  rcTEncTop.setUseFastDecisionForMerge      ( m_useFastDecisionForMerge  );
+  rcTEncTop.setMergeRDCands                 ( m_iMergeRDCands );
+  rcTEncTop.setUseCbfFastMode            ( m_bUseCbfFastMode  );
+  rcTEncTop.setUseEarlySkipDetection            ( m_useEarlySkipDetection );
+  rcTEncTop.setUseAnalysisPass              ( m_bUseAnalysisPass );
+  rcTEncTop.setUseParallelIntraSearch       ( m_bUseParallelIntraSearch );
+  rcTEncTop.setUseTableRateEst              ( m_bUseTableRateEst );
 
 #if !REMOVE_LMCHROMA
-  m_cTEncTop.setUseLMChroma                  ( m_bUseLMChroma );
+  rcTEncTop.setUseLMChroma                  ( m_bUseLMChroma );
 #endif
-  m_cTEncTop.setUseTransformSkip             ( m_useTansformSkip      );
-  m_cTEncTop.setUseTransformSkipFast         ( m_useTansformSkipFast  );
-  m_cTEncTop.setUseConstrainedIntraPred      ( m_bUseConstrainedIntraPred );
-  m_cTEncTop.setPCMLog2MinSize          ( m_uiPCMLog2MinSize);
-  m_cTEncTop.setUsePCM                       ( m_usePCM );
-  m_cTEncTop.setPCMLog2MaxSize               ( m_pcmLog2MaxSize);
+  rcTEncTop.setUseTransformSkip             ( m_useTansformSkip      );
+  rcTEncTop.setUseTransformSkipFast         ( m_useTansformSkipFast  );
+  rcTEncTop.setUseConstrainedIntraPred      ( m_bUseConstrainedIntraPred );
+  rcTEncTop.setPCMLog2MinSize          ( m_uiPCMLog2MinSize);
+  rcTEncTop.setUsePCM                       ( m_usePCM );
+  rcTEncTop.setPCMLog2MaxSize               ( m_pcmLog2MaxSize);
 
   //====== Weighted Prediction ========
-  m_cTEncTop.setUseWP                   ( m_bUseWeightPred      );
-  m_cTEncTop.setWPBiPred                ( m_useWeightedBiPred   );
+  rcTEncTop.setUseWP                   ( m_bUseWeightPred      );
+  rcTEncTop.setWPBiPred                ( m_useWeightedBiPred   );
   //====== Parallel Merge Estimation ========
-  m_cTEncTop.setLog2ParallelMergeLevelMinus2 ( m_log2ParallelMergeLevel - 2 );
+  rcTEncTop.setLog2ParallelMergeLevelMinus2 ( m_log2ParallelMergeLevel - 2 );
 
   //====== Slice ========
-  m_cTEncTop.setSliceMode               ( m_iSliceMode                );
-  m_cTEncTop.setSliceArgument           ( m_iSliceArgument            );
+  rcTEncTop.setSliceMode               ( m_iSliceMode                );
+  rcTEncTop.setSliceArgument           ( m_iSliceArgument            );
 
   //====== Dependent Slice ========
-  m_cTEncTop.setDependentSliceMode        ( m_iDependentSliceMode         );
-  m_cTEncTop.setDependentSliceArgument    ( m_iDependentSliceArgument     );
+  rcTEncTop.setDependentSliceMode        ( m_iDependentSliceMode         );
+  rcTEncTop.setDependentSliceArgument    ( m_iDependentSliceArgument     );
 #if DEPENDENT_SLICES
-  m_cTEncTop.setCabacIndependentFlag      ( m_bCabacIndependentFlag   );
+  rcTEncTop.setCabacIndependentFlag      ( m_bCabacIndependentFlag   );
 #endif
   int iNumPartInCU = 1<<(m_uiMaxCUDepth<<1);
   if(m_iDependentSliceMode==SHARP_FIXED_NUMBER_OF_LCU_IN_DEPENDENT_SLICE)
   {
 #if REMOVE_FGS
-    m_cTEncTop.setDependentSliceArgument ( m_iDependentSliceArgument * iNumPartInCU );
+    rcTEncTop.setDependentSliceArgument ( m_iDependentSliceArgument * iNumPartInCU );
 #else
-    m_cTEncTop.setDependentSliceArgument ( m_iDependentSliceArgument * ( iNumPartInCU >> ( m_iSliceGranularity << 1 ) ) );
+    rcTEncTop.setDependentSliceArgument ( m_iDependentSliceArgument * ( iNumPartInCU >> ( m_iSliceGranularity << 1 ) ) );
 #endif
   }
   if(m_iSliceMode==AD_HOC_SLICES_FIXED_NUMBER_OF_LCU_IN_SLICE)
   {
 #if REMOVE_FGS
-    m_cTEncTop.setSliceArgument ( m_iSliceArgument * iNumPartInCU );
+    rcTEncTop.setSliceArgument ( m_iSliceArgument * iNumPartInCU );
 #else
-    m_cTEncTop.setSliceArgument ( m_iSliceArgument * ( iNumPartInCU >> ( m_iSliceGranularity << 1 ) ) );
+    rcTEncTop.setSliceArgument ( m_iSliceArgument * ( iNumPartInCU >> ( m_iSliceGranularity << 1 ) ) );
 #endif
   }
   if(m_iSliceMode==AD_HOC_SLICES_FIXED_NUMBER_OF_TILES_IN_SLICE)
   {
-    m_cTEncTop.setSliceArgument ( m_iSliceArgument );
+    rcTEncTop.setSliceArgument ( m_iSliceArgument );
   }
   
 #if !REMOVE_FGS
-  m_cTEncTop.setSliceGranularity        ( m_iSliceGranularity         );
+  rcTEncTop.setSliceGranularity        ( m_iSliceGranularity         );
 #endif
   if(m_iSliceMode == 0 )
   {
     m_bLFCrossSliceBoundaryFlag = true;
   }
-  m_cTEncTop.setLFCrossSliceBoundaryFlag( m_bLFCrossSliceBoundaryFlag );
-  m_cTEncTop.setUseSAO ( m_bUseSAO );
-  m_cTEncTop.setMaxNumOffsetsPerPic (m_maxNumOffsetsPerPic);
-  m_cTEncTop.setSaoLcuBasedOptimization (m_saoLcuBasedOptimization);
-  m_cTEncTop.setPCMInputBitDepthFlag  ( m_bPCMInputBitDepthFlag); 
-  m_cTEncTop.setPCMFilterDisableFlag  ( m_bPCMFilterDisableFlag); 
-
-  m_cTEncTop.setPictureDigestEnabled(m_pictureDigestEnabled);
-
-  m_cTEncTop.setUniformSpacingIdr          ( m_iUniformSpacingIdr );
-  m_cTEncTop.setNumColumnsMinus1           ( m_iNumColumnsMinus1 );
-  m_cTEncTop.setNumRowsMinus1              ( m_iNumRowsMinus1 );
+  rcTEncTop.setLFCrossSliceBoundaryFlag( m_bLFCrossSliceBoundaryFlag );
+  rcTEncTop.setUseSAO ( m_bUseSAO );
+  rcTEncTop.setMaxNumOffsetsPerPic (m_maxNumOffsetsPerPic);
+  rcTEncTop.setSaoLcuBasedOptimization (m_saoLcuBasedOptimization);
+  rcTEncTop.setSaoStatsThreads (m_saoStatsThreads);
+  rcTEncTop.setPCMInputBitDepthFlag  ( m_bPCMInputBitDepthFlag); 
+  rcTEncTop.setPCMFilterDisableFlag  ( m_bPCMFilterDisableFlag); 
+
+  rcTEncTop.setPictureDigestEnabled(m_pictureDigestEnabled);
+  rcTEncTop.setUseAsyncMetrics            ( m_bUseAsyncMetrics );
+  rcTEncTop.setStatsFile                  ( m_pchStatsFile );
+
+  rcTEncTop.setUniformSpacingIdr          ( m_iUniformSpacingIdr );
+  rcTEncTop.setNumColumnsMinus1           ( m_iNumColumnsMinus1 );
+  rcTEncTop.setNumRowsMinus1              ( m_iNumRowsMinus1 );
   if(m_iUniformSpacingIdr==0)
   {
-    m_cTEncTop.setColumnWidth              ( m_pchColumnWidth );
-    m_cTEncTop.setRowHeight                ( m_pchRowHeight );
+    rcTEncTop.setColumnWidth              ( m_pchColumnWidth );
+    rcTEncTop.setRowHeight                ( m_pchRowHeight );
   }
-  m_cTEncTop.xCheckGSParameters();
+  rcTEncTop.xCheckGSParameters();
   Int uiTilesCount          = (m_iNumRowsMinus1+1) * (m_iNumColumnsMinus1+1);
   if(uiTilesCount == 1)
   {
     m_bLFCrossTileBoundaryFlag = true; 
   }
-  m_cTEncTop.setLFCrossTileBoundaryFlag( m_bLFCrossTileBoundaryFlag );
-  m_cTEncTop.setWaveFrontSynchro           ( m_iWaveFrontSynchro );
-  m_cTEncTop.setWaveFrontSubstreams        ( m_iWaveFrontSubstreams );
-  m_cTEncTop.setTMVPModeId ( m_TMVPModeId );
-  m_cTEncTop.setUseScalingListId           ( m_useScalingListId  );
-  m_cTEncTop.setScalingListFile            ( m_scalingListFile   );
-  m_cTEncTop.setSignHideFlag(m_signHideFlag);
+  rcTEncTop.setLFCrossTileBoundaryFlag( m_bLFCrossTileBoundaryFlag );
+  rcTEncTop.setWaveFrontSynchro           ( m_iWaveFrontSynchro );
+  rcTEncTop.setWaveFrontSubstreams        ( m_iWaveFrontSubstreams );
+  rcTEncTop.setTMVPModeId ( m_TMVPModeId );
+  rcTEncTop.setUseScalingListId           ( m_useScalingListId  );
+  rcTEncTop.setScalingListFile            ( m_scalingListFile   );
+  rcTEncTop.setSignHideFlag(m_signHideFlag);
 #if !REMOVE_ALF
-  m_cTEncTop.setALFLowLatencyEncoding( m_alfLowLatencyEncoding );
+  rcTEncTop.setALFLowLatencyEncoding( m_alfLowLatencyEncoding );
 #endif
-  m_cTEncTop.setUseRateCtrl     ( m_enableRateCtrl);
-  m_cTEncTop.setTargetBitrate   ( m_targetBitrate);
-  m_cTEncTop.setNumLCUInUnit    ( m_numLCUInUnit);
-  m_cTEncTop.setTransquantBypassEnableFlag(m_TransquantBypassEnableFlag);
-  m_cTEncTop.setCUTransquantBypassFlagValue(m_CUTransquantBypassFlagValue);
+  rcTEncTop.setUseRateCtrl     ( m_enableRateCtrl);
+  rcTEncTop.setTargetBitrate   ( m_targetBitrate);
+  rcTEncTop.setNumLCUInUnit    ( m_numLCUInUnit);
+  rcTEncTop.setRCLookahead     ( m_iRCLookahead);
+  rcTEncTop.setTransquantBypassEnableFlag(m_TransquantBypassEnableFlag);
+  rcTEncTop.setCUTransquantBypassFlagValue(m_CUTransquantBypassFlagValue);
 #if RECALCULATE_QP_ACCORDING_LAMBDA
-  m_cTEncTop.setUseRecalculateQPAccordingToLambda( m_recalculateQPAccordingToLambda );
+  rcTEncTop.setUseRecalculateQPAccordingToLambda( m_recalculateQPAccordingToLambda );
 #endif
+  rcTEncTop.setRendition       ( xGetNumRenditions() > 1 ? 0 : -1 );
+  rcTEncTop.setUseMotionSeeds  ( m_bUseRenditionMotionSeeds );
 }
 
 Void TAppEncTop::xCreateLib()
 {
+  // picture planes allocated from here on
+  TComPicAlloc::setHugePages( m_iHugePages );
+  TComPicAlloc::setNumaNode ( m_iNumaNode );
+  
   // Video I/O
   m_cTVideoIOYuvInputFile.open( m_pchInputFile,     false, m_uiInputBitDepth, m_uiInternalBitDepth );  // read  mode
   m_cTVideoIOYuvInputFile.skipFrames(m_FrameSkip, m_iSourceWidth - m_aiPad[0], m_iSourceHeight - m_aiPad[1]);
@@ -297,6 +369,74 @@ Void TAppEncTop::xInitLib()
   m_cTEncTop.init();
 }
 
+/** Create the encoders of the further renditions, configured as the first one apart from the QP or target bitrate,
+ *  and let all encoders share the analysis of the source
+ */
+Void TAppEncTop::xCreateRenditions()
+{
+  Int iNumRenditions = xGetNumRenditions();
+  if ( iNumRenditions == 1 )
+  {
+    return;
+  }
+  
+  m_cSharedAnalysis.create( m_iSourceWidth, m_iSourceHeight, m_iSearchRange );
+  m_cTEncTop.setSharedAnalysis( &m_cSharedAnalysis );
+  
+  for ( Int i = 1; i < iNumRenditions; i++ )
+  {
+    TAppEncRendition* pcRendition = new TAppEncRendition;
+    m_apcRenditions.push_back( pcRendition );
+    
+    pcRendition->m_pchBitstreamFile = getRenditionFileName( m_pchBitstreamFile, i );
+    pcRendition->m_pchStatsFile     = m_pchStatsFile ? getRenditionFileName( m_pchStatsFile, i ) : NULL;
+    pcRendition->m_cBitstreamFile.open( pcRendition->m_pchBitstreamFile, fstream::binary | fstream::out );
+    if ( !pcRendition->m_cBitstreamFile )
+    {
+      fprintf(stderr, "\nfailed to open bitstream file `%s' for writing\n", pcRendition->m_pchBitstreamFile);
+      exit(EXIT_FAILURE);
+    }
+    
+    TEncTop& rcTEncTop = pcRendition->m_cTEncTop;
+    xInitLibCfg( rcTEncTop );
+    if ( m_enableRateCtrl )
+    {
+      rcTEncTop.setTargetBitrate( m_aiRenditionBitrate[i - 1] );
+    }
+    else
+    {
+      rcTEncTop.setQP( m_aiRenditionQP[i - 1] );
+    }
+    rcTEncTop.setStatsFile      ( pcRendition->m_pchStatsFile );
+    rcTEncTop.setRendition      ( i );
+    rcTEncTop.setSharedAnalysis ( &m_cSharedAnalysis );
+    rcTEncTop.create();
+    rcTEncTop.init();
+  }
+  
+  m_cRenditionQueue.create( m_iRenditionThreads < 0 ? iNumRenditions - 1 : m_iRenditionThreads );
+}
+
+Void TAppEncTop::xDestroyRenditions()
+{
+  if ( m_apcRenditions.empty() )
+  {
+    return;
+  }
+  
+  m_cRenditionQueue.destroy();
+  for ( UInt i = 0; i < m_apcRenditions.size(); i++ )
+  {
+    TAppEncRendition* pcRendition = m_apcRenditions[i];
+    pcRendition->m_cTEncTop.deletePicBuffer();
+    pcRendition->m_cTEncTop.destroy();
+    xDeleteBuffer( pcRendition->m_cListPicYuvRec );
+    delete pcRendition;
+  }
+  m_apcRenditions.clear();
+  m_cSharedAnalysis.destroy();
+}
+
 // ====================================================================================================================
 // Public member functions
 // ====================================================================================================================
@@ -322,8 +462,9 @@ Void TAppEncTop::encode()
   TComPicYuv*       pcPicYuvRec = NULL;
   
   // initialize internal class & member variables
-  xInitLibCfg();
+  xInitLibCfg( m_cTEncTop );
   xCreateLib();
+  xCreateRenditions();
   xInitLib();
   
   // main encoder loop
@@ -332,13 +473,23 @@ Void TAppEncTop::encode()
   
   list<AccessUnit> outputAccessUnits; ///< list of access units to write out.  is populated by the encoding process
 
+  if ( m_bLowLatencyOutput )
+  {
+    m_pcBitstreamFile = &bitstreamFile;
+    m_iNextReconPOC   = 0;
+    m_cTEncTop.setOutputIf( this );
+  }
+
   // allocate original YUV buffer
   pcPicYuvOrg->create( m_iSourceWidth, m_iSourceHeight, m_uiMaxCUWidth, m_uiMaxCUHeight, m_uiMaxCUDepth );
   
   while ( !bEos )
   {
     // get buffers
-    xGetBuffer(pcPicYuvRec);
+    if ( !m_bLowLatencyOutput )
+    {
+      xGetBuffer(m_cListPicYuvRec, pcPicYuvRec);
+    }
 
     // read input YUV file
     m_cTVideoIOYuvInputFile.read( pcPicYuvOrg, m_aiPad );
@@ -350,14 +501,45 @@ Void TAppEncTop::encode()
     bEos = ( m_cTVideoIOYuvInputFile.isEof() == 1 ?   true : false  );
     bEos = ( m_iFrameRcvd == m_iFrameToBeEncoded ?    true : bEos   );
     
-    // call encoding function for one frame
-    m_cTEncTop.encode( bEos, pcPicYuvOrg, m_cListPicYuvRec, outputAccessUnits, iNumEncoded );
+    // the first encoder analyzes the picture, the further renditions take over the analysis and are coded meanwhile
+    TComPicYuv* pcPicYuvIn = pcPicYuvOrg;
+    if ( !m_apcRenditions.empty() )
+    {
+      m_cTEncTop.receivePicture( pcPicYuvOrg );
+      pcPicYuvIn = NULL;
+      for ( UInt i = 0; i < m_apcRenditions.size(); i++ )
+      {
+        TAppEncRendition* pcRendition = m_apcRenditions[i];
+        pcRendition->m_cTEncTop.receivePicture( pcPicYuvOrg );
+        xGetBuffer( pcRendition->m_cListPicYuvRec, pcPicYuvRec );
+        pcRendition->m_bEos = bEos;
+        m_cRenditionQueue.submit( pcRendition );
+      }
+    }
+    
+    if ( m_bLowLatencyOutput )
+    {
+      // the access units are written by accessUnitEncoded()
+      m_cTEncTop.encode( pcPicYuvIn, bEos );
+    }
+    else
+    {
+      // call encoding function for one frame
+      m_cTEncTop.encode( bEos, pcPicYuvIn, m_cListPicYuvRec, outputAccessUnits, iNumEncoded );
+      
+      // write bistream to file if necessary
+      m_iFrameEncoded += iNumEncoded;
+      if ( iNumEncoded > 0 )
+      {
+        xWriteOutput(bitstreamFile, iNumEncoded, outputAccessUnits);
+        outputAccessUnits.clear();
+      }
+    }
     
-    // write bistream to file if necessary
-    if ( iNumEncoded > 0 )
+    if ( !m_apcRenditions.empty() )
     {
-      xWriteOutput(bitstreamFile, iNumEncoded, outputAccessUnits);
-      outputAccessUnits.clear();
+      m_cRenditionQueue.waitAll();
+      m_cSharedAnalysis.releaseMotionSeeds();
     }
   }
   // delete original YUV buffer
@@ -365,14 +547,32 @@ Void TAppEncTop::encode()
   delete pcPicYuvOrg;
   pcPicYuvOrg = NULL;
   
+  // summaries of all renditions once all of them are coded
+  if ( !m_apcRenditions.empty() )
+  {
+    m_cTEncTop.printSummary();
+    for ( UInt i = 0; i < m_apcRenditions.size(); i++ )
+    {
+      m_apcRenditions[i]->m_cTEncTop.printSummary();
+    }
+    printf("\n");
+  }
+  
   // delete used buffers in encoder class
   m_cTEncTop.deletePicBuffer();
   
   // delete buffers & classes
-  xDeleteBuffer();
+  xDeleteBuffer( m_cListPicYuvRec );
   xDestroyLib();
   
-  printRateSummary();
+  printRateSummary( m_essentialBytes, m_totalBytes );
+  for ( UInt i = 0; i < m_apcRenditions.size(); i++ )
+  {
+    TAppEncRendition* pcRendition = m_apcRenditions[i];
+    printf("Rendition %u, %s: ", i + 1, pcRendition->m_pchBitstreamFile);
+    printRateSummary( pcRendition->m_essentialBytes, pcRendition->m_totalBytes );
+  }
+  xDestroyRenditions();
 
   return;
 }
@@ -382,19 +582,19 @@ Void TAppEncTop::encode()
 // ====================================================================================================================
 
 /**
- - application has picture buffer list with size of GOP
+ - application has picture buffer list with size of GOP + RCLookahead
  - picture buffer list acts as ring buffer
  - end of the list has the latest picture
  .
  */
-Void TAppEncTop::xGetBuffer( TComPicYuv*& rpcPicYuvRec)
+Void TAppEncTop::xGetBuffer( TComList<TComPicYuv*>& rcListPicYuvRec, TComPicYuv*& rpcPicYuvRec)
 {
   assert( m_iGOPSize > 0 );
   
   // org. buffer
-  if ( m_cListPicYuvRec.size() == (UInt)m_iGOPSize )
+  if ( rcListPicYuvRec.size() == (UInt)(m_iGOPSize + m_iRCLookahead) )
   {
-    rpcPicYuvRec = m_cListPicYuvRec.popFront();
+    rpcPicYuvRec = rcListPicYuvRec.popFront();
 
   }
   else
@@ -404,14 +604,14 @@ Void TAppEncTop::xGetBuffer( TComPicYuv*& rpcPicYuvRec)
     rpcPicYuvRec->create( m_iSourceWidth, m_iSourceHeight, m_uiMaxCUWidth, m_uiMaxCUHeight, m_uiMaxCUDepth );
 
   }
-  m_cListPicYuvRec.pushBack( rpcPicYuvRec );
+  rcListPicYuvRec.pushBack( rpcPicYuvRec );
 }
 
-Void TAppEncTop::xDeleteBuffer( )
+Void TAppEncTop::xDeleteBuffer( TComList<TComPicYuv*>& rcListPicYuvRec )
 {
-  TComList<TComPicYuv*>::iterator iterPicYuvRec  = m_cListPicYuvRec.begin();
+  TComList<TComPicYuv*>::iterator iterPicYuvRec  = rcListPicYuvRec.begin();
   
-  Int iSize = Int( m_cListPicYuvRec.size() );
+  Int iSize = Int( rcListPicYuvRec.size() );
   
   for ( Int i = 0; i < iSize; i++ )
   {
@@ -419,10 +619,12 @@ Void TAppEncTop::xDeleteBuffer( )
     pcPicYuvRec->destroy();
     delete pcPicYuvRec; pcPicYuvRec = NULL;
   }
-  
+  rcListPicYuvRec.clear();
 }
 
 /** \param iNumEncoded  number of encoded frames
+ *
+ * The buffers of the frames received but not encoded yet are at the end of the list.
  */
 Void TAppEncTop::xWriteOutput(std::ostream& bitstreamFile, Int iNumEncoded, const std::list<AccessUnit>& accessUnits)
 {
@@ -431,7 +633,7 @@ Void TAppEncTop::xWriteOutput(std::ostream& bitstreamFile, Int iNumEncoded, cons
   TComList<TComPicYuv*>::iterator iterPicYuvRec = m_cListPicYuvRec.end();
   list<AccessUnit>::const_iterator iterBitstream = accessUnits.begin();
   
-  for ( i = 0; i < iNumEncoded; i++ )
+  for ( i = 0; i < iNumEncoded + m_iFrameRcvd - m_iFrameEncoded; i++ )
   {
     --iterPicYuvRec;
   }
@@ -446,14 +648,57 @@ Void TAppEncTop::xWriteOutput(std::ostream& bitstreamFile, Int iNumEncoded, cons
 
     const AccessUnit& au = *(iterBitstream++);
     const vector<unsigned>& stats = writeAnnexB(bitstreamFile, au);
-    rateStatsAccum(au, stats);
+    rateStatsAccum(au, stats, m_essentialBytes, m_totalBytes);
   }
 }
 
-/**
- *
+/** Write an access unit of the low-latency encoder and the reconstructions that are due in display order
+ * \param iPOC POC of the coded picture
+ * \param rcAccessUnit coded access unit
+ * \param pcPicYuvRec reconstruction of the picture
+ */
+Void TAppEncTop::accessUnitEncoded(Int iPOC, AccessUnit& rcAccessUnit, TComPicYuv* pcPicYuvRec)
+{
+  const vector<unsigned>& stats = writeAnnexB(*m_pcBitstreamFile, rcAccessUnit);
+  rateStatsAccum(rcAccessUnit, stats, m_essentialBytes, m_totalBytes);
+  m_pcBitstreamFile->flush();
+
+  if (!m_pchReconFile)
+  {
+    return;
+  }
+
+  // m_cListPicYuvRec holds the spare buffers of the reordering
+  TComPicYuv* pcPicYuvOut;
+  if ( m_cListPicYuvRec.empty() )
+  {
+    pcPicYuvOut = new TComPicYuv;
+    pcPicYuvOut->create( m_iSourceWidth, m_iSourceHeight, m_uiMaxCUWidth, m_uiMaxCUHeight, m_uiMaxCUDepth );
+  }
+  else
+  {
+    pcPicYuvOut = m_cListPicYuvRec.popFront();
+  }
+  pcPicYuvRec->copyToPic( pcPicYuvOut );
+  m_cReconReorder[iPOC] = pcPicYuvOut;
+
+  while ( !m_cReconReorder.empty() && m_cReconReorder.begin()->first == m_iNextReconPOC )
+  {
+    pcPicYuvOut = m_cReconReorder.begin()->second;
+    m_cTVideoIOYuvReconFile.write( pcPicYuvOut, m_cropLeft, m_cropRight, m_cropTop, m_cropBottom );
+    m_cListPicYuvRec.pushBack( pcPicYuvOut );
+    m_cReconReorder.erase( m_cReconReorder.begin() );
+    m_iNextReconPOC++;
+  }
+}
+
+/** Accumulate the sizes of the NAL units of an access unit
+ * \param au access unit
+ * \param annexBsizes sizes of its NAL units as written
+ * \param essentialBytes receives the bytes of the parameter sets and slices
+ * \param totalBytes receives the bytes of all NAL units
  */
-void TAppEncTop::rateStatsAccum(const AccessUnit& au, const std::vector<unsigned>& annexBsizes)
+void TAppEncTop::rateStatsAccum(const AccessUnit& au, const std::vector<unsigned>& annexBsizes, unsigned& essentialBytes, unsigned& totalBytes)
 {
   AccessUnit::const_iterator it_au = au.begin();
   vector<unsigned>::const_iterator it_stats = annexBsizes.begin();
@@ -473,22 +718,22 @@ void TAppEncTop::rateStatsAccum(const AccessUnit& au, const std::vector<unsigned
     case NAL_UNIT_VPS:
     case NAL_UNIT_SPS:
     case NAL_UNIT_PPS:
-      m_essentialBytes += *it_stats;
+      essentialBytes += *it_stats;
       break;
     default:
       break;
     }
 
-    m_totalBytes += *it_stats;
+    totalBytes += *it_stats;
   }
 }
 
-void TAppEncTop::printRateSummary()
+void TAppEncTop::printRateSummary(unsigned essentialBytes, unsigned totalBytes)
 {
   double time = (double) m_iFrameRcvd / m_iFrameRate;
-  printf("Bytes written to file: %u (%.3f kbps)\n", m_totalBytes, 0.008 * m_totalBytes / time);
+  printf("Bytes written to file: %u (%.3f kbps)\n", totalBytes, 0.008 * totalBytes / time);
 #if VERBOSE_RATE
-  printf("Bytes for SPS/PPS/Slice (Incl. Annex B): %u (%.3f kbps)\n", m_essentialBytes, 0.008 * m_essentialBytes / time);
+  printf("Bytes for SPS/PPS/Slice (Incl. Annex B): %u (%.3f kbps)\n", essentialBytes, 0.008 * essentialBytes / time);
 #endif
 }
 
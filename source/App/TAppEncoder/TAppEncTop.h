@@ -39,9 +39,15 @@
 #define __TAPPENCTOP__
 
 #include <list>
+#include <map>
 #include <ostream>
+#include <fstream>
+#include <vector>
 
 #include "TLibEncoder/TEncTop.h"
+#include "TLibEncoder/TEncOutputIf.h"
+#include "TLibEncoder/TEncSharedAnalysis.h"
+#include "TLibCommon/TComThread.h"
 #include "TLibVideoIO/TVideoIOYuv.h"
 #include "TLibCommon/AccessUnit.h"
 #include "TAppEncCfg.h"
@@ -53,8 +59,28 @@
 // Class definition
 // ====================================================================================================================
 
+/// further rendition of the source, coded by its own encoder next to the one of the application
+class TAppEncRendition : public TComJob
+{
+public:
+  TEncTop                    m_cTEncTop;                    ///< encoder of the rendition
+  std::fstream               m_cBitstreamFile;              ///< bitstream output of the rendition
+  char*                      m_pchBitstreamFile;            ///< bitstream file name
+  char*                      m_pchStatsFile;                ///< rate/lambda statistics file name, NULL if not written
+  TComList<TComPicYuv*>      m_cListPicYuvRec;              ///< reconstructions of the rendition
+  Bool                       m_bEos;                        ///< the latest received picture is the last one
+  Int                        m_iFrameEncoded;               ///< number of encoded frames
+  unsigned                   m_essentialBytes;
+  unsigned                   m_totalBytes;
+
+  TAppEncRendition();
+  virtual ~TAppEncRendition();
+
+  Void execute();                                           ///< code the received pictures that are due and write them
+};
+
 /// encoder application class
-class TAppEncTop : public TAppEncCfg
+class TAppEncTop : public TAppEncCfg, public TEncOutputIf
 {
 private:
   // class interface
@@ -65,26 +91,39 @@ private:
   TComList<TComPicYuv*>      m_cListPicYuvRec;              ///< list of reconstruction YUV files
   
   Int                        m_iFrameRcvd;                  ///< number of received frames
+  Int                        m_iFrameEncoded;               ///< number of encoded frames
   
   unsigned m_essentialBytes;
   unsigned m_totalBytes;
+
+  std::ostream*              m_pcBitstreamFile;             ///< bitstream output of accessUnitEncoded()
+  std::map<Int, TComPicYuv*> m_cReconReorder;               ///< reconstructions waiting for output in display order
+  Int                        m_iNextReconPOC;               ///< POC of the next reconstruction to write
+
+  std::vector<TAppEncRendition*> m_apcRenditions;           ///< further renditions, coded in parallel to m_cTEncTop
+  TEncSharedAnalysis         m_cSharedAnalysis;             ///< source analysis shared by all renditions
+  TComJobQueue               m_cRenditionQueue;             ///< codes the further renditions
 protected:
   // initialization
   Void  xCreateLib        ();                               ///< create files & encoder class
-  Void  xInitLibCfg       ();                               ///< initialize internal variables
+  Void  xInitLibCfg       ( TEncTop& rcTEncTop );           ///< initialize internal variables of an encoder
+  Void  xCreateRenditions ();                               ///< create and initialize the encoders of the further renditions
+  Void  xDestroyRenditions();                               ///< destroy the encoders of the further renditions
   Void  xInitLib          ();                               ///< initialize encoder class
   Void  xDestroyLib       ();                               ///< destroy encoder class
   
   /// obtain required buffers
-  Void xGetBuffer(TComPicYuv*& rpcPicYuvRec);
+  Void xGetBuffer(TComList<TComPicYuv*>& rcListPicYuvRec, TComPicYuv*& rpcPicYuvRec);
   
   /// delete allocated buffers
-  Void  xDeleteBuffer     ();
+  Void  xDeleteBuffer     ( TComList<TComPicYuv*>& rcListPicYuvRec );
   
   // file I/O
   Void xWriteOutput(std::ostream& bitstreamFile, Int iNumEncoded, const std::list<AccessUnit>& accessUnits); ///< write bitstream to file
-  void rateStatsAccum(const AccessUnit& au, const std::vector<unsigned>& stats);
-  void printRateSummary();
+  void printRateSummary(unsigned essentialBytes, unsigned totalBytes);
+  
+  /// output interface of the low-latency encoder
+  Void accessUnitEncoded(Int iPOC, AccessUnit& rcAccessUnit, TComPicYuv* pcPicYuvRec);
   
 public:
   TAppEncTop();
@@ -92,6 +131,8 @@ public:
   
   Void        encode      ();                               ///< main encoding function
   TEncTop&    getTEncTop  ()   { return  m_cTEncTop; }      ///< return encoder class pointer reference
+  
+  static void rateStatsAccum(const AccessUnit& au, const std::vector<unsigned>& stats, unsigned& essentialBytes, unsigned& totalBytes);
 };// END CLASS DEFINITION TAppEncTop
 
 //! \}
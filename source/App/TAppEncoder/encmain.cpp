@@ -38,9 +38,42 @@
 #include <time.h>
 #include "TAppEncTop.h"
 
+#if defined(_WIN32)
+#define NOMINMAX
+#include <windows.h>
+#include <psapi.h>
+#pragma comment(lib, "psapi.lib")
+#else
+#include <sys/resource.h>
+#endif
+
 //! \ingroup TAppEncoder
 //! \{
 
+/// peak resident memory of the process in MB, 0 if it cannot be determined
+static double getPeakMemoryMB()
+{
+#if defined(_WIN32)
+  PROCESS_MEMORY_COUNTERS pmc;
+  if (GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc)))
+  {
+    return pmc.PeakWorkingSetSize / (1024.0 * 1024.0);
+  }
+  return 0;
+#else
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) != 0)
+  {
+    return 0;
+  }
+#if defined(__APPLE__)
+  return usage.ru_maxrss / (1024.0 * 1024.0); // bytes
+#else
+  return usage.ru_maxrss / 1024.0;            // kilobytes
+#endif
+#endif
+}
+
 // ====================================================================================================================
 // Main function
 // ====================================================================================================================
@@ -77,6 +110,7 @@ int main(int argc, char* argv[])
   // ending time
   dResult = (double)(clock()-lBefore) / CLOCKS_PER_SEC;
   printf("\n Total Time: %12.3f sec.\n", dResult);
+  printf(" Peak Memory: %11.1f MB\n", getPeakMemoryMB());
 
   // destroy application encoder class
   cTAppEncTop.destroy();
@@ -0,0 +1,146 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.  
+ *
+ * Copyright (c) 2010-2012, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "SolveLambdaModifiers.h"
+#include <string>
+#include <sstream>
+#include <limits>
+#include <cassert>
+#include <cmath>
+
+std::vector< LayerStatistics > parseLayerStatistics( std::istream& i )
+{
+  std::vector< LayerStatistics > result;
+  
+  while( i.good( ) )
+  {
+    std::string line;
+    std::getline( i, line );
+    std::istringstream iLine( line );
+    
+    // Only the "layer" lines are used, the "pic" lines and the comments are skipped
+    std::string keyword;
+    iLine >> keyword;
+    if( keyword != "layer" ) continue;
+    
+    long temporalIdLong;
+    LayerStatistics layer;
+    iLine >> temporalIdLong >> layer.numPictures >> layer.averageBits >> layer.lambdaModifier;
+    if( iLine.fail( ) ) throw StatsParseException( );
+    if( temporalIdLong < 0 || ( long )std::numeric_limits< unsigned char >::max( ) < temporalIdLong ) throw StatsParseException( );
+    if( layer.averageBits <= 0.0 || layer.lambdaModifier <= 0.0 ) throw StatsParseException( );
+    layer.temporalId = ( unsigned char )temporalIdLong;
+    if( !result.empty( ) && layer.temporalId <= result.back( ).temporalId ) throw StatsParseException( );
+    
+    result.push_back( layer );
+  }
+  
+  if( result.empty( ) ) throw StatsParseException( );
+  return result;
+}
+
+double solveLambdaModifier( double targetBitrate, const LayerStatistics& layer, double rateSensitivity, double rateRatio )
+{
+  assert( 0.0 < targetBitrate );
+  assert( 0.0 < layer.averageBits );
+  assert( 0.0 < layer.lambdaModifier );
+  assert( rateSensitivity < 0.0 );
+  assert( 0.0 < rateRatio );
+  
+  // bits = c * lambdaModifier ^ rateSensitivity, with c known from the pass
+  return layer.lambdaModifier * std::pow( targetBitrate / ( rateRatio * layer.averageBits ), 1.0 / rateSensitivity );
+}
+
+namespace
+{
+  /// Formatted input for a target bitrate vector
+  /// \param left The input stream that contains the bitrates, separated by single spaces
+  /// \param right The vector to be written to
+  /// \pre right must be empty
+  void parseTargets( std::istream& left, std::vector< double >& right )
+  {
+    assert( right.empty( ) );
+    
+    for( ; ; )
+    {
+      double bitrate;
+      left >> bitrate;
+      if( left.fail( ) ) break;
+      if( bitrate <= ( double )0.0 )
+      {
+        left.setstate( std::istream::failbit );
+      }
+      else
+      {
+        right.push_back( bitrate );
+      }
+      if( !left.good( ) ) break;
+      
+      if( left.peek( ) == ' ' )
+      {
+        left.ignore( );
+      }
+      else
+      {
+        break;
+      }
+    }
+  }
+}
+
+void solveLambdaModifiers(
+    std::ostream& o,
+    std::istream& targetsIstream,
+    std::istream& statsIstream,
+    double rateSensitivity,
+    double rateRatio )
+{
+  // Parse the targets
+  std::vector< double > targetVector;
+  parseTargets( targetsIstream, targetVector );
+  if( targetVector.empty( ) || targetsIstream.fail( ) || targetsIstream.good( ) ) throw SolveTargetsParseException( );
+  
+  // Parse the statistics
+  std::vector< LayerStatistics > layerVector( parseLayerStatistics( statsIstream ) );
+  if( layerVector.size( ) != targetVector.size( ) ) throw MismatchedLayersException( );
+  
+  // Solve and output the results
+  o.setf( std::ostream::fixed, std::ostream::floatfield );
+  o.precision( 7 );
+  for( size_t i( 0 ); i < layerVector.size( ); ++i )
+  {
+    if( i != 0 ) o << " ";
+    o << "-LM" << ( long )layerVector[ i ].temporalId << " ";
+    o << solveLambdaModifier( targetVector[ i ], layerVector[ i ], rateSensitivity, rateRatio );
+  }
+}
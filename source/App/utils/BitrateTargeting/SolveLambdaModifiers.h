@@ -0,0 +1,113 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.  
+ *
+ * Copyright (c) 2010-2012, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef SOLVE_LAMBDA_MODIFIERS_H
+#define SOLVE_LAMBDA_MODIFIERS_H
+
+#include "RuntimeError.h"
+#include <vector>
+#include <istream>
+#include <ostream>
+
+/// Thrown if there is an error parsing the statistics file written by the encoder (StatsFile option)
+class StatsParseException: public RuntimeError
+{
+  public:
+    virtual ~StatsParseException( ) throw( ) { }
+  protected:
+    void outputWhat( std::ostream& o ) const { o << "Error parsing statistics"; }
+};
+
+/// Thrown if there is an error parsing the targets
+class SolveTargetsParseException: public RuntimeError
+{
+  public:
+    virtual ~SolveTargetsParseException( ) throw( ) { }
+  protected:
+    void outputWhat( std::ostream& o ) const { o << "Error parsing targets"; }
+};
+
+/// Thrown if the number of targets does not match the number of temporal layers in the statistics
+class MismatchedLayersException: public RuntimeError
+{
+  public:
+    virtual ~MismatchedLayersException( ) throw( ) { }
+  protected:
+    void outputWhat( std::ostream& o ) const { o << "Number of targets does not match the number of temporal layers"; }
+};
+
+/// Default sensitivity of the bitrate to the Lambda-modifier, the inverse of the exponent of the R-lambda model (lambda = alpha * bpp ^ -1.367)
+const double defaultRateSensitivity = -1.0 / 1.367;
+
+/// Rate statistics of the inter pictures of one temporal layer, as written in a "layer" line of the statistics file
+struct LayerStatistics
+{
+  unsigned char temporalId;
+  unsigned long numPictures;
+  double averageBits;
+  double lambdaModifier;
+};
+
+/// Parses the per-temporal-layer lines of a statistics file
+/// \param i The input stream that contains the statistics file
+/// \return The layer statistics in increasing temporal layer order
+/// \throw StatsParseException if a "layer" line cannot be parsed, the temporal layers are not increasing, or there are no layer lines
+std::vector< LayerStatistics > parseLayerStatistics( std::istream& i );
+
+/// Predicts the Lambda-modifier that reaches a target bitrate from a single pass
+/// The bitrate is modelled as proportional to the Lambda-modifier raised to the power of rateSensitivity.
+/// \param targetBitrate The target bitrate for this temporal layer
+/// \param layer The statistics of the pass for this temporal layer
+/// \param rateSensitivity The exponent of the bitrate model, must be negative
+/// \param rateRatio The ratio between the bitrates of the final encoding and of the pass at the same Lambda-modifier, e.g. to account for the reduced search of an analysis pass
+/// \return The Lambda-modifier guess
+/// \pre All of the values must be positive, except rateSensitivity which must be negative
+double solveLambdaModifier( double targetBitrate, const LayerStatistics& layer, double rateSensitivity, double rateRatio );
+
+/// Predicts all of the Lambda-modifiers from a single pass
+/// \param o The output stream to write the Lambda-modifiers to, in the format of guessLambdaModifiers
+/// \param targetsIstream The input stream that contains the target bitrates, one per temporal layer in the statistics
+/// \param statsIstream The input stream that contains the statistics file
+/// \param rateSensitivity The exponent of the bitrate model, must be negative
+/// \param rateRatio The ratio between the bitrates of the final encoding and of the pass at the same Lambda-modifier
+/// \throw SolveTargetsParseException if there is an error parsing the target bitrates
+/// \throw StatsParseException if there is an error parsing the statistics
+/// \throw MismatchedLayersException if the number of targets and temporal layers differ
+void solveLambdaModifiers(
+    std::ostream& o,
+    std::istream& targetsIstream,
+    std::istream& statsIstream,
+    double rateSensitivity,
+    double rateRatio );
+
+#endif
@@ -0,0 +1,93 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.  
+ *
+ * Copyright (c) 2010-2012, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "RuntimeError.h"
+#include "SolveLambdaModifiers.h"
+#include <iostream>
+
+class WrongNumberOfArgumentsException: public RuntimeError
+{
+  public:
+    virtual ~WrongNumberOfArgumentsException( ) throw( ) { }
+  protected:
+    void outputWhat( std::ostream& o ) const { o << "Wrong number of arguments"; }
+};
+
+/// Thrown if the rate sensitivity or the rate ratio cannot be parsed
+class ModelParameterParseException: public RuntimeError
+{
+  public:
+    virtual ~ModelParameterParseException( ) throw( ) { }
+  protected:
+    void outputWhat( std::ostream& o ) const { o << "Error parsing the rate-sensitivity or rate-ratio parameter"; }
+};
+
+/// Parses a model parameter given on the command line
+/// \throw ModelParameterParseException if the parameter is not a number or has the wrong sign
+double parseModelParameter( const char* pArg, bool negative )
+{
+  std::istringstream i( pArg );
+  double result;
+  i >> result;
+  if( i.fail( ) || !i.eof( ) || ( negative ? 0.0 <= result : result <= 0.0 ) ) throw ModelParameterParseException( );
+  return result;
+}
+
+/// Usage: solveLambdaModifiers "<targets>" [<rate sensitivity> [<rate ratio>]] < statsFile
+int main( int argc, char** ppArgv )
+{
+  try
+  {
+    if( argc < 2 || 4 < argc ) throw WrongNumberOfArgumentsException( );
+    
+    std::string targetBitratesString( ppArgv[ 1 ] );
+    std::istringstream targetBitratesIstream( targetBitratesString );
+    
+    double rateSensitivity( argc > 2 ? parseModelParameter( ppArgv[ 2 ], true ) : defaultRateSensitivity );
+    double rateRatio( argc > 3 ? parseModelParameter( ppArgv[ 3 ], false ) : 1.0 );
+    
+    solveLambdaModifiers( std::cout, targetBitratesIstream, std::cin, rateSensitivity, rateRatio );
+    return 0;
+  
+  }
+  catch( std::exception& e )
+  {
+    std::cerr << e.what( ) << std::endl;
+  }
+  catch( ... )
+  {
+    std::cerr << "Unknown exception" << std::endl;
+  }
+  return 1;
+}
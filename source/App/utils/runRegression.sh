@@ -0,0 +1,248 @@
+#! /bin/bash
+
+# The copyright in this software is being made available under the BSD
+# License, included below. This software may be subject to other third party
+# and contributor rights, including patent rights, and no such rights are
+# granted under this license.  
+#
+# Copyright (c) 2010-2012, ITU/ISO/IEC
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are met:
+#
+#  * Redistributions of source code must retain the above copyright notice,
+#    this list of conditions and the following disclaimer.
+#  * Redistributions in binary form must reproduce the above copyright notice,
+#    this list of conditions and the following disclaimer in the documentation
+#    and/or other materials provided with the distribution.
+#  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+#    be used to endorse or promote products derived from this software without
+#    specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+# AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+# IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+# ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+# BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+# CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+# SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+# INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+# CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+# ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+# THE POSSIBILITY OF SUCH DAMAGE.
+# Speed and quality regression harness.  Generates a deterministic synthetic sequence with synthetic_YCbCr, encodes it
+# with every encoder configuration file at several QPs, decodes each bitstream to verify the picture digest SEI and
+# writes one report line per encoding: speed (fps), peak memory, bitrate and PSNR.  Given the report of a baseline
+# build, it also prints per configuration the speed-up, the memory ratio and the BD-rate of this build.
+
+SCRIPT_DIRECTORY=$(cd "$(dirname "$0")" && pwd)
+
+BIN_DIRECTORY="$SCRIPT_DIRECTORY/../../../bin"
+CFG_DIRECTORY="$SCRIPT_DIRECTORY/../../../cfg"
+OUTPUT_DIRECTORY="regression"
+CONFIGURATIONS=""
+QPS="22 27 32 37"
+NUM_FRAMES=32
+SIZE="416x240"
+SCENE_LENGTH=8
+SEED=1
+EXTRA_ARGUMENTS=""
+BASELINE_REPORT=""
+
+function outputUsageAndExit {
+  echo "Usage: $0 [options]" >&2
+  echo "  -b binDirectory      directory of TAppEncoder, TAppDecoder and synthetic_YCbCr (default: bin of the tree)" >&2
+  echo "  -c cfgDirectory      directory of the encoder_*.cfg files (default: cfg of the tree)" >&2
+  echo "  -p \"names\"           configurations to run, e.g. \"intra_main lowdelay_P_main\" (default: all)" >&2
+  echo "  -o outputDirectory   directory of the sequence, bitstreams, logs and report (default: $OUTPUT_DIRECTORY)" >&2
+  echo "  -q \"qps\"             QPs of every configuration (default: \"$QPS\"); BD-rates need at least four" >&2
+  echo "  -f numFrames         number of frames (default: $NUM_FRAMES)" >&2
+  echo "  -s WxH               picture size (default: $SIZE)" >&2
+  echo "  -l sceneLength       frames between scene cuts (default: $SCENE_LENGTH)" >&2
+  echo "  -S seed              seed of the synthetic content (default: $SEED)" >&2
+  echo "  -e \"arguments\"       extra encoder arguments, e.g. the options of the feature under test" >&2
+  echo "  -r baselineReport    report of a baseline run to compare this run against" >&2
+  exit 1
+}
+
+# Find an executable of the given name, the static build is used when the dynamic one is missing
+function findExecutable {
+  local name
+  for name in "$1" "$1Static" "$1d" "$1Staticd" ; do
+    if [[ -x "$BIN_DIRECTORY/$name" ]] ; then
+      printf "$BIN_DIRECTORY/$name"
+      return
+    fi
+  done
+  printf "Cannot find $1 in $BIN_DIRECTORY.\n" >&2
+  exit 1
+}
+
+# Wall clock time in seconds
+function now {
+  date +%s.%N
+}
+
+while getopts "b:c:p:o:q:f:s:l:S:e:r:h" option ; do
+  case $option in
+    b) BIN_DIRECTORY="$OPTARG" ;;
+    c) CFG_DIRECTORY="$OPTARG" ;;
+    p) CONFIGURATIONS="$OPTARG" ;;
+    o) OUTPUT_DIRECTORY="$OPTARG" ;;
+    q) QPS="$OPTARG" ;;
+    f) NUM_FRAMES="$OPTARG" ;;
+    s) SIZE="$OPTARG" ;;
+    l) SCENE_LENGTH="$OPTARG" ;;
+    S) SEED="$OPTARG" ;;
+    e) EXTRA_ARGUMENTS="$OPTARG" ;;
+    r) BASELINE_REPORT="$OPTARG" ;;
+    *) outputUsageAndExit ;;
+  esac
+done
+
+WIDTH=${SIZE%x*}
+HEIGHT=${SIZE#*x}
+ENCODER=$(findExecutable TAppEncoder) || exit 1
+DECODER=$(findExecutable TAppDecoder) || exit 1
+GENERATOR=$(findExecutable synthetic_YCbCr) || exit 1
+if [[ "" == "$CONFIGURATIONS" ]] ; then
+  CONFIGURATIONS=$(cd "$CFG_DIRECTORY" && ls encoder_*.cfg | sed -e 's/^encoder_//' -e 's/\.cfg$//')
+fi
+if [[ "" != "$BASELINE_REPORT" && ! -f "$BASELINE_REPORT" ]] ; then
+  printf "Cannot read the baseline report $BASELINE_REPORT.\n" >&2
+  exit 1
+fi
+
+mkdir -p "$OUTPUT_DIRECTORY" || exit 1
+SEQUENCE="$OUTPUT_DIRECTORY/synthetic_${WIDTH}x${HEIGHT}_${NUM_FRAMES}_${SEED}.yuv"
+REPORT="$OUTPUT_DIRECTORY/report.txt"
+
+if [[ ! -f "$SEQUENCE" ]] ; then
+  "$GENERATOR" -o "$SEQUENCE" --SourceWidth=$WIDTH --SourceHeight=$HEIGHT --NumFrames=$NUM_FRAMES --SceneLength=$SCENE_LENGTH --Seed=$SEED > /dev/null || exit 1
+fi
+
+{
+  echo "# $(date -u '+%Y-%m-%d %H:%M:%S UTC') $(uname -n) $(grep -m1 'model name' /proc/cpuinfo 2>/dev/null | sed -e 's/.*: //')"
+  echo "# sequence ${WIDTH}x${HEIGHT}, $NUM_FRAMES frames, scene length $SCENE_LENGTH, seed $SEED, extra arguments: $EXTRA_ARGUMENTS"
+  echo "# configuration qp frames fps peakMB kbps psnrY psnrU psnrV bitstreamMD5 status"
+} > "$REPORT"
+
+FAILURES=0
+for configuration in $CONFIGURATIONS ; do
+  for qp in $QPS ; do
+    name="${configuration}_QP$qp"
+    bitstream="$OUTPUT_DIRECTORY/$name.bin"
+    reconstruction="$OUTPUT_DIRECTORY/${name}_rec.yuv"
+    decoded="$OUTPUT_DIRECTORY/${name}_dec.yuv"
+    start=$(now)
+    "$ENCODER" -c "$CFG_DIRECTORY/encoder_$configuration.cfg" -i "$SEQUENCE" -wdt $WIDTH -hgt $HEIGHT -fr 30 -f $NUM_FRAMES -q $qp \
+      -b "$bitstream" -o "$reconstruction" --SEIpictureDigest=1 $EXTRA_ARGUMENTS > "$OUTPUT_DIRECTORY/${name}_enc.log" 2>&1
+    encoderStatus=$?
+    end=$(now)
+
+    # the summary line of the encoder holds the number of frames, bitrate and PSNR
+    read frames kbps psnrY psnrU psnrV <<< $(grep -A2 '^SUMMARY' "$OUTPUT_DIRECTORY/${name}_enc.log" | tail -1 | awk '{ print $1, $3, $4, $5, $6 }')
+    # encoders without the peak memory report give n/a
+    peakMB=$(sed -n -e 's/^ *Peak Memory: *\([0-9.]*\).*/\1/p' "$OUTPUT_DIRECTORY/${name}_enc.log")
+    status=ok
+    if [[ $encoderStatus != 0 || "" == "$frames" ]] ; then
+      status=encoderFailure
+    else
+      "$DECODER" -b "$bitstream" -o "$decoded" > "$OUTPUT_DIRECTORY/${name}_dec.log" 2>&1
+      if [[ $? != 0 ]] ; then
+        status=decoderFailure
+      elif grep -q 'ERROR' "$OUTPUT_DIRECTORY/${name}_dec.log" || [[ $(grep -c '(OK)' "$OUTPUT_DIRECTORY/${name}_dec.log") != $frames ]] ; then
+        status=digestMismatch
+      elif ! cmp -s "$reconstruction" "$decoded" ; then
+        status=reconstructionMismatch
+      fi
+    fi
+    [[ $status != ok ]] && FAILURES=$((FAILURES + 1))
+    fps=$(awk -v f="${frames:-0}" -v s="$start" -v e="$end" 'BEGIN { printf "%.3f", (e > s ? f / (e - s) : 0) }')
+    md5=$(md5sum < "$bitstream" 2>/dev/null | cut -c1-32)
+    echo "$configuration $qp ${frames:-0} $fps ${peakMB:-n/a} ${kbps:-0} ${psnrY:-0} ${psnrU:-0} ${psnrV:-0} ${md5:-none} $status" | tee -a "$REPORT"
+    rm -f "$reconstruction" "$decoded"
+  done
+done
+
+if [[ "" != "$BASELINE_REPORT" ]] ; then
+  echo
+  echo "Comparison against $BASELINE_REPORT"
+  # BD-rate: cubic fit of log(bitrate) over Y-PSNR through the points of each run, integrated over the
+  # common PSNR interval.  Negative values are bitrate savings of this run.
+  awk '
+    function fitCubic(n, xs, ys, c,    m, i, j, k, r, p, t) {
+      for (i = 0; i < 4; i++) {
+        for (j = 0; j <= 4; j++) m[i, j] = 0
+        for (k = 0; k < n; k++) {
+          for (j = 0; j < 4; j++) m[i, j] += xs[k] ^ (i + j)
+          m[i, 4] += ys[k] * xs[k] ^ i
+        }
+      }
+      for (i = 0; i < 4; i++) {
+        p = i
+        for (r = i + 1; r < 4; r++) if ((m[r, i] < 0 ? -m[r, i] : m[r, i]) > (m[p, i] < 0 ? -m[p, i] : m[p, i])) p = r
+        for (j = 0; j <= 4; j++) { t = m[i, j]; m[i, j] = m[p, j]; m[p, j] = t }
+        for (r = 0; r < 4; r++) {
+          if (r == i || m[i, i] == 0) continue
+          t = m[r, i] / m[i, i]
+          for (j = 0; j <= 4; j++) m[r, j] -= t * m[i, j]
+        }
+      }
+      for (i = 0; i < 4; i++) c[i] = m[i, i] != 0 ? m[i, 4] / m[i, i] : 0
+    }
+    function integral(c, lo, hi,    i, s) {
+      s = 0
+      for (i = 0; i < 4; i++) s += c[i] * (hi ^ (i + 1) - lo ^ (i + 1)) / (i + 1)
+      return s
+    }
+    /^#/ { next }
+    {
+      run = FILENAME == ARGV[1] ? 0 : 1
+      cfg = $1
+      if (!(cfg in seen)) { seen[cfg] = 1; order[numCfg++] = cfg }
+      k = cfg SUBSEP run
+      idx = count[k]++
+      psnr[k, idx] = $7; rate[k, idx] = $6 > 0 ? log($6) : 0
+      logFps[k] += $4 > 0 ? log($4) : 0
+      if ($5 != "n/a") { peak[k] += $5; numPeak[k]++ }
+      md5[cfg, run, $2] = $10
+      if ($11 != "ok") failed[k] = 1
+    }
+    END {
+      printf "%-24s %9s %9s %10s %10s %s\n", "configuration", "speed-up", "memory", "BD-rate Y", "bitstreams", "status"
+      for (i = 0; i < numCfg; i++) {
+        cfg = order[i]; b = cfg SUBSEP 0; t = cfg SUBSEP 1
+        if (!(b in count) || !(t in count)) { printf "%-24s   only in one report\n", cfg; continue }
+        speedup = exp(logFps[t] / count[t] - logFps[b] / count[b])
+        memory = "n/a"
+        if (numPeak[b] > 0 && numPeak[t] > 0 && peak[b] > 0) memory = sprintf("%.3fx", (peak[t] / numPeak[t]) / (peak[b] / numPeak[b]))
+        bd = "n/a"
+        if (count[b] >= 4 && count[t] >= 4) {
+          for (run = 0; run < 2; run++) {
+            k = cfg SUBSEP run; lo[run] = 1e9; hi[run] = -1e9
+            for (j = 0; j < count[k]; j++) {
+              xs[j] = psnr[k, j]; ys[j] = rate[k, j]
+              if (xs[j] < lo[run]) lo[run] = xs[j]
+              if (xs[j] > hi[run]) hi[run] = xs[j]
+            }
+            fitCubic(count[k], xs, ys, coef)
+            for (j = 0; j < 4; j++) c[run, j] = coef[j]
+          }
+          from = lo[0] > lo[1] ? lo[0] : lo[1]; to = hi[0] < hi[1] ? hi[0] : hi[1]
+          if (to > from) {
+            for (j = 0; j < 4; j++) { cb[j] = c[0, j]; ct[j] = c[1, j] }
+            bd = sprintf("%+.2f%%", (exp((integral(ct, from, to) - integral(cb, from, to)) / (to - from)) - 1) * 100)
+          }
+        }
+        same = "identical"
+        for (key in md5) { split(key, part, SUBSEP); if (part[1] == cfg && md5[cfg, 0, part[3]] != md5[cfg, 1, part[3]]) same = "differ" }
+        printf "%-24s %8.3fx %9s %10s %10s %s\n", cfg, speedup, memory, bd, same, (failed[t] ? "FAILED" : "ok")
+      }
+    }' "$BASELINE_REPORT" "$REPORT"
+fi
+
+echo
+echo "Report written to $REPORT, $FAILURES failures"
+[[ $FAILURES == 0 ]]
@@ -0,0 +1,276 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.  
+ *
+ * Copyright (c) 2010-2012, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** \file     synthetic_YCbCr.cpp
+    \brief    Generator of deterministic synthetic 4:2:0 test sequences
+*/
+
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#include "TLibCommon/TComPicYuv.h"
+#include "TLibVideoIO/TVideoIOYuv.h"
+#include "TAppCommon/program_options_lite.h"
+
+using namespace std;
+namespace po = df::program_options_lite;
+
+/// content of one scene; the scenes of a sequence are separated by hard cuts
+enum SceneType
+{
+  SCENE_GRADIENT = 0,   ///< moving gradients with a moving object
+  SCENE_PAN,            ///< texture panning at a sub-pel velocity
+  SCENE_NOISE,          ///< static texture with strong temporal noise
+  SCENE_MIXED,          ///< panning texture, moving gradient object and light noise
+  NUM_SCENE_TYPES
+};
+
+static const double PI = 3.14159265358979323846;
+
+static const char* s_sceneNames[NUM_SCENE_TYPES] = { "gradient", "pan", "noise", "mixed" };
+
+/// parameters of one scene, drawn from the seed
+struct Scene
+{
+  SceneType type;
+  unsigned  seed;       ///< seed of the texture lattice
+  double    velX;       ///< motion in samples per frame
+  double    velY;
+  double    objVelX;    ///< motion of the object in samples per frame
+  double    objVelY;
+  double    noise;      ///< amplitude of the temporal noise in 8-bit units
+  int       cb;         ///< mean chroma
+  int       cr;
+};
+
+/// deterministic pseudo random numbers (xorshift32)
+static unsigned nextRand(unsigned& state)
+{
+  state ^= state << 13;
+  state ^= state >> 17;
+  state ^= state << 5;
+  return state;
+}
+
+/// uniformly distributed value in [lo, hi]
+static double randRange(unsigned& state, double lo, double hi)
+{
+  return lo + (hi - lo) * (nextRand(state) & 0xffff) / 65535.0;
+}
+
+/// value in [0, 255] attached to an integer lattice point
+static double latticeValue(int x, int y, unsigned seed)
+{
+  unsigned h = (unsigned)x * 0x8da6b343u ^ (unsigned)y * 0xd8163841u ^ seed * 0xcb1ab31fu;
+  h ^= h >> 13;
+  h *= 0x5bd1e995u;
+  h ^= h >> 15;
+  return (h & 0xff);
+}
+
+/// smooth value noise of the given lattice spacing, continuous in x and y
+static double valueNoise(double x, double y, int spacing, unsigned seed)
+{
+  double fx = x / spacing;
+  double fy = y / spacing;
+  int    ix = (int)floor(fx);
+  int    iy = (int)floor(fy);
+  double tx = fx - ix;
+  double ty = fy - iy;
+  tx = tx * tx * (3 - 2 * tx);
+  ty = ty * ty * (3 - 2 * ty);
+  double top    = latticeValue(ix, iy,     seed) * (1 - tx) + latticeValue(ix + 1, iy,     seed) * tx;
+  double bottom = latticeValue(ix, iy + 1, seed) * (1 - tx) + latticeValue(ix + 1, iy + 1, seed) * tx;
+  return top * (1 - ty) + bottom * ty;
+}
+
+/// natural looking texture in [0, 255]: two octaves of value noise and a fine grain
+static double texture(double x, double y, unsigned seed)
+{
+  return 0.55 * valueNoise(x, y, 32, seed) + 0.35 * valueNoise(x, y, 6, seed + 1) + 0.10 * latticeValue((int)floor(x), (int)floor(y), seed + 2);
+}
+
+/// sample of one component at picture position (x, y) in luma units, in [0, 255] before noise
+static double sceneSample(const Scene& scene, int comp, double x, double y, int frame, int width, int height)
+{
+  double t = frame;
+  double val;
+  switch (scene.type)
+  {
+  case SCENE_GRADIENT:
+    {
+      double phase = (x + scene.velX * t) / width + (y + scene.velY * t) / height;
+      val = comp ? 128 + 40 * sin(2 * PI * (phase + 0.3 * comp)) : 128 + 100 * sin(PI * phase);
+      break;
+    }
+  case SCENE_PAN:
+  case SCENE_NOISE:
+    {
+      double px = scene.type == SCENE_PAN ? x + scene.velX * t : x;
+      double py = scene.type == SCENE_PAN ? y + scene.velY * t : y;
+      val = comp ? 128 + 0.3 * (texture(px, py, scene.seed + 16 * comp) - 128) : texture(px, py, scene.seed);
+      break;
+    }
+  default:
+    {
+      val = comp ? 128 + 0.3 * (texture(x + scene.velX * t, y + scene.velY * t, scene.seed + 16 * comp) - 128)
+                 : texture(x + scene.velX * t, y + scene.velY * t, scene.seed);
+      break;
+    }
+  }
+
+  // moving object: a gradient filled rectangle of a quarter of the picture
+  if (scene.type == SCENE_GRADIENT || scene.type == SCENE_MIXED)
+  {
+    double ox = fmod(width  / 8.0 + scene.objVelX * t + 4.0 * width,  (double)width);
+    double oy = fmod(height / 8.0 + scene.objVelY * t + 4.0 * height, (double)height);
+    double rx = x - ox;
+    double ry = y - oy;
+    if (rx >= 0 && rx < width / 4 && ry >= 0 && ry < height / 4)
+    {
+      val = comp ? (comp == 1 ? scene.cb : scene.cr) : 40 + 180 * (rx + ry) / (width / 4 + height / 4);
+    }
+  }
+  return val;
+}
+
+/** Draw one frame of a scene
+ * \param frame      picture to fill
+ * \param scene      scene parameters
+ * \param frameIdx   frame index within the scene
+ * \param bitDepth   bit depth of the samples
+ * \param noiseState state of the noise generator
+ */
+static void drawFrame(TComPicYuv& frame, const Scene& scene, int frameIdx, int bitDepth, unsigned& noiseState)
+{
+  int width  = frame.getWidth();
+  int height = frame.getHeight();
+  int maxVal = (1 << bitDepth) - 1;
+  double scale = (double)(1 << (bitDepth - 8));
+  for (int comp = 0; comp < 3; comp++)
+  {
+    Pel* plane   = comp == 0 ? frame.getLumaAddr() : comp == 1 ? frame.getCbAddr() : frame.getCrAddr();
+    int  stride  = comp ? frame.getCStride() : frame.getStride();
+    int  shift   = comp ? 1 : 0;
+    for (int y = 0; y < height >> shift; y++)
+    {
+      for (int x = 0; x < width >> shift; x++)
+      {
+        double val = sceneSample(scene, comp, (double)(x << shift), (double)(y << shift), frameIdx, width, height);
+        if (scene.noise > 0)
+        {
+          // sum of three uniform values approximates a gaussian
+          double n = randRange(noiseState, -1, 1) + randRange(noiseState, -1, 1) + randRange(noiseState, -1, 1);
+          val += n * scene.noise / (comp ? 2 : 1);
+        }
+        int sample = (int)floor(val * scale + 0.5);
+        plane[x] = (Pel)(sample < 0 ? 0 : sample > maxVal ? maxVal : sample);
+      }
+      plane += stride;
+    }
+  }
+}
+
+int main(int argc, const char** argv)
+{
+  bool do_help;
+  string filename_out;
+  unsigned int width, height;
+  unsigned int bitdepth_out;
+  unsigned int num_frames;
+  unsigned int scene_length;
+  unsigned int seed;
+
+  po::Options opts;
+  opts.addOptions()
+  ("help", do_help, false, "this help text")
+  ("OutputFile,o", filename_out, string(""), "output file")
+  ("SourceWidth", width, 416u, "picture width, a multiple of 8")
+  ("SourceHeight", height, 240u, "picture height, a multiple of 8")
+  ("OutputBitDepth", bitdepth_out, 8u, "bit-depth of output file (8..16)")
+  ("NumFrames", num_frames, 64u, "number of frames to generate")
+  ("SceneLength", scene_length, 16u, "number of frames between scene cuts")
+  ("Seed", seed, 1u, "seed of the content, equal seeds give identical sequences")
+  ;
+
+  po::setDefaults(opts);
+  po::scanArgv(opts, argc, argv);
+
+  if (argc == 1 || do_help)
+  {
+    /* argc == 1: no options have been specified */
+    po::doHelp(cout, opts);
+    return EXIT_FAILURE;
+  }
+  if (filename_out.empty() || width == 0 || height == 0 || width % 8 || height % 8 || bitdepth_out < 8 || bitdepth_out > 16 || scene_length == 0)
+  {
+    cerr << "invalid arguments, see --help" << endl;
+    return EXIT_FAILURE;
+  }
+
+  TVideoIOYuv output;
+  output.open((char*)filename_out.c_str(), true, bitdepth_out, bitdepth_out);
+
+  TComPicYuv frame;
+  frame.create( width, height, 1, 1, 0 );
+
+  unsigned sceneState = seed ? seed : 1;
+  unsigned noiseState = sceneState ^ 0x9e3779b9u;
+  Scene    scene = Scene();
+  for (unsigned int i = 0; i < num_frames; i++)
+  {
+    if (i % scene_length == 0)
+    {
+      // scene cut: the types cycle, so that every type is present in sequences of four scenes or more
+      scene.type    = (SceneType)((i / scene_length) % NUM_SCENE_TYPES);
+      scene.seed    = nextRand(sceneState);
+      scene.velX    = randRange(sceneState, -3, 3);
+      scene.velY    = randRange(sceneState, -2, 2);
+      scene.objVelX = randRange(sceneState, -6, 6);
+      scene.objVelY = randRange(sceneState, -4, 4);
+      scene.noise   = scene.type == SCENE_NOISE ? 6 : scene.type == SCENE_MIXED ? 1.5 : 0;
+      scene.cb      = (int)randRange(sceneState, 64, 192);
+      scene.cr      = (int)randRange(sceneState, 64, 192);
+      cout << "frame " << i << ": " << s_sceneNames[scene.type] << " scene" << endl;
+    }
+    drawFrame(frame, scene, i % scene_length, bitdepth_out, noiseState);
+    output.write(&frame);
+  }
+
+  output.close();
+  frame.destroy();
+
+  return EXIT_SUCCESS;
+}
@@ -39,6 +39,7 @@
 #define __COMMONDEF__
 
 #include <algorithm>
+#include <stdlib.h>
 
 #if _MSC_VER > 1000
 // disable "signed and unsigned mismatch"
@@ -94,6 +95,12 @@
 
 #define NVM_BITS          "[%d bit] ", (sizeof(void*) == 8 ? 64 : 32) ///< used for checking 64-bit O/S
 
+#if SIMD_SSE2 && ( defined(__SSE2__) || defined(_M_X64) || ( defined(_M_IX86_FP) && _M_IX86_FP >= 2 ) )
+#define HAS_SSE2          1                     ///< SSE2 kernels are compiled in
+#else
+#define HAS_SSE2          0
+#endif
+
 #ifndef NULL
 #define NULL              0
 #endif
@@ -131,10 +138,19 @@ template <typename T> inline T Clip(T x) { return std::min<T>(T(g_uiIBDI_MAX), s
 /** clip a, such that minVal <= a <= maxVal */
 template <typename T> inline T Clip3( T minVal, T maxVal, T a) { return std::min<T> (std::max<T> (minVal, a) , maxVal); }  ///< general min/max clip
 
-#define DATA_ALIGN                  1                                                                 ///< use 32-bit aligned malloc/free
+#define DATA_ALIGN                  1                                                                 ///< use cache-line (64-byte) aligned malloc/free
 #if     DATA_ALIGN && _WIN32 && ( _MSC_VER > 1300 )
-#define xMalloc( type, len )        _aligned_malloc( sizeof(type)*(len), 32 )
+#define xMalloc( type, len )        _aligned_malloc( sizeof(type)*(len), 64 )
 #define xFree( ptr )                _aligned_free  ( ptr )
+#elif   DATA_ALIGN && !_WIN32
+/** malloc with 64-byte alignment, released with free() */
+inline Void* xAlignedMalloc( size_t uiSize )
+{
+  Void* p = NULL;
+  return posix_memalign( &p, 64, uiSize ) == 0 ? p : NULL;
+}
+#define xMalloc( type, len )        xAlignedMalloc( sizeof(type)*(len) )
+#define xFree( ptr )                free     ( ptr )
 #else
 #define xMalloc( type, len )        malloc   ( sizeof(type)*(len) )
 #define xFree( ptr )                free     ( ptr )
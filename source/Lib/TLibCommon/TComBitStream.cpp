@@ -37,6 +37,7 @@
 
 #include <stdint.h>
 #include <vector>
+#include <algorithm>
 #include "TComBitStream.h"
 #include <string.h>
 #include <memory.h>
@@ -80,11 +81,13 @@ TComInputBitstream::~TComInputBitstream()
 
 char* TComOutputBitstream::getByteStream() const
 {
+  xFlushBytes();
   return (char*) &m_fifo->front();
 }
 
 unsigned int TComOutputBitstream::getByteStreamLength()
 {
+  xFlushBytes();
   return unsigned(m_fifo->size());
 }
 
@@ -95,47 +98,51 @@ void TComOutputBitstream::clear()
   m_num_held_bits = 0;
 }
 
-Void TComOutputBitstream::write   ( UInt uiBits, UInt uiNumberOfBits )
+/**
+ * move the whole bytes held in the accumulator to the fifo, leaving
+ * fewer than 8 held bits.
+ */
+Void TComOutputBitstream::xFlushBytes() const
 {
-  assert( uiNumberOfBits <= 32 );
-
-  /* any modulo 8 remainder of num_total_bits cannot be written this time,
-   * and will be held until next time. */
-  unsigned num_total_bits = uiNumberOfBits + m_num_held_bits;
-  unsigned next_num_held_bits = num_total_bits % 8;
-
-  /* form a byte aligned word (write_bits), by concatenating any held bits
-   * with the new bits, discarding the bits that will form the next_held_bits.
-   * eg: H = held bits, V = n new bits        /---- next_held_bits
-   * len(H)=7, len(V)=1: ... ---- HHHH HHHV . 0000 0000, next_num_held_bits=0
-   * len(H)=7, len(V)=2: ... ---- HHHH HHHV . V000 0000, next_num_held_bits=1
-   * if total_bits < 8, the value of v_ is not used */
-  unsigned char next_held_bits = uiBits << (8 - next_num_held_bits);
-
-  if (!(num_total_bits >> 3))
+  unsigned num_bytes = m_num_held_bits >> 3;
+  if (num_bytes == 0)
   {
-    /* insufficient bits accumulated to write out, append new_held_bits to
-     * current held_bits */
-    /* NB, this requires that v only contains 0 in bit positions {31..n} */
-    m_held_bits |= next_held_bits;
-    m_num_held_bits = next_num_held_bits;
     return;
   }
 
-  /* topword serves to justify held_bits to align with the msb of uiBits */
-  unsigned topword = (uiNumberOfBits - next_num_held_bits) & ~((1 << 3) -1);
-  unsigned int write_bits = (m_held_bits << topword) | (uiBits >> next_num_held_bits);
+  size_t size = m_fifo->size();
+  if (size + num_bytes > m_fifo->capacity())
+  {
+    /* grow geometrically from a reasonable minimum to avoid many small reallocations */
+    m_fifo->reserve(max<size_t>(2 * m_fifo->capacity(), max<size_t>(size + num_bytes, 1024)));
+  }
+  m_fifo->resize(size + num_bytes);
 
-  switch (num_total_bits >> 3)
+  uint8_t* dst = &(*m_fifo)[size];
+  unsigned remainder = m_num_held_bits & 0x7;
+  for (unsigned i = 0; i < num_bytes; i++)
   {
-  case 4: m_fifo->push_back(write_bits >> 24);
-  case 3: m_fifo->push_back(write_bits >> 16);
-  case 2: m_fifo->push_back(write_bits >> 8);
-  case 1: m_fifo->push_back(write_bits);
+    dst[i] = uint8_t(m_held_bits >> (remainder + 8 * (num_bytes - 1 - i)));
   }
 
-  m_held_bits = next_held_bits;
-  m_num_held_bits = next_num_held_bits;
+  m_held_bits &= (UInt64(1) << remainder) - 1;
+  m_num_held_bits = remainder;
+}
+
+Void TComOutputBitstream::write   ( UInt uiBits, UInt uiNumberOfBits )
+{
+  assert( uiNumberOfBits <= 32 );
+
+  /* bits are appended to a 64-bit accumulator and only moved to the fifo,
+   * a whole number of bytes at a time, when the accumulator would overflow
+   * or when the fifo is accessed.
+   * NB, this requires that uiBits only contains 0 in bit positions {31..n} */
+  if (m_num_held_bits + uiNumberOfBits > 64)
+  {
+    xFlushBytes();
+  }
+  m_held_bits = (m_held_bits << uiNumberOfBits) | uiBits;
+  m_num_held_bits += uiNumberOfBits;
 }
 
 Void TComOutputBitstream::writeAlignOne()
@@ -147,13 +154,10 @@ Void TComOutputBitstream::writeAlignOne()
 
 Void TComOutputBitstream::writeAlignZero()
 {
-  if (0 == m_num_held_bits)
-  {
-    return;
-  }
-  m_fifo->push_back(m_held_bits);
-  m_held_bits = 0;
-  m_num_held_bits = 0;
+  unsigned num_bits = getNumBitsUntilByteAligned();
+  m_held_bits <<= num_bits;
+  m_num_held_bits += num_bits;
+  xFlushBytes();
 }
 
 /**
@@ -166,9 +170,25 @@ Void   TComOutputBitstream::addSubstream( TComOutputBitstream* pcSubstream )
   UInt uiNumBits = pcSubstream->getNumberOfWrittenBits();
 
   const vector<uint8_t>& rbsp = pcSubstream->getFIFO();
-  for (vector<uint8_t>::const_iterator it = rbsp.begin(); it != rbsp.end();)
+  xFlushBytes();
+  if (m_num_held_bits == 0)
+  {
+    /* byte-aligned: append the bytes in one go */
+    m_fifo->insert(m_fifo->end(), rbsp.begin(), rbsp.end());
+  }
+  else
   {
-    write(*it++, 8);
+    /* not aligned: shift the bytes in through the accumulator, four at a time */
+    size_t n = rbsp.size();
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+      write((UInt(rbsp[i]) << 24) | (UInt(rbsp[i+1]) << 16) | (UInt(rbsp[i+2]) << 8) | UInt(rbsp[i+3]), 32);
+    }
+    for (; i < n; i++)
+    {
+      write(rbsp[i], 8);
+    }
   }
   if (uiNumBits&0x7)
   {
@@ -276,6 +296,8 @@ void TComOutputBitstream::insertAt(const TComOutputBitstream& src, unsigned pos)
 {
   unsigned src_bits = src.getNumberOfWrittenBits();
   assert(0 == src_bits % 8);
+  src.xFlushBytes();
+  xFlushBytes();
 
   vector<uint8_t>::iterator at = this->m_fifo->begin() + pos;
   this->m_fifo->insert(at, src.m_fifo->begin(), src.m_fifo->end());
@@ -293,6 +315,8 @@ Void TComInputBitstream::readOutTrailingBits ()
 
 TComOutputBitstream& TComOutputBitstream::operator= (const TComOutputBitstream& src)
 {
+  src.xFlushBytes();
+  xFlushBytes();
   vector<uint8_t>::iterator at = this->m_fifo->begin();
   this->m_fifo->insert(at, src.m_fifo->begin(), src.m_fifo->end());
 
@@ -82,9 +82,12 @@ class TComOutputBitstream : public TComBitIf
    */
   std::vector<uint8_t> *m_fifo;
 
-  unsigned int m_num_held_bits; /// number of bits not flushed to bytestream.
-  unsigned char m_held_bits; /// the bits held and not flushed to bytestream.
-                             /// this value is always msb-aligned, bigendian.
+  mutable unsigned int m_num_held_bits; /// number of bits not flushed to bytestream, less than 64.
+  mutable UInt64 m_held_bits; /// the bits held and not flushed to bytestream.
+                              /// this value is lsb-aligned, the oldest bit is the most significant one.
+                              /// whole bytes are moved to the fifo by xFlushBytes() before the fifo is accessed.
+
+  Void xFlushBytes() const;
 
 public:
   // create / destroy
@@ -143,13 +146,14 @@ public:
   /**
    * Return a reference to the internal fifo
    */
-  std::vector<uint8_t>& getFIFO() { return *m_fifo; }
+  std::vector<uint8_t>& getFIFO() { xFlushBytes(); return *m_fifo; }
 
-  UChar getHeldBits  ()          { return m_held_bits;          }
+  /** Return the bits of the incomplete last byte, msb-aligned */
+  UChar getHeldBits  ()          { xFlushBytes(); return UChar( m_held_bits << ( 8 - m_num_held_bits ) ); }
 
   TComOutputBitstream& operator= (const TComOutputBitstream& src);
   /** Return a reference to the internal fifo */
-  std::vector<uint8_t>& getFIFO() const { return *m_fifo; }
+  std::vector<uint8_t>& getFIFO() const { xFlushBytes(); return *m_fifo; }
 
   Void          addSubstream    ( TComOutputBitstream* pcSubstream );
 #if BYTE_ALIGNMENT
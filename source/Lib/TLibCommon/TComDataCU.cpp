@@ -46,8 +46,15 @@
 Int * TComDataCU::m_pcGlbArlCoeffY  = NULL;
 Int * TComDataCU::m_pcGlbArlCoeffCb = NULL;
 Int * TComDataCU::m_pcGlbArlCoeffCr = NULL;
+UInt  TComDataCU::m_uiGlbArlCoeffRefs = 0;
 #endif
 
+/// round an arena sub-buffer size up so that the following buffer starts 32-byte aligned
+static inline UInt xAlignArenaSize( UInt uiSize )
+{
+  return ( uiSize + 31 ) & ~31;
+}
+
 // ====================================================================================================================
 // Constructor / destructor / create / destroy
 // ====================================================================================================================
@@ -119,6 +126,8 @@ TComDataCU::TComDataCU()
   m_bDecSubCu          = false;
   m_uiSliceStartCU        = 0;
   m_uiDependentSliceStartCU = 0;
+  m_puhArena           = NULL;
+  m_uiArenaNumPart     = 0;
 }
 
 TComDataCU::~TComDataCU()
@@ -138,52 +147,91 @@ Void TComDataCU::create(UInt uiNumPartition, UInt uiWidth, UInt uiHeight, Bool b
   m_uiNumPartition     = uiNumPartition;
   m_unitSize = unitSize;
   
+  // all per-partition data of the CU lives in one arena: the one-byte fields field-major (CUPartField), followed
+  // by the motion fields, the slice start arrays, the coefficient, ARL and PCM sample buffers. Decoder sub-CUs alias
+  // the picture CU for everything but the slice start arrays.
+  assert( sizeof(Bool) == 1 );
+  UInt uiNumSamples   = uiWidth*uiHeight;
+  UInt uiMvFieldSize  = xAlignArenaSize( TComCUMvField::getMemorySize( uiNumPartition ) );
+  UInt uiFieldsSize   = bDecSubCu ? 0 : xAlignArenaSize( NUM_CU_PART_FIELDS * uiNumPartition );
+  UInt uiSliceSize    = xAlignArenaSize( sizeof(UInt) * uiNumPartition );
+  UInt uiCoeffSize    = xAlignArenaSize( sizeof(TCoeff) * uiNumSamples ) + 2 * xAlignArenaSize( sizeof(TCoeff) * uiNumSamples/4 );
+  UInt uiPelSize      = xAlignArenaSize( sizeof(Pel) * uiNumSamples )    + 2 * xAlignArenaSize( sizeof(Pel) * uiNumSamples/4 );
+#if ADAPTIVE_QP_SELECTION
+  UInt uiArlSize      = bGlobalRMARLBuffer ? 0 : xAlignArenaSize( sizeof(Int) * uiNumSamples ) + 2 * xAlignArenaSize( sizeof(Int) * uiNumSamples/4 );
+#else
+  UInt uiArlSize      = 0;
+#endif
+  UInt uiArenaSize    = 2 * uiSliceSize;
+  if ( !bDecSubCu )
+  {
+    uiArenaSize += uiFieldsSize + 2 * uiMvFieldSize + uiCoeffSize + uiArlSize + uiPelSize;
+  }
+
+  m_puhArena          = (UChar*)xMalloc( UChar, uiArenaSize );
+  m_uiArenaNumPart    = uiNumPartition;
+  memset( m_puhArena, 0, uiArenaSize );
+  UChar* puhCur       = m_puhArena + uiFieldsSize;
+
   if ( !bDecSubCu )
   {
-    m_phQP               = (Char*     )xMalloc(Char,     uiNumPartition);
-    m_puhDepth           = (UChar*    )xMalloc(UChar,    uiNumPartition);
-    m_puhWidth           = (UChar*    )xMalloc(UChar,    uiNumPartition);
-    m_puhHeight          = (UChar*    )xMalloc(UChar,    uiNumPartition);
+    m_phQP               = (Char*  )xGetPartField( CU_FIELD_QP );
+    m_puhDepth           = (UChar* )xGetPartField( CU_FIELD_DEPTH );
+    m_puhWidth           = (UChar* )xGetPartField( CU_FIELD_WIDTH );
+    m_puhHeight          = (UChar* )xGetPartField( CU_FIELD_HEIGHT );
 
 #if SKIP_FLAG
-    m_skipFlag           = new Bool[ uiNumPartition ];
+    m_skipFlag           = (Bool*  )xGetPartField( CU_FIELD_SKIP_FLAG );
 #endif
 
-    m_pePartSize         = new Char[ uiNumPartition ];
+    m_pePartSize         = (Char*  )xGetPartField( CU_FIELD_PART_SIZE );
     memset( m_pePartSize, SIZE_NONE,uiNumPartition * sizeof( *m_pePartSize ) );
-    m_pePredMode         = new Char[ uiNumPartition ];
-    m_CUTransquantBypass = new Bool[ uiNumPartition ];
-    m_pbMergeFlag        = (Bool*  )xMalloc(Bool,   uiNumPartition);
-    m_puhMergeIndex      = (UChar* )xMalloc(UChar,  uiNumPartition);
-    m_puhLumaIntraDir    = (UChar* )xMalloc(UChar,  uiNumPartition);
-    m_puhChromaIntraDir  = (UChar* )xMalloc(UChar,  uiNumPartition);
-    m_puhInterDir        = (UChar* )xMalloc(UChar,  uiNumPartition);
+    m_pePredMode         = (Char*  )xGetPartField( CU_FIELD_PRED_MODE );
+    m_CUTransquantBypass = (Bool*  )xGetPartField( CU_FIELD_TQ_BYPASS );
+    m_pbMergeFlag        = (Bool*  )xGetPartField( CU_FIELD_MERGE_FLAG );
+    m_puhMergeIndex      = (UChar* )xGetPartField( CU_FIELD_MERGE_INDEX );
+    m_puhLumaIntraDir    = (UChar* )xGetPartField( CU_FIELD_LUMA_DIR );
+    m_puhChromaIntraDir  = (UChar* )xGetPartField( CU_FIELD_CHROMA_DIR );
+    m_puhInterDir        = (UChar* )xGetPartField( CU_FIELD_INTER_DIR );
     
-    m_puhTrIdx           = (UChar* )xMalloc(UChar,  uiNumPartition);
+    m_puhTrIdx           = (UChar* )xGetPartField( CU_FIELD_TR_IDX );
 #if !REMOVE_NSQT
-    m_nsqtPartIdx        = (UChar* )xMalloc(UChar,  uiNumPartition);
+    m_nsqtPartIdx        = (UChar* )xGetPartField( CU_FIELD_NSQT_PART_IDX );
 #endif
-    m_puhTransformSkip[0] = (UChar* )xMalloc(UChar,  uiNumPartition);
-    m_puhTransformSkip[1] = (UChar* )xMalloc(UChar,  uiNumPartition);
-    m_puhTransformSkip[2] = (UChar* )xMalloc(UChar,  uiNumPartition);
+    m_puhTransformSkip[0] = (UChar* )xGetPartField( CU_FIELD_TS_Y );
+    m_puhTransformSkip[1] = (UChar* )xGetPartField( CU_FIELD_TS_U );
+    m_puhTransformSkip[2] = (UChar* )xGetPartField( CU_FIELD_TS_V );
 
-    m_puhCbf[0]          = (UChar* )xMalloc(UChar,  uiNumPartition);
-    m_puhCbf[1]          = (UChar* )xMalloc(UChar,  uiNumPartition);
-    m_puhCbf[2]          = (UChar* )xMalloc(UChar,  uiNumPartition);
+    m_puhCbf[0]          = (UChar* )xGetPartField( CU_FIELD_CBF_Y );
+    m_puhCbf[1]          = (UChar* )xGetPartField( CU_FIELD_CBF_U );
+    m_puhCbf[2]          = (UChar* )xGetPartField( CU_FIELD_CBF_V );
     
-    m_apiMVPIdx[0]       = new Char[ uiNumPartition ];
-    m_apiMVPIdx[1]       = new Char[ uiNumPartition ];
-    m_apiMVPNum[0]       = new Char[ uiNumPartition ];
-    m_apiMVPNum[1]       = new Char[ uiNumPartition ];
+    m_apiMVPIdx[0]       = (Char*  )xGetPartField( CU_FIELD_MVP_IDX_L0 );
+    m_apiMVPIdx[1]       = (Char*  )xGetPartField( CU_FIELD_MVP_IDX_L1 );
+    m_apiMVPNum[0]       = (Char*  )xGetPartField( CU_FIELD_MVP_NUM_L0 );
+    m_apiMVPNum[1]       = (Char*  )xGetPartField( CU_FIELD_MVP_NUM_L1 );
     memset( m_apiMVPIdx[0], -1,uiNumPartition * sizeof( Char ) );
     memset( m_apiMVPIdx[1], -1,uiNumPartition * sizeof( Char ) );
     
-    m_pcTrCoeffY         = (TCoeff*)xMalloc(TCoeff, uiWidth*uiHeight);
-    m_pcTrCoeffCb        = (TCoeff*)xMalloc(TCoeff, uiWidth*uiHeight/4);
-    m_pcTrCoeffCr        = (TCoeff*)xMalloc(TCoeff, uiWidth*uiHeight/4);
-    memset( m_pcTrCoeffY, 0,uiWidth*uiHeight * sizeof( TCoeff ) );
-    memset( m_pcTrCoeffCb, 0,uiWidth*uiHeight/4 * sizeof( TCoeff ) );
-    memset( m_pcTrCoeffCr, 0,uiWidth*uiHeight/4 * sizeof( TCoeff ) );
+    m_pbIPCMFlag         = (Bool*  )xGetPartField( CU_FIELD_IPCM_FLAG );
+
+    m_acCUMvField[0].create( uiNumPartition, puhCur );  puhCur += uiMvFieldSize;
+    m_acCUMvField[1].create( uiNumPartition, puhCur );  puhCur += uiMvFieldSize;
+  }
+  else
+  {
+    m_acCUMvField[0].setNumPartition(uiNumPartition );
+    m_acCUMvField[1].setNumPartition(uiNumPartition );
+  }
+  
+  m_uiSliceStartCU          = (UInt*)puhCur;  puhCur += uiSliceSize;
+  m_uiDependentSliceStartCU = (UInt*)puhCur;  puhCur += uiSliceSize;
+
+  if ( !bDecSubCu )
+  {
+    m_pcTrCoeffY         = (TCoeff*)puhCur;  puhCur += xAlignArenaSize( sizeof(TCoeff) * uiNumSamples );
+    m_pcTrCoeffCb        = (TCoeff*)puhCur;  puhCur += xAlignArenaSize( sizeof(TCoeff) * uiNumSamples/4 );
+    m_pcTrCoeffCr        = (TCoeff*)puhCur;  puhCur += xAlignArenaSize( sizeof(TCoeff) * uiNumSamples/4 );
 #if ADAPTIVE_QP_SELECTION    
     if( bGlobalRMARLBuffer )
     {
@@ -197,32 +245,21 @@ Void TComDataCU::create(UInt uiNumPartition, UInt uiWidth, UInt uiHeight, Bool b
       m_pcArlCoeffCb       = m_pcGlbArlCoeffCb;
       m_pcArlCoeffCr       = m_pcGlbArlCoeffCr;
       m_ArlCoeffIsAliasedAllocation = true;
+      m_uiGlbArlCoeffRefs++;
     }
     else
     {
-      m_pcArlCoeffY        = (Int*)xMalloc(Int, uiWidth*uiHeight);
-      m_pcArlCoeffCb       = (Int*)xMalloc(Int, uiWidth*uiHeight/4);
-      m_pcArlCoeffCr       = (Int*)xMalloc(Int, uiWidth*uiHeight/4);
+      m_pcArlCoeffY        = (Int*)puhCur;  puhCur += xAlignArenaSize( sizeof(Int) * uiNumSamples );
+      m_pcArlCoeffCb       = (Int*)puhCur;  puhCur += xAlignArenaSize( sizeof(Int) * uiNumSamples/4 );
+      m_pcArlCoeffCr       = (Int*)puhCur;  puhCur += xAlignArenaSize( sizeof(Int) * uiNumSamples/4 );
     }
 #endif
     
-    m_pbIPCMFlag         = (Bool*  )xMalloc(Bool, uiNumPartition);
-    m_pcIPCMSampleY      = (Pel*   )xMalloc(Pel , uiWidth*uiHeight);
-    m_pcIPCMSampleCb     = (Pel*   )xMalloc(Pel , uiWidth*uiHeight/4);
-    m_pcIPCMSampleCr     = (Pel*   )xMalloc(Pel , uiWidth*uiHeight/4);
-
-    m_acCUMvField[0].create( uiNumPartition );
-    m_acCUMvField[1].create( uiNumPartition );
-    
+    m_pcIPCMSampleY      = (Pel*   )puhCur;  puhCur += xAlignArenaSize( sizeof(Pel) * uiNumSamples );
+    m_pcIPCMSampleCb     = (Pel*   )puhCur;  puhCur += xAlignArenaSize( sizeof(Pel) * uiNumSamples/4 );
+    m_pcIPCMSampleCr     = (Pel*   )puhCur;  puhCur += xAlignArenaSize( sizeof(Pel) * uiNumSamples/4 );
   }
-  else
-  {
-    m_acCUMvField[0].setNumPartition(uiNumPartition );
-    m_acCUMvField[1].setNumPartition(uiNumPartition );
-  }
-  
-  m_uiSliceStartCU        = (UInt*  )xMalloc(UInt, uiNumPartition);
-  m_uiDependentSliceStartCU = (UInt*  )xMalloc(UInt, uiNumPartition);
+  assert( puhCur == m_puhArena + uiArenaSize );
   
   // create pattern memory
   m_pcPattern            = (TComPattern*)xMalloc(TComPattern, 1);
@@ -250,61 +287,52 @@ Void TComDataCU::destroy()
   }
   
   // encoder-side buffer free
-  if ( !m_bDecSubCu )
+  if ( !m_bDecSubCu && m_puhArena )
   {
-    if ( m_phQP               ) { xFree(m_phQP);                m_phQP              = NULL; }
-    if ( m_puhDepth           ) { xFree(m_puhDepth);            m_puhDepth          = NULL; }
-    if ( m_puhWidth           ) { xFree(m_puhWidth);            m_puhWidth          = NULL; }
-    if ( m_puhHeight          ) { xFree(m_puhHeight);           m_puhHeight         = NULL; }
-
-#if SKIP_FLAG
-    if ( m_skipFlag           ) { delete[] m_skipFlag;          m_skipFlag          = NULL; }
-#endif
-
-    if ( m_pePartSize         ) { delete[] m_pePartSize;        m_pePartSize        = NULL; }
-    if ( m_pePredMode         ) { delete[] m_pePredMode;        m_pePredMode        = NULL; }
-    if ( m_CUTransquantBypass ) { delete[] m_CUTransquantBypass;m_CUTransquantBypass = NULL; }
-    if ( m_puhCbf[0]          ) { xFree(m_puhCbf[0]);           m_puhCbf[0]         = NULL; }
-    if ( m_puhCbf[1]          ) { xFree(m_puhCbf[1]);           m_puhCbf[1]         = NULL; }
-    if ( m_puhCbf[2]          ) { xFree(m_puhCbf[2]);           m_puhCbf[2]         = NULL; }
-    if ( m_puhInterDir        ) { xFree(m_puhInterDir);         m_puhInterDir       = NULL; }
-    if ( m_pbMergeFlag        ) { xFree(m_pbMergeFlag);         m_pbMergeFlag       = NULL; }
-    if ( m_puhMergeIndex      ) { xFree(m_puhMergeIndex);       m_puhMergeIndex     = NULL; }
-    if ( m_puhLumaIntraDir    ) { xFree(m_puhLumaIntraDir);     m_puhLumaIntraDir   = NULL; }
-    if ( m_puhChromaIntraDir  ) { xFree(m_puhChromaIntraDir);   m_puhChromaIntraDir = NULL; }
-    if ( m_puhTrIdx           ) { xFree(m_puhTrIdx);            m_puhTrIdx          = NULL; }
-#if !REMOVE_NSQT
-    if ( m_nsqtPartIdx        ) { xFree(m_nsqtPartIdx);         m_nsqtPartIdx       = NULL; }
-#endif
-    if ( m_puhTransformSkip[0]) { xFree(m_puhTransformSkip[0]); m_puhTransformSkip[0] = NULL; }
-    if ( m_puhTransformSkip[1]) { xFree(m_puhTransformSkip[1]); m_puhTransformSkip[1] = NULL; }
-    if ( m_puhTransformSkip[2]) { xFree(m_puhTransformSkip[2]); m_puhTransformSkip[2] = NULL; }
-    if ( m_pcTrCoeffY         ) { xFree(m_pcTrCoeffY);          m_pcTrCoeffY        = NULL; }
-    if ( m_pcTrCoeffCb        ) { xFree(m_pcTrCoeffCb);         m_pcTrCoeffCb       = NULL; }
-    if ( m_pcTrCoeffCr        ) { xFree(m_pcTrCoeffCr);         m_pcTrCoeffCr       = NULL; }
 #if ADAPTIVE_QP_SELECTION
-    if (!m_ArlCoeffIsAliasedAllocation)
+    if ( m_ArlCoeffIsAliasedAllocation )
     {
-      xFree(m_pcArlCoeffY); m_pcArlCoeffY = 0;
-      xFree(m_pcArlCoeffCb); m_pcArlCoeffCb = 0;
-      xFree(m_pcArlCoeffCr); m_pcArlCoeffCr = 0;
+      // picture CUs may be destroyed while others still alias the global buffers
+      m_ArlCoeffIsAliasedAllocation = false;
+      if ( --m_uiGlbArlCoeffRefs == 0 )
+      {
+        xFree(m_pcGlbArlCoeffY);      m_pcGlbArlCoeffY    = NULL;
+        xFree(m_pcGlbArlCoeffCb);     m_pcGlbArlCoeffCb   = NULL;
+        xFree(m_pcGlbArlCoeffCr);     m_pcGlbArlCoeffCr   = NULL;
+      }
     }
-    if ( m_pcGlbArlCoeffY     ) { xFree(m_pcGlbArlCoeffY);      m_pcGlbArlCoeffY    = NULL; }
-    if ( m_pcGlbArlCoeffCb    ) { xFree(m_pcGlbArlCoeffCb);     m_pcGlbArlCoeffCb   = NULL; }
-    if ( m_pcGlbArlCoeffCr    ) { xFree(m_pcGlbArlCoeffCr);     m_pcGlbArlCoeffCr   = NULL; }
+    m_pcArlCoeffY = m_pcArlCoeffCb = m_pcArlCoeffCr = NULL;
 #endif
-    if ( m_pbIPCMFlag         ) { xFree(m_pbIPCMFlag   );       m_pbIPCMFlag        = NULL; }
-    if ( m_pcIPCMSampleY      ) { xFree(m_pcIPCMSampleY);       m_pcIPCMSampleY     = NULL; }
-    if ( m_pcIPCMSampleCb     ) { xFree(m_pcIPCMSampleCb);      m_pcIPCMSampleCb    = NULL; }
-    if ( m_pcIPCMSampleCr     ) { xFree(m_pcIPCMSampleCr);      m_pcIPCMSampleCr    = NULL; }
-    if ( m_apiMVPIdx[0]       ) { delete[] m_apiMVPIdx[0];      m_apiMVPIdx[0]      = NULL; }
-    if ( m_apiMVPIdx[1]       ) { delete[] m_apiMVPIdx[1];      m_apiMVPIdx[1]      = NULL; }
-    if ( m_apiMVPNum[0]       ) { delete[] m_apiMVPNum[0];      m_apiMVPNum[0]      = NULL; }
-    if ( m_apiMVPNum[1]       ) { delete[] m_apiMVPNum[1];      m_apiMVPNum[1]      = NULL; }
     
     m_acCUMvField[0].destroy();
     m_acCUMvField[1].destroy();
-    
+
+    m_phQP               = NULL;
+    m_puhDepth           = NULL;
+    m_puhWidth           = NULL;
+    m_puhHeight          = NULL;
+#if SKIP_FLAG
+    m_skipFlag           = NULL;
+#endif
+    m_pePartSize         = NULL;
+    m_pePredMode         = NULL;
+    m_CUTransquantBypass = NULL;
+    m_pbMergeFlag        = NULL;
+    m_puhMergeIndex      = NULL;
+    m_puhLumaIntraDir    = NULL;
+    m_puhChromaIntraDir  = NULL;
+    m_puhInterDir        = NULL;
+    m_puhTrIdx           = NULL;
+#if !REMOVE_NSQT
+    m_nsqtPartIdx        = NULL;
+#endif
+    m_puhTransformSkip[0] = m_puhTransformSkip[1] = m_puhTransformSkip[2] = NULL;
+    m_puhCbf[0]          = m_puhCbf[1]          = m_puhCbf[2]          = NULL;
+    m_apiMVPIdx[0]       = m_apiMVPIdx[1]       = NULL;
+    m_apiMVPNum[0]       = m_apiMVPNum[1]       = NULL;
+    m_pbIPCMFlag         = NULL;
+    m_pcTrCoeffY         = m_pcTrCoeffCb        = m_pcTrCoeffCr        = NULL;
+    m_pcIPCMSampleY      = m_pcIPCMSampleCb     = m_pcIPCMSampleCr     = NULL;
   }
   
   m_pcCUAboveLeft       = NULL;
@@ -315,16 +343,14 @@ Void TComDataCU::destroy()
   m_apcCUColocated[0]   = NULL;
   m_apcCUColocated[1]   = NULL;
 
-  if( m_uiSliceStartCU )
-  {
-    xFree(m_uiSliceStartCU);
-    m_uiSliceStartCU=NULL;
-  }
-  if(m_uiDependentSliceStartCU )
+  m_uiSliceStartCU          = NULL;
+  m_uiDependentSliceStartCU = NULL;
+  if ( m_puhArena )
   {
-    xFree(m_uiDependentSliceStartCU);
-    m_uiDependentSliceStartCU=NULL;
+    xFree(m_puhArena);
+    m_puhArena = NULL;
   }
+  m_uiArenaNumPart = 0;
 }
 
 const NDBFBlockInfo& NDBFBlockInfo::operator= (const NDBFBlockInfo& src)
@@ -405,42 +431,16 @@ Void TComDataCU::initCU( TComPic* pcPic, UInt iCUAddr )
   Int partStartIdx = getSlice()->getDependentSliceCurStartCUAddr() - pcPic->getPicSym()->getInverseCUOrderMap(iCUAddr) * pcPic->getNumPartInCU();
 
   Int numElements = min<Int>( partStartIdx, m_uiNumPartition );
-  for ( Int ui = 0; ui < numElements; ui++ )
+  TComDataCU * pcFrom = pcPic->getCU(getAddr());
+  if ( numElements > 0 )
   {
-    TComDataCU * pcFrom = pcPic->getCU(getAddr());
-#if SKIP_FLAG
-    m_skipFlag[ui]   = pcFrom->getSkipFlag(ui);
-#endif
-    m_pePartSize[ui] = pcFrom->getPartitionSize(ui);
-    m_pePredMode[ui] = pcFrom->getPredictionMode(ui);
-    m_CUTransquantBypass[ui] = pcFrom->getCUTransquantBypass(ui);
-    m_puhDepth[ui] = pcFrom->getDepth(ui);
-    m_puhWidth  [ui] = pcFrom->getWidth(ui);
-    m_puhHeight [ui] = pcFrom->getHeight(ui);
-    m_puhTrIdx  [ui] = pcFrom->getTransformIdx(ui);
-#if !REMOVE_NSQT
-    m_nsqtPartIdx[ui] = pcFrom->getNSQTPartIdx(ui);
-#endif
-    m_puhTransformSkip[0][ui] = pcFrom->getTransformSkip(ui,TEXT_LUMA);
-    m_puhTransformSkip[1][ui] = pcFrom->getTransformSkip(ui,TEXT_CHROMA_U);
-    m_puhTransformSkip[2][ui] = pcFrom->getTransformSkip(ui,TEXT_CHROMA_V);
-    m_apiMVPIdx[0][ui] = pcFrom->m_apiMVPIdx[0][ui];;
-    m_apiMVPIdx[1][ui] = pcFrom->m_apiMVPIdx[1][ui];
-    m_apiMVPNum[0][ui] = pcFrom->m_apiMVPNum[0][ui];
-    m_apiMVPNum[1][ui] = pcFrom->m_apiMVPNum[1][ui];
-    m_phQP[ui]=pcFrom->m_phQP[ui];
+    if ( pcFrom != this )
+    {
+      xCopyPartFields( 0, pcFrom, 0, numElements );
+    }
     m_lcuAlfEnabled[0] = pcFrom->m_lcuAlfEnabled[0];
     m_lcuAlfEnabled[1] = pcFrom->m_lcuAlfEnabled[1];
     m_lcuAlfEnabled[2] = pcFrom->m_lcuAlfEnabled[2];
-    m_pbMergeFlag[ui]=pcFrom->m_pbMergeFlag[ui];
-    m_puhMergeIndex[ui]=pcFrom->m_puhMergeIndex[ui];
-    m_puhLumaIntraDir[ui]=pcFrom->m_puhLumaIntraDir[ui];
-    m_puhChromaIntraDir[ui]=pcFrom->m_puhChromaIntraDir[ui];
-    m_puhInterDir[ui]=pcFrom->m_puhInterDir[ui];
-    m_puhCbf[0][ui]=pcFrom->m_puhCbf[0][ui];
-    m_puhCbf[1][ui]=pcFrom->m_puhCbf[1][ui];
-    m_puhCbf[2][ui]=pcFrom->m_puhCbf[2][ui];
-    m_pbIPCMFlag[ui] = pcFrom->m_pbIPCMFlag[ui];
   }
   
   Int firstElement = max<Int>( partStartIdx, 0 );
@@ -448,38 +448,8 @@ Void TComDataCU::initCU( TComPic* pcPic, UInt iCUAddr )
   
   if ( numElements > 0 )
   {
-#if SKIP_FLAG
-    memset( m_skipFlag          + firstElement, false,                    numElements * sizeof( *m_skipFlag ) );
-#endif
-
-    memset( m_pePartSize        + firstElement, SIZE_NONE,                numElements * sizeof( *m_pePartSize ) );
-    memset( m_pePredMode        + firstElement, MODE_NONE,                numElements * sizeof( *m_pePredMode ) );
-    memset( m_CUTransquantBypass+ firstElement, false,                    numElements * sizeof( *m_CUTransquantBypass) );
-    memset( m_puhDepth          + firstElement, 0,                        numElements * sizeof( *m_puhDepth ) );
-    memset( m_puhTrIdx          + firstElement, 0,                        numElements * sizeof( *m_puhTrIdx ) );
-#if !REMOVE_NSQT
-    memset( m_nsqtPartIdx       + firstElement, 0,                        numElements * sizeof( *m_nsqtPartIdx) );
-#endif
-    memset( m_puhTransformSkip[0] + firstElement, 0,                      numElements * sizeof( *m_puhTransformSkip[0]) );
-    memset( m_puhTransformSkip[1] + firstElement, 0,                      numElements * sizeof( *m_puhTransformSkip[1]) );
-    memset( m_puhTransformSkip[2] + firstElement, 0,                      numElements * sizeof( *m_puhTransformSkip[2]) );
-    memset( m_puhWidth          + firstElement, g_uiMaxCUWidth,           numElements * sizeof( *m_puhWidth ) );
-    memset( m_puhHeight         + firstElement, g_uiMaxCUHeight,          numElements * sizeof( *m_puhHeight ) );
-    memset( m_apiMVPIdx[0]      + firstElement, -1,                       numElements * sizeof( *m_apiMVPIdx[0] ) );
-    memset( m_apiMVPIdx[1]      + firstElement, -1,                       numElements * sizeof( *m_apiMVPIdx[1] ) );
-    memset( m_apiMVPNum[0]      + firstElement, -1,                       numElements * sizeof( *m_apiMVPNum[0] ) );
-    memset( m_apiMVPNum[1]      + firstElement, -1,                       numElements * sizeof( *m_apiMVPNum[1] ) );
-    memset( m_phQP              + firstElement, getSlice()->getSliceQp(), numElements * sizeof( *m_phQP ) );
+    xResetPartFields( firstElement, numElements, 0, getSlice()->getSliceQp() );
     m_lcuAlfEnabled[0] = m_lcuAlfEnabled[1] = m_lcuAlfEnabled[2] = false;
-    memset( m_pbMergeFlag       + firstElement, false,                    numElements * sizeof( *m_pbMergeFlag ) );
-    memset( m_puhMergeIndex     + firstElement, 0,                        numElements * sizeof( *m_puhMergeIndex ) );
-    memset( m_puhLumaIntraDir   + firstElement, DC_IDX,                   numElements * sizeof( *m_puhLumaIntraDir ) );
-    memset( m_puhChromaIntraDir + firstElement, 0,                        numElements * sizeof( *m_puhChromaIntraDir ) );
-    memset( m_puhInterDir       + firstElement, 0,                        numElements * sizeof( *m_puhInterDir ) );
-    memset( m_puhCbf[0]         + firstElement, 0,                        numElements * sizeof( *m_puhCbf[0] ) );
-    memset( m_puhCbf[1]         + firstElement, 0,                        numElements * sizeof( *m_puhCbf[1] ) );
-    memset( m_puhCbf[2]         + firstElement, 0,                        numElements * sizeof( *m_puhCbf[2] ) );
-    memset( m_pbIPCMFlag        + firstElement, false,                    numElements * sizeof( *m_pbIPCMFlag ) );
   }
   
   UInt uiTmp = g_uiMaxCUWidth*g_uiMaxCUHeight;
@@ -504,7 +474,6 @@ Void TComDataCU::initCU( TComPic* pcPic, UInt iCUAddr )
   }
   else 
   {
-    TComDataCU * pcFrom = pcPic->getCU(getAddr());
     m_acCUMvField[0].copyFrom(&pcFrom->m_acCUMvField[0],m_uiNumPartition,0);
     m_acCUMvField[1].copyFrom(&pcFrom->m_acCUMvField[1],m_uiNumPartition,0);
     for(int i=0; i<uiTmp; i++) 
@@ -587,41 +556,11 @@ Void TComDataCU::initEstData( UInt uiDepth, Int qp )
   UChar uhHeight = g_uiMaxCUHeight >> uiDepth;
   m_lcuAlfEnabled[0] = m_lcuAlfEnabled[1] = m_lcuAlfEnabled[2] = false;
 
-  for (UInt ui = 0; ui < m_uiNumPartition; ui++)
+  Int iFirstElement = (Int)getSlice()->getDependentSliceCurStartCUAddr() - (Int)( getPic()->getPicSym()->getInverseCUOrderMap(getAddr())*m_pcPic->getNumPartInCU()+m_uiAbsIdxInLCU );
+  iFirstElement = max<Int>( iFirstElement, 0 );
+  if ( iFirstElement < (Int)m_uiNumPartition )
   {
-    if(getPic()->getPicSym()->getInverseCUOrderMap(getAddr())*m_pcPic->getNumPartInCU()+m_uiAbsIdxInLCU+ui >= getSlice()->getDependentSliceCurStartCUAddr())
-    {
-      m_apiMVPIdx[0][ui] = -1;
-      m_apiMVPIdx[1][ui] = -1;
-      m_apiMVPNum[0][ui] = -1;
-      m_apiMVPNum[1][ui] = -1;
-      m_puhDepth  [ui] = uiDepth;
-      m_puhWidth  [ui] = uhWidth;
-      m_puhHeight [ui] = uhHeight;
-      m_puhTrIdx  [ui] = 0;
-#if !REMOVE_NSQT
-      m_nsqtPartIdx[ui] = 0;
-#endif
-      m_puhTransformSkip[0][ui] = 0;
-      m_puhTransformSkip[1][ui] = 0;
-      m_puhTransformSkip[2][ui] = 0;
-#if SKIP_FLAG
-      m_skipFlag[ui]   = false;
-#endif
-      m_pePartSize[ui] = SIZE_NONE;
-      m_pePredMode[ui] = MODE_NONE;
-      m_CUTransquantBypass[ui] = false;
-      m_pbIPCMFlag[ui] = 0;
-      m_phQP[ui] = qp;
-      m_pbMergeFlag[ui] = 0;
-      m_puhMergeIndex[ui] = 0;
-      m_puhLumaIntraDir[ui] = DC_IDX;
-      m_puhChromaIntraDir[ui] = 0;
-      m_puhInterDir[ui] = 0;
-      m_puhCbf[0][ui] = 0;
-      m_puhCbf[1][ui] = 0;
-      m_puhCbf[2][ui] = 0;
-    }
+    xResetPartFields( iFirstElement, m_uiNumPartition - iFirstElement, uiDepth, qp );
   }
 
   UInt uiTmp = uhWidth*uhHeight;
@@ -676,81 +615,21 @@ Void TComDataCU::initSubCU( TComDataCU* pcCU, UInt uiPartUnitIdx, UInt uiDepth,
   m_numSucIPCM       = 0;
   m_lastCUSucIPCMFlag   = false;
 
-  Int iSizeInUchar = sizeof( UChar  ) * m_uiNumPartition;
-  Int iSizeInBool  = sizeof( Bool   ) * m_uiNumPartition;
-
-  Int sizeInChar = sizeof( Char  ) * m_uiNumPartition;
-  memset( m_phQP,              qp,  sizeInChar );
-
   m_lcuAlfEnabled[0] = pcCU->m_lcuAlfEnabled[0];
   m_lcuAlfEnabled[1] = pcCU->m_lcuAlfEnabled[1];
   m_lcuAlfEnabled[2] = pcCU->m_lcuAlfEnabled[2];
-  memset( m_pbMergeFlag,        0, iSizeInBool  );
-  memset( m_puhMergeIndex,      0, iSizeInUchar );
-  memset( m_puhLumaIntraDir,    DC_IDX, iSizeInUchar );
-  memset( m_puhChromaIntraDir,  0, iSizeInUchar );
-  memset( m_puhInterDir,        0, iSizeInUchar );
-  memset( m_puhTrIdx,           0, iSizeInUchar );
-  memset( m_puhTransformSkip[0], 0, iSizeInUchar );
-  memset( m_puhTransformSkip[1], 0, iSizeInUchar );
-  memset( m_puhTransformSkip[2], 0, iSizeInUchar );
-  memset( m_puhCbf[0],          0, iSizeInUchar );
-  memset( m_puhCbf[1],          0, iSizeInUchar );
-  memset( m_puhCbf[2],          0, iSizeInUchar );
-  memset( m_puhDepth,     uiDepth, iSizeInUchar );
 
-  UChar uhWidth  = g_uiMaxCUWidth  >> uiDepth;
-  UChar uhHeight = g_uiMaxCUHeight >> uiDepth;
-  memset( m_puhWidth,          uhWidth,  iSizeInUchar );
-  memset( m_puhHeight,         uhHeight, iSizeInUchar );
-  memset( m_pbIPCMFlag,        0, iSizeInBool  );
-  for (UInt ui = 0; ui < m_uiNumPartition; ui++)
+  // partitions before the start of the dependent slice keep the data of the parent CU
+  Int iNumOldSlicePart = (Int)getSlice()->getDependentSliceCurStartCUAddr() - (Int)( m_pcPic->getPicSym()->getInverseCUOrderMap(getAddr())*m_pcPic->getNumPartInCU()+m_uiAbsIdxInLCU );
+  iNumOldSlicePart = min<Int>( max<Int>( iNumOldSlicePart, 0 ), m_uiNumPartition );
+  xResetPartFields( iNumOldSlicePart, m_uiNumPartition - iNumOldSlicePart, uiDepth, qp );
+  if ( iNumOldSlicePart > 0 )
   {
-#if SKIP_FLAG
-    m_skipFlag[ui]   = false;
-#endif
-    m_pePartSize[ui] = SIZE_NONE;
-    m_pePredMode[ui] = MODE_NONE;
-    m_CUTransquantBypass[ui] = false;
-    m_apiMVPIdx[0][ui] = -1;
-    m_apiMVPIdx[1][ui] = -1;
-    m_apiMVPNum[0][ui] = -1;
-    m_apiMVPNum[1][ui] = -1;
-    if(m_pcPic->getPicSym()->getInverseCUOrderMap(getAddr())*m_pcPic->getNumPartInCU()+m_uiAbsIdxInLCU+ui<getSlice()->getDependentSliceCurStartCUAddr())
-    {
-      m_apiMVPIdx[0][ui] = pcCU->m_apiMVPIdx[0][uiPartOffset+ui];
-      m_apiMVPIdx[1][ui] = pcCU->m_apiMVPIdx[1][uiPartOffset+ui];;
-      m_apiMVPNum[0][ui] = pcCU->m_apiMVPNum[0][uiPartOffset+ui];;
-      m_apiMVPNum[1][ui] = pcCU->m_apiMVPNum[1][uiPartOffset+ui];;
-      m_puhDepth  [ui] = pcCU->getDepth(uiPartOffset+ui);
-      m_puhWidth  [ui] = pcCU->getWidth(uiPartOffset+ui);
-      m_puhHeight  [ui] = pcCU->getHeight(uiPartOffset+ui);
-      m_puhTrIdx  [ui] = pcCU->getTransformIdx(uiPartOffset+ui);
-#if !REMOVE_NSQT
-      m_nsqtPartIdx[ui] = pcCU->getNSQTPartIdx(uiPartOffset+ui);
-#endif
-      m_puhTransformSkip[0][ui] = pcCU->getTransformSkip(uiPartOffset+ui,TEXT_LUMA);
-      m_puhTransformSkip[1][ui] = pcCU->getTransformSkip(uiPartOffset+ui,TEXT_CHROMA_U);
-      m_puhTransformSkip[2][ui] = pcCU->getTransformSkip(uiPartOffset+ui,TEXT_CHROMA_V);
-#if SKIP_FLAG
-      m_skipFlag[ui]   = pcCU->getSkipFlag(uiPartOffset+ui);
-#endif
-      m_pePartSize[ui] = pcCU->getPartitionSize(uiPartOffset+ui);
-      m_pePredMode[ui] = pcCU->getPredictionMode(uiPartOffset+ui);
-      m_CUTransquantBypass[ui] = pcCU->getCUTransquantBypass(uiPartOffset+ui);
-      m_pbIPCMFlag[ui]=pcCU->m_pbIPCMFlag[uiPartOffset+ui];
-      m_phQP[ui] = pcCU->m_phQP[uiPartOffset+ui];
-      m_pbMergeFlag[ui]=pcCU->m_pbMergeFlag[uiPartOffset+ui];
-      m_puhMergeIndex[ui]=pcCU->m_puhMergeIndex[uiPartOffset+ui];
-      m_puhLumaIntraDir[ui]=pcCU->m_puhLumaIntraDir[uiPartOffset+ui];
-      m_puhChromaIntraDir[ui]=pcCU->m_puhChromaIntraDir[uiPartOffset+ui];
-      m_puhInterDir[ui]=pcCU->m_puhInterDir[uiPartOffset+ui];
-      m_puhCbf[0][ui]=pcCU->m_puhCbf[0][uiPartOffset+ui];
-      m_puhCbf[1][ui]=pcCU->m_puhCbf[1][uiPartOffset+ui];
-      m_puhCbf[2][ui]=pcCU->m_puhCbf[2][uiPartOffset+ui];
-
-    }
+    xCopyPartFields( 0, pcCU, uiPartOffset, iNumOldSlicePart );
   }
+
+  UChar uhWidth  = g_uiMaxCUWidth  >> uiDepth;
+  UChar uhHeight = g_uiMaxCUHeight >> uiDepth;
   UInt uiTmp = uhWidth*uhHeight;
   memset( m_pcTrCoeffY , 0, sizeof(TCoeff)*uiTmp );
 #if ADAPTIVE_QP_SELECTION  
@@ -815,6 +694,66 @@ Void TComDataCU::initSubCU( TComDataCU* pcCU, UInt uiPartUnitIdx, UInt uiDepth,
   memcpy(m_uiDependentSliceStartCU,pcCU->m_uiDependentSliceStartCU+uiPartOffset,sizeof(UInt)*m_uiNumPartition);
 }
 
+/** Initialize the CU as a copy of another CU of the same size, including its estimation data.
+ * Used to search modes of the same CU on several CU data structures independently.
+ * \param pcCU  source CU
+ */
+Void TComDataCU::initEstDataFrom( TComDataCU* pcCU )
+{
+  assert( pcCU->getTotalNumPart() == m_uiArenaNumPart );
+
+  m_pcPic              = pcCU->getPic();
+  m_pcSlice            = pcCU->getSlice();
+  m_uiCUAddr           = pcCU->getAddr();
+  m_uiAbsIdxInLCU      = pcCU->getZorderIdxInCU();
+  m_uiCUPelX           = pcCU->getCUPelX();
+  m_uiCUPelY           = pcCU->getCUPelY();
+  m_uiNumPartition     = pcCU->getTotalNumPart();
+
+  m_dTotalCost         = pcCU->getTotalCost();
+  m_uiTotalDistortion  = pcCU->getTotalDistortion();
+  m_uiTotalBits        = pcCU->getTotalBits();
+  m_uiTotalBins        = pcCU->getTotalBins();
+  m_codedQP            = pcCU->getCodedQP();
+
+  m_numSucIPCM         = pcCU->getNumSucIPCM();
+  m_lastCUSucIPCMFlag  = pcCU->getLastCUSucIPCMFlag();
+
+  m_lcuAlfEnabled[0] = pcCU->m_lcuAlfEnabled[0];
+  m_lcuAlfEnabled[1] = pcCU->m_lcuAlfEnabled[1];
+  m_lcuAlfEnabled[2] = pcCU->m_lcuAlfEnabled[2];
+
+  m_pcCULeft          = pcCU->getCULeft();
+  m_pcCUAbove         = pcCU->getCUAbove();
+  m_pcCUAboveLeft     = pcCU->getCUAboveLeft();
+  m_pcCUAboveRight    = pcCU->getCUAboveRight();
+  m_apcCUColocated[0] = pcCU->getCUColocated(REF_PIC_LIST_0);
+  m_apcCUColocated[1] = pcCU->getCUColocated(REF_PIC_LIST_1);
+
+  xCopyPartFields( 0, pcCU, 0, m_uiNumPartition );
+  m_acCUMvField[0].copyFrom( pcCU->getCUMvField( REF_PIC_LIST_0 ), m_uiNumPartition, 0 );
+  m_acCUMvField[1].copyFrom( pcCU->getCUMvField( REF_PIC_LIST_1 ), m_uiNumPartition, 0 );
+
+  UInt uiTmp = m_uiNumPartition * m_unitSize * m_unitSize;
+  memcpy( m_pcTrCoeffY,    pcCU->getCoeffY(),     sizeof(TCoeff)*uiTmp );
+#if ADAPTIVE_QP_SELECTION
+  memcpy( m_pcArlCoeffY,   pcCU->getArlCoeffY(),  sizeof(Int)*uiTmp );
+#endif
+  memcpy( m_pcIPCMSampleY, pcCU->getPCMSampleY(), sizeof(Pel)*uiTmp );
+  uiTmp >>= 2;
+  memcpy( m_pcTrCoeffCb,    pcCU->getCoeffCb(),     sizeof(TCoeff)*uiTmp );
+  memcpy( m_pcTrCoeffCr,    pcCU->getCoeffCr(),     sizeof(TCoeff)*uiTmp );
+#if ADAPTIVE_QP_SELECTION
+  memcpy( m_pcArlCoeffCb,   pcCU->getArlCoeffCb(),  sizeof(Int)*uiTmp );
+  memcpy( m_pcArlCoeffCr,   pcCU->getArlCoeffCr(),  sizeof(Int)*uiTmp );
+#endif
+  memcpy( m_pcIPCMSampleCb, pcCU->getPCMSampleCb(), sizeof(Pel)*uiTmp );
+  memcpy( m_pcIPCMSampleCr, pcCU->getPCMSampleCr(), sizeof(Pel)*uiTmp );
+
+  memcpy( m_uiSliceStartCU,          pcCU->m_uiSliceStartCU,          sizeof(UInt)*m_uiNumPartition );
+  memcpy( m_uiDependentSliceStartCU, pcCU->m_uiDependentSliceStartCU, sizeof(UInt)*m_uiNumPartition );
+}
+
 Void TComDataCU::setOutsideCUPart( UInt uiAbsPartIdx, UInt uiDepth )
 {
   UInt uiNumPartition = m_uiNumPartition >> (uiDepth << 1);
@@ -979,47 +918,10 @@ Void TComDataCU::copyPartFrom( TComDataCU* pcCU, UInt uiPartUnitIdx, UInt uiDept
   UInt uiOffset         = pcCU->getTotalNumPart()*uiPartUnitIdx;
   
   UInt uiNumPartition = pcCU->getTotalNumPart();
-  Int iSizeInUchar  = sizeof( UChar ) * uiNumPartition;
-  Int iSizeInBool   = sizeof( Bool  ) * uiNumPartition;
-  
-  Int sizeInChar  = sizeof( Char ) * uiNumPartition;
-#if SKIP_FLAG
-  memcpy( m_skipFlag   + uiOffset, pcCU->getSkipFlag(),       sizeof( *m_skipFlag )   * uiNumPartition );
-#endif
-  memcpy( m_phQP       + uiOffset, pcCU->getQP(),             sizeInChar                        );
-  memcpy( m_pePartSize + uiOffset, pcCU->getPartitionSize(),  sizeof( *m_pePartSize ) * uiNumPartition );
-  memcpy( m_pePredMode + uiOffset, pcCU->getPredictionMode(), sizeof( *m_pePredMode ) * uiNumPartition );
-  memcpy( m_CUTransquantBypass + uiOffset, pcCU->getCUTransquantBypass(), sizeof( *m_CUTransquantBypass ) * uiNumPartition );
+  xCopyPartFields( uiOffset, pcCU, 0, uiNumPartition );
   m_lcuAlfEnabled[0] = pcCU->m_lcuAlfEnabled[0];
   m_lcuAlfEnabled[1] = pcCU->m_lcuAlfEnabled[1];
   m_lcuAlfEnabled[2] = pcCU->m_lcuAlfEnabled[2];
-  memcpy( m_pbMergeFlag         + uiOffset, pcCU->getMergeFlag(),         iSizeInBool  );
-  memcpy( m_puhMergeIndex       + uiOffset, pcCU->getMergeIndex(),        iSizeInUchar );
-  memcpy( m_puhLumaIntraDir     + uiOffset, pcCU->getLumaIntraDir(),      iSizeInUchar );
-  memcpy( m_puhChromaIntraDir   + uiOffset, pcCU->getChromaIntraDir(),    iSizeInUchar );
-  memcpy( m_puhInterDir         + uiOffset, pcCU->getInterDir(),          iSizeInUchar );
-  memcpy( m_puhTrIdx            + uiOffset, pcCU->getTransformIdx(),      iSizeInUchar );
-#if !REMOVE_NSQT
-  memcpy( m_nsqtPartIdx         + uiOffset, pcCU->getNSQTPartIdx(),       iSizeInUchar );
-#endif
-  memcpy( m_puhTransformSkip[0] + uiOffset, pcCU->getTransformSkip(TEXT_LUMA),     iSizeInUchar );
-  memcpy( m_puhTransformSkip[1] + uiOffset, pcCU->getTransformSkip(TEXT_CHROMA_U), iSizeInUchar );
-  memcpy( m_puhTransformSkip[2] + uiOffset, pcCU->getTransformSkip(TEXT_CHROMA_V), iSizeInUchar );
-
-  memcpy( m_puhCbf[0] + uiOffset, pcCU->getCbf(TEXT_LUMA)    , iSizeInUchar );
-  memcpy( m_puhCbf[1] + uiOffset, pcCU->getCbf(TEXT_CHROMA_U), iSizeInUchar );
-  memcpy( m_puhCbf[2] + uiOffset, pcCU->getCbf(TEXT_CHROMA_V), iSizeInUchar );
-  
-  memcpy( m_puhDepth  + uiOffset, pcCU->getDepth(),  iSizeInUchar );
-  memcpy( m_puhWidth  + uiOffset, pcCU->getWidth(),  iSizeInUchar );
-  memcpy( m_puhHeight + uiOffset, pcCU->getHeight(), iSizeInUchar );
-  
-  memcpy( m_apiMVPIdx[0] + uiOffset, pcCU->getMVPIdx(REF_PIC_LIST_0), iSizeInUchar );
-  memcpy( m_apiMVPIdx[1] + uiOffset, pcCU->getMVPIdx(REF_PIC_LIST_1), iSizeInUchar );
-  memcpy( m_apiMVPNum[0] + uiOffset, pcCU->getMVPNum(REF_PIC_LIST_0), iSizeInUchar );
-  memcpy( m_apiMVPNum[1] + uiOffset, pcCU->getMVPNum(REF_PIC_LIST_1), iSizeInUchar );
-  
-  memcpy( m_pbIPCMFlag + uiOffset, pcCU->getIPCMFlag(), iSizeInBool );
 
   m_pcCUAboveLeft      = pcCU->getCUAboveLeft();
   m_pcCUAboveRight     = pcCU->getCUAboveRight();
@@ -1064,53 +966,13 @@ Void TComDataCU::copyToPic( UChar uhDepth )
   rpcCU->getTotalDistortion() = m_uiTotalDistortion;
   rpcCU->getTotalBits()       = m_uiTotalBits;
   
-  Int iSizeInUchar  = sizeof( UChar ) * m_uiNumPartition;
-  Int iSizeInBool   = sizeof( Bool  ) * m_uiNumPartition;
-  
-  Int sizeInChar  = sizeof( Char ) * m_uiNumPartition;
-
-#if SKIP_FLAG
-  memcpy( rpcCU->getSkipFlag() + m_uiAbsIdxInLCU, m_skipFlag, sizeof( *m_skipFlag ) * m_uiNumPartition );
-#endif
-
-  memcpy( rpcCU->getQP() + m_uiAbsIdxInLCU, m_phQP, sizeInChar  );
-
-  memcpy( rpcCU->getPartitionSize()  + m_uiAbsIdxInLCU, m_pePartSize, sizeof( *m_pePartSize ) * m_uiNumPartition );
-  memcpy( rpcCU->getPredictionMode() + m_uiAbsIdxInLCU, m_pePredMode, sizeof( *m_pePredMode ) * m_uiNumPartition );
-  memcpy( rpcCU->getCUTransquantBypass()+ m_uiAbsIdxInLCU, m_CUTransquantBypass, sizeof( *m_CUTransquantBypass ) * m_uiNumPartition );
+  rpcCU->xCopyPartFields( m_uiAbsIdxInLCU, this, 0, m_uiNumPartition );
   rpcCU->m_lcuAlfEnabled[0] = m_lcuAlfEnabled[0];
   rpcCU->m_lcuAlfEnabled[1] = m_lcuAlfEnabled[1];
   rpcCU->m_lcuAlfEnabled[2] = m_lcuAlfEnabled[2];
-  memcpy( rpcCU->getMergeFlag()         + m_uiAbsIdxInLCU, m_pbMergeFlag,         iSizeInBool  );
-  memcpy( rpcCU->getMergeIndex()        + m_uiAbsIdxInLCU, m_puhMergeIndex,       iSizeInUchar );
-  memcpy( rpcCU->getLumaIntraDir()      + m_uiAbsIdxInLCU, m_puhLumaIntraDir,     iSizeInUchar );
-  memcpy( rpcCU->getChromaIntraDir()    + m_uiAbsIdxInLCU, m_puhChromaIntraDir,   iSizeInUchar );
-  memcpy( rpcCU->getInterDir()          + m_uiAbsIdxInLCU, m_puhInterDir,         iSizeInUchar );
-  memcpy( rpcCU->getTransformIdx()      + m_uiAbsIdxInLCU, m_puhTrIdx,            iSizeInUchar );
-#if !REMOVE_NSQT
-  memcpy( rpcCU->getNSQTPartIdx()       + m_uiAbsIdxInLCU, m_nsqtPartIdx,         iSizeInUchar );
-#endif
-  memcpy( rpcCU->getTransformSkip(TEXT_LUMA)     + m_uiAbsIdxInLCU, m_puhTransformSkip[0], iSizeInUchar );
-  memcpy( rpcCU->getTransformSkip(TEXT_CHROMA_U) + m_uiAbsIdxInLCU, m_puhTransformSkip[1], iSizeInUchar );
-  memcpy( rpcCU->getTransformSkip(TEXT_CHROMA_V) + m_uiAbsIdxInLCU, m_puhTransformSkip[2], iSizeInUchar );
-
-  memcpy( rpcCU->getCbf(TEXT_LUMA)     + m_uiAbsIdxInLCU, m_puhCbf[0], iSizeInUchar );
-  memcpy( rpcCU->getCbf(TEXT_CHROMA_U) + m_uiAbsIdxInLCU, m_puhCbf[1], iSizeInUchar );
-  memcpy( rpcCU->getCbf(TEXT_CHROMA_V) + m_uiAbsIdxInLCU, m_puhCbf[2], iSizeInUchar );
-  
-  memcpy( rpcCU->getDepth()  + m_uiAbsIdxInLCU, m_puhDepth,  iSizeInUchar );
-  memcpy( rpcCU->getWidth()  + m_uiAbsIdxInLCU, m_puhWidth,  iSizeInUchar );
-  memcpy( rpcCU->getHeight() + m_uiAbsIdxInLCU, m_puhHeight, iSizeInUchar );
-  
-  memcpy( rpcCU->getMVPIdx(REF_PIC_LIST_0) + m_uiAbsIdxInLCU, m_apiMVPIdx[0], iSizeInUchar );
-  memcpy( rpcCU->getMVPIdx(REF_PIC_LIST_1) + m_uiAbsIdxInLCU, m_apiMVPIdx[1], iSizeInUchar );
-  memcpy( rpcCU->getMVPNum(REF_PIC_LIST_0) + m_uiAbsIdxInLCU, m_apiMVPNum[0], iSizeInUchar );
-  memcpy( rpcCU->getMVPNum(REF_PIC_LIST_1) + m_uiAbsIdxInLCU, m_apiMVPNum[1], iSizeInUchar );
   
   m_acCUMvField[0].copyTo( rpcCU->getCUMvField( REF_PIC_LIST_0 ), m_uiAbsIdxInLCU );
   m_acCUMvField[1].copyTo( rpcCU->getCUMvField( REF_PIC_LIST_1 ), m_uiAbsIdxInLCU );
-  
-  memcpy( rpcCU->getIPCMFlag() + m_uiAbsIdxInLCU, m_pbIPCMFlag,         iSizeInBool  );
 
   UInt uiTmp  = (g_uiMaxCUWidth*g_uiMaxCUHeight)>>(uhDepth<<1);
   UInt uiTmp2 = m_uiAbsIdxInLCU*m_pcPic->getMinCUWidth()*m_pcPic->getMinCUHeight();
@@ -1132,6 +994,7 @@ Void TComDataCU::copyToPic( UChar uhDepth )
   rpcCU->getTotalBins() = m_uiTotalBins;
   memcpy( rpcCU->m_uiSliceStartCU        + m_uiAbsIdxInLCU, m_uiSliceStartCU,        sizeof( UInt ) * m_uiNumPartition  );
   memcpy( rpcCU->m_uiDependentSliceStartCU + m_uiAbsIdxInLCU, m_uiDependentSliceStartCU, sizeof( UInt ) * m_uiNumPartition  );
+  rpcCU->storeMotionGrid( m_uiAbsIdxInLCU, m_uiNumPartition );
 }
 
 Void TComDataCU::copyToPic( UChar uhDepth, UInt uiPartIdx, UInt uiPartDepth )
@@ -1146,49 +1009,12 @@ Void TComDataCU::copyToPic( UChar uhDepth, UInt uiPartIdx, UInt uiPartDepth )
   rpcCU->getTotalDistortion() = m_uiTotalDistortion;
   rpcCU->getTotalBits()       = m_uiTotalBits;
   
-  Int iSizeInUchar  = sizeof( UChar  ) * uiQNumPart;
-  Int iSizeInBool   = sizeof( Bool   ) * uiQNumPart;
-  
-  Int sizeInChar  = sizeof( Char ) * uiQNumPart;
-#if SKIP_FLAG
-  memcpy( rpcCU->getSkipFlag()       + uiPartOffset, m_skipFlag,   sizeof( *m_skipFlag )   * uiQNumPart );
-#endif
-
-  memcpy( rpcCU->getQP() + uiPartOffset, m_phQP, sizeInChar );
-  memcpy( rpcCU->getPartitionSize()  + uiPartOffset, m_pePartSize, sizeof( *m_pePartSize ) * uiQNumPart );
-  memcpy( rpcCU->getPredictionMode() + uiPartOffset, m_pePredMode, sizeof( *m_pePredMode ) * uiQNumPart );
-  memcpy( rpcCU->getCUTransquantBypass()+ uiPartOffset, m_CUTransquantBypass, sizeof( *m_CUTransquantBypass ) * uiQNumPart );
+  rpcCU->xCopyPartFields( uiPartOffset, this, 0, uiQNumPart );
   rpcCU->m_lcuAlfEnabled[0] = m_lcuAlfEnabled[0];
   rpcCU->m_lcuAlfEnabled[1] = m_lcuAlfEnabled[1];
   rpcCU->m_lcuAlfEnabled[2] = m_lcuAlfEnabled[2];
-  memcpy( rpcCU->getMergeFlag()         + uiPartOffset, m_pbMergeFlag,         iSizeInBool  );
-  memcpy( rpcCU->getMergeIndex()        + uiPartOffset, m_puhMergeIndex,       iSizeInUchar );
-  memcpy( rpcCU->getLumaIntraDir()      + uiPartOffset, m_puhLumaIntraDir,     iSizeInUchar );
-  memcpy( rpcCU->getChromaIntraDir()    + uiPartOffset, m_puhChromaIntraDir,   iSizeInUchar );
-  memcpy( rpcCU->getInterDir()          + uiPartOffset, m_puhInterDir,         iSizeInUchar );
-  memcpy( rpcCU->getTransformIdx()      + uiPartOffset, m_puhTrIdx,            iSizeInUchar );
-#if !REMOVE_NSQT
-  memcpy( rpcCU->getNSQTPartIdx()       + uiPartOffset, m_nsqtPartIdx,         iSizeInUchar );
-#endif
-  memcpy( rpcCU->getTransformSkip(TEXT_LUMA)     + uiPartOffset, m_puhTransformSkip[0], iSizeInUchar );
-  memcpy( rpcCU->getTransformSkip(TEXT_CHROMA_U) + uiPartOffset, m_puhTransformSkip[1], iSizeInUchar );
-  memcpy( rpcCU->getTransformSkip(TEXT_CHROMA_V) + uiPartOffset, m_puhTransformSkip[2], iSizeInUchar );
-  memcpy( rpcCU->getCbf(TEXT_LUMA)     + uiPartOffset, m_puhCbf[0], iSizeInUchar );
-  memcpy( rpcCU->getCbf(TEXT_CHROMA_U) + uiPartOffset, m_puhCbf[1], iSizeInUchar );
-  memcpy( rpcCU->getCbf(TEXT_CHROMA_V) + uiPartOffset, m_puhCbf[2], iSizeInUchar );
-  
-  memcpy( rpcCU->getDepth()  + uiPartOffset, m_puhDepth,  iSizeInUchar );
-  memcpy( rpcCU->getWidth()  + uiPartOffset, m_puhWidth,  iSizeInUchar );
-  memcpy( rpcCU->getHeight() + uiPartOffset, m_puhHeight, iSizeInUchar );
-  
-  memcpy( rpcCU->getMVPIdx(REF_PIC_LIST_0) + uiPartOffset, m_apiMVPIdx[0], iSizeInUchar );
-  memcpy( rpcCU->getMVPIdx(REF_PIC_LIST_1) + uiPartOffset, m_apiMVPIdx[1], iSizeInUchar );
-  memcpy( rpcCU->getMVPNum(REF_PIC_LIST_0) + uiPartOffset, m_apiMVPNum[0], iSizeInUchar );
-  memcpy( rpcCU->getMVPNum(REF_PIC_LIST_1) + uiPartOffset, m_apiMVPNum[1], iSizeInUchar );
   m_acCUMvField[0].copyTo( rpcCU->getCUMvField( REF_PIC_LIST_0 ), m_uiAbsIdxInLCU, uiPartStart, uiQNumPart );
   m_acCUMvField[1].copyTo( rpcCU->getCUMvField( REF_PIC_LIST_1 ), m_uiAbsIdxInLCU, uiPartStart, uiQNumPart );
-  
-  memcpy( rpcCU->getIPCMFlag() + uiPartOffset, m_pbIPCMFlag,         iSizeInBool  );
 
   UInt uiTmp  = (g_uiMaxCUWidth*g_uiMaxCUHeight)>>((uhDepth+uiPartDepth)<<1);
   UInt uiTmp2 = uiPartOffset*m_pcPic->getMinCUWidth()*m_pcPic->getMinCUHeight();
@@ -1210,8 +1036,86 @@ Void TComDataCU::copyToPic( UChar uhDepth, UInt uiPartIdx, UInt uiPartDepth )
   memcpy( rpcCU->getPCMSampleCb() + uiTmp2 , m_pcIPCMSampleCb, sizeof( Pel ) * uiTmp );
   memcpy( rpcCU->getPCMSampleCr() + uiTmp2 , m_pcIPCMSampleCr, sizeof( Pel ) * uiTmp );
   rpcCU->getTotalBins() = m_uiTotalBins;
-  memcpy( rpcCU->m_uiSliceStartCU        + uiPartOffset, m_uiSliceStartCU,        sizeof( UInt ) * uiQNumPart  );
-  memcpy( rpcCU->m_uiDependentSliceStartCU + uiPartOffset, m_uiDependentSliceStartCU, sizeof( UInt ) * uiQNumPart  );
+  // the slice start addresses were taken from the picture CU and do not change during the mode decision,
+  // so they are not written back: the inter search of the encoder reads them while an intra task calls this
+  rpcCU->storeMotionGrid( uiPartOffset, uiQNumPart );
+}
+
+/** Store the motion of the given partitions of this picture CU in the motion grid of the picture.
+ * \param uiAbsPartIdx  first partition in z-order
+ * \param uiNumPart     number of partitions
+ */
+Void TComDataCU::storeMotionGrid( UInt uiAbsPartIdx, UInt uiNumPart )
+{
+  TComPicSym*      pcPicSym          = m_pcPic->getPicSym();
+  UInt             uiNumPartInWidth  = m_pcPic->getNumPartInWidth();
+  UInt             uiStride          = pcPicSym->getMotionGridStride();
+  MotionGridEntry* pcGrid            = pcPicSym->getMotionGrid()
+                                     + ( m_uiCUAddr / pcPicSym->getFrameWidthInCU() ) * m_pcPic->getNumPartInHeight() * uiStride
+                                     + ( m_uiCUAddr % pcPicSym->getFrameWidthInCU() ) * uiNumPartInWidth;
+
+  for ( UInt uiIdx = uiAbsPartIdx; uiIdx < uiAbsPartIdx + uiNumPart; uiIdx++ )
+  {
+    UInt             uiRaster = g_auiZscanToRaster[uiIdx];
+    MotionGridEntry& rcEntry  = pcGrid[ ( uiRaster / uiNumPartInWidth ) * uiStride + uiRaster % uiNumPartInWidth ];
+    rcEntry.acMv[0]     = m_acCUMvField[0].getMv( uiIdx );
+    rcEntry.acMv[1]     = m_acCUMvField[1].getMv( uiIdx );
+    rcEntry.aiRefIdx[0] = m_acCUMvField[0].getRefIdx( uiIdx );
+    rcEntry.aiRefIdx[1] = m_acCUMvField[1].getRefIdx( uiIdx );
+    rcEntry.uhInterDir  = isIntra( uiIdx ) ? 0 : m_puhInterDir[uiIdx];
+  }
+}
+
+/** Copy the one-byte per-partition fields of a range of partitions from another CU.
+ * \param uiDstIdx   first destination partition in this CU
+ * \param pcSrc      source CU
+ * \param uiSrcIdx   first source partition in pcSrc
+ * \param uiNumPart  number of partitions
+ */
+Void TComDataCU::xCopyPartFields( UInt uiDstIdx, TComDataCU* pcSrc, UInt uiSrcIdx, UInt uiNumPart )
+{
+  assert( !m_bDecSubCu && !pcSrc->m_bDecSubCu );
+  if ( uiNumPart == m_uiArenaNumPart && uiNumPart == pcSrc->m_uiArenaNumPart )
+  {
+    ::memcpy( m_puhArena, pcSrc->m_puhArena, NUM_CU_PART_FIELDS * uiNumPart );
+    return;
+  }
+  UChar*       puhDst = m_puhArena + uiDstIdx;
+  const UChar* puhSrc = pcSrc->m_puhArena + uiSrcIdx;
+  for ( Int iField = 0; iField < NUM_CU_PART_FIELDS; iField++ )
+  {
+    ::memcpy( puhDst, puhSrc, uiNumPart );
+    puhDst += m_uiArenaNumPart;
+    puhSrc += pcSrc->m_uiArenaNumPart;
+  }
+}
+
+/** Reset the one-byte per-partition fields of a range of partitions to the state of an unpredicted CU.
+ * \param uiIdx      first partition
+ * \param uiNumPart  number of partitions
+ * \param uiDepth    CU depth, determines depth, width and height
+ * \param iQP        QP
+ */
+Void TComDataCU::xResetPartFields( UInt uiIdx, UInt uiNumPart, UInt uiDepth, Int iQP )
+{
+  UChar auhValue[NUM_CU_PART_FIELDS];
+  ::memset( auhValue, 0, sizeof( auhValue ) );
+  auhValue[CU_FIELD_QP]         = (UChar)iQP;
+  auhValue[CU_FIELD_DEPTH]      = (UChar)uiDepth;
+  auhValue[CU_FIELD_WIDTH]      = (UChar)( g_uiMaxCUWidth  >> uiDepth );
+  auhValue[CU_FIELD_HEIGHT]     = (UChar)( g_uiMaxCUHeight >> uiDepth );
+  auhValue[CU_FIELD_PART_SIZE]  = (UChar)SIZE_NONE;
+  auhValue[CU_FIELD_PRED_MODE]  = (UChar)MODE_NONE;
+  auhValue[CU_FIELD_LUMA_DIR]   = DC_IDX;
+  auhValue[CU_FIELD_MVP_IDX_L0] = auhValue[CU_FIELD_MVP_IDX_L1] = (UChar)-1;
+  auhValue[CU_FIELD_MVP_NUM_L0] = auhValue[CU_FIELD_MVP_NUM_L1] = (UChar)-1;
+
+  UChar* puhDst = m_puhArena + uiIdx;
+  for ( Int iField = 0; iField < NUM_CU_PART_FIELDS; iField++ )
+  {
+    ::memset( puhDst, auhValue[iField], uiNumPart );
+    puhDst += m_uiArenaNumPart;
+  }
 }
 
 // --------------------------------------------------------------------------------------------------------------------
@@ -1594,6 +1498,107 @@ TComDataCU* TComDataCU::getPUBelowLeft( UInt& uiBLPartUnitIdx, UInt uiCurrPartUn
   return NULL;
 }
 
+/** Get the motion of a spatial neighbour for merge and AMVP from the motion grid of the picture.
+ * The availability rules are those of getPULeft(), getPUAbove(), getPUAboveRight(), getPUBelowLeft() and
+ * getPUAboveLeft() with slice and tile restriction and motion data compression, without walking the CU pointers.
+ * Neighbours inside this CU are read from this CU, as they are not in the picture yet.
+ * \param rcEntry            motion of the neighbour, the inter direction is 0 for intra partitions
+ * \param uiCurrPartUnitIdx  z-order index of the current partition in the LCU
+ * \param eDir               direction of the neighbour
+ * \returns true if the neighbour is available
+ */
+Bool TComDataCU::getMotionNeighbour( MotionGridEntry& rcEntry, UInt uiCurrPartUnitIdx, MVP_DIR eDir )
+{
+  Int  iNumPartInWidth  = m_pcPic->getNumPartInWidth();
+  Int  iNumPartInHeight = m_pcPic->getNumPartInHeight();
+  UInt uiRaster         = g_auiZscanToRaster[uiCurrPartUnitIdx];
+  Int  iX               = uiRaster % iNumPartInWidth;
+  Int  iY               = uiRaster / iNumPartInWidth;
+
+  switch( eDir )
+  {
+    case MD_LEFT:        iX--;       break;
+    case MD_ABOVE:       iY--;       break;
+    case MD_ABOVE_RIGHT: iX++; iY--; break;
+    case MD_BELOW_LEFT:  iX--; iY++; break;
+    case MD_ABOVE_LEFT:  iX--; iY--; break;
+    default:             return false;
+  }
+
+  TComDataCU* pcPicCU = m_pcPic->getCU( m_uiCUAddr );
+  if ( eDir == MD_ABOVE_RIGHT && pcPicCU->getCUPelX() + g_auiRasterToPelX[uiRaster] + m_pcPic->getMinCUWidth() >= m_pcSlice->getSPS()->getPicWidthInLumaSamples() )
+  {
+    return false;
+  }
+  if ( eDir == MD_BELOW_LEFT && pcPicCU->getCUPelY() + g_auiRasterToPelY[uiRaster] + m_pcPic->getMinCUHeight() >= m_pcSlice->getSPS()->getPicHeightInLumaSamples() )
+  {
+    return false;
+  }
+
+  Int iLCUOffsetX = iX < 0 ? -1 : ( iX >= iNumPartInWidth  ? 1 : 0 );
+  Int iLCUOffsetY = iY < 0 ? -1 : ( iY >= iNumPartInHeight ? 1 : 0 );
+  if ( iLCUOffsetY > 0 || ( iLCUOffsetX > 0 && iLCUOffsetY == 0 ) )
+  {
+    return false;                                          // LCUs below and to the right are not coded yet
+  }
+  iX -= iLCUOffsetX * iNumPartInWidth;
+  iY -= iLCUOffsetY * iNumPartInHeight;
+
+  TComPicSym* pcPicSym      = m_pcPic->getPicSym();
+  UInt        uiPartUnitIdx = g_auiRasterToZscan[ iY * iNumPartInWidth + iX ];
+  TComDataCU* pcCUNeighbour = pcPicCU;
+  if ( iLCUOffsetX == 0 && iLCUOffsetY == 0 )
+  {
+    if ( ( eDir == MD_ABOVE_RIGHT || eDir == MD_BELOW_LEFT ) && uiCurrPartUnitIdx <= uiPartUnitIdx )
+    {
+      return false;
+    }
+  }
+  else
+  {
+    pcCUNeighbour = iLCUOffsetY == 0 ? m_pcCULeft : ( iLCUOffsetX < 0 ? m_pcCUAboveLeft : ( iLCUOffsetX == 0 ? m_pcCUAbove : m_pcCUAboveRight ) );
+    if ( pcCUNeighbour == NULL || pcCUNeighbour->getSlice() == NULL
+      || pcPicSym->getTileIdxMap( pcCUNeighbour->getAddr() ) != pcPicSym->getTileIdxMap( m_uiCUAddr ) )
+    {
+      return false;
+    }
+    if ( iLCUOffsetX > 0 && pcPicSym->getInverseCUOrderMap( pcCUNeighbour->getAddr() ) > pcPicSym->getInverseCUOrderMap( m_uiCUAddr ) )
+    {
+      return false;
+    }
+    if ( iLCUOffsetY < 0 )
+    {
+      uiPartUnitIdx = g_motionRefer[uiPartUnitIdx];
+    }
+  }
+
+  if ( pcPicSym->getInverseCUOrderMap( pcCUNeighbour->getAddr() ) * m_pcPic->getNumPartInCU() + uiPartUnitIdx < pcPicCU->getSliceStartCU( uiCurrPartUnitIdx ) )
+  {
+    return false;
+  }
+
+  Int iCUX = g_auiZscanToRaster[m_uiAbsIdxInLCU] % iNumPartInWidth;
+  Int iCUY = g_auiZscanToRaster[m_uiAbsIdxInLCU] / iNumPartInWidth;
+  if ( pcCUNeighbour == pcPicCU
+    && iX >= iCUX && iX < iCUX + (Int)( m_puhWidth[0]  / m_pcPic->getMinCUWidth() )
+    && iY >= iCUY && iY < iCUY + (Int)( m_puhHeight[0] / m_pcPic->getMinCUHeight() ) )
+  {
+    UInt uiIdx = uiPartUnitIdx - m_uiAbsIdxInLCU;
+    rcEntry.acMv[0]     = m_acCUMvField[0].getMv( uiIdx );
+    rcEntry.acMv[1]     = m_acCUMvField[1].getMv( uiIdx );
+    rcEntry.aiRefIdx[0] = m_acCUMvField[0].getRefIdx( uiIdx );
+    rcEntry.aiRefIdx[1] = m_acCUMvField[1].getRefIdx( uiIdx );
+    rcEntry.uhInterDir  = isIntra( uiIdx ) ? 0 : m_puhInterDir[uiIdx];
+    return true;
+  }
+
+  UInt uiAddr  = pcCUNeighbour->getAddr();
+  UInt uiGridX = ( uiAddr % pcPicSym->getFrameWidthInCU() ) * iNumPartInWidth  + g_auiZscanToRaster[uiPartUnitIdx] % iNumPartInWidth;
+  UInt uiGridY = ( uiAddr / pcPicSym->getFrameWidthInCU() ) * iNumPartInHeight + g_auiZscanToRaster[uiPartUnitIdx] / iNumPartInWidth;
+  rcEntry = pcPicSym->getMotionGrid()[ uiGridY * pcPicSym->getMotionGridStride() + uiGridX ];
+  return true;
+}
+
 TComDataCU* TComDataCU::getPUBelowLeftAdi(UInt& uiBLPartUnitIdx, UInt uiPuHeight,  UInt uiCurrPartUnitIdx, UInt uiPartUnitOffset, Bool bEnforceSliceRestriction, Bool bEnforceDependentSliceRestriction )
 {
   UInt uiAbsPartIdxLB     = g_auiZscanToRaster[uiCurrPartUnitIdx];
@@ -2747,6 +2752,44 @@ Bool TComDataCU::hasEqualMotion( UInt uiAbsPartIdx, TComDataCU* pcCandCU, UInt u
   return true;
 }
 
+/** Copy the motion of a spatial neighbour into a merge candidate.
+ * \param rcNeighbour  motion of the neighbour
+ * \param ruhInterDir  inter direction of the candidate
+ * \param pcMvField    motion fields of list 0 and list 1 of the candidate
+ */
+Void TComDataCU::xGetMergeCandidate( const MotionGridEntry& rcNeighbour, UChar& ruhInterDir, TComMvField* pcMvField )
+{
+  ruhInterDir = rcNeighbour.uhInterDir;
+  pcMvField[0].setMvField( rcNeighbour.acMv[0], rcNeighbour.aiRefIdx[0] );
+  if ( getSlice()->isInterB() )
+  {
+    pcMvField[1].setMvField( rcNeighbour.acMv[1], rcNeighbour.aiRefIdx[1] );
+  }
+}
+
+/** Check whether two spatial neighbours carry the same motion, see hasEqualMotion().
+ */
+Bool TComDataCU::xHasEqualMotion( const MotionGridEntry& rcEntry, const MotionGridEntry& rcCand )
+{
+  if ( rcEntry.uhInterDir != rcCand.uhInterDir )
+  {
+    return false;
+  }
+
+  for ( UInt uiRefListIdx = 0; uiRefListIdx < 2; uiRefListIdx++ )
+  {
+    if ( rcEntry.uhInterDir & ( 1 << uiRefListIdx ) )
+    {
+      if ( rcEntry.acMv[uiRefListIdx] != rcCand.acMv[uiRefListIdx] || rcEntry.aiRefIdx[uiRefListIdx] != rcCand.aiRefIdx[uiRefListIdx] )
+      {
+        return false;
+      }
+    }
+  }
+
+  return true;
+}
+
 /** Constructs a list of merging candidates
  * \param uiAbsPartIdx
  * \param uiPUIdx 
@@ -2776,30 +2819,15 @@ Void TComDataCU::getInterMergeCandidates( UInt uiAbsPartIdx, UInt uiPUIdx, UInt
   deriveLeftBottomIdxGeneral( cCurPS, uiAbsPartIdx, uiPUIdx, uiPartIdxLB );
 
   //left
-  UInt uiLeftPartIdx = 0;
-  TComDataCU* pcCULeft = 0;
-  pcCULeft = getPULeft( uiLeftPartIdx, uiPartIdxLB, true, false );
-  if (pcCULeft) 
-  {
-    if (!pcCULeft->isDiffMER(xP -1, yP+nPSH-1, xP, yP))
-    {
-      pcCULeft = NULL;
-    }
-  }
+  MotionGridEntry cLeft;
+  Bool bLeft = getMotionNeighbour( cLeft, uiPartIdxLB, MD_LEFT ) && isDiffMER( xP-1, yP+nPSH-1, xP, yP );
   PartSize partSize = getPartitionSize( uiAbsPartIdx );
   if (!(uiPUIdx == 1 && (partSize == SIZE_Nx2N || partSize == SIZE_nLx2N || partSize == SIZE_nRx2N)))
   {
-  if ( pcCULeft && !pcCULeft->isIntra( uiLeftPartIdx ) )
+  if ( bLeft && cLeft.uhInterDir )
   {
     abCandIsInter[iCount] = true;
-    // get Inter Dir
-    puhInterDirNeighbours[iCount] = pcCULeft->getInterDir( uiLeftPartIdx );
-    // get Mv from Left
-    pcCULeft->getMvField( pcCULeft, uiLeftPartIdx, REF_PIC_LIST_0, pcMvFieldNeighbours[iCount<<1] );
-    if ( getSlice()->isInterB() )
-    {
-      pcCULeft->getMvField( pcCULeft, uiLeftPartIdx, REF_PIC_LIST_1, pcMvFieldNeighbours[(iCount<<1)+1] );
-    }
+    xGetMergeCandidate( cLeft, puhInterDirNeighbours[iCount], pcMvFieldNeighbours + (iCount<<1) );
     if ( mrgCandIdx == iCount )
     {
       return;
@@ -2809,29 +2837,14 @@ Void TComDataCU::getInterMergeCandidates( UInt uiAbsPartIdx, UInt uiPUIdx, UInt
   }
 
   // above
-  UInt uiAbovePartIdx = 0;
-  TComDataCU* pcCUAbove = 0;
-  pcCUAbove = getPUAbove( uiAbovePartIdx, uiPartIdxRT, true, false, true );
-    if (pcCUAbove) 
-    {
-      if (!pcCUAbove->isDiffMER(xP+nPSW-1, yP-1, xP, yP))
-      {
-        pcCUAbove = NULL;
-      }
-    }
-  if ( pcCUAbove && !pcCUAbove->isIntra( uiAbovePartIdx ) 
+  MotionGridEntry cAbove;
+  Bool bAbove = getMotionNeighbour( cAbove, uiPartIdxRT, MD_ABOVE ) && isDiffMER( xP+nPSW-1, yP-1, xP, yP );
+  if ( bAbove && cAbove.uhInterDir
     && !(uiPUIdx == 1 && (cCurPS == SIZE_2NxN || cCurPS == SIZE_2NxnU || cCurPS == SIZE_2NxnD))
-    && ( !pcCULeft || pcCULeft->isIntra( uiLeftPartIdx ) || !pcCULeft->hasEqualMotion( uiLeftPartIdx, pcCUAbove, uiAbovePartIdx ) ) )
+    && ( !bLeft || !cLeft.uhInterDir || !xHasEqualMotion( cLeft, cAbove ) ) )
   {
     abCandIsInter[iCount] = true;
-    // get Inter Dir
-    puhInterDirNeighbours[iCount] = pcCUAbove->getInterDir( uiAbovePartIdx );
-    // get Mv from Left
-    pcCUAbove->getMvField( pcCUAbove, uiAbovePartIdx, REF_PIC_LIST_0, pcMvFieldNeighbours[iCount<<1] );
-    if ( getSlice()->isInterB() )
-    {
-      pcCUAbove->getMvField( pcCUAbove, uiAbovePartIdx, REF_PIC_LIST_1, pcMvFieldNeighbours[(iCount<<1)+1] );
-    }
+    xGetMergeCandidate( cAbove, puhInterDirNeighbours[iCount], pcMvFieldNeighbours + (iCount<<1) );
     if ( mrgCandIdx == iCount )
     {
       return;
@@ -2840,27 +2853,12 @@ Void TComDataCU::getInterMergeCandidates( UInt uiAbsPartIdx, UInt uiPUIdx, UInt
   }
 
   // above right
-  UInt uiAboveRightPartIdx = 0;
-  TComDataCU* pcCUAboveRight = 0;
-  pcCUAboveRight = getPUAboveRight( uiAboveRightPartIdx, uiPartIdxRT, true, false, true );
-  if (pcCUAboveRight) 
-  {
-    if (!pcCUAboveRight->isDiffMER(xP+nPSW, yP-1, xP, yP))
-    {
-      pcCUAboveRight = NULL;
-    }
-  }
-  if ( pcCUAboveRight && !pcCUAboveRight->isIntra( uiAboveRightPartIdx ) && ( !pcCUAbove || pcCUAbove->isIntra( uiAbovePartIdx ) || !pcCUAbove->hasEqualMotion( uiAbovePartIdx, pcCUAboveRight, uiAboveRightPartIdx ) ) )
+  MotionGridEntry cAboveRight;
+  Bool bAboveRight = getMotionNeighbour( cAboveRight, uiPartIdxRT, MD_ABOVE_RIGHT ) && isDiffMER( xP+nPSW, yP-1, xP, yP );
+  if ( bAboveRight && cAboveRight.uhInterDir && ( !bAbove || !cAbove.uhInterDir || !xHasEqualMotion( cAbove, cAboveRight ) ) )
   {
     abCandIsInter[iCount] = true;
-    // get Inter Dir
-    puhInterDirNeighbours[iCount] = pcCUAboveRight->getInterDir( uiAboveRightPartIdx );
-    // get Mv from Left
-    pcCUAboveRight->getMvField( pcCUAboveRight, uiAboveRightPartIdx, REF_PIC_LIST_0, pcMvFieldNeighbours[iCount<<1] );
-    if ( getSlice()->isInterB() )
-    {
-      pcCUAboveRight->getMvField( pcCUAboveRight, uiAboveRightPartIdx, REF_PIC_LIST_1, pcMvFieldNeighbours[(iCount<<1)+1] );
-    }
+    xGetMergeCandidate( cAboveRight, puhInterDirNeighbours[iCount], pcMvFieldNeighbours + (iCount<<1) );
     if ( mrgCandIdx == iCount )
     {
       return;
@@ -2869,27 +2867,12 @@ Void TComDataCU::getInterMergeCandidates( UInt uiAbsPartIdx, UInt uiPUIdx, UInt
   }
 
   //left bottom
-  UInt uiLeftBottomPartIdx = 0;
-  TComDataCU* pcCULeftBottom = 0;
-  pcCULeftBottom = this->getPUBelowLeft( uiLeftBottomPartIdx, uiPartIdxLB, true, false );
-  if (pcCULeftBottom)
-  {
-    if (!pcCULeftBottom->isDiffMER(xP-1, yP+nPSH, xP, yP))
-    {
-      pcCULeftBottom = NULL;
-    }
-  }
-  if ( pcCULeftBottom && !pcCULeftBottom->isIntra( uiLeftBottomPartIdx ) && ( !pcCULeft || pcCULeft->isIntra( uiLeftPartIdx ) || !pcCULeft->hasEqualMotion( uiLeftPartIdx, pcCULeftBottom, uiLeftBottomPartIdx ) ) )
+  MotionGridEntry cLeftBottom;
+  Bool bLeftBottom = getMotionNeighbour( cLeftBottom, uiPartIdxLB, MD_BELOW_LEFT ) && isDiffMER( xP-1, yP+nPSH, xP, yP );
+  if ( bLeftBottom && cLeftBottom.uhInterDir && ( !bLeft || !cLeft.uhInterDir || !xHasEqualMotion( cLeft, cLeftBottom ) ) )
   {
     abCandIsInter[iCount] = true;
-    // get Inter Dir
-    puhInterDirNeighbours[iCount] = pcCULeftBottom->getInterDir( uiLeftBottomPartIdx );
-    // get Mv from Left
-    pcCULeftBottom->getMvField( pcCULeftBottom, uiLeftBottomPartIdx, REF_PIC_LIST_0, pcMvFieldNeighbours[iCount<<1] );
-    if ( getSlice()->isInterB() )
-    {
-      pcCULeftBottom->getMvField( pcCULeftBottom, uiLeftBottomPartIdx, REF_PIC_LIST_1, pcMvFieldNeighbours[(iCount<<1)+1] );
-    }
+    xGetMergeCandidate( cLeftBottom, puhInterDirNeighbours[iCount], pcMvFieldNeighbours + (iCount<<1) );
     if ( mrgCandIdx == iCount )
     {
       return;
@@ -2900,30 +2883,15 @@ Void TComDataCU::getInterMergeCandidates( UInt uiAbsPartIdx, UInt uiPUIdx, UInt
   // above left 
   if( iCount < 4 )
   {
-    UInt uiAboveLeftPartIdx = 0;
-    TComDataCU* pcCUAboveLeft = 0;
-    pcCUAboveLeft = getPUAboveLeft( uiAboveLeftPartIdx, uiAbsPartAddr, true, false, true );
-    if (pcCUAboveLeft) 
-    {
-      if (!pcCUAboveLeft->isDiffMER(xP-1, yP-1, xP, yP))
-      {
-        pcCUAboveLeft = NULL;
-      }
-    }
-    if( pcCUAboveLeft && !pcCUAboveLeft->isIntra( uiAboveLeftPartIdx )
-     && ( !pcCULeft || pcCULeft->isIntra( uiLeftPartIdx ) || !pcCULeft->hasEqualMotion( uiLeftPartIdx, pcCUAboveLeft, uiAboveLeftPartIdx ) )
-     && ( !pcCUAbove || pcCUAbove->isIntra( uiAbovePartIdx ) || !pcCUAbove->hasEqualMotion( uiAbovePartIdx, pcCUAboveLeft, uiAboveLeftPartIdx ) )
+    MotionGridEntry cAboveLeft;
+    Bool bAboveLeft = getMotionNeighbour( cAboveLeft, uiAbsPartAddr, MD_ABOVE_LEFT ) && isDiffMER( xP-1, yP-1, xP, yP );
+    if( bAboveLeft && cAboveLeft.uhInterDir
+     && ( !bLeft || !cLeft.uhInterDir || !xHasEqualMotion( cLeft, cAboveLeft ) )
+     && ( !bAbove || !cAbove.uhInterDir || !xHasEqualMotion( cAbove, cAboveLeft ) )
      )
     {
       abCandIsInter[iCount] = true;
-      // get Inter Dir
-      puhInterDirNeighbours[iCount] = pcCUAboveLeft->getInterDir( uiAboveLeftPartIdx );
-      // get Mv from Left
-      pcCUAboveLeft->getMvField( pcCUAboveLeft, uiAboveLeftPartIdx, REF_PIC_LIST_0, pcMvFieldNeighbours[iCount<<1] );
-      if ( getSlice()->isInterB() )
-      {
-        pcCUAboveLeft->getMvField( pcCUAboveLeft, uiAboveLeftPartIdx, REF_PIC_LIST_1, pcMvFieldNeighbours[(iCount<<1)+1] );
-      }
+      xGetMergeCandidate( cAboveLeft, puhInterDirNeighbours[iCount], pcMvFieldNeighbours + (iCount<<1) );
       if ( mrgCandIdx == iCount )
       {
         return;
@@ -3342,15 +3310,12 @@ Void TComDataCU::fillMvpCand ( UInt uiPartIdx, UInt uiPartAddr, RefPicList eRefP
   deriveLeftRightTopIdx( eCUMode, uiPartIdx, uiPartIdxLT, uiPartIdxRT );
   deriveLeftBottomIdx( eCUMode, uiPartIdx, uiPartIdxLB );
   
-  TComDataCU* tmpCU = NULL;
-  UInt idx;
-  tmpCU = getPUBelowLeft(idx, uiPartIdxLB, true, false);
-  bAddedSmvp = (tmpCU != NULL) && (tmpCU->getPredictionMode(idx) != MODE_INTRA);
+  MotionGridEntry cNeighbour;
+  bAddedSmvp = getMotionNeighbour( cNeighbour, uiPartIdxLB, MD_BELOW_LEFT ) && cNeighbour.uhInterDir;
 
   if (!bAddedSmvp)
   {
-    tmpCU = getPULeft(idx, uiPartIdxLB, true, false);
-    bAddedSmvp = (tmpCU != NULL) && (tmpCU->getPredictionMode(idx) != MODE_INTRA);
+    bAddedSmvp = getMotionNeighbour( cNeighbour, uiPartIdxLB, MD_LEFT ) && cNeighbour.uhInterDir;
   }
 
   // Left predictor search
@@ -3581,54 +3546,18 @@ Bool TComDataCU::isSkipped( UInt uiPartIdx )
 
 Bool TComDataCU::xAddMVPCand( AMVPInfo* pInfo, RefPicList eRefPicList, Int iRefIdx, UInt uiPartUnitIdx, MVP_DIR eDir )
 {
-  TComDataCU* pcTmpCU = NULL;
-  UInt uiIdx;
-  switch( eDir )
+  MotionGridEntry cNeighbour;
+  if ( !getMotionNeighbour( cNeighbour, uiPartUnitIdx, eDir ) )
   {
-    case MD_LEFT:
-    {
-      pcTmpCU = getPULeft(uiIdx, uiPartUnitIdx, true, false);
-      break;
-    }
-    case MD_ABOVE:
-    {
-      pcTmpCU = getPUAbove(uiIdx, uiPartUnitIdx, true, false, true);
-      break;
-    }
-    case MD_ABOVE_RIGHT:
-    {
-      pcTmpCU = getPUAboveRight(uiIdx, uiPartUnitIdx, true, false, true);
-      break;
-    }
-    case MD_BELOW_LEFT:
-    {
-      pcTmpCU = getPUBelowLeft(uiIdx, uiPartUnitIdx, true, false);
-      break;
-    }
-    case MD_ABOVE_LEFT:
-    {
-      pcTmpCU = getPUAboveLeft(uiIdx, uiPartUnitIdx, true, false, true);
-      break;
-    }
-    default:
-    {
-      break;
-    }
+    return false;
   }
- 
-  if ( pcTmpCU != NULL && m_pcSlice->isEqualRef(eRefPicList, pcTmpCU->getCUMvField(eRefPicList)->getRefIdx(uiIdx), iRefIdx) )
+
+  if ( m_pcSlice->isEqualRef(eRefPicList, cNeighbour.aiRefIdx[eRefPicList], iRefIdx) )
   {
-    TComMv cMvPred = pcTmpCU->getCUMvField(eRefPicList)->getMv(uiIdx);
-    
-    pInfo->m_acMvCand[ pInfo->iN++] = cMvPred;
+    pInfo->m_acMvCand[ pInfo->iN++] = cNeighbour.acMv[eRefPicList];
     return true;
   }
 
-  if ( pcTmpCU == NULL ) 
-  {
-    return false;
-  }
-  
   RefPicList eRefPicList2nd = REF_PIC_LIST_0;
   if(       eRefPicList == REF_PIC_LIST_0 )
   {
@@ -3644,13 +3573,12 @@ Bool TComDataCU::xAddMVPCand( AMVPInfo* pInfo, RefPicList eRefPicList, Int iRefI
   Int iNeibRefPOC;
 
 
-  if( pcTmpCU->getCUMvField(eRefPicList2nd)->getRefIdx(uiIdx) >= 0 )
+  if( cNeighbour.aiRefIdx[eRefPicList2nd] >= 0 )
   {
-    iNeibRefPOC = pcTmpCU->getSlice()->getRefPOC( eRefPicList2nd, pcTmpCU->getCUMvField(eRefPicList2nd)->getRefIdx(uiIdx) );
+    iNeibRefPOC = m_pcSlice->getRefPOC( eRefPicList2nd, cNeighbour.aiRefIdx[eRefPicList2nd] );
     if( iNeibRefPOC == iCurrRefPOC ) // Same Reference Frame But Diff List//
     {
-      TComMv cMvPred = pcTmpCU->getCUMvField(eRefPicList2nd)->getMv(uiIdx);
-      pInfo->m_acMvCand[ pInfo->iN++] = cMvPred;
+      pInfo->m_acMvCand[ pInfo->iN++] = cNeighbour.acMv[eRefPicList2nd];
       return true;
     }
   }
@@ -3667,42 +3595,8 @@ Bool TComDataCU::xAddMVPCand( AMVPInfo* pInfo, RefPicList eRefPicList, Int iRefI
  */
 Bool TComDataCU::xAddMVPCandOrder( AMVPInfo* pInfo, RefPicList eRefPicList, Int iRefIdx, UInt uiPartUnitIdx, MVP_DIR eDir )
 {
-  TComDataCU* pcTmpCU = NULL;
-  UInt uiIdx;
-  switch( eDir )
-  {
-  case MD_LEFT:
-    {
-      pcTmpCU = getPULeft(uiIdx, uiPartUnitIdx, true, false);
-      break;
-    }
-  case MD_ABOVE:
-    {
-      pcTmpCU = getPUAbove(uiIdx, uiPartUnitIdx, true, false, true);
-      break;
-    }
-  case MD_ABOVE_RIGHT:
-    {
-      pcTmpCU = getPUAboveRight(uiIdx, uiPartUnitIdx, true, false, true);
-      break;
-    }
-  case MD_BELOW_LEFT:
-    {
-      pcTmpCU = getPUBelowLeft(uiIdx, uiPartUnitIdx, true, false);
-      break;
-    }
-  case MD_ABOVE_LEFT:
-    {
-      pcTmpCU = getPUAboveLeft(uiIdx, uiPartUnitIdx, true, false, true);
-      break;
-    }
-  default:
-    {
-      break;
-    }
-  }
-
-  if ( pcTmpCU == NULL ) 
+  MotionGridEntry cNeighbour;
+  if ( !getMotionNeighbour( cNeighbour, uiPartUnitIdx, eDir ) )
   {
     return false;
   }
@@ -3720,65 +3614,41 @@ Bool TComDataCU::xAddMVPCandOrder( AMVPInfo* pInfo, RefPicList eRefPicList, Int
   Int iCurrPOC = m_pcSlice->getPOC();
   Int iCurrRefPOC = m_pcSlice->getRefPic( eRefPicList, iRefIdx)->getPOC();
   Int iNeibPOC = iCurrPOC;
-  Int iNeibRefPOC;
 
   Bool bIsCurrRefLongTerm = m_pcSlice->getRefPic( eRefPicList, iRefIdx)->getIsLongTerm();
-  Bool bIsNeibRefLongTerm = false;
-  //---------------  V1 (END) ------------------//
-  if( pcTmpCU->getCUMvField(eRefPicList)->getRefIdx(uiIdx) >= 0)
-  {
-    iNeibRefPOC = pcTmpCU->getSlice()->getRefPOC( eRefPicList, pcTmpCU->getCUMvField(eRefPicList)->getRefIdx(uiIdx) );
-    TComMv cMvPred = pcTmpCU->getCUMvField(eRefPicList)->getMv(uiIdx);
-    TComMv rcMv;
 
-    bIsNeibRefLongTerm = pcTmpCU->getSlice()->getRefPic( eRefPicList, pcTmpCU->getCUMvField(eRefPicList)->getRefIdx(uiIdx) )->getIsLongTerm();
-    if ( bIsCurrRefLongTerm || bIsNeibRefLongTerm )
-    {
-      rcMv = cMvPred;
-    }
-    else
-    {
-      Int iScale = xGetDistScaleFactor( iCurrPOC, iCurrRefPOC, iNeibPOC, iNeibRefPOC );
-      if ( iScale == 4096 )
-      {
-        rcMv = cMvPred;
-      }
-      else
-      {
-        rcMv = cMvPred.scaleMv( iScale );
-      }
-    }
-    pInfo->m_acMvCand[ pInfo->iN++] = rcMv;
-    return true;
-  }
-  //---------------------- V2(END) --------------------//
-  if( pcTmpCU->getCUMvField(eRefPicList2nd)->getRefIdx(uiIdx) >= 0)
+  // the neighbour's motion of the same list first, then of the other list, scaled to the current reference
+  for ( Int iList = 0; iList < 2; iList++ )
   {
-    iNeibRefPOC = pcTmpCU->getSlice()->getRefPOC( eRefPicList2nd, pcTmpCU->getCUMvField(eRefPicList2nd)->getRefIdx(uiIdx) );
-    TComMv cMvPred = pcTmpCU->getCUMvField(eRefPicList2nd)->getMv(uiIdx);
-    TComMv rcMv;
-
-    bIsNeibRefLongTerm = pcTmpCU->getSlice()->getRefPic( eRefPicList2nd, pcTmpCU->getCUMvField(eRefPicList2nd)->getRefIdx(uiIdx) )->getIsLongTerm();
-    if ( bIsCurrRefLongTerm || bIsNeibRefLongTerm )
+    RefPicList eNeibRefPicList = iList == 0 ? eRefPicList : eRefPicList2nd;
+    Int        iNeibRefIdx     = cNeighbour.aiRefIdx[eNeibRefPicList];
+    if( iNeibRefIdx >= 0 )
     {
-      rcMv = cMvPred;
-    }
-    else
-    {
-      Int iScale = xGetDistScaleFactor( iCurrPOC, iCurrRefPOC, iNeibPOC, iNeibRefPOC );
-      if ( iScale == 4096 )
+      Int    iNeibRefPOC        = m_pcSlice->getRefPOC( eNeibRefPicList, iNeibRefIdx );
+      Bool   bIsNeibRefLongTerm = m_pcSlice->getRefPic( eNeibRefPicList, iNeibRefIdx )->getIsLongTerm();
+      TComMv cMvPred            = cNeighbour.acMv[eNeibRefPicList];
+      TComMv rcMv;
+
+      if ( bIsCurrRefLongTerm || bIsNeibRefLongTerm )
       {
         rcMv = cMvPred;
       }
       else
       {
-        rcMv = cMvPred.scaleMv( iScale );
+        Int iScale = xGetDistScaleFactor( iCurrPOC, iCurrRefPOC, iNeibPOC, iNeibRefPOC );
+        if ( iScale == 4096 )
+        {
+          rcMv = cMvPred;
+        }
+        else
+        {
+          rcMv = cMvPred.scaleMv( iScale );
+        }
       }
+      pInfo->m_acMvCand[ pInfo->iN++] = rcMv;
+      return true;
     }
-    pInfo->m_acMvCand[ pInfo->iN++] = rcMv;
-    return true;
   }
-  //---------------------- V3(END) --------------------//
   return false;
 }
 
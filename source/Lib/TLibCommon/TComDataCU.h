@@ -92,6 +92,42 @@ struct NDBFBlockInfo
   const NDBFBlockInfo& operator= (const NDBFBlockInfo& src);  //!< "=" operator
 };
 
+/// one-byte per-partition fields of a CU, stored field-major in the CU arena
+enum CUPartField
+{
+  CU_FIELD_QP = 0,
+  CU_FIELD_DEPTH,
+  CU_FIELD_WIDTH,
+  CU_FIELD_HEIGHT,
+#if SKIP_FLAG
+  CU_FIELD_SKIP_FLAG,
+#endif
+  CU_FIELD_PART_SIZE,
+  CU_FIELD_PRED_MODE,
+  CU_FIELD_TQ_BYPASS,
+  CU_FIELD_MERGE_FLAG,
+  CU_FIELD_MERGE_INDEX,
+  CU_FIELD_LUMA_DIR,
+  CU_FIELD_CHROMA_DIR,
+  CU_FIELD_INTER_DIR,
+  CU_FIELD_TR_IDX,
+#if !REMOVE_NSQT
+  CU_FIELD_NSQT_PART_IDX,
+#endif
+  CU_FIELD_TS_Y,
+  CU_FIELD_TS_U,
+  CU_FIELD_TS_V,
+  CU_FIELD_CBF_Y,
+  CU_FIELD_CBF_U,
+  CU_FIELD_CBF_V,
+  CU_FIELD_MVP_IDX_L0,
+  CU_FIELD_MVP_IDX_L1,
+  CU_FIELD_MVP_NUM_L0,
+  CU_FIELD_MVP_NUM_L1,
+  CU_FIELD_IPCM_FLAG,
+  NUM_CU_PART_FIELDS
+};
+
 
 // ====================================================================================================================
 // Class definition
@@ -153,6 +189,7 @@ private:
   static Int*   m_pcGlbArlCoeffY;     ///< ARL coefficient buffer (Y)
   static Int*   m_pcGlbArlCoeffCb;    ///< ARL coefficient buffer (Cb)
   static Int*   m_pcGlbArlCoeffCr;    ///< ARL coefficient buffer (Cr)
+  static UInt   m_uiGlbArlCoeffRefs;  ///< number of CUs aliasing the global ARL coefficient buffers
 #endif
   
   Pel*          m_pcIPCMSampleY;      ///< PCM sample buffer (Y)
@@ -208,11 +245,22 @@ private:
   UInt*         m_uiSliceStartCU;    ///< Start CU address of current slice
   UInt*         m_uiDependentSliceStartCU; ///< Start CU address of current slice
   Char          m_codedQP;
+
+  UChar*        m_puhArena;           ///< single allocation holding all per-partition data, coefficients and PCM samples
+  UInt          m_uiArenaNumPart;     ///< number of partitions the arena was created for (stride of the CUPartField arrays)
 protected:
   
   /// add possible motion vector predictor candidates
   Bool          xAddMVPCand           ( AMVPInfo* pInfo, RefPicList eRefPicList, Int iRefIdx, UInt uiPartUnitIdx, MVP_DIR eDir );
   Bool          xAddMVPCandOrder      ( AMVPInfo* pInfo, RefPicList eRefPicList, Int iRefIdx, UInt uiPartUnitIdx, MVP_DIR eDir );
+  /// merge candidates from the motion of spatial neighbours
+  Void          xGetMergeCandidate    ( const MotionGridEntry& rcNeighbour, UChar& ruhInterDir, TComMvField* pcMvField );
+  static Bool   xHasEqualMotion       ( const MotionGridEntry& rcEntry, const MotionGridEntry& rcCand );
+
+  /// arena access
+  UChar*        xGetPartField         ( Int iField ) { return m_puhArena + iField * m_uiArenaNumPart; }
+  Void          xCopyPartFields       ( UInt uiDstIdx, TComDataCU* pcSrc, UInt uiSrcIdx, UInt uiNumPart );
+  Void          xResetPartFields      ( UInt uiIdx, UInt uiNumPart, UInt uiDepth, Int iQP );
 
   Void          deriveRightBottomIdx        ( PartSize eCUMode, UInt uiPartIdx, UInt& ruiPartIdxRB );
   Bool          xGetColMVP( RefPicList eRefPicList, Int uiCUAddr, Int uiPartUnitIdx, TComMv& rcMv, Int& riRefIdx );
@@ -248,6 +296,7 @@ public:
   Void          initCU                ( TComPic* pcPic, UInt uiCUAddr );
   Void          initEstData           ( UInt uiDepth, Int qp );
   Void          initSubCU             ( TComDataCU* pcCU, UInt uiPartUnitIdx, UInt uiDepth, Int qp );
+  Void          initEstDataFrom       ( TComDataCU* pcCU );
   Void          setOutsideCUPart      ( UInt uiAbsPartIdx, UInt uiDepth );
 
   Void          copySubCU             ( TComDataCU* pcCU, UInt uiPartUnitIdx, UInt uiDepth );
@@ -256,6 +305,7 @@ public:
   
   Void          copyToPic             ( UChar uiDepth );
   Void          copyToPic             ( UChar uiDepth, UInt uiPartIdx, UInt uiPartDepth );
+  Void          storeMotionGrid       ( UInt uiAbsPartIdx, UInt uiNumPart );
   
   // -------------------------------------------------------------------------------------------------------------------
   // member functions for CU description
@@ -491,6 +541,8 @@ public:
   TComDataCU*   getPUAboveRight             ( UInt&  uiARPartUnitIdx, UInt uiCurrPartUnitIdx, Bool bEnforceSliceRestriction=true, Bool bEnforceDependentSliceRestriction=true, Bool MotionDataCompresssion = false );
   TComDataCU*   getPUBelowLeft              ( UInt&  uiBLPartUnitIdx, UInt uiCurrPartUnitIdx, Bool bEnforceSliceRestriction=true, Bool bEnforceDependentSliceRestriction=true );
 
+  Bool          getMotionNeighbour          ( MotionGridEntry& rcEntry, UInt uiCurrPartUnitIdx, MVP_DIR eDir );
+
   TComDataCU*   getQpMinCuLeft              ( UInt&  uiLPartUnitIdx , UInt uiCurrAbsIdxInLCU, Bool bEnforceSliceRestriction=true, Bool bEnforceDependentSliceRestriction=true );
   TComDataCU*   getQpMinCuAbove             ( UInt&  aPartUnitIdx , UInt currAbsIdxInLCU, Bool enforceSliceRestriction=true, Bool enforceDependentSliceRestriction=true );
   Char          getRefQP                    ( UInt   uiCurrAbsIdxInLCU                       );
@@ -61,7 +61,34 @@ Void TComCUMvField::create( UInt uiNumPartition )
   m_pcMvd    = new TComMv[ uiNumPartition ];
   m_piRefIdx = new Char  [ uiNumPartition ];
   
-  m_uiNumPartition = uiNumPartition;
+  m_uiNumPartition  = uiNumPartition;
+  m_bExternalMemory = false;
+}
+
+/** Create the motion field in caller-owned memory of getMemorySize( uiNumPartition ) bytes.
+ * The memory must be zeroed, suitably aligned and outlive the field; destroy() does not free it.
+ * \param uiNumPartition number of partitions
+ * \param puhMemory      memory to place the arrays in
+ */
+Void TComCUMvField::create( UInt uiNumPartition, UChar* puhMemory )
+{
+  assert(m_pcMv     == NULL);
+  assert(m_pcMvd    == NULL);
+  assert(m_piRefIdx == NULL);
+  
+  // TComMv only holds two Shorts, so zeroed memory is a valid array of zero vectors
+  m_pcMv     = reinterpret_cast<TComMv*>( puhMemory );
+  m_pcMvd    = reinterpret_cast<TComMv*>( puhMemory + sizeof(TComMv) * uiNumPartition );
+  m_piRefIdx = reinterpret_cast<Char*>  ( puhMemory + sizeof(TComMv) * uiNumPartition * 2 );
+  
+  m_uiNumPartition  = uiNumPartition;
+  m_bExternalMemory = true;
+}
+
+/// number of bytes needed by create( uiNumPartition, puhMemory )
+UInt TComCUMvField::getMemorySize( UInt uiNumPartition )
+{
+  return ( 2 * sizeof(TComMv) + sizeof(Char) ) * uiNumPartition;
 }
 
 Void TComCUMvField::destroy()
@@ -70,9 +97,12 @@ Void TComCUMvField::destroy()
   assert(m_pcMvd    != NULL);
   assert(m_piRefIdx != NULL);
   
-  delete[] m_pcMv;
-  delete[] m_pcMvd;
-  delete[] m_piRefIdx;
+  if ( !m_bExternalMemory )
+  {
+    delete[] m_pcMv;
+    delete[] m_pcMvd;
+    delete[] m_piRefIdx;
+  }
   
   m_pcMv     = NULL;
   m_pcMvd    = NULL;
@@ -57,6 +57,15 @@ typedef struct _AMVPInfo
   Int    iN;                                ///< number of motion vector predictor candidates
 } AMVPInfo;
 
+/// motion information of one minimum partition, stored in the raster-ordered motion grid of a picture
+typedef struct _MotionGridEntry
+{
+  TComMv acMv[2];                           ///< motion vectors of list 0 and list 1
+  Char   aiRefIdx[2];                       ///< reference indices of list 0 and list 1
+  UChar  uhInterDir;                        ///< inter direction, 0 for intra partitions
+  UChar  uhReserved;                        ///< pads the entry to 12 bytes
+} MotionGridEntry;
+
 // ====================================================================================================================
 // Class definition
 // ====================================================================================================================
@@ -95,13 +104,14 @@ private:
   TComMv*   m_pcMvd;
   Char*     m_piRefIdx;
   UInt      m_uiNumPartition;
+  Bool      m_bExternalMemory;  ///< arrays live in memory owned by the caller of create()
   AMVPInfo  m_cAMVPInfo;
     
   template <typename T>
   Void setAll( T *p, T const & val, PartSize eCUMode, Int iPartAddr, UInt uiDepth, Int iPartIdx );
 
 public:
-  TComCUMvField() : m_pcMv(NULL), m_pcMvd(NULL), m_piRefIdx(NULL), m_uiNumPartition(0) {}
+  TComCUMvField() : m_pcMv(NULL), m_pcMvd(NULL), m_piRefIdx(NULL), m_uiNumPartition(0), m_bExternalMemory(false) {}
   ~TComCUMvField() {}
 
   // ------------------------------------------------------------------------------------------------------------------
@@ -109,8 +119,11 @@ public:
   // ------------------------------------------------------------------------------------------------------------------
   
   Void    create( UInt uiNumPartition );
+  Void    create( UInt uiNumPartition, UChar* puhMemory );
   Void    destroy();
   
+  static UInt getMemorySize( UInt uiNumPartition );
+  
   // ------------------------------------------------------------------------------------------------------------------
   // clear / copy
   // ------------------------------------------------------------------------------------------------------------------
@@ -55,6 +55,7 @@ TComPic::TComPic()
 , m_pcPicYuvResi                          (NULL)
 , m_bReconstructed                        (false)
 , m_bNeededForOutput                      (false)
+, m_bOutputHeld                           (false)
 , m_uiCurrSliceIdx                        (0)
 , m_pSliceSUMap                           (NULL)
 , m_pbValidSlice                          (NULL)
@@ -69,6 +69,7 @@ private:
   TComPicYuv*           m_pcPicYuvResi;           //  Residual
   Bool                  m_bReconstructed;
   Bool                  m_bNeededForOutput;
+  Bool                  m_bOutputHeld;            //  Output picture still read by the application, the buffer must not be reused
   UInt                  m_uiCurrSliceIdx;         // Index of current slice
   Int*                  m_pSliceSUMap;
   Bool*                 m_pbValidSlice;
@@ -135,6 +136,8 @@ public:
   Bool          getReconMark ()       { return m_bReconstructed;  }
   Void          setOutputMark (Bool b) { m_bNeededForOutput = b;     }
   Bool          getOutputMark ()       { return m_bNeededForOutput;  }
+  Void          setOutputHeld (Bool b) { m_bOutputHeld = b;          }
+  Bool          getOutputHeld ()       { return m_bOutputHeld;       }
  
   Void          compressMotion(); 
   UInt          getCurrSliceIdx()            { return m_uiCurrSliceIdx;                }
@@ -0,0 +1,193 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.  
+ *
+ * Copyright (c) 2010-2012, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** \file     TComPicAlloc.cpp
+    \brief    allocator of picture planes: aligned rows, huge pages and NUMA placement
+*/
+
+#include <stdlib.h>
+#include <assert.h>
+
+#ifdef _WIN32
+#include <malloc.h>
+#elif defined(__linux__)
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "TComPicAlloc.h"
+
+//! \ingroup TLibCommon
+//! \{
+
+#if defined(__linux__) && !defined(MPOL_PREFERRED)
+#define MPOL_PREFERRED              1                             ///< memory policy of mbind(), not exported without libnuma
+#endif
+
+/// bookkeeping stored in the PIC_ALIGN_BYTES in front of each buffer
+struct PicAllocHeader
+{
+  Void*   pBase;                    ///< start of the underlying allocation
+  size_t  uiLength;                 ///< length of the mapping, 0 for heap allocations
+};
+
+Int TComPicAlloc::m_iHugePages = 1;
+Int TComPicAlloc::m_iNumaNode  = -1;
+
+// ====================================================================================================================
+// Platform layer
+// ====================================================================================================================
+
+#if defined(__linux__)
+/** map a buffer of uiLength bytes on a huge page boundary
+ * \param iHugePages huge page mode, see TComPicAlloc::setHugePages()
+ * \param iNumaNode  preferred NUMA node or -1
+ * \param rpBase     returns the start of the mapping
+ * \param ruiMapped  returns the length of the mapping
+ * \returns the huge page aligned start of the buffer, NULL when mapping failed
+ */
+static UChar* xMapHuge( size_t uiLength, Int iHugePages, Int iNumaNode, Void*& rpBase, size_t& ruiMapped )
+{
+  UChar* pAligned = NULL;
+#ifdef MAP_HUGETLB
+  if ( iHugePages == 2 )
+  {
+    // explicit huge pages fail unless the pool (vm.nr_hugepages) has enough free pages, fall back to the page cache
+    Void* p = mmap( NULL, uiLength, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0 );
+    if ( p != MAP_FAILED )
+    {
+      rpBase    = p;
+      ruiMapped = uiLength;
+      pAligned  = (UChar*)p;
+    }
+  }
+#endif
+  if ( pAligned == NULL )
+  {
+    // over-allocate by one huge page so the buffer can start on a huge page boundary, the slack is never touched
+    size_t uiMapped = uiLength + PIC_HUGE_PAGE_BYTES;
+    Void*  p        = mmap( NULL, uiMapped, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0 );
+    if ( p == MAP_FAILED )
+    {
+      return NULL;
+    }
+    rpBase    = p;
+    ruiMapped = uiMapped;
+    pAligned  = (UChar*)( ( (size_t)p + PIC_HUGE_PAGE_BYTES - 1 ) & ~(size_t)( PIC_HUGE_PAGE_BYTES - 1 ) );
+#ifdef MADV_HUGEPAGE
+    if ( iHugePages != 0 )
+    {
+      madvise( pAligned, uiLength, MADV_HUGEPAGE );
+    }
+#endif
+  }
+  
+  if ( iNumaNode >= 0 && iNumaNode < (Int)( 8 * sizeof( unsigned long ) ) )
+  {
+    // the policy only steers where pages go on first touch, failure (no NUMA kernel, offline node) is harmless
+    unsigned long uiNodeMask = 1UL << iNumaNode;
+    syscall( __NR_mbind, pAligned, uiLength, MPOL_PREFERRED, &uiNodeMask, 8 * sizeof( unsigned long ), 0 );
+  }
+  return pAligned;
+}
+#endif
+
+// ====================================================================================================================
+// Public member functions
+// ====================================================================================================================
+
+/** allocate a plane buffer
+ * \param uiSize size in bytes
+ * \returns PIC_ALIGN_BYTES aligned buffer, uninitialised and not yet backed by physical pages
+ */
+Void* TComPicAlloc::alloc( size_t uiSize )
+{
+  PicAllocHeader cHeader;
+  UChar*         pStart = NULL;
+  size_t         uiLength = uiSize + PIC_ALIGN_BYTES;
+  
+#if defined(__linux__)
+  if ( uiLength >= PIC_HUGE_PAGE_BYTES && ( m_iHugePages != 0 || m_iNumaNode >= 0 ) )
+  {
+    uiLength = ( uiLength + PIC_HUGE_PAGE_BYTES - 1 ) & ~(size_t)( PIC_HUGE_PAGE_BYTES - 1 );
+    pStart   = xMapHuge( uiLength, m_iHugePages, m_iNumaNode, cHeader.pBase, cHeader.uiLength );
+  }
+#endif
+  if ( pStart == NULL )
+  {
+#ifdef _WIN32
+    cHeader.pBase = _aligned_malloc( uiSize + PIC_ALIGN_BYTES, PIC_ALIGN_BYTES );
+#else
+    if ( posix_memalign( &cHeader.pBase, PIC_ALIGN_BYTES, uiSize + PIC_ALIGN_BYTES ) != 0 )
+    {
+      cHeader.pBase = NULL;
+    }
+#endif
+    if ( cHeader.pBase == NULL )
+    {
+      return NULL;
+    }
+    cHeader.uiLength = 0;
+    pStart = (UChar*)cHeader.pBase;
+  }
+  
+  *(PicAllocHeader*)pStart = cHeader;
+  return pStart + PIC_ALIGN_BYTES;
+}
+
+/** release a plane buffer
+ * \param pBuf buffer returned by alloc(), may be NULL
+ */
+Void TComPicAlloc::free( Void* pBuf )
+{
+  if ( pBuf == NULL )
+  {
+    return;
+  }
+  PicAllocHeader* pcHeader = (PicAllocHeader*)( (UChar*)pBuf - PIC_ALIGN_BYTES );
+#if defined(__linux__)
+  if ( pcHeader->uiLength != 0 )
+  {
+    munmap( pcHeader->pBase, pcHeader->uiLength );
+    return;
+  }
+#endif
+#ifdef _WIN32
+  _aligned_free( pcHeader->pBase );
+#else
+  ::free( pcHeader->pBase );
+#endif
+}
+
+//! \}
@@ -0,0 +1,88 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.  
+ *
+ * Copyright (c) 2010-2012, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** \file     TComPicAlloc.h
+    \brief    allocator of picture planes: aligned rows, huge pages and NUMA placement (header)
+*/
+
+#ifndef __TCOMPICALLOC__
+#define __TCOMPICALLOC__
+
+#if _MSC_VER > 1000
+#pragma once
+#endif // _MSC_VER > 1000
+
+#include <stddef.h>
+#include "CommonDef.h"
+
+//! \ingroup TLibCommon
+//! \{
+
+// ====================================================================================================================
+// Constants
+// ====================================================================================================================
+
+#define PIC_ALIGN_BYTES             64                            ///< alignment of plane origins and strides (one cache line)
+#define PIC_HUGE_PAGE_BYTES         ( 2 << 20 )                   ///< huge page size, planes of at least this size may use huge pages
+
+// ====================================================================================================================
+// Class definition
+// ====================================================================================================================
+
+/** allocator of the sample planes of TComPicYuv
+ *
+ * All planes start on a PIC_ALIGN_BYTES boundary. Planes of at least PIC_HUGE_PAGE_BYTES are mapped on a huge page
+ * boundary and, depending on the huge page mode, advised for transparent huge pages or taken from the explicit huge
+ * page pool. The memory is not touched on allocation, so by default its pages are placed on the NUMA node of the
+ * thread that first writes them; a preferred node may be set instead. The settings are process wide and apply to
+ * the planes allocated after they are changed.
+ */
+class TComPicAlloc
+{
+public:
+  static Void*  alloc           ( size_t uiSize );                                    ///< allocate uiSize bytes, PIC_ALIGN_BYTES aligned
+  static Void   free            ( Void* pBuf );                                       ///< release a buffer returned by alloc()
+  
+  static Void   setHugePages    ( Int iMode )   { m_iHugePages = iMode; }             ///< 0: off, 1: transparent huge pages, 2: explicit huge pages
+  static Int    getHugePages    ()              { return m_iHugePages;  }
+  static Void   setNumaNode     ( Int iNode )   { m_iNumaNode = iNode;  }             ///< preferred NUMA node, -1: first touch
+  static Int    getNumaNode     ()              { return m_iNumaNode;   }
+  
+private:
+  static Int    m_iHugePages;
+  static Int    m_iNumaNode;
+};
+
+//! \}
+
+#endif // __TCOMPICALLOC__
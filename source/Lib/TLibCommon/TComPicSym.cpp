@@ -83,12 +83,9 @@ Void TComPicSym::create  ( Int iPicWidth, Int iPicHeight, UInt uiMaxWidth, UInt
   for ( i=0; i<m_uiNumCUsInFrame ; i++ )
   {
     m_apcTComDataCU[i] = new TComDataCU;
-    m_apcTComDataCU[i]->create( m_uiNumPartitions, m_uiMaxCUWidth, m_uiMaxCUHeight, false, m_uiMaxCUWidth >> m_uhTotalDepth
-#if ADAPTIVE_QP_SELECTION
-      , true
-#endif     
-      );
   }
+  m_bCUDataReleased = true;
+  restoreCUData();
 
   m_puiCUOrderMap = new UInt[m_uiNumCUsInFrame+1];
   m_puiTileIdxMap = new UInt[m_uiNumCUsInFrame];
@@ -104,6 +101,45 @@ Void TComPicSym::create  ( Int iPicWidth, Int iPicHeight, UInt uiMaxWidth, UInt
 #endif
 }
 
+/** Free the buffers of all CUs and the motion grid, e.g. when the picture is no longer used for reference.
+ *  Only the slices, tiles and maps remain valid until restoreCUData() is called.
+ */
+Void TComPicSym::releaseCUData()
+{
+  if ( m_bCUDataReleased )
+  {
+    return;
+  }
+  for ( UInt i = 0; i < m_uiNumCUsInFrame; i++ )
+  {
+    m_apcTComDataCU[i]->destroy();
+  }
+  delete [] m_pcMotionGrid;
+  m_pcMotionGrid = NULL;
+  m_bCUDataReleased = true;
+}
+
+/** Allocate the buffers of all CUs again after releaseCUData()
+ */
+Void TComPicSym::restoreCUData()
+{
+  if ( !m_bCUDataReleased )
+  {
+    return;
+  }
+  for ( UInt i = 0; i < m_uiNumCUsInFrame; i++ )
+  {
+    m_apcTComDataCU[i]->create( m_uiNumPartitions, m_uiMaxCUWidth, m_uiMaxCUHeight, false, m_uiMaxCUWidth >> m_uhTotalDepth
+#if ADAPTIVE_QP_SELECTION
+      , true
+#endif     
+      );
+  }
+  m_uiMotionGridStride = m_uiWidthInCU * m_uiNumPartInWidth;
+  m_pcMotionGrid       = new MotionGridEntry[ m_uiMotionGridStride * m_uiHeightInCU * m_uiNumPartInHeight ];
+  m_bCUDataReleased = false;
+}
+
 Void TComPicSym::destroy()
 {
   if (m_uiNumAllocatedSlice>0)
@@ -119,13 +155,19 @@ Void TComPicSym::destroy()
   Int i;
   for (i = 0; i < m_uiNumCUsInFrame; i++)
   {
-    m_apcTComDataCU[i]->destroy();
+    if ( !m_bCUDataReleased )
+    {
+      m_apcTComDataCU[i]->destroy();
+    }
     delete m_apcTComDataCU[i];
     m_apcTComDataCU[i] = NULL;
   }
   delete [] m_apcTComDataCU;
   m_apcTComDataCU = NULL;
 
+  delete [] m_pcMotionGrid;
+  m_pcMotionGrid = NULL;
+
   for(i = 0; i < (m_iNumColumnsMinus1+1)*(m_iNumRowsMinus1+1); i++ )
   {
     delete m_apcTComTile[i];
@@ -100,6 +100,9 @@ private:
   TComSlice**   m_apcTComSlice;
   UInt          m_uiNumAllocatedSlice;
   TComDataCU**  m_apcTComDataCU;        ///< array of CU data
+  Bool          m_bCUDataReleased;      ///< buffers of the CU data are freed, the CU objects are kept
+  MotionGridEntry* m_pcMotionGrid;      ///< motion of all minimum partitions in picture raster order
+  UInt          m_uiMotionGridStride;   ///< number of minimum partitions in one row of the motion grid
   
   Int           m_iTileBoundaryIndependenceIdr;
   Int           m_iNumColumnsMinus1; 
@@ -115,8 +118,11 @@ private:
 public:
   Void        create  ( Int iPicWidth, Int iPicHeight, UInt uiMaxWidth, UInt uiMaxHeight, UInt uiMaxDepth );
   Void        destroy ();
+  Void        releaseCUData();
+  Void        restoreCUData();
+  Bool        getCUDataReleased()       { return m_bCUDataReleased;             }
 
-  TComPicSym  ()                        { m_uiNumAllocatedSlice = 0;            }
+  TComPicSym  ()                        { m_uiNumAllocatedSlice = 0; m_pcMotionGrid = NULL; }
   TComSlice*  getSlice(UInt i)          { return  m_apcTComSlice[i];            }
   UInt        getFrameWidthInCU()       { return m_uiWidthInCU;                 }
   UInt        getFrameHeightInCU()      { return m_uiHeightInCU;                }
@@ -124,6 +130,8 @@ public:
   UInt        getMinCUHeight()          { return m_uiMinCUHeight;               }
   UInt        getNumberOfCUsInFrame()   { return m_uiNumCUsInFrame;  }
   TComDataCU*&  getCU( UInt uiCUAddr )  { return m_apcTComDataCU[uiCUAddr];     }
+  MotionGridEntry* getMotionGrid()      { return m_pcMotionGrid;                }
+  UInt        getMotionGridStride()     { return m_uiMotionGridStride;          }
   
   Void        setSlice(TComSlice* p, UInt i) { m_apcTComSlice[i] = p;           }
   UInt        getNumAllocatedSlice()    { return m_uiNumAllocatedSlice;         }
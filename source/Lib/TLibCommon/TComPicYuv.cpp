@@ -46,10 +46,21 @@
 #endif
 
 #include "TComPicYuv.h"
+#include "TComPicAlloc.h"
+
+#if HAS_SSE2
+#include <emmintrin.h>
+#endif
 
 //! \ingroup TLibCommon
 //! \{
 
+/// luma margins and strides are multiples of twice the samples in PIC_ALIGN_BYTES, so the rows of all planes start on a
+/// cache line while the chroma stride stays half the luma stride, as assumed by the file I/O and picture digests
+static const Int s_iAlignSamples = 2 * PIC_ALIGN_BYTES / sizeof( Pel );
+
+static inline Int xAlignSamples( Int i ) { return ( i + s_iAlignSamples - 1 ) / s_iAlignSamples * s_iAlignSamples; }
+
 TComPicYuv::TComPicYuv()
 {
   m_apiPicBufY      = NULL;   // Buffer (including margin)
@@ -60,7 +71,11 @@ TComPicYuv::TComPicYuv()
   m_piPicOrgU       = NULL;
   m_piPicOrgV       = NULL;
   
+  m_apiPicBufY8     = NULL;
+  m_piPicOrgY8      = NULL;
+  
   m_bIsBorderExtended = false;
+  m_aiExtendedRows[0] = m_aiExtendedRows[1] = m_aiExtendedRows[2] = 0;
 }
 
 TComPicYuv::~TComPicYuv()
@@ -79,21 +94,25 @@ Void TComPicYuv::create( Int iPicWidth, Int iPicHeight, UInt uiMaxCUWidth, UInt
   Int numCuInWidth  = m_iPicWidth  / m_iCuWidth  + (m_iPicWidth  % m_iCuWidth  != 0);
   Int numCuInHeight = m_iPicHeight / m_iCuHeight + (m_iPicHeight % m_iCuHeight != 0);
   
-  m_iLumaMarginX    = g_uiMaxCUWidth  + 16; // for 16-byte alignment
+  m_iLumaMarginX    = xAlignSamples( g_uiMaxCUWidth + 16 ); // aligned picture origin
   m_iLumaMarginY    = g_uiMaxCUHeight + 16;  // margin for 8-tap filter and infinite padding
   
   m_iChromaMarginX  = m_iLumaMarginX>>1;
   m_iChromaMarginY  = m_iLumaMarginY>>1;
   
-  m_apiPicBufY      = (Pel*)xMalloc( Pel, ( m_iPicWidth       + (m_iLumaMarginX  <<1)) * ( m_iPicHeight       + (m_iLumaMarginY  <<1)));
-  m_apiPicBufU      = (Pel*)xMalloc( Pel, ((m_iPicWidth >> 1) + (m_iChromaMarginX<<1)) * ((m_iPicHeight >> 1) + (m_iChromaMarginY<<1)));
-  m_apiPicBufV      = (Pel*)xMalloc( Pel, ((m_iPicWidth >> 1) + (m_iChromaMarginX<<1)) * ((m_iPicHeight >> 1) + (m_iChromaMarginY<<1)));
+  m_iStride         = xAlignSamples( m_iPicWidth + (m_iLumaMarginX<<1) );
+  m_iCStride        = m_iStride>>1;
+  
+  m_apiPicBufY      = (Pel*)TComPicAlloc::alloc( getLumaBufSize()   );
+  m_apiPicBufU      = (Pel*)TComPicAlloc::alloc( getChromaBufSize() );
+  m_apiPicBufV      = (Pel*)TComPicAlloc::alloc( getChromaBufSize() );
   
   m_piPicOrgY       = m_apiPicBufY + m_iLumaMarginY   * getStride()  + m_iLumaMarginX;
   m_piPicOrgU       = m_apiPicBufU + m_iChromaMarginY * getCStride() + m_iChromaMarginX;
   m_piPicOrgV       = m_apiPicBufV + m_iChromaMarginY * getCStride() + m_iChromaMarginX;
   
   m_bIsBorderExtended = false;
+  m_aiExtendedRows[0] = m_aiExtendedRows[1] = m_aiExtendedRows[2] = 0;
   
   m_cuOffsetY = new Int[numCuInWidth * numCuInHeight];
   m_cuOffsetC = new Int[numCuInWidth * numCuInHeight];
@@ -125,9 +144,11 @@ Void TComPicYuv::destroy()
   m_piPicOrgU       = NULL;
   m_piPicOrgV       = NULL;
   
-  if( m_apiPicBufY ){ xFree( m_apiPicBufY );    m_apiPicBufY = NULL; }
-  if( m_apiPicBufU ){ xFree( m_apiPicBufU );    m_apiPicBufU = NULL; }
-  if( m_apiPicBufV ){ xFree( m_apiPicBufV );    m_apiPicBufV = NULL; }
+  if( m_apiPicBufY ){ TComPicAlloc::free( m_apiPicBufY );    m_apiPicBufY = NULL; }
+  if( m_apiPicBufU ){ TComPicAlloc::free( m_apiPicBufU );    m_apiPicBufU = NULL; }
+  if( m_apiPicBufV ){ TComPicAlloc::free( m_apiPicBufV );    m_apiPicBufV = NULL; }
+  if( m_apiPicBufY8 ){ TComPicAlloc::free( m_apiPicBufY8 );  m_apiPicBufY8 = NULL; }
+  m_piPicOrgY8      = NULL;
 
   delete[] m_cuOffsetY;
   delete[] m_cuOffsetC;
@@ -147,10 +168,12 @@ Void TComPicYuv::createLuma( Int iPicWidth, Int iPicHeight, UInt uiMaxCUWidth, U
   Int numCuInWidth  = m_iPicWidth  / m_iCuWidth  + (m_iPicWidth  % m_iCuWidth  != 0);
   Int numCuInHeight = m_iPicHeight / m_iCuHeight + (m_iPicHeight % m_iCuHeight != 0);
   
-  m_iLumaMarginX    = g_uiMaxCUWidth  + 16; // for 16-byte alignment
+  m_iLumaMarginX    = xAlignSamples( g_uiMaxCUWidth + 16 ); // aligned picture origin
   m_iLumaMarginY    = g_uiMaxCUHeight + 16;  // margin for 8-tap filter and infinite padding
   
-  m_apiPicBufY      = (Pel*)xMalloc( Pel, ( m_iPicWidth       + (m_iLumaMarginX  <<1)) * ( m_iPicHeight       + (m_iLumaMarginY  <<1)));
+  m_iStride         = xAlignSamples( m_iPicWidth + (m_iLumaMarginX<<1) );
+  
+  m_apiPicBufY      = (Pel*)TComPicAlloc::alloc( getLumaBufSize() );
   m_piPicOrgY       = m_apiPicBufY + m_iLumaMarginY   * getStride()  + m_iLumaMarginX;
   
   m_cuOffsetY = new Int[numCuInWidth * numCuInHeight];
@@ -179,20 +202,54 @@ Void TComPicYuv::destroyLuma()
 {
   m_piPicOrgY       = NULL;
   
-  if( m_apiPicBufY ){ xFree( m_apiPicBufY );    m_apiPicBufY = NULL; }
+  if( m_apiPicBufY ){ TComPicAlloc::free( m_apiPicBufY );    m_apiPicBufY = NULL; }
+  if( m_apiPicBufY8 ){ TComPicAlloc::free( m_apiPicBufY8 );  m_apiPicBufY8 = NULL; }
+  m_piPicOrgY8      = NULL;
   
   delete[] m_cuOffsetY;
   delete[] m_buOffsetY;
 }
 
+/** Copy the luma buffer, including the margin, to its 8-bit copy, which is allocated on first use
+ *
+ * Only valid when the internal bit depth is 8, the samples are stored without conversion.
+ * Integer motion estimation reads the 8-bit copy at half the memory bandwidth of the luma plane.
+ */
+Void TComPicYuv::copyToLuma8()
+{
+  assert( g_uiBitDepth + g_uiBitIncrement == 8 );
+  Int iSize = getStride() * ( m_iPicHeight + ( m_iLumaMarginY << 1 ) );
+  if ( m_apiPicBufY8 == NULL )
+  {
+    m_apiPicBufY8 = (UChar*)TComPicAlloc::alloc( iSize );
+    m_piPicOrgY8  = m_apiPicBufY8 + ( m_piPicOrgY - m_apiPicBufY );
+  }
+  
+  const Pel* piSrc = m_apiPicBufY;
+  UChar*     piDst = m_apiPicBufY8;
+  Int        i     = 0;
+#if HAS_SSE2
+  for ( ; i + 16 <= iSize; i += 16 )
+  {
+    __m128i cLo = _mm_loadu_si128( (const __m128i*)( piSrc + i ) );
+    __m128i cHi = _mm_loadu_si128( (const __m128i*)( piSrc + i + 8 ) );
+    _mm_storeu_si128( (__m128i*)( piDst + i ), _mm_packus_epi16( cLo, cHi ) );
+  }
+#endif
+  for ( ; i < iSize; i++ )
+  {
+    piDst[i] = (UChar)piSrc[i];
+  }
+}
+
 Void  TComPicYuv::copyToPic (TComPicYuv*  pcPicYuvDst)
 {
   assert( m_iPicWidth  == pcPicYuvDst->getWidth()  );
   assert( m_iPicHeight == pcPicYuvDst->getHeight() );
   
-  ::memcpy ( pcPicYuvDst->getBufY(), m_apiPicBufY, sizeof (Pel) * ( m_iPicWidth       + (m_iLumaMarginX   << 1)) * ( m_iPicHeight       + (m_iLumaMarginY   << 1)) );
-  ::memcpy ( pcPicYuvDst->getBufU(), m_apiPicBufU, sizeof (Pel) * ((m_iPicWidth >> 1) + (m_iChromaMarginX << 1)) * ((m_iPicHeight >> 1) + (m_iChromaMarginY << 1)) );
-  ::memcpy ( pcPicYuvDst->getBufV(), m_apiPicBufV, sizeof (Pel) * ((m_iPicWidth >> 1) + (m_iChromaMarginX << 1)) * ((m_iPicHeight >> 1) + (m_iChromaMarginY << 1)) );
+  ::memcpy ( pcPicYuvDst->getBufY(), m_apiPicBufY, getLumaBufSize() );
+  ::memcpy ( pcPicYuvDst->getBufU(), m_apiPicBufU, getChromaBufSize() );
+  ::memcpy ( pcPicYuvDst->getBufV(), m_apiPicBufV, getChromaBufSize() );
   return;
 }
 
@@ -201,7 +258,7 @@ Void  TComPicYuv::copyToPicLuma (TComPicYuv*  pcPicYuvDst)
   assert( m_iPicWidth  == pcPicYuvDst->getWidth()  );
   assert( m_iPicHeight == pcPicYuvDst->getHeight() );
   
-  ::memcpy ( pcPicYuvDst->getBufY(), m_apiPicBufY, sizeof (Pel) * ( m_iPicWidth       + (m_iLumaMarginX   << 1)) * ( m_iPicHeight       + (m_iLumaMarginY   << 1)) );
+  ::memcpy ( pcPicYuvDst->getBufY(), m_apiPicBufY, getLumaBufSize() );
   return;
 }
 
@@ -210,7 +267,7 @@ Void  TComPicYuv::copyToPicCb (TComPicYuv*  pcPicYuvDst)
   assert( m_iPicWidth  == pcPicYuvDst->getWidth()  );
   assert( m_iPicHeight == pcPicYuvDst->getHeight() );
   
-  ::memcpy ( pcPicYuvDst->getBufU(), m_apiPicBufU, sizeof (Pel) * ((m_iPicWidth >> 1) + (m_iChromaMarginX << 1)) * ((m_iPicHeight >> 1) + (m_iChromaMarginY << 1)) );
+  ::memcpy ( pcPicYuvDst->getBufU(), m_apiPicBufU, getChromaBufSize() );
   return;
 }
 
@@ -219,7 +276,7 @@ Void  TComPicYuv::copyToPicCr (TComPicYuv*  pcPicYuvDst)
   assert( m_iPicWidth  == pcPicYuvDst->getWidth()  );
   assert( m_iPicHeight == pcPicYuvDst->getHeight() );
   
-  ::memcpy ( pcPicYuvDst->getBufV(), m_apiPicBufV, sizeof (Pel) * ((m_iPicWidth >> 1) + (m_iChromaMarginX << 1)) * ((m_iPicHeight >> 1) + (m_iChromaMarginY << 1)) );
+  ::memcpy ( pcPicYuvDst->getBufV(), m_apiPicBufV, getChromaBufSize() );
   return;
 }
 
@@ -249,20 +306,53 @@ Void TComPicYuv::extendPicBorder ()
 {
   if ( m_bIsBorderExtended ) return;
   
-  xExtendPicCompBorder( getLumaAddr(), getStride(),  getWidth(),      getHeight(),      m_iLumaMarginX,   m_iLumaMarginY   );
-  xExtendPicCompBorder( getCbAddr()  , getCStride(), getWidth() >> 1, getHeight() >> 1, m_iChromaMarginX, m_iChromaMarginY );
-  xExtendPicCompBorder( getCrAddr()  , getCStride(), getWidth() >> 1, getHeight() >> 1, m_iChromaMarginX, m_iChromaMarginY );
+  Int iNumRows = getNumCuRows();
+  for ( Int iComp = 0; iComp < 3; iComp++ )
+  {
+    extendPicBorderRows( iComp, iNumRows );
+  }
+}
+
+/** Extend the margins of the CU rows of one plane that became final since the last call
+ * \param iComp    plane index (0: Y, 1: Cb, 2: Cr)
+ * \param iNumRows number of CU rows of the plane, counted from the top, whose samples are final
+ *
+ * The left and right margins of each new row are padded, the top margin once the first row is done and
+ * the bottom margin once the last row is done, so the result equals the whole-picture extension.
+ */
+Void TComPicYuv::extendPicBorderRows ( Int iComp, Int iNumRows )
+{
+  Int iStartRow = m_aiExtendedRows[iComp];
+  if ( iNumRows <= iStartRow )
+  {
+    return;
+  }
+  
+  if ( iComp == 0 )
+  {
+    xExtendPicCompBorderRows( getLumaAddr(), getStride(), getWidth(), getHeight(), m_iLumaMarginX, m_iLumaMarginY, m_iCuHeight, iStartRow, iNumRows );
+  }
+  else
+  {
+    xExtendPicCompBorderRows( iComp == 1 ? getCbAddr() : getCrAddr(), getCStride(), getWidth() >> 1, getHeight() >> 1, m_iChromaMarginX, m_iChromaMarginY, m_iCuHeight >> 1, iStartRow, iNumRows );
+  }
+  m_aiExtendedRows[iComp] = iNumRows;
   
-  m_bIsBorderExtended = true;
+  if ( getNumExtendedRows() == getNumCuRows() )
+  {
+    m_bIsBorderExtended = true;
+  }
 }
 
-Void TComPicYuv::xExtendPicCompBorder  (Pel* piTxt, Int iStride, Int iWidth, Int iHeight, Int iMarginX, Int iMarginY)
+Void TComPicYuv::xExtendPicCompBorderRows( Pel* piTxt, Int iStride, Int iWidth, Int iHeight, Int iMarginX, Int iMarginY, Int iRowHeight, Int iStartRow, Int iEndRow )
 {
   Int   x, y;
+  Int   iStartY = iStartRow * iRowHeight;
+  Int   iEndY   = std::min( iEndRow * iRowHeight, iHeight );
   Pel*  pi;
   
-  pi = piTxt;
-  for ( y = 0; y < iHeight; y++)
+  pi = piTxt + iStartY * iStride;
+  for ( y = iStartY; y < iEndY; y++ )
   {
     for ( x = 0; x < iMarginX; x++ )
     {
@@ -272,16 +362,22 @@ Void TComPicYuv::xExtendPicCompBorder  (Pel* piTxt, Int iStride, Int iWidth, Int
     pi += iStride;
   }
   
-  pi -= (iStride + iMarginX);
-  for ( y = 0; y < iMarginY; y++ )
+  if ( iStartY == 0 )
   {
-    ::memcpy( pi + (y+1)*iStride, pi, sizeof(Pel)*(iWidth + (iMarginX<<1)) );
+    pi = piTxt - iMarginX;
+    for ( y = 0; y < iMarginY; y++ )
+    {
+      ::memcpy( pi - (y+1)*iStride, pi, sizeof(Pel)*(iWidth + (iMarginX<<1)) );
+    }
   }
   
-  pi -= ((iHeight-1) * iStride);
-  for ( y = 0; y < iMarginY; y++ )
+  if ( iEndY == iHeight )
   {
-    ::memcpy( pi - (y+1)*iStride, pi, sizeof(Pel)*(iWidth + (iMarginX<<1)) );
+    pi = piTxt + (iHeight-1) * iStride - iMarginX;
+    for ( y = 0; y < iMarginY; y++ )
+    {
+      ::memcpy( pi + (y+1)*iStride, pi, sizeof(Pel)*(iWidth + (iMarginX<<1)) );
+    }
   }
 }
 
@@ -410,4 +506,48 @@ Void TComPicYuv::xFixedRoundingPic()
 }
 #endif
 
+/** sum of squared differences between two sample planes of equal geometry
+ * \param piSrc0  first plane
+ * \param piSrc1  second plane
+ * \param iStride stride of both planes
+ * \param iWidth  width of the compared area
+ * \param iHeight height of the compared area
+ * \returns accumulated squared sample differences
+ */
+UInt64 calcSSD( const Pel* piSrc0, const Pel* piSrc1, Int iStride, Int iWidth, Int iHeight )
+{
+  UInt64 uiSSD = 0;
+#if HAS_SSE2
+  __m128i mSum = _mm_setzero_si128();
+  const __m128i mZero = _mm_setzero_si128();
+#endif
+  for( Int y = 0; y < iHeight; y++ )
+  {
+    Int x = 0;
+#if HAS_SSE2
+    // squares of two neighbouring differences fit a 32-bit lane, the row sum is widened to 64 bits
+    for( ; x + 8 <= iWidth; x += 8 )
+    {
+      __m128i mDiff = _mm_sub_epi16( _mm_loadu_si128( (const __m128i*)&piSrc0[x] ), _mm_loadu_si128( (const __m128i*)&piSrc1[x] ) );
+      __m128i mSqr  = _mm_madd_epi16( mDiff, mDiff );
+      mSum = _mm_add_epi64( mSum, _mm_unpacklo_epi32( mSqr, mZero ) );
+      mSum = _mm_add_epi64( mSum, _mm_unpackhi_epi32( mSqr, mZero ) );
+    }
+#endif
+    for( ; x < iWidth; x++ )
+    {
+      Int iDiff = (Int)( piSrc0[x] - piSrc1[x] );
+      uiSSD    += iDiff * iDiff;
+    }
+    piSrc0 += iStride;
+    piSrc1 += iStride;
+  }
+#if HAS_SSE2
+  UInt64 auiSum[2];
+  _mm_storeu_si128( (__m128i*)auiSum, mSum );
+  uiSSD += auiSum[0] + auiSum[1];
+#endif
+  return uiSSD;
+}
+
 //! \}
@@ -66,6 +66,9 @@ private:
   Pel*  m_piPicOrgU;
   Pel*  m_piPicOrgV;
   
+  UChar* m_apiPicBufY8;         ///< 8-bit copy of the luma buffer (including margin), NULL until copyToLuma8()
+  UChar* m_piPicOrgY8;          ///< m_apiPicBufY8 at the position of m_piPicOrgY
+  
   // ------------------------------------------------------------------------------------------------
   //  Parameter for general YUV buffer usage
   // ------------------------------------------------------------------------------------------------
@@ -85,10 +88,14 @@ private:
   Int   m_iChromaMarginX;
   Int   m_iChromaMarginY;
   
+  Int   m_iStride;              ///< luma stride, width plus margins padded to a multiple of PIC_ALIGN_BYTES
+  Int   m_iCStride;             ///< chroma stride, half the luma stride
+  
   Bool  m_bIsBorderExtended;
+  Int   m_aiExtendedRows[3];    ///< number of CU rows of each plane whose margins are extended
   
 protected:
-  Void  xExtendPicCompBorder (Pel* piTxt, Int iStride, Int iWidth, Int iHeight, Int iMarginX, Int iMarginY);
+  Void  xExtendPicCompBorderRows( Pel* piTxt, Int iStride, Int iWidth, Int iHeight, Int iMarginX, Int iMarginY, Int iRowHeight, Int iStartRow, Int iEndRow );
   
 public:
   TComPicYuv         ();
@@ -104,6 +111,8 @@ public:
   Void  createLuma  ( Int iPicWidth, Int iPicHeight, UInt uiMaxCUWidth, UInt uiMaxCUHeight, UInt uhMaxCUDepth );
   Void  destroyLuma ();
   
+  Void  copyToLuma8 ();
+  
   // ------------------------------------------------------------------------------------------------
   //  Get information of picture
   // ------------------------------------------------------------------------------------------------
@@ -111,8 +120,11 @@ public:
   Int   getWidth    ()     { return  m_iPicWidth;    }
   Int   getHeight   ()     { return  m_iPicHeight;   }
   
-  Int   getStride   ()     { return (m_iPicWidth     ) + (m_iLumaMarginX  <<1); }
-  Int   getCStride  ()     { return (m_iPicWidth >> 1) + (m_iChromaMarginX<<1); }
+  Int   getStride   ()     { return m_iStride;  }
+  Int   getCStride  ()     { return m_iCStride; }
+  
+  size_t getLumaBufSize  () { return sizeof(Pel) * m_iStride  * ( m_iPicHeight        + (m_iLumaMarginY  <<1) ); } ///< bytes of the luma buffer, including margin
+  size_t getChromaBufSize() { return sizeof(Pel) * m_iCStride * ((m_iPicHeight >> 1) + (m_iChromaMarginY<<1) ); } ///< bytes of one chroma buffer, including margin
   
   Int   getLumaMargin   () { return m_iLumaMarginX;  }
   Int   getChromaMargin () { return m_iChromaMarginX;}
@@ -138,6 +150,10 @@ public:
   Pel*  getCbAddr   ( Int iCuAddr ) { return m_piPicOrgU + m_cuOffsetC[ iCuAddr ]; }
   Pel*  getCrAddr   ( Int iCuAddr ) { return m_piPicOrgV + m_cuOffsetC[ iCuAddr ]; }
   Pel*  getLumaAddr ( Int iCuAddr, Int uiAbsZorderIdx ) { return m_piPicOrgY + m_cuOffsetY[iCuAddr] + m_buOffsetY[g_auiZscanToRaster[uiAbsZorderIdx]]; }
+  
+  //  8-bit luma copy, same stride and offsets as the luma plane
+  UChar* getLumaAddr8()    { return  m_piPicOrgY8;   }
+  UChar* getLumaAddr8( Int iCuAddr, Int uiAbsZorderIdx ) { return m_piPicOrgY8 + m_cuOffsetY[iCuAddr] + m_buOffsetY[g_auiZscanToRaster[uiAbsZorderIdx]]; }
   Pel*  getCbAddr   ( Int iCuAddr, Int uiAbsZorderIdx ) { return m_piPicOrgU + m_cuOffsetC[iCuAddr] + m_buOffsetC[g_auiZscanToRaster[uiAbsZorderIdx]]; }
   Pel*  getCrAddr   ( Int iCuAddr, Int uiAbsZorderIdx ) { return m_piPicOrgV + m_cuOffsetC[iCuAddr] + m_buOffsetC[g_auiZscanToRaster[uiAbsZorderIdx]]; }
   
@@ -153,12 +169,15 @@ public:
   
   //  Extend function of picture buffer
   Void  extendPicBorder      ();
+  Void  extendPicBorderRows  ( Int iComp, Int iNumRows );   ///< extend the margins of plane iComp up to CU row iNumRows, as rows become final
+  Int   getNumCuRows         ()     { return m_iPicHeight / m_iCuHeight + ( m_iPicHeight % m_iCuHeight != 0 ); }
+  Int   getNumExtendedRows   ()     { return std::min( m_aiExtendedRows[0], std::min( m_aiExtendedRows[1], m_aiExtendedRows[2] ) ); } ///< CU rows extended in all planes
   
   //  Dump picture
   Void  dump (char* pFileName, Bool bAdd = false);
   
   // Set border extension flag
-  Void  setBorderExtension(Bool b) { m_bIsBorderExtended = b; }
+  Void  setBorderExtension(Bool b) { m_bIsBorderExtended = b; m_aiExtendedRows[0] = m_aiExtendedRows[1] = m_aiExtendedRows[2] = b ? getNumCuRows() : 0; }
 #if FIXED_ROUNDING_FRAME_MEMORY
   Void  xFixedRoundingPic();
 #endif  
@@ -167,6 +186,7 @@ public:
 void calcChecksum(TComPicYuv& pic, unsigned char digest[3][16]);
 void calcCRC(TComPicYuv& pic, unsigned char digest[3][16]);
 void calcMD5(TComPicYuv& pic, unsigned char digest[3][16]);
+UInt64 calcSSD( const Pel* piSrc0, const Pel* piSrc1, Int iStride, Int iWidth, Int iHeight );
 //! \}
 
 #endif // __TCOMPICYUV__
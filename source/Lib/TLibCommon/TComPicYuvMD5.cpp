@@ -31,9 +31,14 @@
  * THE POSSIBILITY OF SUCH DAMAGE.
  */
 
+#include <vector>
 #include "TComPicYuv.h"
 #include "libmd5/MD5.h"
 
+#if HAS_SSE2
+#include <emmintrin.h>
+#endif
+
 //! \ingroup TLibCommon
 //! \{
 
@@ -71,6 +76,39 @@ static void md5_plane(MD5& md5, const Pel* plane, unsigned width, unsigned heigh
   unsigned width_modN = width % N;
   unsigned width_less_modN = width - width_modN;
 
+#if HAS_SSE2
+  /* x86 stores Pel's in little endian byte order, so 16bit output can be
+   * hashed straight from the picture memory, one line per update */
+  if (OUTPUT_BITDEPTH_DIV8 == 2)
+  {
+    for (unsigned y = 0; y < height; y++)
+    {
+      md5.update((unsigned char*)&plane[y*stride], width * 2);
+    }
+    return;
+  }
+
+  /* 8bit output: truncate a whole line into a byte buffer, 16 samples at a time */
+  std::vector<unsigned char> line(width + 16);
+  const __m128i lowByte = _mm_set1_epi16(0xff);
+  for (unsigned y = 0; y < height; y++)
+  {
+    const Pel* src = &plane[y*stride];
+    unsigned x = 0;
+    for (; x + 16 <= width; x += 16)
+    {
+      __m128i a = _mm_and_si128(_mm_loadu_si128((const __m128i*)&src[x]), lowByte);
+      __m128i b = _mm_and_si128(_mm_loadu_si128((const __m128i*)&src[x + 8]), lowByte);
+      _mm_storeu_si128((__m128i*)&line[x], _mm_packus_epi16(a, b));
+    }
+    for (; x < width; x++)
+    {
+      line[x] = (unsigned char)src[x];
+    }
+    md5.update(&line[0], width);
+  }
+  (void)width_less_modN;
+#else
   for (unsigned y = 0; y < height; y++)
   {
     /* convert pel's into unsigned chars in little endian byte order.
@@ -81,32 +119,74 @@ static void md5_plane(MD5& md5, const Pel* plane, unsigned width, unsigned heigh
     /* mop up any of the remaining line */
     md5_block<OUTPUT_BITDEPTH_DIV8>(md5, &plane[y*stride + width_less_modN], width_modN);
   }
+#endif
+}
+
+/**
+ * Build the table that shifts numBits message bits into the CRC register at
+ * once: for register value crc, the result of numBits single-bit steps with
+ * message bits v is ((crc << numBits) | v) ^ table[crc >> (16 - numBits)].
+ * Valid for numBits <= 8, since message bits cannot reach the register msb.
+ */
+static void initCRCTable(unsigned int numBits, unsigned int* table)
+{
+  for (unsigned int h = 0; h < (1u << numBits); h++)
+  {
+    unsigned int crcVal = h << (16 - numBits);
+    for (unsigned int bitIdx = 0; bitIdx < numBits; bitIdx++)
+    {
+      unsigned int crcMsb = (crcVal >> 15) & 1;
+      crcVal = ((crcVal << 1) & 0xffff) ^ (crcMsb * 0x1021);
+    }
+    table[h] = crcVal;
+  }
 }
 
 void compCRC(const Pel* plane, unsigned int width, unsigned int height, unsigned int stride, unsigned char digest[16])
 {
   unsigned int bitdepth = g_uiBitDepth + g_uiBitIncrement;
   unsigned int dataMsbIdx = bitdepth - 1;
-  unsigned int crcMsb;
-  unsigned int bitVal;
   unsigned int crcVal = 0xffff;
-  unsigned int bitIdx;
+
+  /* each sample contributes bitdepth message bits: the first (bitdepth - 8)
+   * through the small table, the last 8 through the byte table */
+  unsigned int numHighBits = bitdepth - 8;
+  unsigned int byteTable[256];
+  unsigned int highTable[256];
+  initCRCTable(8, byteTable);
+  if (numHighBits)
+  {
+    initCRCTable(numHighBits, highTable);
+  }
+
+  /* message bits of every sample value, first bit in the msb */
+  std::vector<unsigned int> message(1u << bitdepth);
+  for (unsigned int val = 0; val < message.size(); val++)
+  {
+    unsigned int bits = 0;
+    for (unsigned int bitIdx = 0; bitIdx < bitdepth; bitIdx++)
+    {
+      bits = (bits << 1) | ((val >> (dataMsbIdx - (bitIdx&dataMsbIdx))) & 1);
+    }
+    message[val] = bits;
+  }
+  unsigned int sampleMask = (1u << bitdepth) - 1;
+
   for (unsigned y = 0; y < height; y++)
   {
     for (unsigned x = 0; x < width; x++)
-    {     
-      for(bitIdx=0; bitIdx<bitdepth; bitIdx++)
+    {
+      unsigned int bits = message[plane[y*stride+x] & sampleMask];
+      if (numHighBits)
       {
-        crcMsb = (crcVal >> 15) & 1;
-        bitVal = (plane[y*stride+x]>> (dataMsbIdx - (bitIdx&dataMsbIdx))) & 1;
-        crcVal = (((crcVal << 1) + bitVal) & 0xffff) ^ (crcMsb * 0x1021);
+        crcVal = (((crcVal << numHighBits) | (bits >> 8)) & 0xffff) ^ highTable[crcVal >> (16 - numHighBits)];
       }
+      crcVal = (((crcVal << 8) | (bits & 0xff)) & 0xffff) ^ byteTable[crcVal >> 8];
     }
   }
-  for(bitIdx=0; bitIdx<16; bitIdx++)
+  for (unsigned int i = 0; i < 2; i++)
   {
-    crcMsb = (crcVal >> 15) & 1;
-    crcVal = ((crcVal << 1) & 0xffff) ^ (crcMsb * 0x1021);
+    crcVal = ((crcVal << 8) & 0xffff) ^ byteTable[crcVal >> 8];
   }
 
   digest[0] = (crcVal>>8)  & 0xff;
@@ -136,16 +216,47 @@ void compChecksum(const Pel* plane, unsigned int width, unsigned int height, uns
   unsigned int checksum = 0;
   unsigned char xor_mask;
 
+  /* horizontal part of xor_mask, shared by all lines */
+  std::vector<Pel> xMask(width + 8);
+  for (unsigned x = 0; x < width; x++)
+  {
+    xMask[x] = (x & 0xff) ^ (x >> 8);
+  }
+
   for (unsigned y = 0; y < height; y++)
   {
-    for (unsigned x = 0; x < width; x++)
+    const Pel* src = &plane[y*stride];
+    unsigned char yMask = (y & 0xff) ^ (y >> 8);
+    unsigned x = 0;
+#if HAS_SSE2
+    /* the sum is taken modulo 2^32, so it can be accumulated in any order */
+    const __m128i lowByte = _mm_set1_epi16(0xff);
+    const __m128i one     = _mm_set1_epi16(1);
+    const __m128i yMaskV  = _mm_set1_epi16(yMask);
+    __m128i sum = _mm_setzero_si128();
+    for (; x + 8 <= width; x += 8)
+    {
+      __m128i pel  = _mm_loadu_si128((const __m128i*)&src[x]);
+      __m128i mask = _mm_xor_si128(_mm_loadu_si128((const __m128i*)&xMask[x]), yMaskV);
+      __m128i term = _mm_xor_si128(_mm_and_si128(pel, lowByte), mask);
+      if(bitdepth > 8)
+      {
+        term = _mm_add_epi16(term, _mm_xor_si128(_mm_srli_epi16(pel, 8), mask));
+      }
+      sum = _mm_add_epi32(sum, _mm_madd_epi16(term, one));
+    }
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0x4e));
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0xb1));
+    checksum += (unsigned int)_mm_cvtsi128_si32(sum);
+#endif
+    for (; x < width; x++)
     {
-      xor_mask = (x & 0xff) ^ (y & 0xff) ^ (x >> 8) ^ (y >> 8);
-      checksum = (checksum + ((plane[y*stride+x] & 0xff) ^ xor_mask)) & 0xffffffff;
+      xor_mask = xMask[x] ^ yMask;
+      checksum = (checksum + ((src[x] & 0xff) ^ xor_mask)) & 0xffffffff;
 
       if(bitdepth > 8)
       {
-        checksum = (checksum + ((plane[y*stride+x]>>8) ^ xor_mask)) & 0xffffffff;
+        checksum = (checksum + ((src[x]>>8) ^ xor_mask)) & 0xffffffff;
       }
     }
   }
@@ -37,9 +37,14 @@
 
 #include <math.h>
 #include <assert.h>
+#include <string.h>
 #include "TComRom.h"
 #include "TComRdCost.h"
 
+#if HAS_SSE2
+#include <emmintrin.h>
+#endif
+
 //! \ingroup TLibCommon
 //! \{
 
@@ -2286,4 +2291,56 @@ UInt TComRdCost::xGetHADs( DistParam* pcDtParam )
   return ( uiSum >> g_uiBitIncrement );
 }
 
+/** sum of absolute differences between two blocks of 8-bit samples
+ * \param piOrg      first block
+ * \param iStrideOrg stride of piOrg
+ * \param piCur      second block
+ * \param iStrideCur stride of piCur
+ * \param iCols      block width, a multiple of 4
+ * \param iRows      block height
+ * \returns accumulated absolute sample differences
+ */
+UInt calcSAD8( const UChar* piOrg, Int iStrideOrg, const UChar* piCur, Int iStrideCur, Int iCols, Int iRows )
+{
+#if HAS_SSE2
+  __m128i cSum = _mm_setzero_si128();
+  for ( ; iRows != 0; iRows-- )
+  {
+    Int iX = 0;
+    for ( ; iX + 16 <= iCols; iX += 16 )
+    {
+      cSum = _mm_add_epi64( cSum, _mm_sad_epu8( _mm_loadu_si128( (const __m128i*)( piOrg + iX ) ), _mm_loadu_si128( (const __m128i*)( piCur + iX ) ) ) );
+    }
+    if ( iX + 8 <= iCols )
+    {
+      cSum = _mm_add_epi64( cSum, _mm_sad_epu8( _mm_loadl_epi64( (const __m128i*)( piOrg + iX ) ), _mm_loadl_epi64( (const __m128i*)( piCur + iX ) ) ) );
+      iX += 8;
+    }
+    if ( iX < iCols )
+    {
+      Int iOrg4, iCur4;
+      ::memcpy( &iOrg4, piOrg + iX, 4 );
+      ::memcpy( &iCur4, piCur + iX, 4 );
+      cSum = _mm_add_epi64( cSum, _mm_sad_epu8( _mm_cvtsi32_si128( iOrg4 ), _mm_cvtsi32_si128( iCur4 ) ) );
+    }
+    piOrg += iStrideOrg;
+    piCur += iStrideCur;
+  }
+  cSum = _mm_add_epi64( cSum, _mm_unpackhi_epi64( cSum, cSum ) );
+  return (UInt)_mm_cvtsi128_si32( cSum );
+#else
+  UInt uiSum = 0;
+  for ( ; iRows != 0; iRows-- )
+  {
+    for ( Int iX = 0; iX < iCols; iX++ )
+    {
+      uiSum += abs( piOrg[iX] - piCur[iX] );
+    }
+    piOrg += iStrideOrg;
+    piCur += iStrideCur;
+  }
+  return uiSum;
+#endif
+}
+
 //! \}
@@ -155,9 +155,11 @@ public:
   
 #if WEIGHTED_CHROMA_DISTORTION
   Void    setChromaDistortionWeight      ( Double chromaDistortionWeight) { m_chromaDistortionWeight = chromaDistortionWeight; };
+  Double  getChromaDistortionWeight      ()   { return m_chromaDistortionWeight; }
 #endif
   Void    setLambda      ( Double dLambda );
   Void    setFrameLambda ( Double dLambda ) { m_dFrameLambda = dLambda; }
+  Double  getLambda      ()   { return m_dLambda; }
   
   Double  getSqrtLambda ()   { return m_sqrtLambda; }
   
@@ -257,6 +259,8 @@ public:
   
 };// END CLASS DEFINITION TComRdCost
 
+UInt calcSAD8( const UChar* piOrg, Int iStrideOrg, const UChar* piCur, Int iStrideCur, Int iCols, Int iRows );
+
 //! \}
 
 #endif // __TCOMRDCOST__
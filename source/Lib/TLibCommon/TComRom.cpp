@@ -46,11 +46,19 @@
 //! \ingroup TLibCommon
 //! \{
 
+/// number of coder instances using the ROM tables, several encoders of one process share them
+static UInt s_uiROMUsers = 0;
+
 // initialize ROM variables
 Void initROM()
 {
   Int i, c;
   
+  if ( s_uiROMUsers++ > 0 )
+  {
+    return;
+  }
+  
   // g_aucConvertToBit[ x ]: log2(x/4), if x=4 -> 0, x=8 -> 1, x=16 -> 2, ...
   ::memset( g_aucConvertToBit,   -1, sizeof( g_aucConvertToBit ) );
   c=0;
@@ -143,6 +151,11 @@ Void destroyROM()
 {
   Int i;
   
+  if ( s_uiROMUsers == 0 || --s_uiROMUsers > 0 )
+  {
+    return;
+  }
+  
   for ( i=0; i<MAX_CU_DEPTH; i++ )
   {
 #if !REMOVE_ZIGZAG_SCAN
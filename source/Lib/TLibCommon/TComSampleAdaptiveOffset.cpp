@@ -1064,7 +1064,7 @@ Pel* TComSampleAdaptiveOffset::getPicYuvAddr(TComPicYuv* pcPicYuv, Int iYCbCr, I
     break;
   }
 }
-/** Process SAO all units 
+/** Process SAO all units, extending the picture margins of each finished CTU row of reference pictures
  * \param saoLcuParam SAO LCU parameters
  * \param oneUnitFlag one unit flag
  * \param yCbCr color componet index
@@ -1107,6 +1107,7 @@ Void TComSampleAdaptiveOffset::processSaoUnitAll(SaoLcuParam* saoLcuParam, Bool
   Pel *tmpUSwap;
   Int isChroma = (yCbCr == 0) ? 0:1;
   Bool mergeLeftFlag;
+  Bool extendRows = m_pcPic->getSlice(0)->isReferenced();
 
   offset[0] = 0;
   for (idxY = 0; idxY< frameHeightInCU; idxY++)
@@ -1232,6 +1233,12 @@ Void TComSampleAdaptiveOffset::processSaoUnitAll(SaoLcuParam* saoLcuParam, Bool
     tmpUSwap = m_pTmpU1;
     m_pTmpU1 = m_pTmpU2;
     m_pTmpU2 = tmpUSwap;
+
+    // the row is final: pad its margins while it is still in cache
+    if (extendRows)
+    {
+      m_pcPic->getPicYuvRec()->extendPicBorderRows(yCbCr, idxY+1);
+    }
   }
 
 }
@@ -0,0 +1,345 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.  
+ *
+ * Copyright (c) 2010-2012, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** \file     TComThread.cpp
+    \brief    portable threading primitives and job queue
+*/
+
+#include <assert.h>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+
+#include "TComThread.h"
+
+//! \ingroup TLibCommon
+//! \{
+
+// ====================================================================================================================
+// Platform layer
+// ====================================================================================================================
+
+/// entry point and argument handed to a new thread
+struct ThreadStart
+{
+  Void (*pFunc)( Void* );
+  Void* pArg;
+};
+
+#ifdef _WIN32
+
+static DWORD WINAPI xThreadEntry( LPVOID pParam )
+{
+  ThreadStart* pStart = (ThreadStart*)pParam;
+  pStart->pFunc( pStart->pArg );
+  delete pStart;
+  return 0;
+}
+
+static Void* xCreateThread( Void (*pFunc)( Void* ), Void* pArg )
+{
+  ThreadStart* pStart = new ThreadStart;
+  pStart->pFunc = pFunc;
+  pStart->pArg  = pArg;
+  HANDLE hThread = CreateThread( NULL, 0, xThreadEntry, pStart, 0, NULL );
+  assert( hThread != NULL );
+  return hThread;
+}
+
+static Void xJoinThread( Void* pThread )
+{
+  WaitForSingleObject( (HANDLE)pThread, INFINITE );
+  CloseHandle( (HANDLE)pThread );
+}
+
+TComMutex::TComMutex()
+{
+  CRITICAL_SECTION* pcs = new CRITICAL_SECTION;
+  InitializeCriticalSection( pcs );
+  m_pHandle = pcs;
+}
+
+TComMutex::~TComMutex()
+{
+  DeleteCriticalSection( (CRITICAL_SECTION*)m_pHandle );
+  delete (CRITICAL_SECTION*)m_pHandle;
+}
+
+Void TComMutex::lock()
+{
+  EnterCriticalSection( (CRITICAL_SECTION*)m_pHandle );
+}
+
+Void TComMutex::unlock()
+{
+  LeaveCriticalSection( (CRITICAL_SECTION*)m_pHandle );
+}
+
+TComCondition::TComCondition()
+{
+  CONDITION_VARIABLE* pcv = new CONDITION_VARIABLE;
+  InitializeConditionVariable( pcv );
+  m_pHandle = pcv;
+}
+
+TComCondition::~TComCondition()
+{
+  delete (CONDITION_VARIABLE*)m_pHandle;
+}
+
+Void TComCondition::wait( TComMutex& rcMutex )
+{
+  SleepConditionVariableCS( (CONDITION_VARIABLE*)m_pHandle, (CRITICAL_SECTION*)rcMutex.m_pHandle, INFINITE );
+}
+
+Void TComCondition::signal()
+{
+  WakeConditionVariable( (CONDITION_VARIABLE*)m_pHandle );
+}
+
+Void TComCondition::broadcast()
+{
+  WakeAllConditionVariable( (CONDITION_VARIABLE*)m_pHandle );
+}
+
+#else
+
+static Void* xThreadEntry( Void* pParam )
+{
+  ThreadStart* pStart = (ThreadStart*)pParam;
+  pStart->pFunc( pStart->pArg );
+  delete pStart;
+  return NULL;
+}
+
+static Void* xCreateThread( Void (*pFunc)( Void* ), Void* pArg )
+{
+  ThreadStart* pStart = new ThreadStart;
+  pStart->pFunc = pFunc;
+  pStart->pArg  = pArg;
+  pthread_t* pThread = new pthread_t;
+  Int iRet = pthread_create( pThread, NULL, xThreadEntry, pStart );
+  assert( iRet == 0 );
+  (Void)iRet;
+  return pThread;
+}
+
+static Void xJoinThread( Void* pThread )
+{
+  pthread_join( *(pthread_t*)pThread, NULL );
+  delete (pthread_t*)pThread;
+}
+
+TComMutex::TComMutex()
+{
+  pthread_mutex_t* pMutex = new pthread_mutex_t;
+  pthread_mutex_init( pMutex, NULL );
+  m_pHandle = pMutex;
+}
+
+TComMutex::~TComMutex()
+{
+  pthread_mutex_destroy( (pthread_mutex_t*)m_pHandle );
+  delete (pthread_mutex_t*)m_pHandle;
+}
+
+Void TComMutex::lock()
+{
+  pthread_mutex_lock( (pthread_mutex_t*)m_pHandle );
+}
+
+Void TComMutex::unlock()
+{
+  pthread_mutex_unlock( (pthread_mutex_t*)m_pHandle );
+}
+
+TComCondition::TComCondition()
+{
+  pthread_cond_t* pCond = new pthread_cond_t;
+  pthread_cond_init( pCond, NULL );
+  m_pHandle = pCond;
+}
+
+TComCondition::~TComCondition()
+{
+  pthread_cond_destroy( (pthread_cond_t*)m_pHandle );
+  delete (pthread_cond_t*)m_pHandle;
+}
+
+Void TComCondition::wait( TComMutex& rcMutex )
+{
+  pthread_cond_wait( (pthread_cond_t*)m_pHandle, (pthread_mutex_t*)rcMutex.m_pHandle );
+}
+
+Void TComCondition::signal()
+{
+  pthread_cond_signal( (pthread_cond_t*)m_pHandle );
+}
+
+Void TComCondition::broadcast()
+{
+  pthread_cond_broadcast( (pthread_cond_t*)m_pHandle );
+}
+
+#endif
+
+// ====================================================================================================================
+// Job queue
+// ====================================================================================================================
+
+TComJobQueue::TComJobQueue()
+: m_iNumPending ( 0 )
+, m_bTerminate  ( false )
+{
+}
+
+TComJobQueue::~TComJobQueue()
+{
+  destroy();
+}
+
+/** start the worker threads
+ * \param iNumThreads number of worker threads, 0 executes every job synchronously in submit()
+ */
+Void TComJobQueue::create( Int iNumThreads )
+{
+  assert( m_apThreads.empty() );
+  m_bTerminate = false;
+  for ( Int i = 0; i < iNumThreads; i++ )
+  {
+    m_apThreads.push_back( xCreateThread( xRunWorker, this ) );
+  }
+}
+
+/** finish all queued jobs and stop the worker threads
+ */
+Void TComJobQueue::destroy()
+{
+  if ( m_apThreads.empty() )
+  {
+    return;
+  }
+  waitAll();
+  m_cMutex.lock();
+  m_bTerminate = true;
+  m_cJobAvailable.broadcast();
+  m_cMutex.unlock();
+  for ( UInt i = 0; i < m_apThreads.size(); i++ )
+  {
+    xJoinThread( m_apThreads[i] );
+  }
+  m_apThreads.clear();
+}
+
+Void TComJobQueue::submit( TComJob* pcJob )
+{
+  pcJob->m_bDone = false;
+  if ( m_apThreads.empty() )
+  {
+    pcJob->execute();
+    pcJob->m_bDone = true;
+    return;
+  }
+  TComLock cLock( m_cMutex );
+  m_cJobs.push_back( pcJob );
+  m_iNumPending++;
+  m_cJobAvailable.signal();
+}
+
+/** block until the given job has been executed
+ */
+Void TComJobQueue::wait( TComJob* pcJob )
+{
+  TComLock cLock( m_cMutex );
+  while ( !pcJob->m_bDone )
+  {
+    m_cJobFinished.wait( m_cMutex );
+  }
+}
+
+/** block until every submitted job has been executed
+ */
+Void TComJobQueue::waitAll()
+{
+  TComLock cLock( m_cMutex );
+  while ( m_iNumPending > 0 )
+  {
+    m_cJobFinished.wait( m_cMutex );
+  }
+}
+
+Bool TComJobQueue::isDone( TComJob* pcJob )
+{
+  TComLock cLock( m_cMutex );
+  return pcJob->m_bDone;
+}
+
+Void TComJobQueue::xRunWorker( Void* pArg )
+{
+  ((TComJobQueue*)pArg)->xWorkerLoop();
+}
+
+Void TComJobQueue::xWorkerLoop()
+{
+  m_cMutex.lock();
+  for ( ;; )
+  {
+    while ( m_cJobs.empty() && !m_bTerminate )
+    {
+      m_cJobAvailable.wait( m_cMutex );
+    }
+    if ( m_cJobs.empty() )
+    {
+      break;
+    }
+    TComJob* pcJob = m_cJobs.front();
+    m_cJobs.pop_front();
+    m_cMutex.unlock();
+
+    pcJob->execute();
+
+    m_cMutex.lock();
+    pcJob->m_bDone = true;
+    m_iNumPending--;
+    m_cJobFinished.broadcast();
+  }
+  m_cMutex.unlock();
+}
+
+//! \}
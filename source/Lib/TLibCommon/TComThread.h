@@ -0,0 +1,156 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.  
+ *
+ * Copyright (c) 2010-2012, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** \file     TComThread.h
+    \brief    portable threading primitives and job queue (header)
+*/
+
+#ifndef __TCOMTHREAD__
+#define __TCOMTHREAD__
+
+#if _MSC_VER > 1000
+#pragma once
+#endif // _MSC_VER > 1000
+
+#include <deque>
+#include <vector>
+#include "CommonDef.h"
+
+//! \ingroup TLibCommon
+//! \{
+
+// ====================================================================================================================
+// Class definition
+// ====================================================================================================================
+
+/// mutual exclusion lock (pthread mutex or Win32 critical section)
+class TComMutex
+{
+public:
+  TComMutex();
+  ~TComMutex();
+
+  Void  lock    ();
+  Void  unlock  ();
+
+private:
+  friend class TComCondition;
+  Void* m_pHandle;
+
+  TComMutex( const TComMutex& );
+  TComMutex& operator= ( const TComMutex& );
+};
+
+/// locks a mutex for the lifetime of the object
+class TComLock
+{
+public:
+  TComLock( TComMutex& rcMutex ) : m_rcMutex( rcMutex ) { m_rcMutex.lock(); }
+  ~TComLock()                                           { m_rcMutex.unlock(); }
+
+private:
+  TComMutex& m_rcMutex;
+
+  TComLock( const TComLock& );
+  TComLock& operator= ( const TComLock& );
+};
+
+/// condition variable, always used together with a locked TComMutex
+class TComCondition
+{
+public:
+  TComCondition();
+  ~TComCondition();
+
+  Void  wait      ( TComMutex& rcMutex );
+  Void  signal    ();
+  Void  broadcast ();
+
+private:
+  Void* m_pHandle;
+
+  TComCondition( const TComCondition& );
+  TComCondition& operator= ( const TComCondition& );
+};
+
+/// unit of work executed by TComJobQueue
+class TComJob
+{
+public:
+  TComJob() : m_bDone( false ) {}
+  virtual ~TComJob() {}
+
+  virtual Void execute() = 0;
+
+private:
+  friend class TComJobQueue;
+  Bool m_bDone;                               ///< set by the queue once execute() has returned
+};
+
+/// FIFO job queue serviced by a pool of worker threads
+/** With zero worker threads jobs are executed synchronously inside submit(), so callers can use
+ *  the same code path whether or not threading is enabled. Jobs are owned by the caller and must
+ *  stay alive until wait() or waitAll() has returned for them.
+ */
+class TComJobQueue
+{
+public:
+  TComJobQueue();
+  ~TComJobQueue();
+
+  Void  create        ( Int iNumThreads );
+  Void  destroy       ();
+
+  Void  submit        ( TComJob* pcJob );
+  Void  wait          ( TComJob* pcJob );
+  Void  waitAll       ();
+  Bool  isDone        ( TComJob* pcJob );
+
+  Int   getNumThreads ()                    { return (Int)m_apThreads.size(); }
+
+private:
+  static Void xRunWorker( Void* pArg );
+  Void  xWorkerLoop   ();
+
+  std::vector<Void*>    m_apThreads;
+  std::deque<TComJob*>  m_cJobs;
+  Int                   m_iNumPending;      ///< jobs submitted but not yet finished
+  Bool                  m_bTerminate;
+  TComMutex             m_cMutex;
+  TComCondition         m_cJobAvailable;
+  TComCondition         m_cJobFinished;
+};
+
+//! \}
+
+#endif // __TCOMTHREAD__
@@ -541,25 +541,58 @@ void partialButterfly8(short *src,short *dst,int shift, int line)
 }
 
 
-void partialButterflyInverse8(short *src,short *dst,int shift, int line)
+/** 8-point inverse partial butterfly
+ *  \param line number of transforms, also the stride of src
+ *  \param numLines number of leading transforms to compute, the input of the others is all zero and their output is not needed
+ *  \param numNzIn number of leading input samples of each transform that may be non-zero
+ */
+void partialButterflyInverse8(short *src,short *dst,int shift, int line, int numLines, int numNzIn)
 {
-  int j,k;    
+  int j,k,r;    
   int E[4],O[4];
   int EE[2],EO[2];
   int add = 1<<(shift-1);
 
-  for (j=0; j<line; j++) 
+  for (j=0; j<numLines; j++) 
   {    
-    /* Utilizing symmetry properties to the maximum to minimize the number of multiplications */
-    for (k=0;k<4;k++)
+    if (numNzIn == 8)
     {
-      O[k] = g_aiT8[ 1][k]*src[line] + g_aiT8[ 3][k]*src[3*line] + g_aiT8[ 5][k]*src[5*line] + g_aiT8[ 7][k]*src[7*line];
-    }
+      /* Utilizing symmetry properties to the maximum to minimize the number of multiplications */
+      for (k=0;k<4;k++)
+      {
+        O[k] = g_aiT8[ 1][k]*src[line] + g_aiT8[ 3][k]*src[3*line] + g_aiT8[ 5][k]*src[5*line] + g_aiT8[ 7][k]*src[7*line];
+      }
 
-    EO[0] = g_aiT8[2][0]*src[ 2*line ] + g_aiT8[6][0]*src[ 6*line ];
-    EO[1] = g_aiT8[2][1]*src[ 2*line ] + g_aiT8[6][1]*src[ 6*line ];
-    EE[0] = g_aiT8[0][0]*src[ 0      ] + g_aiT8[4][0]*src[ 4*line ];
-    EE[1] = g_aiT8[0][1]*src[ 0      ] + g_aiT8[4][1]*src[ 4*line ];
+      EO[0] = g_aiT8[2][0]*src[ 2*line ] + g_aiT8[6][0]*src[ 6*line ];
+      EO[1] = g_aiT8[2][1]*src[ 2*line ] + g_aiT8[6][1]*src[ 6*line ];
+      EE[0] = g_aiT8[0][0]*src[ 0      ] + g_aiT8[4][0]*src[ 4*line ];
+      EE[1] = g_aiT8[0][1]*src[ 0      ] + g_aiT8[4][1]*src[ 4*line ];
+    }
+    else
+    {
+      /* same sums restricted to the input samples that may be non-zero */
+      for (k=0;k<4;k++)
+      {
+        O[k] = 0;
+        for (r=1;r<numNzIn;r+=2)
+        {
+          O[k] += g_aiT8[r][k]*src[r*line];
+        }
+      }
+      for (k=0;k<2;k++)
+      {
+        EO[k] = 0;
+        EE[k] = g_aiT8[0][k]*src[0];
+        for (r=2;r<numNzIn;r+=4)
+        {
+          EO[k] += g_aiT8[r][k]*src[r*line];
+        }
+        for (r=4;r<numNzIn;r+=8)
+        {
+          EE[k] += g_aiT8[r][k]*src[r*line];
+        }
+      }
+    }
 
     /* Combining even and odd terms at each hierarchy levels to calculate the final spatial domain vector */ 
     E[0] = EE[0] + EO[0];
@@ -628,30 +661,71 @@ void partialButterfly16(short *src,short *dst,int shift, int line)
 }
 
 
-void partialButterflyInverse16(short *src,short *dst,int shift, int line)
+/** 16-point inverse partial butterfly
+ *  \param line number of transforms, also the stride of src
+ *  \param numLines number of leading transforms to compute, the input of the others is all zero and their output is not needed
+ *  \param numNzIn number of leading input samples of each transform that may be non-zero
+ */
+void partialButterflyInverse16(short *src,short *dst,int shift, int line, int numLines, int numNzIn)
 {
-  int j,k;  
+  int j,k,r;  
   int E[8],O[8];
   int EE[4],EO[4];
   int EEE[2],EEO[2];
   int add = 1<<(shift-1);
 
-  for (j=0; j<line; j++)
+  for (j=0; j<numLines; j++)
   {    
-    /* Utilizing symmetry properties to the maximum to minimize the number of multiplications */
-    for (k=0;k<8;k++)
+    if (numNzIn == 16)
     {
-      O[k] = g_aiT16[ 1][k]*src[ line] + g_aiT16[ 3][k]*src[ 3*line] + g_aiT16[ 5][k]*src[ 5*line] + g_aiT16[ 7][k]*src[ 7*line] + 
-        g_aiT16[ 9][k]*src[ 9*line] + g_aiT16[11][k]*src[11*line] + g_aiT16[13][k]*src[13*line] + g_aiT16[15][k]*src[15*line];
+      /* Utilizing symmetry properties to the maximum to minimize the number of multiplications */
+      for (k=0;k<8;k++)
+      {
+        O[k] = g_aiT16[ 1][k]*src[ line] + g_aiT16[ 3][k]*src[ 3*line] + g_aiT16[ 5][k]*src[ 5*line] + g_aiT16[ 7][k]*src[ 7*line] + 
+          g_aiT16[ 9][k]*src[ 9*line] + g_aiT16[11][k]*src[11*line] + g_aiT16[13][k]*src[13*line] + g_aiT16[15][k]*src[15*line];
+      }
+      for (k=0;k<4;k++)
+      {
+        EO[k] = g_aiT16[ 2][k]*src[ 2*line] + g_aiT16[ 6][k]*src[ 6*line] + g_aiT16[10][k]*src[10*line] + g_aiT16[14][k]*src[14*line];
+      }
+      EEO[0] = g_aiT16[4][0]*src[ 4*line ] + g_aiT16[12][0]*src[ 12*line ];
+      EEE[0] = g_aiT16[0][0]*src[ 0      ] + g_aiT16[ 8][0]*src[ 8*line  ];
+      EEO[1] = g_aiT16[4][1]*src[ 4*line ] + g_aiT16[12][1]*src[ 12*line ];
+      EEE[1] = g_aiT16[0][1]*src[ 0      ] + g_aiT16[ 8][1]*src[ 8*line  ];
     }
-    for (k=0;k<4;k++)
+    else
     {
-      EO[k] = g_aiT16[ 2][k]*src[ 2*line] + g_aiT16[ 6][k]*src[ 6*line] + g_aiT16[10][k]*src[10*line] + g_aiT16[14][k]*src[14*line];
+      /* same sums restricted to the input samples that may be non-zero */
+      for (k=0;k<8;k++)
+      {
+        O[k] = 0;
+        for (r=1;r<numNzIn;r+=2)
+        {
+          O[k] += g_aiT16[r][k]*src[r*line];
+        }
+      }
+      for (k=0;k<4;k++)
+      {
+        EO[k] = 0;
+        for (r=2;r<numNzIn;r+=4)
+        {
+          EO[k] += g_aiT16[r][k]*src[r*line];
+        }
+      }
+      for (k=0;k<2;k++)
+      {
+        EEO[k] = 0;
+        EEE[k] = g_aiT16[0][k]*src[0];
+        for (r=4;r<numNzIn;r+=8)
+        {
+          EEO[k] += g_aiT16[r][k]*src[r*line];
+        }
+        for (r=8;r<numNzIn;r+=16)
+        {
+          EEE[k] += g_aiT16[r][k]*src[r*line];
+        }
+      }
     }
-    EEO[0] = g_aiT16[4][0]*src[ 4*line ] + g_aiT16[12][0]*src[ 12*line ];
-    EEE[0] = g_aiT16[0][0]*src[ 0      ] + g_aiT16[ 8][0]*src[ 8*line  ];
-    EEO[1] = g_aiT16[4][1]*src[ 4*line ] + g_aiT16[12][1]*src[ 12*line ];
-    EEE[1] = g_aiT16[0][1]*src[ 0      ] + g_aiT16[ 8][1]*src[ 8*line  ];
 
     /* Combining even and odd terms at each hierarchy levels to calculate the final spatial domain vector */ 
     for (k=0;k<2;k++)
@@ -736,38 +810,87 @@ void partialButterfly32(short *src,short *dst,int shift, int line)
 }
 
 
-void partialButterflyInverse32(short *src,short *dst,int shift, int line)
+/** 32-point inverse partial butterfly
+ *  \param line number of transforms, also the stride of src
+ *  \param numLines number of leading transforms to compute, the input of the others is all zero and their output is not needed
+ *  \param numNzIn number of leading input samples of each transform that may be non-zero
+ */
+void partialButterflyInverse32(short *src,short *dst,int shift, int line, int numLines, int numNzIn)
 {
-  int j,k;  
+  int j,k,r;  
   int E[16],O[16];
   int EE[8],EO[8];
   int EEE[4],EEO[4];
   int EEEE[2],EEEO[2];
   int add = 1<<(shift-1);
 
-  for (j=0; j<line; j++)
+  for (j=0; j<numLines; j++)
   {    
-    /* Utilizing symmetry properties to the maximum to minimize the number of multiplications */
-    for (k=0;k<16;k++)
-    {
-      O[k] = g_aiT32[ 1][k]*src[ line  ] + g_aiT32[ 3][k]*src[ 3*line  ] + g_aiT32[ 5][k]*src[ 5*line  ] + g_aiT32[ 7][k]*src[ 7*line  ] + 
-        g_aiT32[ 9][k]*src[ 9*line  ] + g_aiT32[11][k]*src[ 11*line ] + g_aiT32[13][k]*src[ 13*line ] + g_aiT32[15][k]*src[ 15*line ] + 
-        g_aiT32[17][k]*src[ 17*line ] + g_aiT32[19][k]*src[ 19*line ] + g_aiT32[21][k]*src[ 21*line ] + g_aiT32[23][k]*src[ 23*line ] + 
-        g_aiT32[25][k]*src[ 25*line ] + g_aiT32[27][k]*src[ 27*line ] + g_aiT32[29][k]*src[ 29*line ] + g_aiT32[31][k]*src[ 31*line ];
-    }
-    for (k=0;k<8;k++)
+    if (numNzIn == 32)
     {
-      EO[k] = g_aiT32[ 2][k]*src[ 2*line  ] + g_aiT32[ 6][k]*src[ 6*line  ] + g_aiT32[10][k]*src[ 10*line ] + g_aiT32[14][k]*src[ 14*line ] + 
-        g_aiT32[18][k]*src[ 18*line ] + g_aiT32[22][k]*src[ 22*line ] + g_aiT32[26][k]*src[ 26*line ] + g_aiT32[30][k]*src[ 30*line ];
+      /* Utilizing symmetry properties to the maximum to minimize the number of multiplications */
+      for (k=0;k<16;k++)
+      {
+        O[k] = g_aiT32[ 1][k]*src[ line  ] + g_aiT32[ 3][k]*src[ 3*line  ] + g_aiT32[ 5][k]*src[ 5*line  ] + g_aiT32[ 7][k]*src[ 7*line  ] + 
+          g_aiT32[ 9][k]*src[ 9*line  ] + g_aiT32[11][k]*src[ 11*line ] + g_aiT32[13][k]*src[ 13*line ] + g_aiT32[15][k]*src[ 15*line ] + 
+          g_aiT32[17][k]*src[ 17*line ] + g_aiT32[19][k]*src[ 19*line ] + g_aiT32[21][k]*src[ 21*line ] + g_aiT32[23][k]*src[ 23*line ] + 
+          g_aiT32[25][k]*src[ 25*line ] + g_aiT32[27][k]*src[ 27*line ] + g_aiT32[29][k]*src[ 29*line ] + g_aiT32[31][k]*src[ 31*line ];
+      }
+      for (k=0;k<8;k++)
+      {
+        EO[k] = g_aiT32[ 2][k]*src[ 2*line  ] + g_aiT32[ 6][k]*src[ 6*line  ] + g_aiT32[10][k]*src[ 10*line ] + g_aiT32[14][k]*src[ 14*line ] + 
+          g_aiT32[18][k]*src[ 18*line ] + g_aiT32[22][k]*src[ 22*line ] + g_aiT32[26][k]*src[ 26*line ] + g_aiT32[30][k]*src[ 30*line ];
+      }
+      for (k=0;k<4;k++)
+      {
+        EEO[k] = g_aiT32[4][k]*src[ 4*line ] + g_aiT32[12][k]*src[ 12*line ] + g_aiT32[20][k]*src[ 20*line ] + g_aiT32[28][k]*src[ 28*line ];
+      }
+      EEEO[0] = g_aiT32[8][0]*src[ 8*line ] + g_aiT32[24][0]*src[ 24*line ];
+      EEEO[1] = g_aiT32[8][1]*src[ 8*line ] + g_aiT32[24][1]*src[ 24*line ];
+      EEEE[0] = g_aiT32[0][0]*src[ 0      ] + g_aiT32[16][0]*src[ 16*line ];    
+      EEEE[1] = g_aiT32[0][1]*src[ 0      ] + g_aiT32[16][1]*src[ 16*line ];
     }
-    for (k=0;k<4;k++)
+    else
     {
-      EEO[k] = g_aiT32[4][k]*src[ 4*line ] + g_aiT32[12][k]*src[ 12*line ] + g_aiT32[20][k]*src[ 20*line ] + g_aiT32[28][k]*src[ 28*line ];
+      /* same sums restricted to the input samples that may be non-zero */
+      for (k=0;k<16;k++)
+      {
+        O[k] = 0;
+        for (r=1;r<numNzIn;r+=2)
+        {
+          O[k] += g_aiT32[r][k]*src[r*line];
+        }
+      }
+      for (k=0;k<8;k++)
+      {
+        EO[k] = 0;
+        for (r=2;r<numNzIn;r+=4)
+        {
+          EO[k] += g_aiT32[r][k]*src[r*line];
+        }
+      }
+      for (k=0;k<4;k++)
+      {
+        EEO[k] = 0;
+        for (r=4;r<numNzIn;r+=8)
+        {
+          EEO[k] += g_aiT32[r][k]*src[r*line];
+        }
+      }
+      for (k=0;k<2;k++)
+      {
+        EEEO[k] = 0;
+        EEEE[k] = g_aiT32[0][k]*src[0];
+        for (r=8;r<numNzIn;r+=16)
+        {
+          EEEO[k] += g_aiT32[r][k]*src[r*line];
+        }
+        for (r=16;r<numNzIn;r+=32)
+        {
+          EEEE[k] += g_aiT32[r][k]*src[r*line];
+        }
+      }
     }
-    EEEO[0] = g_aiT32[8][0]*src[ 8*line ] + g_aiT32[24][0]*src[ 24*line ];
-    EEEO[1] = g_aiT32[8][1]*src[ 8*line ] + g_aiT32[24][1]*src[ 24*line ];
-    EEEE[0] = g_aiT32[0][0]*src[ 0      ] + g_aiT32[16][0]*src[ 16*line ];    
-    EEEE[1] = g_aiT32[0][1]*src[ 0      ] + g_aiT32[16][1]*src[ 16*line ];
 
     /* Combining even and odd terms at each hierarchy levels to calculate the final spatial domain vector */
     EEE[0] = EEEE[0] + EEEO[0];
@@ -888,8 +1011,12 @@ void xTrMxN(short *block,short *coeff, int iWidth, int iHeight, UInt uiMode)
 *  \param block output data (residual)
 *  \param iWidth input data (width of transform)
 *  \param iHeight input data (height of transform)
+*  \param sigWidth width of the top-left region holding all non-zero coefficients
+*  \param sigHeight height of the top-left region holding all non-zero coefficients
+*
+*  Coefficients outside the significant region are not read.
 */
-void xITrMxN(short *coeff,short *block, int iWidth, int iHeight, UInt uiMode)
+void xITrMxN(short *coeff,short *block, int iWidth, int iHeight, UInt uiMode, int sigWidth, int sigHeight)
 {
   int shift_1st = SHIFT_INV_1ST;
 #if FULL_NBIT
@@ -898,27 +1025,39 @@ void xITrMxN(short *coeff,short *block, int iWidth, int iHeight, UInt uiMode)
   int shift_2nd = SHIFT_INV_2ND - g_uiBitIncrement;
 #endif
 
+  if( sigWidth == 1 && sigHeight == 1 && ( iWidth > 4 || uiMode == REG_DCT ) )
+  {
+    /* DC only: every basis function of row 0 equals 64, so both stages reduce to a scaling */
+    int dc = Clip3( -32768, 32767, ( 64 * coeff[0] + ( 1 << ( shift_1st - 1 ) ) ) >> shift_1st );
+    dc     = Clip3( -32768, 32767, ( 64 * dc       + ( 1 << ( shift_2nd - 1 ) ) ) >> shift_2nd );
+    for( int n = 0; n < iWidth * iHeight; n++ )
+    {
+      block[n] = (short)dc;
+    }
+    return;
+  }
+
   short tmp[ 64*64];
 #if !REMOVE_NSQT
   if( iWidth == 16 && iHeight == 4)
   {
     partialButterflyInverse4(coeff,tmp,shift_1st,iWidth);
-    partialButterflyInverse16(tmp,block,shift_2nd,iHeight);
+    partialButterflyInverse16(tmp,block,shift_2nd,iHeight,iHeight,16);
   }
   else if( iWidth == 32 && iHeight == 8)
   {
-    partialButterflyInverse8(coeff,tmp,shift_1st,iWidth);
-    partialButterflyInverse32(tmp,block,shift_2nd,iHeight);
+    partialButterflyInverse8(coeff,tmp,shift_1st,iWidth,iWidth,8);
+    partialButterflyInverse32(tmp,block,shift_2nd,iHeight,iHeight,32);
   }
   else if( iWidth == 4 && iHeight == 16)
   {
-    partialButterflyInverse16(coeff,tmp,shift_1st,iWidth);
+    partialButterflyInverse16(coeff,tmp,shift_1st,iWidth,iWidth,16);
     partialButterflyInverse4(tmp,block,shift_2nd,iHeight);
   }
   else if( iWidth == 8 && iHeight == 32)
   {
-    partialButterflyInverse32(coeff,tmp,shift_1st,iWidth);
-    partialButterflyInverse8(tmp,block,shift_2nd,iHeight);
+    partialButterflyInverse32(coeff,tmp,shift_1st,iWidth,iWidth,32);
+    partialButterflyInverse8(tmp,block,shift_2nd,iHeight,iHeight,8);
   }
   else
 #endif
@@ -956,18 +1095,18 @@ void xITrMxN(short *coeff,short *block, int iWidth, int iHeight, UInt uiMode)
   }
   else if( iWidth == 8 && iHeight == 8)
   {
-    partialButterflyInverse8(coeff,tmp,shift_1st,iWidth);
-    partialButterflyInverse8(tmp,block,shift_2nd,iHeight);
+    partialButterflyInverse8(coeff,tmp,shift_1st,iWidth,sigWidth,sigHeight);
+    partialButterflyInverse8(tmp,block,shift_2nd,iHeight,iHeight,sigWidth);
   }
   else if( iWidth == 16 && iHeight == 16)
   {
-    partialButterflyInverse16(coeff,tmp,shift_1st,iWidth);
-    partialButterflyInverse16(tmp,block,shift_2nd,iHeight);
+    partialButterflyInverse16(coeff,tmp,shift_1st,iWidth,sigWidth,sigHeight);
+    partialButterflyInverse16(tmp,block,shift_2nd,iHeight,iHeight,sigWidth);
   }
   else if( iWidth == 32 && iHeight == 32)
   {
-    partialButterflyInverse32(coeff,tmp,shift_1st,iWidth);
-    partialButterflyInverse32(tmp,block,shift_2nd,iHeight);
+    partialButterflyInverse32(coeff,tmp,shift_1st,iWidth,sigWidth,sigHeight);
+    partialButterflyInverse32(tmp,block,shift_2nd,iHeight,iHeight,sigWidth);
   }
 }
 
@@ -1269,7 +1408,27 @@ Void TComTrQuant::xQuant( TComDataCU* pcCU,
 
 }
 
-Void TComTrQuant::xDeQuant( const TCoeff* pSrc, Int* pDes, Int iWidth, Int iHeight, Int scalingListType )
+/** Extend the significant region to include a non-zero coefficient
+ * \param iPos raster position of the coefficient
+ * \param uiLog2Width log2 of the block width
+ */
+__inline Void TComTrQuant::xUpdateSigRegion( Int iPos, UInt uiLog2Width, UInt& ruiSigWidth, UInt& ruiSigHeight )
+{
+  UInt uiPosX = ( iPos & ( ( 1 << uiLog2Width ) - 1 ) ) + 1;
+  UInt uiPosY = ( iPos >> uiLog2Width ) + 1;
+  ruiSigWidth  = max( ruiSigWidth,  uiPosX );
+  ruiSigHeight = max( ruiSigHeight, uiPosY );
+}
+
+/** Dequantization of a transform block
+ * \param pSrc quantized coefficients
+ * \param pDes dequantized coefficients
+ * \param ruiSigWidth returns the width of the top-left region that holds all non-zero coefficients
+ * \param ruiSigHeight returns the height of the top-left region that holds all non-zero coefficients
+ *
+ * Zero coefficients are written as zero without being scaled, since they dequantize to zero.
+ */
+Void TComTrQuant::xDeQuant( const TCoeff* pSrc, Int* pDes, Int iWidth, Int iHeight, Int scalingListType, UInt& ruiSigWidth, UInt& ruiSigHeight )
 {
   
   const TCoeff* piQCoef   = pSrc;
@@ -1304,6 +1463,9 @@ Void TComTrQuant::xDeQuant( const TCoeff* pSrc, Int* pDes, Int iWidth, Int iHeig
 
   iShift = QUANT_IQUANT_SHIFT - QUANT_SHIFT - iTransformShift;
 
+  ruiSigWidth  = 0;
+  ruiSigHeight = 0;
+
   TCoeff clipQCoef;
   const Int bitRange = min( 15, ( Int )( 12 + uiLog2TrSize + uiBitDepth - m_cQP.m_iPer) );
   const Int levelLimit = 1 << bitRange;
@@ -1325,6 +1487,12 @@ Void TComTrQuant::xDeQuant( const TCoeff* pSrc, Int* pDes, Int iWidth, Int iHeig
     {
       for( Int n = 0; n < iWidth*iHeight; n++ )
       {
+        if( piQCoef[n] == 0 )
+        {
+          piCoef[n] = 0;
+          continue;
+        }
+        xUpdateSigRegion( n, uiLog2TrSize, ruiSigWidth, ruiSigHeight );
         clipQCoef = Clip3( -32768, 32767, piQCoef[n] );
         iCoeffQ = ((clipQCoef * piDequantCoef[n]) + iAdd ) >> (iShift -  m_cQP.m_iPer);
         piCoef[n] = Clip3(-32768,32767,iCoeffQ);
@@ -1334,6 +1502,12 @@ Void TComTrQuant::xDeQuant( const TCoeff* pSrc, Int* pDes, Int iWidth, Int iHeig
     {
       for( Int n = 0; n < iWidth*iHeight; n++ )
       {
+        if( piQCoef[n] == 0 )
+        {
+          piCoef[n] = 0;
+          continue;
+        }
+        xUpdateSigRegion( n, uiLog2TrSize, ruiSigWidth, ruiSigHeight );
         clipQCoef = Clip3( -levelLimit, levelLimit - 1, piQCoef[n] );
         iCoeffQ = (clipQCoef * piDequantCoef[n]) << (m_cQP.m_iPer - iShift);
         piCoef[n] = Clip3(-32768,32767,iCoeffQ);
@@ -1347,6 +1521,12 @@ Void TComTrQuant::xDeQuant( const TCoeff* pSrc, Int* pDes, Int iWidth, Int iHeig
 
     for( Int n = 0; n < iWidth*iHeight; n++ )
     {
+      if( piQCoef[n] == 0 )
+      {
+        piCoef[n] = 0;
+        continue;
+      }
+      xUpdateSigRegion( n, uiLog2TrSize, ruiSigWidth, ruiSigHeight );
       clipQCoef = Clip3( -32768, 32767, piQCoef[n] );
       iCoeffQ = ( clipQCoef * scale + iAdd ) >> iShift;
       piCoef[n] = Clip3(-32768,32767,iCoeffQ);
@@ -1438,14 +1618,19 @@ Void TComTrQuant::invtransformNxN( Bool transQuantBypass, TextType eText, UInt u
     } 
     return;
   }
-  xDeQuant( pcCoeff, m_plTempCoeff, uiWidth, uiHeight, scalingListType);
+  UInt uiSigWidth, uiSigHeight;
+  xDeQuant( pcCoeff, m_plTempCoeff, uiWidth, uiHeight, scalingListType, uiSigWidth, uiSigHeight );
+#if !INV_TRANS_SIG_REGION
+  uiSigWidth  = uiWidth;
+  uiSigHeight = uiHeight;
+#endif
   if(useTransformSkip == true)
   {
     xITransformSkip( m_plTempCoeff, rpcResidual, uiStride, uiWidth, uiHeight );
   }
   else
   {
-    xIT( uiMode, m_plTempCoeff, rpcResidual, uiStride, uiWidth, uiHeight );
+    xIT( uiMode, m_plTempCoeff, rpcResidual, uiStride, uiWidth, uiHeight, uiSigWidth, uiSigHeight );
   }
 }
 
@@ -1580,7 +1765,7 @@ Void TComTrQuant::xT( UInt uiMode, Pel* piBlkResi, UInt uiStride, Int* psCoeff,
  *  \param iSize transform size (iSize x iSize)
  *  \param uiMode is Intra Prediction mode used in Mode-Dependent DCT/DST only
  */
-Void TComTrQuant::xIT( UInt uiMode, Int* plCoef, Pel* pResidual, UInt uiStride, Int iWidth, Int iHeight )
+Void TComTrQuant::xIT( UInt uiMode, Int* plCoef, Pel* pResidual, UInt uiStride, Int iWidth, Int iHeight, UInt uiSigWidth, UInt uiSigHeight )
 {
 #if MATRIX_MULT  
   Int iSize = iWidth;
@@ -1593,15 +1778,31 @@ Void TComTrQuant::xIT( UInt uiMode, Int* plCoef, Pel* pResidual, UInt uiStride,
 #endif
   xITr(plCoef,pResidual,uiStride,(UInt)iSize,uiMode);
 #else
-  Int j;
+  Int i, j;
+  if( uiSigWidth == 0 )
+  {
+    /* no non-zero coefficient, the residual is zero */
+    for ( j = 0; j < iHeight; j++ )
+    {
+      memset( pResidual + j * uiStride, 0, iWidth * sizeof(Pel) );
+    }
+    return;
+  }
   {
     short block[ 64 * 64 ];
     short coeff[ 64 * 64 ];
-    for ( j = 0; j < iHeight * iWidth; j++ )
+    /* only the pruned square butterflies skip the coefficients outside the significant region */
+    Bool bPruned     = ( iWidth == iHeight && iWidth > 4 );
+    Int  iCopyWidth  = bPruned ? (Int)uiSigWidth  : iWidth;
+    Int  iCopyHeight = bPruned ? (Int)uiSigHeight : iHeight;
+    for ( j = 0; j < iCopyHeight; j++ )
     {    
-      coeff[j] = (short)plCoef[j];
+      for ( i = 0; i < iCopyWidth; i++ )
+      {
+        coeff[j * iWidth + i] = (short)plCoef[j * iWidth + i];
+      }
     }
-    xITrMxN( coeff, block, iWidth, iHeight, uiMode );
+    xITrMxN( coeff, block, iWidth, iHeight, uiMode, (Int)uiSigWidth, (Int)uiSigHeight );
     {
       for ( j = 0; j < iHeight; j++ )
       {    
@@ -71,6 +71,28 @@ typedef struct
   Int scanNonZigzag[2];         ///< flag for non zigzag scan
 } estBitsSbacStruct;
 
+// ====================================================================================================================
+// Transform kernels
+// ====================================================================================================================
+
+#if !MATRIX_MULT
+void partialButterfly4        ( short *src, short *dst, int shift, int line );
+void partialButterfly8        ( short *src, short *dst, int shift, int line );
+void partialButterfly16       ( short *src, short *dst, int shift, int line );
+void partialButterfly32       ( short *src, short *dst, int shift, int line );
+void partialButterflyInverse4 ( short *src, short *dst, int shift, int line );
+void partialButterflyInverse8 ( short *src, short *dst, int shift, int line, int numLines, int numNzIn );
+void partialButterflyInverse16( short *src, short *dst, int shift, int line, int numLines, int numNzIn );
+void partialButterflyInverse32( short *src, short *dst, int shift, int line, int numLines, int numNzIn );
+void fastForwardDst           ( short *block, short *coeff, int shift );
+void fastInverseDst           ( short *tmp, short *block, int shift );
+
+/// 2D forward transform of a contiguous iWidth x iHeight block
+void xTrMxN  ( short *block, short *coeff, int iWidth, int iHeight, UInt uiMode );
+/// 2D inverse transform, reading only the sigWidth x sigHeight top-left coefficients
+void xITrMxN ( short *coeff, short *block, int iWidth, int iHeight, UInt uiMode, int sigWidth, int sigHeight );
+#endif
+
 // ====================================================================================================================
 // Class definition
 // ====================================================================================================================
@@ -151,8 +173,11 @@ public:
 #if RDOQ_CHROMA_LAMBDA 
   Void setLambda(Double dLambdaLuma, Double dLambdaChroma) { m_dLambdaLuma = dLambdaLuma; m_dLambdaChroma = dLambdaChroma; }
   Void selectLambda(TextType eTType) { m_dLambda = (eTType == TEXT_LUMA) ? m_dLambdaLuma : m_dLambdaChroma; }
+  Double getLambdaLuma()   { return m_dLambdaLuma;   }
+  Double getLambdaChroma() { return m_dLambdaChroma; }
 #else
   Void setLambda(Double dLambda) { m_dLambda = dLambda;}
+  Double getLambda() { return m_dLambda; }
 #endif
   Void setRDOQOffset( UInt uiRDOQOffset ) { m_uiRDOQOffset = uiRDOQOffset; }
   
@@ -302,10 +327,11 @@ __inline Int xGetICRate  ( UInt                            uiAbsLevel,
   
   
   // dequantization
-  Void xDeQuant( const TCoeff* pSrc, Int* pDes, Int iWidth, Int iHeight, Int scalingListType );
+  Void xDeQuant( const TCoeff* pSrc, Int* pDes, Int iWidth, Int iHeight, Int scalingListType, UInt& ruiSigWidth, UInt& ruiSigHeight );
+  __inline Void xUpdateSigRegion ( Int iPos, UInt uiLog2Width, UInt& ruiSigWidth, UInt& ruiSigHeight );
   
   // inverse transform
-  Void xIT    ( UInt uiMode, Int* plCoef, Pel* pResidual, UInt uiStride, Int iWidth, Int iHeight );
+  Void xIT    ( UInt uiMode, Int* plCoef, Pel* pResidual, UInt uiStride, Int iWidth, Int iHeight, UInt uiSigWidth, UInt uiSigHeight );
   
   // inverse skipping transform
   Void xITransformSkip ( Int* plCoef, Pel* pResidual, UInt uiStride, Int width, Int height );
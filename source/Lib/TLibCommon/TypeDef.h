@@ -189,6 +189,7 @@
 
 #define IBDI_DISTORTION                0           ///< enable/disable SSE modification when IBDI is used (JCTVC-D152)
 #define FIXED_ROUNDING_FRAME_MEMORY    0           ///< enable/disable fixed rounding to 8-bitdepth of frame memory when IBDI is used  
+#define PEL8_ME                        1           ///< integer motion estimation on 8-bit copies of the luma planes when the internal bit depth is 8
 
 #define WRITE_BACK                      1           ///< Enable/disable the encoder to replace the deltaPOC and Used by current from the config file with the values derived by the refIdc parameter.
 #define AUTO_INTER_RPS                  1           ///< Enable/disable the automatic generation of refIdc from the deltaPOC and Used by current from the config file.
@@ -236,6 +237,9 @@
 
 #define MATRIX_MULT                             0   // Brute force matrix multiplication instead of partial butterfly
 
+#define SIMD_SSE2                               1   ///< use SSE2 intrinsics in sample-processing kernels when the target supports them
+#define INV_TRANS_SIG_REGION                    1   ///< restrict the inverse transform to the region holding the non-zero coefficients, DC-only fast path
+
 #define REG_DCT 65535
 
 #define AMP_SAD                               1           ///< dedicated SAD functions for AMP
@@ -133,4 +133,23 @@ void read(InputNALUnit& nalu, vector<uint8_t>& nalUnitBuf)
   }
 #endif
 }
+
+/**
+ * get the NAL unit type and temporal id from the first two bytes of a
+ * NAL unit, without copying it or removing emulation prevention bytes
+ * (which cannot occur within the header)
+ */
+void peekNalUnitHeader(const uint8_t* pucNalUnit, NalUnitType& reNalUnitType, Int& riTemporalId)
+{
+#if REMOVE_NAL_REF_FLAG
+  reNalUnitType = (NalUnitType) ((pucNalUnit[0] >> 1) & 0x3f);
+  riTemporalId  = Int(pucNalUnit[1] & 0x7);
+#else
+  reNalUnitType = (NalUnitType) (pucNalUnit[0] & 0x3f);
+  riTemporalId  = Int(pucNalUnit[1] >> 5);
+#endif
+#if TEMPORAL_ID_PLUS1
+  riTemporalId -= 1;
+#endif
+}
 //! \}
@@ -53,5 +53,6 @@ struct InputNALUnit : public NALUnit
 };
 
 void read(InputNALUnit& nalu, std::vector<uint8_t>& nalUnitBuf);
+void peekNalUnitHeader(const uint8_t* pucNalUnit, NalUnitType& reNalUnitType, Int& riTemporalId);
 
 //! \}
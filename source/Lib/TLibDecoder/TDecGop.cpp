@@ -49,7 +49,7 @@ extern bool g_md5_mismatch; ///< top level flag to signal when there is a decode
 
 //! \ingroup TLibDecoder
 //! \{
-static void calcAndPrintHashStatus(TComPicYuv& pic, const SEImessages* seis);
+static void printHashStatus(TDecPicHash* pcHash);
 // ====================================================================================================================
 // Constructor / destructor / initialization / destroy
 // ====================================================================================================================
@@ -75,6 +75,8 @@ Void TDecGop::create()
 
 Void TDecGop::destroy()
 {
+  flushPicHashes();
+  m_cHashQueue.destroy();
 }
 
 Void TDecGop::init( TDecEntropy*            pcEntropyDecoder, 
@@ -198,7 +200,11 @@ Void TDecGop::decompressSlice(TComInputBitstream* pcBitstream, TComPic*& rpcPic)
   m_dDecTime += (double)(clock()-iBeforeTime) / CLOCKS_PER_SEC;
 }
 
-Void TDecGop::filterPicture(TComPic*& rpcPic)
+/** Apply the in-loop filters to a decoded picture and queue its hash check
+ * \param rpcPic decoded picture
+ * \param bSkipLoopFilters skip deblocking and SAO, the picture differs from the conforming output
+ */
+Void TDecGop::filterPicture(TComPic*& rpcPic, Bool bSkipLoopFilters)
 {
   TComSlice*  pcSlice = rpcPic->getSlice(rpcPic->getCurrSliceIdx());
 
@@ -220,11 +226,14 @@ Void TDecGop::filterPicture(TComPic*& rpcPic)
     }
   }
   m_pcLoopFilter->setCfg(pcSlice->getPPS()->getDeblockingFilterControlPresent(), pcSlice->getLoopFilterDisable(), pcSlice->getLoopFilterBetaOffset(), pcSlice->getLoopFilterTcOffset(), bLFCrossTileBoundary);
-  m_pcLoopFilter->loopFilterPic( rpcPic );
+  if (!bSkipLoopFilters)
+  {
+    m_pcLoopFilter->loopFilterPic( rpcPic );
+  }
 
   pcSlice = rpcPic->getSlice(0);
 #if REMOVE_ALF
-  if(pcSlice->getSPS()->getUseSAO())
+  if(pcSlice->getSPS()->getUseSAO() && !bSkipLoopFilters)
 #else
   if(pcSlice->getSPS()->getUseSAO() || pcSlice->getSPS()->getUseALF())
 #endif
@@ -240,7 +249,7 @@ Void TDecGop::filterPicture(TComPic*& rpcPic)
 #endif
   }
 
-  if( pcSlice->getSPS()->getUseSAO() )
+  if( pcSlice->getSPS()->getUseSAO() && !bSkipLoopFilters )
   {
     if(pcSlice->getSaoEnabledFlag())
     {
@@ -278,7 +287,7 @@ Void TDecGop::filterPicture(TComPic*& rpcPic)
 #endif
 
 #if REMOVE_ALF
-  if(pcSlice->getSPS()->getUseSAO())
+  if(pcSlice->getSPS()->getUseSAO() && !bSkipLoopFilters)
 #else
   if(pcSlice->getSPS()->getUseSAO() || pcSlice->getSPS()->getUseALF())
 #endif
@@ -286,35 +295,63 @@ Void TDecGop::filterPicture(TComPic*& rpcPic)
     rpcPic->destroyNonDBFilterInfo();
   }
 
+  // finish the margins of the planes SAO did not process, so the reference is complete before it is used
+  if ( rpcPic->getSlice(0)->isReferenced() )
+  {
+    rpcPic->getPicYuvRec()->extendPicBorder();
+  }
+
   rpcPic->compressMotion(); 
   Char c = (pcSlice->isIntra() ? 'I' : pcSlice->isInterP() ? 'P' : 'B');
   if (!pcSlice->isReferenced()) c += 32;
 
   //-- For time output for each slice
-  printf("\nPOC %4d TId: %1d ( %c-SLICE, QP%3d ) ", pcSlice->getPOC(),
+  /* the status line is printed once the picture hash is available, so it is captured now */
+  TDecPicHash* pcHash = new TDecPicHash;
+  Char acLine[64];
+  snprintf(acLine, sizeof(acLine), "\nPOC %4d TId: %1d ( %c-SLICE, QP%3d ) ", pcSlice->getPOC(),
                                                     pcSlice->getTLayer(),
                                                     c,
                                                     pcSlice->getSliceQp() );
+  pcHash->m_cLog = acLine;
 
   m_dDecTime += (double)(clock()-iBeforeTime) / CLOCKS_PER_SEC;
-  printf ("[DT %6.3f] ", m_dDecTime );
+  snprintf(acLine, sizeof(acLine), "[DT %6.3f] ", m_dDecTime );
+  pcHash->m_cLog += acLine;
   m_dDecTime  = 0;
 
   for (Int iRefList = 0; iRefList < 2; iRefList++)
   {
-    printf ("[L%d ", iRefList);
+    snprintf(acLine, sizeof(acLine), "[L%d ", iRefList);
+    pcHash->m_cLog += acLine;
     for (Int iRefIndex = 0; iRefIndex < pcSlice->getNumRefIdx(RefPicList(iRefList)); iRefIndex++)
     {
-      printf ("%d ", pcSlice->getRefPOC(RefPicList(iRefList), iRefIndex));
+      snprintf(acLine, sizeof(acLine), "%d ", pcSlice->getRefPOC(RefPicList(iRefList), iRefIndex));
+      pcHash->m_cLog += acLine;
     }
-    printf ("] ");
+    pcHash->m_cLog += "] ";
   }
-  if (m_pictureDigestEnabled)
+  if (bSkipLoopFilters)
   {
-    calcAndPrintHashStatus(*rpcPic->getPicYuvRec(), rpcPic->getSEIs());
+    pcHash->m_cLog += "[unfiltered] ";
   }
 
+  /* the SEI messages of the picture are released when its buffer is reused, so the received digest is copied */
+  const SEImessages* seis = rpcPic->getSEIs();
+  /* an unfiltered picture cannot match its digest */
+  pcHash->m_pcPic   = m_pictureDigestEnabled && !bSkipLoopFilters ? rpcPic : NULL;
+  pcHash->m_iMethod = -1;
+  if (seis && seis->picture_digest)
+  {
+    pcHash->m_iMethod = seis->picture_digest->method;
+    ::memcpy(pcHash->m_aucReceived, seis->picture_digest->digest, sizeof(pcHash->m_aucReceived));
+  }
+  m_cPendingHashes.push_back(pcHash);
+  m_cHashQueue.submit(pcHash);
+  flushPicHashes(NULL, false);
+
 #if FIXED_ROUNDING_FRAME_MEMORY
+  flushPicHashes(rpcPic);
   rpcPic->getPicYuvRec()->xFixedRoundingPic();
 #endif
 
@@ -330,9 +367,79 @@ Void TDecGop::filterPicture(TComPic*& rpcPic)
   m_LFCrossSliceBoundaryFlag.clear();
 }
 
+/** Select the number of threads that compute the picture hashes
+ * \param b compute the hashes on a background thread
+ */
+Void TDecGop::setUseAsyncHash( Bool b )
+{
+  flushPicHashes();
+  m_cHashQueue.destroy();
+  m_cHashQueue.create( b ? 1 : 0 );
+}
+
+/** Print the status lines of the decoded pictures in decoding order
+ * \param pcPic print up to and including this picture, NULL prints every pending picture
+ * \param bWait wait for unfinished hashes instead of stopping at the first one
+ *
+ * Must be called before a picture buffer with a pending hash is reused or released.
+ */
+Void TDecGop::flushPicHashes( TComPic* pcPic, Bool bWait )
+{
+  Bool bPending = (pcPic == NULL);
+  for (std::list<TDecPicHash*>::iterator it = m_cPendingHashes.begin(); it != m_cPendingHashes.end() && !bPending; it++)
+  {
+    bPending = ((*it)->m_pcPic == pcPic);
+  }
+
+  while (!m_cPendingHashes.empty())
+  {
+    TDecPicHash* pcHash = m_cPendingHashes.front();
+    if (!bPending || (!bWait && !m_cHashQueue.isDone(pcHash)))
+    {
+      break;
+    }
+    m_cHashQueue.wait(pcHash);
+    m_cPendingHashes.pop_front();
+
+    printf("%s", pcHash->m_cLog.c_str());
+    if (pcHash->m_pcPic)
+    {
+      printHashStatus(pcHash);
+    }
+    bPending = (pcPic == NULL || pcHash->m_pcPic != pcPic);
+    delete pcHash;
+  }
+}
+
+/**
+ * Calculate hash for the decoded picture, using the method of the
+ * picture_digest SEI message if one was received.
+ */
+Void TDecPicHash::execute()
+{
+  if (!m_pcPic)
+  {
+    return;
+  }
+  TComPicYuv& pic = *m_pcPic->getPicYuvRec();
+
+  if(m_iMethod == SEIpictureDigest::MD5)
+  {
+    calcMD5(pic, m_aucDigest);
+  }
+  else if(m_iMethod == SEIpictureDigest::CRC)
+  {
+    calcCRC(pic, m_aucDigest);
+  }
+  else if(m_iMethod == SEIpictureDigest::CHECKSUM)
+  {
+    calcChecksum(pic, m_aucDigest);
+  }
+}
+
 /**
- * Calculate and print hash for pic, compare to picture_digest SEI if
- * present in seis.  seis may be NULL.  Hash is printed to stdout, in
+ * Print hash for pic, compare to picture_digest SEI if one was
+ * received.  Hash is printed to stdout, in
  * a manner suitable for the status line. Theformat is:
  *  [Hash_type:xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx,(yyy)]
  * Where, x..x is the hash
@@ -341,29 +448,24 @@ Void TDecGop::filterPicture(TComPic*& rpcPic)
  *            ***ERROR*** - calculated hash does not match the SEI message
  *            unk         - no SEI message was available for comparison
  */
-static void calcAndPrintHashStatus(TComPicYuv& pic, const SEImessages* seis)
+static void printHashStatus(TDecPicHash* pcHash)
 {
-  /* calculate MD5sum for entire reconstructed picture */
-  unsigned char recon_digest[3][16];
   int numChar=0;
   const char* hashType;
 
-  if(seis && seis->picture_digest->method == SEIpictureDigest::MD5)
+  if(pcHash->m_iMethod == SEIpictureDigest::MD5)
   {
     hashType = "MD5";
-    calcMD5(pic, recon_digest);
     numChar = 16;    
   }
-  else if(seis && seis->picture_digest->method == SEIpictureDigest::CRC)
+  else if(pcHash->m_iMethod == SEIpictureDigest::CRC)
   {
     hashType = "CRC";
-    calcCRC(pic, recon_digest);
     numChar = 2;
   }
-  else if(seis && seis->picture_digest->method == SEIpictureDigest::CHECKSUM)
+  else if(pcHash->m_iMethod == SEIpictureDigest::CHECKSUM)
   {
     hashType = "Checksum";
-    calcChecksum(pic, recon_digest);
     numChar = 4;
   }
   else
@@ -375,14 +477,14 @@ static void calcAndPrintHashStatus(TComPicYuv& pic, const SEImessages* seis)
   const char* ok = "(unk)";
   bool mismatch = false;
 
-  if (seis && seis->picture_digest)
+  if (pcHash->m_iMethod >= 0)
   {
     ok = "(OK)";
     for(int yuvIdx = 0; yuvIdx < 3; yuvIdx++)
     {
       for (unsigned i = 0; i < numChar; i++)
       {
-        if (recon_digest[yuvIdx][i] != seis->picture_digest->digest[yuvIdx][i])
+        if (pcHash->m_aucDigest[yuvIdx][i] != pcHash->m_aucReceived[yuvIdx][i])
         {
           ok = "(***ERROR***)";
           mismatch = true;
@@ -391,12 +493,12 @@ static void calcAndPrintHashStatus(TComPicYuv& pic, const SEImessages* seis)
     }
   }
 
-  printf("[%s:%s,%s] ", hashType, digestToString(recon_digest, numChar), ok);
+  printf("[%s:%s,%s] ", hashType, digestToString(pcHash->m_aucDigest, numChar), ok);
 
   if (mismatch)
   {
     g_md5_mismatch = true;
-    printf("[rx%s:%s] ", hashType, digestToString(seis->picture_digest->digest, numChar));
+    printf("[rx%s:%s] ", hashType, digestToString(pcHash->m_aucReceived, numChar));
   }
 }
 //! \}
@@ -50,12 +50,16 @@
 #include "TLibCommon/TComLoopFilter.h"
 #include "TLibCommon/TComAdaptiveLoopFilter.h"
 #include "TLibCommon/TComSampleAdaptiveOffset.h"
+#include "TLibCommon/TComThread.h"
 
 #include "TDecEntropy.h"
 #include "TDecSlice.h"
 #include "TDecBinCoder.h"
 #include "TDecBinCoderCABAC.h"
 
+#include <list>
+#include <string>
+
 //! \ingroup TLibDecoder
 //! \{
 
@@ -63,6 +67,22 @@
 // Class definition
 // ====================================================================================================================
 
+/// picture hash check of one decoded picture
+/** Computed off the decoding path by the hash queue of TDecGop; the status line is printed in
+ *  decoding order once the job has finished.
+ */
+class TDecPicHash : public TComJob
+{
+public:
+  TComPic*      m_pcPic;
+  Int           m_iMethod;                  ///< SEIpictureDigest::Method of the received digest, -1 when none was received
+  UChar         m_aucReceived[3][16];       ///< digest of the picture_digest SEI message
+  UChar         m_aucDigest[3][16];         ///< output: digest of the decoded picture
+  std::string   m_cLog;                     ///< status line up to the hash status, captured at decoding time
+
+  Void execute();
+};
+
 /// GOP decoder class
 class TDecGop
 {
@@ -88,6 +108,9 @@ private:
   Double                m_dDecTime;
   Int m_pictureDigestEnabled;  ///< Checksum(3)/CRC(2)/MD5(1)/disable(0) acting on SEI picture_digest message
 
+  TComJobQueue              m_cHashQueue;       ///< computes picture hashes in the background
+  std::list<TDecPicHash*>   m_cPendingHashes;   ///< status lines not yet printed, in decoding order
+
   //! list that contains the CU address of each slice plus the end address 
   std::vector<Int> m_sliceStartCUAddress;
   std::vector<Bool> m_LFCrossSliceBoundaryFlag;
@@ -114,10 +137,12 @@ public:
   Void  destroy ();
 //  Void  decompressGop(TComInputBitstream* pcBitstream, TComPic*& rpcPic, Bool bExecuteDeblockAndAlf );
   Void  decompressSlice(TComInputBitstream* pcBitstream, TComPic*& rpcPic );
-  Void  filterPicture  (TComPic*& rpcPic );
+  Void  filterPicture  (TComPic*& rpcPic, Bool bSkipLoopFilters );
   Void  setGopSize( Int i) { m_iGopSize = i; }
 
   void setPictureDigestEnabled(Int enabled) { m_pictureDigestEnabled = enabled; }
+  Void  setUseAsyncHash ( Bool b );
+  Void  flushPicHashes  ( TComPic* pcPic = NULL, Bool bWait = true );
 
 };
 
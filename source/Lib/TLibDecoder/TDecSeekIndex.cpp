@@ -0,0 +1,298 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.  
+ *
+ * Copyright (c) 2010-2012, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** \file     TDecSeekIndex.cpp
+    \brief    random access index of a bitstream
+*/
+
+#include <algorithm>
+#include <fstream>
+#include <assert.h>
+#include "AnnexBread.h"
+#include "NALread.h"
+#include "TDecTop.h"
+#include "TDecSeekIndex.h"
+
+//! \ingroup TLibDecoder
+//! \{
+
+/// first bytes of an index file, followed by the format version
+static const Char s_acMagic[4] = { 'H', 'R', 'A', 'X' };
+static const UInt s_uiVersion  = 1;
+
+static Void xWriteUInt( std::ostream& rcOut, UInt64 uiValue, Int iBytes )
+{
+  for ( Int i = iBytes - 1; i >= 0; i-- )
+  {
+    rcOut.put( Char( ( uiValue >> ( 8 * i ) ) & 0xff ) );
+  }
+}
+
+static UInt64 xReadUInt( std::istream& rcIn, Int iBytes )
+{
+  UInt64 uiValue = 0;
+  for ( Int i = 0; i < iBytes; i++ )
+  {
+    uiValue = ( uiValue << 8 ) | UChar( rcIn.get() );
+  }
+  return uiValue;
+}
+
+// ====================================================================================================================
+// Public member functions
+// ====================================================================================================================
+
+/** Scan a bitstream once and index its IRAP access units
+ * \param rcBitstream Annex B byte stream, read to its end
+ *
+ * Only the parameter sets and the first slice header of each picture are parsed. An access unit starts at the
+ * first non-VCL NAL unit following the last slice of the previous picture. The parameter sets of an entry are all
+ * distinct parameter sets received before it, in the order of their last occurrence, so that decoding them in turn
+ * leaves the ones active at the entry.
+ */
+Void TDecSeekIndex::build( std::istream& rcBitstream )
+{
+  m_cParamSets.clear();
+  m_cEntries.clear();
+  
+  TDecTop cDecTop;
+  cDecTop.create();
+  cDecTop.init();
+  
+  InputByteStream   bytestream( rcBitstream );
+  UInt64            uiOffset   = 0;
+  UInt64            uiAUOffset = 0;
+  Bool              bAUStarted = false;
+  std::vector<UInt> cActiveParamSets;
+  
+  while ( !!rcBitstream )
+  {
+    AnnexBStats stats = AnnexBStats();
+    std::vector<uint8_t> nalUnit;
+    byteStreamNALUnit( bytestream, nalUnit, stats );
+    
+    UInt64 uiNalOffset = uiOffset;
+    uiOffset += stats.m_numLeadingZero8BitsBytes + stats.m_numZeroByteBytes + stats.m_numStartCodePrefixBytes
+              + stats.m_numBytesInNALUnit + stats.m_numTrailingZero8BitsBytes;
+    if ( nalUnit.empty() )
+    {
+      continue;
+    }
+    
+    std::vector<UChar> cRawNalUnit( nalUnit.begin(), nalUnit.end() );
+    InputNALUnit nalu;
+    ::read( nalu, nalUnit );
+    
+    if ( nalu.isSlice() )
+    {
+      Int iPOC;
+      if ( cDecTop.scanNalUnit( nalu, iPOC ) )
+      {
+        if ( xIsIRAP( nalu.m_nalUnitType ) )
+        {
+          Entry cEntry;
+          cEntry.m_uiOffset     = bAUStarted ? uiAUOffset : uiNalOffset;
+          cEntry.m_iPOC         = iPOC;
+          cEntry.m_iLastPOC     = iPOC;
+          cEntry.m_eNalUnitType = nalu.m_nalUnitType;
+          cEntry.m_cParamSets   = cActiveParamSets;
+          m_cEntries.push_back( cEntry );
+        }
+        else if ( !m_cEntries.empty() )
+        {
+          m_cEntries.back().m_iLastPOC = max( m_cEntries.back().m_iLastPOC, iPOC );
+        }
+      }
+      bAUStarted = false;
+      continue;
+    }
+    
+    if ( !bAUStarted )
+    {
+      uiAUOffset = uiNalOffset;
+      bAUStarted = true;
+    }
+    if ( nalu.m_nalUnitType == NAL_UNIT_VPS || nalu.m_nalUnitType == NAL_UNIT_SPS || nalu.m_nalUnitType == NAL_UNIT_PPS )
+    {
+      UInt uiIdx = UInt( std::find( m_cParamSets.begin(), m_cParamSets.end(), cRawNalUnit ) - m_cParamSets.begin() );
+      if ( uiIdx == m_cParamSets.size() )
+      {
+        m_cParamSets.push_back( cRawNalUnit );
+      }
+      cActiveParamSets.erase( std::remove( cActiveParamSets.begin(), cActiveParamSets.end(), uiIdx ), cActiveParamSets.end() );
+      cActiveParamSets.push_back( uiIdx );
+      
+      Int iPOC;
+      cDecTop.scanNalUnit( nalu, iPOC );
+    }
+  }
+  
+  cDecTop.deletePicBuffer();
+  cDecTop.destroy();
+}
+
+/** Write the index to a file
+ * \param pchFile file name
+ * \returns false if the file could not be written
+ */
+Bool TDecSeekIndex::write( const Char* pchFile ) const
+{
+  std::ofstream cFile( pchFile, std::ios::out | std::ios::binary );
+  if ( !cFile )
+  {
+    return false;
+  }
+  
+  cFile.write( s_acMagic, sizeof( s_acMagic ) );
+  xWriteUInt( cFile, s_uiVersion, 4 );
+  
+  xWriteUInt( cFile, m_cParamSets.size(), 4 );
+  for ( UInt ui = 0; ui < m_cParamSets.size(); ui++ )
+  {
+    xWriteUInt( cFile, m_cParamSets[ ui ].size(), 4 );
+    cFile.write( (const Char*) &m_cParamSets[ ui ][ 0 ], m_cParamSets[ ui ].size() );
+  }
+  
+  xWriteUInt( cFile, m_cEntries.size(), 4 );
+  for ( UInt ui = 0; ui < m_cEntries.size(); ui++ )
+  {
+    const Entry& rcEntry = m_cEntries[ ui ];
+    xWriteUInt( cFile, rcEntry.m_uiOffset, 8 );
+    xWriteUInt( cFile, UInt( rcEntry.m_iPOC ), 4 );
+    xWriteUInt( cFile, UInt( rcEntry.m_iLastPOC ), 4 );
+    xWriteUInt( cFile, rcEntry.m_eNalUnitType, 1 );
+    xWriteUInt( cFile, rcEntry.m_cParamSets.size(), 2 );
+    for ( UInt uiPS = 0; uiPS < rcEntry.m_cParamSets.size(); uiPS++ )
+    {
+      xWriteUInt( cFile, rcEntry.m_cParamSets[ uiPS ], 4 );
+    }
+  }
+  
+  return !!cFile;
+}
+
+/** Read an index written by write()
+ * \param pchFile file name
+ * \returns false if the file could not be read or is not an index file
+ */
+Bool TDecSeekIndex::read( const Char* pchFile )
+{
+  m_cParamSets.clear();
+  m_cEntries.clear();
+  
+  std::ifstream cFile( pchFile, std::ios::in | std::ios::binary );
+  Char acMagic[ sizeof( s_acMagic ) ];
+  if ( !cFile.read( acMagic, sizeof( acMagic ) ) || !std::equal( acMagic, acMagic + sizeof( acMagic ), s_acMagic ) || xReadUInt( cFile, 4 ) != s_uiVersion )
+  {
+    return false;
+  }
+  
+  m_cParamSets.resize( UInt( xReadUInt( cFile, 4 ) ) );
+  for ( UInt ui = 0; ui < m_cParamSets.size() && cFile; ui++ )
+  {
+    m_cParamSets[ ui ].resize( UInt( xReadUInt( cFile, 4 ) ) );
+    if ( m_cParamSets[ ui ].empty() )
+    {
+      cFile.setstate( std::ios::failbit );
+      break;
+    }
+    cFile.read( (Char*) &m_cParamSets[ ui ][ 0 ], m_cParamSets[ ui ].size() );
+  }
+  
+  m_cEntries.resize( UInt( xReadUInt( cFile, 4 ) ) );
+  for ( UInt ui = 0; ui < m_cEntries.size() && cFile; ui++ )
+  {
+    Entry& rcEntry = m_cEntries[ ui ];
+    rcEntry.m_uiOffset     = xReadUInt( cFile, 8 );
+    rcEntry.m_iPOC         = Int( UInt( xReadUInt( cFile, 4 ) ) );
+    rcEntry.m_iLastPOC     = Int( UInt( xReadUInt( cFile, 4 ) ) );
+    rcEntry.m_eNalUnitType = NalUnitType( xReadUInt( cFile, 1 ) );
+    rcEntry.m_cParamSets.resize( UInt( xReadUInt( cFile, 2 ) ) );
+    for ( UInt uiPS = 0; uiPS < rcEntry.m_cParamSets.size(); uiPS++ )
+    {
+      rcEntry.m_cParamSets[ uiPS ] = UInt( xReadUInt( cFile, 4 ) );
+      if ( rcEntry.m_cParamSets[ uiPS ] >= m_cParamSets.size() )
+      {
+        cFile.setstate( std::ios::failbit );
+      }
+    }
+  }
+  
+  if ( !cFile )
+  {
+    m_cParamSets.clear();
+    m_cEntries.clear();
+    return false;
+  }
+  return true;
+}
+
+/** Find the IRAP access unit to start decoding at for a POC
+ * \param iPOC requested POC
+ * \returns first entry whose POC range contains iPOC, else the last entry with a POC not above iPOC, else the first
+ *          entry; NULL for an empty index
+ *
+ * The POC range of an entry spans its IRAP picture and the pictures decoded before the next IRAP access unit. Leading
+ * pictures of a CRA are not in its range, they cannot be decoded when starting at the CRA.
+ */
+const TDecSeekIndex::Entry* TDecSeekIndex::findEntry( Int iPOC ) const
+{
+  const Entry* pcBest = m_cEntries.empty() ? NULL : &m_cEntries[ 0 ];
+  for ( UInt ui = 0; ui < m_cEntries.size(); ui++ )
+  {
+    if ( m_cEntries[ ui ].m_iPOC <= iPOC )
+    {
+      if ( iPOC <= m_cEntries[ ui ].m_iLastPOC )
+      {
+        return &m_cEntries[ ui ];
+      }
+      pcBest = &m_cEntries[ ui ];
+    }
+  }
+  return pcBest;
+}
+
+// ====================================================================================================================
+// Private member functions
+// ====================================================================================================================
+
+Bool TDecSeekIndex::xIsIRAP( NalUnitType eNalUnitType )
+{
+  return eNalUnitType == NAL_UNIT_CODED_SLICE_IDR
+      || eNalUnitType == NAL_UNIT_CODED_SLICE_CRA
+      || eNalUnitType == NAL_UNIT_CODED_SLICE_CRANT
+      || eNalUnitType == NAL_UNIT_CODED_SLICE_BLA
+      || eNalUnitType == NAL_UNIT_CODED_SLICE_BLANT;
+}
+
+//! \}
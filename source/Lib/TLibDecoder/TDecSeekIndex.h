@@ -0,0 +1,89 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.  
+ *
+ * Copyright (c) 2010-2012, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** \file     TDecSeekIndex.h
+    \brief    random access index of a bitstream (header)
+*/
+
+#ifndef __TDECSEEKINDEX__
+#define __TDECSEEKINDEX__
+
+#include <istream>
+#include <vector>
+#include "TLibCommon/CommonDef.h"
+
+//! \ingroup TLibDecoder
+//! \{
+
+// ====================================================================================================================
+// Class definition
+// ====================================================================================================================
+
+/// byte offsets, POCs and parameter sets of the IRAP access units of a bitstream, for starting to decode in its middle
+class TDecSeekIndex
+{
+public:
+  /// IRAP access unit of the index
+  struct Entry
+  {
+    UInt64            m_uiOffset;         ///< byte offset of the access unit in the bitstream
+    Int               m_iPOC;             ///< POC of the IRAP picture
+    Int               m_iLastPOC;         ///< highest POC decoded before the next IRAP access unit
+    NalUnitType       m_eNalUnitType;     ///< NAL unit type of the IRAP picture
+    std::vector<UInt> m_cParamSets;       ///< parameter sets to decode before the access unit, indices of getParamSet()
+  };
+  
+private:
+  std::vector< std::vector<UChar> > m_cParamSets;   ///< distinct VPS, SPS and PPS NAL units of the bitstream
+  std::vector<Entry>                m_cEntries;     ///< IRAP access units in decoding order
+  
+  static Bool xIsIRAP( NalUnitType eNalUnitType );
+  
+public:
+  TDecSeekIndex() {}
+  virtual ~TDecSeekIndex() {}
+  
+  Void  build             ( std::istream& rcBitstream );
+  Bool  write             ( const Char* pchFile ) const;
+  Bool  read              ( const Char* pchFile );
+  
+  const Entry* findEntry  ( Int iPOC ) const;
+  
+  UInt  getNumEntries     () const                        { return UInt( m_cEntries.size() ); }
+  const Entry& getEntry   ( UInt uiIdx ) const            { return m_cEntries[ uiIdx ]; }
+  const std::vector<UChar>& getParamSet( UInt uiIdx ) const { return m_cParamSets[ uiIdx ]; }
+};
+
+//! \}
+
+#endif // __TDECSEEKINDEX__
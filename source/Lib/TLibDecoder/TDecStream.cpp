@@ -0,0 +1,337 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.  
+ *
+ * Copyright (c) 2010-2012, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** \file     TDecStream.cpp
+    \brief    streaming decoder interface
+*/
+
+#include <algorithm>
+#include <stdio.h>
+#include "NALread.h"
+#include "TDecStream.h"
+
+//! \ingroup TLibDecoder
+//! \{
+
+// ====================================================================================================================
+// Constructor / destructor / initialization / destroy
+// ====================================================================================================================
+
+TDecStream::TDecStream()
+: m_pcOutputIf        ( NULL )
+, m_pcListPic         ( NULL )
+, m_iSkipFrame        ( 0 )
+, m_iPOCLastDisplay   ( -MAX_INT )
+, m_iMaxTemporalLayer ( -1 )
+, m_bIrapOnly         ( false )
+{
+}
+
+Void TDecStream::create()
+{
+  m_cTDecTop.create();
+}
+
+/** Release the decoder
+ *
+ * Pictures that are still held by the output interface are deleted as well, flush() has to be called and all
+ * output pictures have to be released before.
+ */
+Void TDecStream::destroy()
+{
+  m_cTDecTop.deletePicBuffer();
+  m_cTDecTop.destroy();
+  
+  for ( std::list<TComPic*>::iterator it = m_cDetachedPics.begin(); it != m_cDetachedPics.end(); it++ )
+  {
+    (*it)->destroy();
+    delete *it;
+  }
+  m_cDetachedPics.clear();
+  m_pcListPic = NULL;
+}
+
+Void TDecStream::init()
+{
+  m_cTDecTop.init();
+}
+
+// ====================================================================================================================
+// Public member functions
+// ====================================================================================================================
+
+/** Decode one NAL unit
+ * \param pucNalUnit NAL unit header and payload with emulation prevention bytes, without start code prefix
+ * \param uiSize size of the NAL unit in bytes
+ *
+ * When the NAL unit starts a new picture, the previous picture is finished and the pictures that can be bumped
+ * are passed to the output interface before the NAL unit is decoded.
+ */
+Void TDecStream::decodeNalUnit( const UChar* pucNalUnit, UInt uiSize )
+{
+  if ( uiSize == 0 )
+  {
+    fprintf(stderr, "Warning: Attempt to decode an empty NAL unit\n");
+    return;
+  }
+  if ( uiSize >= 2 && !xIsNalUnitSelected( pucNalUnit ) )
+  {
+    return;
+  }
+  
+  m_cNalUnit.assign( pucNalUnit, pucNalUnit + uiSize );
+  InputNALUnit nalu;
+  read( nalu, m_cNalUnit );
+  if ( nalu.m_nalUnitType == NAL_UNIT_SPS )
+  {
+    assert( nalu.m_temporalId == 0 );
+  }
+  
+  if ( !m_cTDecTop.decode( nalu, m_iSkipFrame, m_iPOCLastDisplay ) )
+  {
+    return;
+  }
+  
+  // the NAL unit is the first slice of a new picture: finish the previous picture
+  UInt uiPOC;
+  m_cTDecTop.executeDeblockAndAlf( uiPOC, m_pcListPic, m_iSkipFrame, m_iPOCLastDisplay );
+  if ( m_pcListPic )
+  {
+    if (   nalu.m_nalUnitType == NAL_UNIT_CODED_SLICE_IDR
+        || nalu.m_nalUnitType == NAL_UNIT_CODED_SLICE_BLANT
+        || nalu.m_nalUnitType == NAL_UNIT_CODED_SLICE_BLA )
+    {
+      xFlushOutput();
+    }
+    xWriteOutput( nalu.m_temporalId );
+  }
+  
+  // and decode the slice again as part of the new picture
+  m_cNalUnit.assign( pucNalUnit, pucNalUnit + uiSize );
+  InputNALUnit naluNew;
+  read( naluNew, m_cNalUnit );
+  m_cTDecTop.decode( naluNew, m_iSkipFrame, m_iPOCLastDisplay );
+}
+
+/** Finish the last picture at the end of the bitstream and output all remaining pictures
+ */
+Void TDecStream::flush()
+{
+  UInt uiPOC;
+  m_cTDecTop.executeDeblockAndAlf( uiPOC, m_pcListPic, m_iSkipFrame, m_iPOCLastDisplay );
+  xFlushOutput();
+}
+
+/** Give a picture passed to the output interface back to the decoder
+ * \param pcHandle TDecOutputPic::m_pcHandle of the picture
+ *
+ * Has to be called from the thread that calls decodeNalUnit() and flush().
+ */
+Void TDecStream::releasePicture( TComPic* pcHandle )
+{
+  pcHandle->setOutputHeld( false );
+  
+  std::list<TComPic*>::iterator it = std::find( m_cDetachedPics.begin(), m_cDetachedPics.end(), pcHandle );
+  if ( it != m_cDetachedPics.end() )
+  {
+    pcHandle->destroy();
+    delete pcHandle;
+    m_cDetachedPics.erase( it );
+  }
+}
+
+// ====================================================================================================================
+// Protected member functions
+// ====================================================================================================================
+
+/** Check from its header whether a NAL unit is decoded, before it is copied and its emulation prevention bytes are removed
+ * \param pucNalUnit NAL unit header and payload
+ * \returns false if the NAL unit belongs to a temporal layer above MaxTemporalLayer, or is a non-IRAP slice when only
+ *          IRAP pictures are decoded
+ *
+ * The SEI messages preceding a skipped slice belong to its picture and are discarded.
+ */
+Bool TDecStream::xIsNalUnitSelected( const UChar* pucNalUnit )
+{
+  NalUnitType eNalUnitType;
+  Int         iTemporalId;
+  peekNalUnitHeader( pucNalUnit, eNalUnitType, iTemporalId );
+  
+  Bool bSlice = false;
+  Bool bIrap  = false;
+  switch ( eNalUnitType )
+  {
+    case NAL_UNIT_CODED_SLICE_CRA:
+    case NAL_UNIT_CODED_SLICE_CRANT:
+    case NAL_UNIT_CODED_SLICE_BLA:
+    case NAL_UNIT_CODED_SLICE_BLANT:
+    case NAL_UNIT_CODED_SLICE_IDR:
+      bIrap  = true;
+      // fall through
+    case NAL_UNIT_CODED_SLICE:
+    case NAL_UNIT_CODED_SLICE_TFD:
+    case NAL_UNIT_CODED_SLICE_TLA:
+      bSlice = true;
+      break;
+    default:
+      break;
+  }
+  
+  if ( ( m_iMaxTemporalLayer >= 0 && iTemporalId > m_iMaxTemporalLayer ) || ( m_bIrapOnly && bSlice && !bIrap ) )
+  {
+    if ( bSlice )
+    {
+      m_cTDecTop.discardSEIs();
+    }
+    return false;
+  }
+  return true;
+}
+
+/** Pass a picture to the output interface and mark it as output
+ * \param pcPic picture in bumping order
+ */
+Void TDecStream::xOutputPicture( TComPic* pcPic )
+{
+  if ( m_pcOutputIf )
+  {
+    TComSPS*    pcSPS    = pcPic->getSlice(0)->getSPS();
+    TComPicYuv* pcPicYuv = pcPic->getPicYuvRec();
+    Int         iLeft    = pcSPS->getPicCropLeftOffset();
+    Int         iTop     = pcSPS->getPicCropTopOffset();
+    Int         iWidth   = pcPicYuv->getWidth()  - iLeft - pcSPS->getPicCropRightOffset();
+    Int         iHeight  = pcPicYuv->getHeight() - iTop  - pcSPS->getPicCropBottomOffset();
+    
+    TDecOutputPic cPic;
+    cPic.m_iPOC        = pcPic->getPOC();
+    cPic.m_apPlane[0]  = pcPicYuv->getLumaAddr() + iTop * pcPicYuv->getStride() + iLeft;
+    cPic.m_apPlane[1]  = pcPicYuv->getCbAddr() + ( iTop >> 1 ) * pcPicYuv->getCStride() + ( iLeft >> 1 );
+    cPic.m_apPlane[2]  = pcPicYuv->getCrAddr() + ( iTop >> 1 ) * pcPicYuv->getCStride() + ( iLeft >> 1 );
+    cPic.m_aiStride[0] = pcPicYuv->getStride();
+    cPic.m_aiStride[1] = cPic.m_aiStride[2] = pcPicYuv->getCStride();
+    cPic.m_aiWidth[0]  = iWidth;
+    cPic.m_aiWidth[1]  = cPic.m_aiWidth[2]  = iWidth  >> 1;
+    cPic.m_aiHeight[0] = iHeight;
+    cPic.m_aiHeight[1] = cPic.m_aiHeight[2] = iHeight >> 1;
+    cPic.m_uiBitDepth  = g_uiBitDepth + g_uiBitIncrement;
+    cPic.m_pcPicYuv    = pcPicYuv;
+    cPic.m_pcHandle    = pcPic;
+    
+    pcPic->setOutputHeld( true );
+    m_pcOutputIf->pictureOutput( cPic );
+  }
+  
+  // update POC of display order
+  m_iPOCLastDisplay = pcPic->getPOC();
+  
+  // erase non-referenced picture in the reference picture list after display
+  if ( !pcPic->getSlice(0)->isReferenced() && pcPic->getReconMark() == true )
+  {
+    pcPic->setReconMark(false);
+    
+    // mark it should be extended later
+    pcPic->getPicYuvRec()->setBorderExtension( false );
+  }
+  pcPic->setOutputMark(false);
+}
+
+/** Output the pictures exceeding the number of reorder pictures, in POC order
+ * \param uiTId temporal layer of the new picture
+ */
+Void TDecStream::xWriteOutput( UInt uiTId )
+{
+  TComList<TComPic*>::iterator iterPic   = m_pcListPic->begin();
+  Int not_displayed = 0;
+  
+  while (iterPic != m_pcListPic->end())
+  {
+    TComPic* pcPic = *(iterPic);
+    if(pcPic->getOutputMark() && pcPic->getPOC() > m_iPOCLastDisplay)
+    {
+       not_displayed++;
+    }
+    iterPic++;
+  }
+  iterPic   = m_pcListPic->begin();
+  
+  while (iterPic != m_pcListPic->end())
+  {
+    TComPic* pcPic = *(iterPic);
+    
+    if ( pcPic->getOutputMark() && (not_displayed >  pcPic->getSlice(0)->getSPS()->getNumReorderPics(uiTId) && pcPic->getPOC() > m_iPOCLastDisplay))
+    {
+      not_displayed--;
+      xOutputPicture( pcPic );
+    }
+    
+    iterPic++;
+  }
+}
+
+/** Output all remaining pictures and empty the picture list of the decoder
+ *
+ * Pictures still held by the output interface are kept until they are released.
+ */
+Void TDecStream::xFlushOutput()
+{
+  // pictures are released below, their hashes must be complete
+  m_cTDecTop.flushPicHashes();
+  
+  if ( !m_pcListPic )
+  {
+    return;
+  }
+  
+  TComList<TComPic*>::iterator iterPic = m_pcListPic->begin();
+  while (iterPic != m_pcListPic->end())
+  {
+    TComPic* pcPic = *(iterPic++);
+    if ( pcPic->getOutputMark() )
+    {
+      xOutputPicture( pcPic );
+    }
+    if ( pcPic->getOutputHeld() )
+    {
+      m_cDetachedPics.push_back( pcPic );
+    }
+    else
+    {
+      pcPic->destroy();
+      delete pcPic;
+    }
+  }
+  m_pcListPic->clear();
+  m_iPOCLastDisplay = -MAX_INT;
+}
+
+//! \}
@@ -0,0 +1,127 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.  
+ *
+ * Copyright (c) 2010-2012, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** \file     TDecStream.h
+    \brief    streaming decoder interface (header)
+*/
+
+#ifndef __TDECSTREAM__
+#define __TDECSTREAM__
+
+#include <list>
+#include <vector>
+#include "TLibCommon/CommonDef.h"
+#include "TLibCommon/TComList.h"
+#include "TLibCommon/TComPic.h"
+#include "TDecTop.h"
+
+//! \ingroup TLibDecoder
+//! \{
+
+// ====================================================================================================================
+// Class definition
+// ====================================================================================================================
+
+/// picture passed to TDecOutputIf, pointing into the picture buffer of the decoder
+class TDecOutputPic
+{
+public:
+  Int         m_iPOC;
+  const Pel*  m_apPlane[3];               ///< Y, Cb and Cr sample at the top-left corner of the cropped picture
+  Int         m_aiStride[3];              ///< plane strides in samples
+  Int         m_aiWidth[3];               ///< plane widths of the cropped picture
+  Int         m_aiHeight[3];              ///< plane heights of the cropped picture
+  UInt        m_uiBitDepth;               ///< bit depth of the samples
+  TComPicYuv* m_pcPicYuv;                 ///< picture buffer the planes point into, not to be modified
+  TComPic*    m_pcHandle;                 ///< release handle, see TDecStream::releasePicture()
+};
+
+/// receives the output pictures of TDecStream
+class TDecOutputIf
+{
+public:
+  /// picture is output, in bumping order
+  /** The picture buffer is not reused by the decoder until TDecStream::releasePicture() has been called with
+   *  rcPic.m_pcHandle, which may also be done from inside this call.
+   */
+  virtual Void  pictureOutput ( const TDecOutputPic& rcPic ) = 0;
+
+  virtual ~TDecOutputIf() {}
+};
+
+/// decoder of NAL units in memory, outputting pictures through TDecOutputIf as soon as they are bumped
+class TDecStream
+{
+private:
+  TDecTop                 m_cTDecTop;                     ///< decoder class
+  TDecOutputIf*           m_pcOutputIf;                   ///< receives the output pictures
+  TComList<TComPic*>*     m_pcListPic;                    ///< picture list of the decoder, NULL before the first picture
+  std::list<TComPic*>     m_cDetachedPics;                ///< pictures flushed from the decoder but not released yet
+  
+  Int                     m_iSkipFrame;                   ///< number of pictures still to be skipped
+  Int                     m_iPOCLastDisplay;              ///< last POC in display order
+  Int                     m_iMaxTemporalLayer;            ///< highest temporal layer decoded, -1 for all layers
+  Bool                    m_bIrapOnly;                    ///< decode IRAP pictures only
+  
+  std::vector<uint8_t>    m_cNalUnit;                     ///< RBSP of the current NAL unit
+  
+public:
+  TDecStream();
+  virtual ~TDecStream() {}
+  
+  Void  create            ();
+  Void  destroy           ();
+  Void  init              ();
+  
+  Void  setOutputIf       ( TDecOutputIf* pcOutputIf )    { m_pcOutputIf = pcOutputIf; }
+  Void  setSkipFrame      ( Int iSkipFrame )              { m_iSkipFrame = iSkipFrame; m_iPOCLastDisplay = -MAX_INT + iSkipFrame; }
+  Void  setMaxTemporalLayer( Int iMaxTemporalLayer )      { m_iMaxTemporalLayer = iMaxTemporalLayer; }
+  Void  setIrapOnly       ( Bool b )                      { m_bIrapOnly = b; m_cTDecTop.setIrapOnly( b ); }
+  Void  setPictureDigestEnabled( Int iEnabled )           { m_cTDecTop.setPictureDigestEnabled( iEnabled ); }
+  Void  setUseAsyncHash   ( Bool b )                      { m_cTDecTop.setUseAsyncHash( b ); }
+  Void  setSkipLoopFilters( Int i )                       { m_cTDecTop.setSkipLoopFilters( i ); }
+  
+  Void  decodeNalUnit     ( const UChar* pucNalUnit, UInt uiSize );
+  Void  flush             ();
+  Void  releasePicture    ( TComPic* pcHandle );
+  
+protected:
+  Bool  xIsNalUnitSelected( const UChar* pucNalUnit );
+  Void  xOutputPicture    ( TComPic* pcPic );
+  Void  xWriteOutput      ( UInt uiTId );
+  Void  xFlushOutput      ();
+};
+
+//! \}
+
+#endif // __TDECSTREAM__
@@ -57,6 +57,9 @@ TDecTop::TDecTop()
   m_pocCRA = 0;
   m_prevRAPisBLA = false;
   m_pocRandomAccess = MAX_INT;          
+  m_bIrapOnly = false;
+  m_iSkipLoopFilters = 0;
+  m_bNextPicturePilot = false;
   m_prevPOC                = MAX_INT;
   m_bFirstSliceInPicture    = true;
   m_bFirstSliceInSequence   = true;
@@ -101,6 +104,8 @@ Void TDecTop::init()
 
 Void TDecTop::deletePicBuffer ( )
 {
+  m_cGopDecoder.flushPicHashes();
+
   TComList<TComPic*>::iterator  iterPic   = m_cListPic.begin();
   Int iSize = Int( m_cListPic.size() );
   
@@ -160,6 +165,10 @@ Void TDecTop::xGetNewPicBuffer ( TComSlice* pcSlice, TComPic*& rpcPic )
   while (iterPic != m_cListPic.end())
   {
     rpcPic = *(iterPic++);
+    if ( rpcPic->getOutputHeld() )
+    {
+      continue;
+    }
     if ( rpcPic->getReconMark() == false && rpcPic->getOutputMark() == false)
     {
       rpcPic->setOutputMark(false);
@@ -184,6 +193,7 @@ Void TDecTop::xGetNewPicBuffer ( TComSlice* pcSlice, TComPic*& rpcPic )
     rpcPic = new TComPic();
     m_cListPic.pushBack( rpcPic );
   }
+  m_cGopDecoder.flushPicHashes( rpcPic );
   rpcPic->destroy();
   rpcPic->create ( pcSlice->getSPS()->getPicWidthInLumaSamples(), pcSlice->getSPS()->getPicHeightInLumaSamples(), g_uiMaxCUWidth, g_uiMaxCUHeight, g_uiMaxCUDepth, true);
 #if REMOVE_APS
@@ -193,7 +203,9 @@ Void TDecTop::xGetNewPicBuffer ( TComSlice* pcSlice, TComPic*& rpcPic )
 
 Void TDecTop::executeDeblockAndAlf(UInt& ruiPOC, TComList<TComPic*>*& rpcListPic, Int& iSkipFrame, Int& iPOCLastDisplay)
 {
-  if (!m_pcPic)
+  // the picture has been finished already when the pictures following it were skipped, e.g. the TFD pictures at the
+  // end of a bitstream decoded from its last CRA picture
+  if (!m_pcPic || m_bFirstSliceInPicture)
   {
     /* nothing to deblock */
     return;
@@ -203,7 +215,15 @@ Void TDecTop::executeDeblockAndAlf(UInt& ruiPOC, TComList<TComPic*>*& rpcListPic
 
   // Execute Deblock and ALF only + Cleanup
 
-  m_cGopDecoder.filterPicture(pcPic);
+  Bool bSkipLoopFilters = false;
+  if (m_iSkipLoopFilters > 0)
+  {
+    TComSlice* pcSlice = pcPic->getSlice(0);
+    bSkipLoopFilters = xIsNonReferencePicture(pcPic)
+                    || (m_iSkipLoopFilters > 1 && pcSlice->getSPS()->getMaxTLayers() > 1 && pcSlice->getTLayer() == pcSlice->getSPS()->getMaxTLayers() - 1);
+  }
+  m_bNextPicturePilot = false;
+  m_cGopDecoder.filterPicture(pcPic, bSkipLoopFilters);
 
   TComSlice::sortPicList( m_cListPic ); // sorting for application output
   ruiPOC              = pcPic->getSlice(m_uiSliceIdx-1)->getPOC();
@@ -214,6 +234,42 @@ Void TDecTop::executeDeblockAndAlf(UInt& ruiPOC, TComList<TComPic*>*& rpcListPic
   return;
 }
 
+/** Check whether a decoded picture is used for reference by any later picture
+ * \param pcPic picture that has just been decoded
+ * \returns true if the reference picture set of the following picture does not contain pcPic
+ *
+ * A picture that is not in the reference picture set of the next picture is marked unused for reference and cannot
+ * be referenced again. At the end of the bitstream no picture follows.
+ */
+Bool TDecTop::xIsNonReferencePicture( TComPic* pcPic )
+{
+  if (!m_bNextPicturePilot)
+  {
+    return true;
+  }
+  TComReferencePictureSet* pcRPS = m_apcSlicePilot->getRPS();
+  Int iPOC     = pcPic->getPOC();
+  Int iNextPOC = m_apcSlicePilot->getPOC();
+  Int iNumShortTerm = pcRPS->getNumberOfNegativePictures() + pcRPS->getNumberOfPositivePictures();
+  for (Int i = 0; i < iNumShortTerm; i++)
+  {
+    if (iNextPOC + pcRPS->getDeltaPOC(i) == iPOC)
+    {
+      return false;
+    }
+  }
+  // long-term pictures may be signalled by their POC LSBs only
+  Int iMaxPOCLsb = 1 << pcPic->getSlice(0)->getSPS()->getBitsForPOC();
+  for (Int i = iNumShortTerm; i < pcRPS->getNumberOfPictures(); i++)
+  {
+    if ((iNextPOC + pcRPS->getDeltaPOC(i) - iPOC) % iMaxPOCLsb == 0)
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
 Void TDecTop::xCreateLostPicture(Int iLostPoc) 
 {
   printf("\ninserting lost poc : %d\n",iLostPoc);
@@ -363,6 +419,7 @@ Bool TDecTop::xDecodeSlice(InputNALUnit &nalu, Int &iSkipFrame, Int iPOCLastDisp
     if (m_prevPOC >= m_pocRandomAccess)
     {
       m_prevPOC = m_apcSlicePilot->getPOC();
+      m_bNextPicturePilot = true;
       return true;
     }
     m_prevPOC = m_apcSlicePilot->getPOC();
@@ -388,6 +445,11 @@ Bool TDecTop::xDecodeSlice(InputNALUnit &nalu, Int &iSkipFrame, Int iPOCLastDisp
     {
       return false;
     }
+    // without the pictures in between, references of an IRAP picture to earlier pictures are not lost
+    if (m_bIrapOnly)
+    {
+      m_pocRandomAccess = m_apcSlicePilot->getPOC();
+    }
   }
   //detect lost reference picture and insert copy of earlier frame.
   Int lostPoc;
@@ -656,6 +718,7 @@ Void TDecTop::xDecodeAPS()
 
 Void TDecTop::xDecodeSEI()
 {
+  delete m_SEIs;
   m_SEIs = new SEImessages;
   m_cEntropyDecoder.decodeSEI(*m_SEIs);
 }
@@ -706,6 +769,76 @@ Bool TDecTop::decode(InputNALUnit& nalu, Int& iSkipFrame, Int& iPOCLastDisplay)
   return false;
 }
 
+/** Drop the SEI messages received for the next picture, when that picture is not decoded
+ */
+Void TDecTop::discardSEIs()
+{
+  delete m_SEIs;
+  m_SEIs = NULL;
+}
+
+/** Parse the parameter sets and slice headers of a bitstream without decoding pictures
+ * \param nalu NAL unit
+ * \param riPOC POC of the picture when nalu is its first slice
+ * \returns true if nalu is the first slice of a picture
+ *
+ * Used for indexing a bitstream, the decoder has to be used for scanning only.
+ */
+Bool TDecTop::scanNalUnit(InputNALUnit& nalu, Int& riPOC)
+{
+  m_cEntropyDecoder.setEntropyDecoder (&m_cCavlcDecoder);
+  m_cEntropyDecoder.setBitstream      (nalu.m_Bitstream);
+
+  switch (nalu.m_nalUnitType)
+  {
+    case NAL_UNIT_VPS:
+      xDecodeVPS();
+      return false;
+
+    case NAL_UNIT_SPS:
+      xDecodeSPS();
+      return false;
+
+    case NAL_UNIT_PPS:
+      xDecodePPS();
+      return false;
+
+    case NAL_UNIT_CODED_SLICE:
+    case NAL_UNIT_CODED_SLICE_TFD:
+    case NAL_UNIT_CODED_SLICE_TLA:
+    case NAL_UNIT_CODED_SLICE_CRA:
+    case NAL_UNIT_CODED_SLICE_CRANT:
+    case NAL_UNIT_CODED_SLICE_BLA:
+    case NAL_UNIT_CODED_SLICE_BLANT:
+    case NAL_UNIT_CODED_SLICE_IDR:
+      // first_slice_in_pic_flag
+      if (nalu.m_Bitstream->peekBits(1) == 0)
+      {
+        return false;
+      }
+      m_apcSlicePilot->initSlice();
+      m_apcSlicePilot->setPPSId(0);
+      m_apcSlicePilot->setPPS(m_parameterSetManagerDecoder.getPrefetchedPPS(0));
+      m_apcSlicePilot->setSPS(m_parameterSetManagerDecoder.getPrefetchedSPS(0));
+      m_apcSlicePilot->initTiles();
+      m_apcSlicePilot->setSliceIdx(0);
+      m_apcSlicePilot->setNalUnitType(nalu.m_nalUnitType);
+#if REMOVE_NAL_REF_FLAG
+      m_apcSlicePilot->setReferenced(true);
+#else
+      m_apcSlicePilot->setReferenced(nalu.m_nalRefFlag);
+#endif
+      m_apcSlicePilot->setTLayerInfo(nalu.m_temporalId);
+
+      m_cEntropyDecoder.decodeSliceHeader (m_apcSlicePilot, &m_parameterSetManagerDecoder);
+      riPOC = m_apcSlicePilot->getPOC();
+      return true;
+
+    default:
+      return false;
+  }
+}
+
 /** Function for checking if picture should be skipped because of association with a previous BLA picture
  * \param iPOCLastDisplay POC of last picture displayed
  * \returns true if the picture should be skipped
@@ -71,6 +71,9 @@ private:
   Int                     m_pocCRA;            ///< POC number of the latest CRA picture
   Bool                    m_prevRAPisBLA;      ///< true if the previous RAP (CRA/CRANT/BLA/BLANT/IDR) picture is a BLA/BLANT picture
   Int                     m_pocRandomAccess;   ///< POC number of the random access point (the first IDR or CRA picture)
+  Bool                    m_bIrapOnly;         ///< only IRAP pictures are decoded, each of them is a random access point
+  Int                     m_iSkipLoopFilters;  ///< 0: filter all pictures, 1: no deblocking and SAO on non-reference pictures, 2: also on the highest temporal layer
+  Bool                    m_bNextPicturePilot; ///< m_apcSlicePilot holds the first slice header of the picture following m_pcPic
 
   TComList<TComPic*>      m_cListPic;         //  Dynamic buffer
   ParameterSetManagerDecoder m_parameterSetManagerDecoder;  // storage for parameter sets 
@@ -110,9 +113,15 @@ public:
   Void  destroy ();
 
   void setPictureDigestEnabled(Int enabled) { m_cGopDecoder.setPictureDigestEnabled(enabled); }
+  Void  setUseAsyncHash ( Bool b )          { m_cGopDecoder.setUseAsyncHash(b); }
+  Void  flushPicHashes  ()                  { m_cGopDecoder.flushPicHashes(); }
+  Void  setIrapOnly     ( Bool b )          { m_bIrapOnly = b; }
+  Void  setSkipLoopFilters( Int i )         { m_iSkipLoopFilters = i; }
 
   Void  init();
   Bool  decode(InputNALUnit& nalu, Int& iSkipFrame, Int& iPOCLastDisplay);
+  Bool  scanNalUnit(InputNALUnit& nalu, Int& riPOC);
+  Void  discardSEIs();
   
   Void  deletePicBuffer();
 
@@ -122,6 +131,7 @@ protected:
   Void  xGetNewPicBuffer  (TComSlice* pcSlice, TComPic*& rpcPic);
   Void  xUpdateGopSize    (TComSlice* pcSlice);
   Void  xCreateLostPicture (Int iLostPOC);
+  Bool  xIsNonReferencePicture( TComPic* pcPic );
 
 #if !REMOVE_APS
   Void      decodeAPS( TComAPS* cAPS) { m_cEntropyDecoder.decodeAPS(cAPS); };
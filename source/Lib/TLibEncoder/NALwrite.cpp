@@ -39,6 +39,10 @@
 #include "TLibCommon/TComBitStream.h"
 #include "NALwrite.h"
 
+#if HAS_SSE2
+#include <emmintrin.h>
+#endif
+
 using namespace std;
 
 //! \ingroup TLibEncoder
@@ -59,6 +63,58 @@ TComOutputBitstream bsNALUHeader;
   out.write(bsNALUHeader.getByteStream(), bsNALUHeader.getByteStreamLength());
 }
 #endif
+/**
+ * copy rbsp bytes to dst, inserting an emulation_prevention_three_byte
+ * before any byte in {00,01,02,03} that follows two zero bytes.
+ * \param dst output buffer, must hold at least uiSize + uiSize / 2 bytes
+ * \param src rbsp bytes
+ * \param uiSize number of rbsp bytes
+ * \returns number of bytes written to dst
+ */
+UInt writeEmulationPrevention(uint8_t* dst, const uint8_t* src, UInt uiSize)
+{
+  uint8_t* dstStart = dst;
+  UInt uiNumZeros = 0; // number of consecutive zero bytes just written
+  UInt i = 0;
+#if HAS_SSE2
+  const __m128i zero = _mm_setzero_si128();
+  while (i + 16 <= uiSize)
+  {
+    __m128i bytes = _mm_loadu_si128((const __m128i*)(src + i));
+    if (uiNumZeros < 2 && _mm_movemask_epi8(_mm_cmpeq_epi8(bytes, zero)) == 0)
+    {
+      /* no zero byte in this block and no pending zero pair: copy as is */
+      _mm_storeu_si128((__m128i*)dst, bytes);
+      dst += 16;
+      i += 16;
+      uiNumZeros = 0;
+      continue;
+    }
+    for (UInt uiEnd = i + 16; i < uiEnd; i++)
+    {
+      if (uiNumZeros == 2 && src[i] <= 3)
+      {
+        *dst++ = emulation_prevention_three_byte[0];
+        uiNumZeros = 0;
+      }
+      *dst++ = src[i];
+      uiNumZeros = src[i] ? 0 : uiNumZeros + 1;
+    }
+  }
+#endif
+  for (; i < uiSize; i++)
+  {
+    if (uiNumZeros == 2 && src[i] <= 3)
+    {
+      *dst++ = emulation_prevention_three_byte[0];
+      uiNumZeros = 0;
+    }
+    *dst++ = src[i];
+    uiNumZeros = src[i] ? 0 : uiNumZeros + 1;
+  }
+  return UInt(dst - dstStart);
+}
+
 /**
  * write nalu to bytestream out, performing RBSP anti startcode
  * emulation as required.  nalu.m_RBSPayload must be byte aligned.
@@ -112,32 +168,13 @@ void write(ostream& out, OutputNALUnit& nalu)
    */
   vector<uint8_t>& rbsp   = nalu.m_Bitstream.getFIFO();
 
-  for (vector<uint8_t>::iterator it = rbsp.begin(); it != rbsp.end();)
-  {
-    /* 1) find the next emulated 00 00 {00,01,02,03}
-     * 2a) if not found, write all remaining bytes out, stop.
-     * 2b) otherwise, write all non-emulated bytes out
-     * 3) insert emulation_prevention_three_byte
-     */
-    vector<uint8_t>::iterator found = it;
-    do
-    {
-      /* NB, end()-1, prevents finding a trailing two byte sequence */
-      found = search_n(found, rbsp.end()-1, 2, 0);
-      found++;
-      /* if not found, found == end, otherwise found = second zero byte */
-      if (found == rbsp.end())
-        break;
-      if (*(++found) <= 3)
-        break;
-    } while (true);
-
-    it = found;
-    if (found != rbsp.end())
-    {
-      it = rbsp.insert(found, emulation_prevention_three_byte[0]);
-    }
-  }
+  /* single pass over the rbsp, escaping into a separate buffer.  The
+   * escaped payload replaces the rbsp, as callers measure the NAL unit
+   * size including the emulation_prevention_three_bytes. */
+  vector<uint8_t> ebsp(rbsp.size() + rbsp.size() / 2 + 1);
+  UInt uiEbspSize = writeEmulationPrevention(&ebsp.front(), rbsp.empty() ? NULL : &rbsp.front(), UInt(rbsp.size()));
+  ebsp.resize(uiEbspSize);
+  rbsp.swap(ebsp);
 
   out.write((char*)&(*rbsp.begin()), rbsp.end() - rbsp.begin());
 
@@ -78,6 +78,7 @@ struct OutputNALUnit : public NALUnit
 };
 
 void write(std::ostream& out, OutputNALUnit& nalu);
+UInt writeEmulationPrevention(uint8_t* dst, const uint8_t* src, UInt uiSize);
 void writeRBSPTrailingBits(TComOutputBitstream& bs);
 
 inline NALUnitEBSP::NALUnitEBSP(OutputNALUnit& nalu)
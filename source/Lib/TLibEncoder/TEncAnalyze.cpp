@@ -44,9 +44,4 @@
 // Construction/Destruction
 //////////////////////////////////////////////////////////////////////
 
-TEncAnalyze             m_gcAnalyzeAll;
-TEncAnalyze             m_gcAnalyzeI;
-TEncAnalyze             m_gcAnalyzeP;
-TEncAnalyze             m_gcAnalyzeB;
-
 //! \}
@@ -149,11 +149,6 @@ public:
   }
 };
 
-extern TEncAnalyze             m_gcAnalyzeAll;
-extern TEncAnalyze             m_gcAnalyzeI;
-extern TEncAnalyze             m_gcAnalyzeP;
-extern TEncAnalyze             m_gcAnalyzeB;
-
 //! \}
 
 #endif // !defined(AFX_TENCANALYZE_H__C79BCAA2_6AC8_4175_A0FE_CF02F5829233__INCLUDED_)
@@ -79,6 +79,9 @@ public:
   UInt  getBinsCoded              ()              { return m_uiBinsCoded;                }
   Void  setBinCountingEnableFlag  ( Bool bFlag )  { m_binCountIncrement = bFlag ? 1 : 0; }
   Bool  getBinCountingEnableFlag  ()              { return m_binCountIncrement != 0;     }
+#if FAST_BIT_EST
+  Void  addFracBits               ( UInt64 uiBits ) { m_fracBits += uiBits;                } ///< add an estimated rate in 1/32768 bit units
+#endif
   
 #if FAST_BIT_EST
 protected:
@@ -154,6 +154,7 @@ protected:
   Bool      m_bUseSAO;
   Int       m_maxNumOffsetsPerPic;
   Bool      m_saoLcuBasedOptimization;
+  Int       m_iSaoStatsThreads;                   ///< number of threads gathering SAO statistics per CTU row
 
   //====== Lossless ========
   Bool      m_useLossless;
@@ -189,8 +190,12 @@ protected:
   Bool      m_bUseFastEnc;
   Bool      m_bUseEarlyCU;
   Bool      m_useFastDecisionForMerge;
+  Int       m_iMergeRDCands;                ///< number of 2Nx2N merge candidates given a full RD check after SATD pre-screening, 0: all
   Bool      m_bUseCbfFastMode;
   Bool      m_useEarlySkipDetection;
+  Bool      m_bUseAnalysisPass;             ///< do not search the smallest CU size, for rate/lambda statistics passes
+  Bool      m_bUseParallelIntraSearch;      ///< search the intra modes of inter slices on a second thread while the inter modes are searched
+  Bool      m_bUseTableRateEst;             ///< price coefficients of rough RQT and intra decisions from context bit tables instead of coding them
 #if !REMOVE_LMCHROMA
   Bool      m_bUseLMChroma;
 #endif
@@ -232,6 +237,10 @@ protected:
   Int       m_iWaveFrontSubstreams;
 
   Int m_pictureDigestEnabled;              ///< Checksum(3)/CRC(2)/MD5(1)/disable(0) acting on SEI picture_digest message
+  Bool      m_bUseAsyncMetrics;            ///< compute PSNR and picture digests on a background thread
+  char*     m_pchStatsFile;                ///< rate/lambda statistics output file name, NULL if not written
+  Int       m_iRendition;                  ///< index of the rendition of a multi-rendition encoding, -1 if coded on its own
+  Bool      m_bUseMotionSeeds;             ///< add the source motion of the shared analysis as start point of the fast motion search of renditions after the first
   //====== Weighted Prediction ========
   Bool      m_bUseWeightPred;       //< Use of Weighting Prediction (P_SLICE)
   Bool      m_useWeightedBiPred;    //< Use of Bi-directional Weighting Prediction (B_SLICE)
@@ -243,6 +252,7 @@ protected:
   Bool      m_enableRateCtrl;                                ///< Flag for using rate control algorithm
   Int       m_targetBitrate;                                 ///< target bitrate
   Int       m_numLCUInUnit;                                  ///< Total number of LCUs in a frame should be divided by the NumLCUInUnit
+  Int       m_iRCLookahead;                                  ///< number of pictures analyzed ahead of the coded GOP by the rate control (0: off)
   Bool      m_TransquantBypassEnableFlag;                     ///< transquant_bypass_enable_flag setting in PPS.
   Bool      m_CUTransquantBypassFlagValue;                    ///< if transquant_bypass_enable_flag, the fixed value to use for the per-CU cu_transquant_bypass_flag.
   TComVPS                    m_cVPS;
@@ -254,6 +264,8 @@ public:
   TEncCfg()
   : m_puiColumnWidth()
   , m_puiRowHeight()
+  , m_iRendition( -1 )
+  , m_bUseMotionSeeds( true )
   {}
 
   virtual ~TEncCfg()
@@ -393,8 +405,12 @@ public:
   Void      setUseFastEnc                   ( Bool  b )     { m_bUseFastEnc = b; }
   Void      setUseEarlyCU                   ( Bool  b )     { m_bUseEarlyCU = b; }
   Void      setUseFastDecisionForMerge      ( Bool  b )     { m_useFastDecisionForMerge = b; }
+  Void      setMergeRDCands                 ( Int   i )     { m_iMergeRDCands = i; }
   Void      setUseCbfFastMode            ( Bool  b )     { m_bUseCbfFastMode = b; }
   Void      setUseEarlySkipDetection        ( Bool  b )     { m_useEarlySkipDetection = b; }
+  Void      setUseAnalysisPass              ( Bool  b )     { m_bUseAnalysisPass = b; }
+  Void      setUseParallelIntraSearch       ( Bool  b )     { m_bUseParallelIntraSearch = b; }
+  Void      setUseTableRateEst              ( Bool  b )     { m_bUseTableRateEst = b; }
   Void      setUseConstrainedIntraPred      ( Bool  b )     { m_bUseConstrainedIntraPred = b; }
   Void      setPCMInputBitDepthFlag         ( Bool  b )     { m_bPCMInputBitDepthFlag = b; }
   Void      setPCMFilterDisableFlag         ( Bool  b )     {  m_bPCMFilterDisableFlag = b; }
@@ -416,8 +432,12 @@ public:
   Bool      getUseFastEnc                   ()      { return m_bUseFastEnc; }
   Bool      getUseEarlyCU                   ()      { return m_bUseEarlyCU; }
   Bool      getUseFastDecisionForMerge      ()      { return m_useFastDecisionForMerge; }
+  Int       getMergeRDCands                 ()      { return m_iMergeRDCands; }
   Bool      getUseCbfFastMode           ()      { return m_bUseCbfFastMode; }
   Bool      getUseEarlySkipDetection        ()      { return m_useEarlySkipDetection; }
+  Bool      getUseAnalysisPass              ()      { return m_bUseAnalysisPass; }
+  Bool      getUseParallelIntraSearch       ()      { return m_bUseParallelIntraSearch; }
+  Bool      getUseTableRateEst              ()      { return m_bUseTableRateEst; }
   Bool      getUseConstrainedIntraPred      ()      { return m_bUseConstrainedIntraPred; }
 #if !REMOVE_NSQT
 #if NS_HAD
@@ -468,6 +488,8 @@ public:
   Int   getMaxNumOffsetsPerPic                   ()                    { return m_maxNumOffsetsPerPic; }
   Void  setSaoLcuBasedOptimization               (bool bVal)           { m_saoLcuBasedOptimization = bVal; }
   Bool  getSaoLcuBasedOptimization               ()                    { return m_saoLcuBasedOptimization; }
+  Void  setSaoStatsThreads                       (Int iVal)            { m_iSaoStatsThreads = iVal; }
+  Int   getSaoStatsThreads                       ()                    { return m_iSaoStatsThreads; }
   Void  setLFCrossTileBoundaryFlag               ( Bool   bValue  )    { m_bLFCrossTileBoundaryFlag = bValue; }
   Bool  getLFCrossTileBoundaryFlag               ()                    { return m_bLFCrossTileBoundaryFlag;   }
   Void  setUniformSpacingIdr           ( Int i )           { m_iUniformSpacingIdr = i; }
@@ -545,6 +567,14 @@ public:
   Int   getWaveFrontSubstreams()                         { return m_iWaveFrontSubstreams; }
   void setPictureDigestEnabled(Int b) { m_pictureDigestEnabled = b; }
   Int getPictureDigestEnabled() { return m_pictureDigestEnabled; }
+  Void  setUseAsyncMetrics             ( Bool b )          { m_bUseAsyncMetrics = b; }
+  Bool  getUseAsyncMetrics             ()                  { return m_bUseAsyncMetrics; }
+  Void  setStatsFile                   ( char* pch )       { m_pchStatsFile = pch; }
+  char* getStatsFile                   ()                  { return m_pchStatsFile; }
+  Void  setRendition                   ( Int i )           { m_iRendition = i; }
+  Int   getRendition                   ()                  { return m_iRendition; }
+  Void  setUseMotionSeeds              ( Bool b )          { m_bUseMotionSeeds = b; }
+  Bool  getUseMotionSeeds              ()                  { return m_bUseMotionSeeds; }
 
   Void      setUseWP               ( Bool  b )   { m_bUseWeightPred    = b;    }
   Void      setWPBiPred            ( Bool b )    { m_useWeightedBiPred = b;    }
@@ -566,6 +596,8 @@ public:
   Void      setTargetBitrate  (Int target)      { m_targetBitrate  = target;  }
   Int       getNumLCUInUnit   ()                { return m_numLCUInUnit;      }
   Void      setNumLCUInUnit   (Int numLCUs)     { m_numLCUInUnit   = numLCUs; }
+  Int       getRCLookahead    ()                { return m_iRCLookahead;      }
+  Void      setRCLookahead    (Int i)           { m_iRCLookahead   = i;       }
   Bool      getTransquantBypassEnableFlag()           { return m_TransquantBypassEnableFlag; }
   Void      setTransquantBypassEnableFlag(Bool flag)  { m_TransquantBypassEnableFlag = flag; }
   Bool      getCUTransquantBypassFlagValue()          { return m_CUTransquantBypassFlagValue; }
@@ -51,6 +51,13 @@ using namespace std;
 // Constructor / destructor / create / destroy
 // ====================================================================================================================
 
+TEncCu::TEncCu()
+: m_pcIntraTask ( NULL )
+{
+  ::memset( m_adSkipCost, 0, sizeof( m_adSkipCost ) );
+  ::memset( m_aiSkipNum,  0, sizeof( m_aiSkipNum  ) );
+}
+
 /**
  \param    uiTotalDepth  total number of allowable depth
  \param    uiMaxWidth    largest CU width
@@ -61,6 +68,7 @@ Void TEncCu::create(UChar uhTotalDepth, UInt uiMaxWidth, UInt uiMaxHeight)
   Int i;
   
   m_uhTotalDepth   = uhTotalDepth + 1;
+  ::memset( m_auiMergeRankWins, 0, sizeof( m_auiMergeRankWins ) );
   m_ppcBestCU      = new TComDataCU*[m_uhTotalDepth-1];
   m_ppcTempCU      = new TComDataCU*[m_uhTotalDepth-1];
     
@@ -110,6 +118,14 @@ Void TEncCu::destroy()
 {
   Int i;
   
+  if ( m_pcIntraTask )
+  {
+    m_cIntraQueue.destroy();
+    m_pcIntraTask->destroy();
+    delete m_pcIntraTask;
+    m_pcIntraTask = NULL;
+  }
+
   for( i=0 ; i<m_uhTotalDepth-1 ; i++)
   {
     if(m_ppcBestCU[i])
@@ -217,6 +233,28 @@ Void TEncCu::init( TEncTop* pcEncTop )
   
   m_bUseSBACRD        = pcEncTop->getUseSBACRD();
   m_pcRateCtrl        = pcEncTop->getRateCtrl();
+
+  // the intra search task keeps its own RD coders, and ARL statistics are gathered per slice by the shared quantizer
+  if ( pcEncTop->getUseParallelIntraSearch() && m_bUseSBACRD
+#if ADAPTIVE_QP_SELECTION
+    && !pcEncTop->getUseAdaptQpSelect()
+#endif
+    )
+  {
+    m_pcIntraTask = new TEncCuIntraTask;
+    m_pcIntraTask->create( pcEncTop, m_uhTotalDepth - 1 );
+    m_cIntraQueue.create( 1 );
+  }
+}
+
+/** \param    pcSlice       slice to be compressed
+ */
+Void TEncCu::initIntraTask( TComSlice* pcSlice )
+{
+  if ( m_pcIntraTask )
+  {
+    m_pcIntraTask->initSlice( pcSlice, m_pcRdCost, m_pcTrQuant );
+  }
 }
 
 // ====================================================================================================================
@@ -407,13 +445,10 @@ Void TEncCu::xCompressCU( TComDataCU*& rpcBestCU, TComDataCU*& rpcTempCU, UInt u
 
   Bool    bTrySplitDQP  = true;
 
-  static  Double  afCost[ MAX_CU_DEPTH ];
-  static  Int      aiNum [ MAX_CU_DEPTH ];
-
   if ( rpcBestCU->getAddr() == 0 )
   {
-    ::memset( afCost, 0, sizeof( afCost ) );
-    ::memset( aiNum,  0, sizeof( aiNum  ) );
+    ::memset( m_adSkipCost, 0, sizeof( m_adSkipCost ) );
+    ::memset( m_aiSkipNum,  0, sizeof( m_aiSkipNum  ) );
   }
 
   Bool bBoundary = false;
@@ -461,6 +496,9 @@ Void TEncCu::xCompressCU( TComDataCU*& rpcBestCU, TComDataCU*& rpcTempCU, UInt u
   // We need to split, so don't try these modes.
   if(!bSliceEnd && !bSliceStart && bInsidePicture )
   {
+    // search the intra modes on the intra task while the inter modes are searched here
+    Bool bIntraTask = m_pcIntraTask && rpcBestCU->getSlice()->getSliceType() != I_SLICE && iMinQP == iMaxQP;
+
     for (Int iQP=iMinQP; iQP<=iMaxQP; iQP++)
     {
       if (isAddLowestQP && (iQP == iMinQP))
@@ -473,6 +511,10 @@ Void TEncCu::xCompressCU( TComDataCU*& rpcBestCU, TComDataCU*& rpcTempCU, UInt u
       fRD_Skip    = MAX_DOUBLE;
 
       rpcTempCU->initEstData( uiDepth, iQP );
+      if ( bIntraTask )
+      {
+        xStartIntraTask( rpcTempCU, uiDepth, iQP );
+      }
 
       // do inter modes, SKIP and 2Nx2N
       if( rpcBestCU->getSlice()->getSliceType() != I_SLICE )
@@ -490,7 +532,7 @@ Void TEncCu::xCompressCU( TComDataCU*& rpcBestCU, TComDataCU*& rpcTempCU, UInt u
         if ( m_pcEncCfg->getUseFastEnc() )
         {
           Int iIdx = g_aucConvertToBit[ rpcBestCU->getWidth(0) ];
-          if ( aiNum [ iIdx ] > 5 && fRD_Skip < EARLY_SKIP_THRES*afCost[ iIdx ]/aiNum[ iIdx ] )
+          if ( m_aiSkipNum[ iIdx ] > 5 && fRD_Skip < EARLY_SKIP_THRES*m_adSkipCost[ iIdx ]/m_aiSkipNum[ iIdx ] )
           {
             bEarlySkip = true;
             bTrySplit  = false;
@@ -704,15 +746,13 @@ Void TEncCu::xCompressCU( TComDataCU*& rpcBestCU, TComDataCU*& rpcTempCU, UInt u
           rpcBestCU->getCbf( 0, TEXT_CHROMA_U ) != 0   ||
           rpcBestCU->getCbf( 0, TEXT_CHROMA_V ) != 0     ) // avoid very complex intra if it is unlikely
         {
-          xCheckRDCostIntra( rpcBestCU, rpcTempCU, SIZE_2Nx2N );
-          rpcTempCU->initEstData( uiDepth, iQP );
-          if( uiDepth == g_uiMaxCUDepth - g_uiAddCUDepth )
+          if ( bIntraTask )
           {
-            if( rpcTempCU->getWidth(0) > ( 1 << rpcTempCU->getSlice()->getSPS()->getQuadtreeTULog2MinSize() ) )
-            {
-              xCheckRDCostIntra( rpcBestCU, rpcTempCU, SIZE_NxN   );
-              rpcTempCU->initEstData( uiDepth, iQP );
-            }
+            xFinishIntraTask( rpcBestCU, rpcTempCU, uiDepth, iQP, true );
+          }
+          else
+          {
+            xCheckRDCostIntraModes( rpcBestCU, rpcTempCU, uiDepth, iQP );
           }
         }
       }
@@ -737,6 +777,11 @@ Void TEncCu::xCompressCU( TComDataCU*& rpcBestCU, TComDataCU*& rpcTempCU, UInt u
     }
 
   }
+    if ( bIntraTask )
+    {
+      // discard the intra modes if they were not reached
+      xFinishIntraTask( rpcBestCU, rpcTempCU, uiDepth, iMinQP, false );
+    }
 
     m_pcEntropyCoder->resetBits();
     m_pcEntropyCoder->encodeSplitFlag( rpcBestCU, 0, uiDepth, true );
@@ -753,8 +798,8 @@ Void TEncCu::xCompressCU( TComDataCU*& rpcBestCU, TComDataCU*& rpcTempCU, UInt u
       if ( rpcBestCU->isSkipped(0) )
       {
         Int iIdx = g_aucConvertToBit[ rpcBestCU->getWidth(0) ];
-        afCost[ iIdx ] += rpcBestCU->getTotalCost();
-        aiNum [ iIdx ] ++;
+        m_adSkipCost[ iIdx ] += rpcBestCU->getTotalCost();
+        m_aiSkipNum [ iIdx ] ++;
       }
     }
 
@@ -767,6 +812,12 @@ Void TEncCu::xCompressCU( TComDataCU*& rpcBestCU, TComDataCU*& rpcTempCU, UInt u
     {
       bSubBranch = true;
     }
+
+    // analysis pass: the smallest CU size is not searched
+    if( m_pcEncCfg->getUseAnalysisPass() && uiDepth + 1 >= g_uiMaxCUDepth - g_uiAddCUDepth )
+    {
+      bSubBranch = false;
+    }
   }
   else if(!(bSliceEnd && bInsidePicture))
   {
@@ -1265,6 +1316,16 @@ Void TEncCu::xCheckRDCostMerge2Nx2N( TComDataCU*& rpcBestCU, TComDataCU*& rpcTem
 
   Bool bestIsSkip = false;
 
+  // SATD pre-screening: only the best ranked candidates are checked with the full RD cost
+  Int    aiCandRank[MRG_MAX_NUM_CANDS];
+  Int    iNumRDCands     = m_pcEncCfg->getMergeRDCands();
+  Int    iBestMergeRank  = -1;
+  Double dBestMergeCost  = MAX_DOUBLE;
+  if ( iNumRDCands > 0 )
+  {
+    xRankMergeCands( rpcTempCU, cMvFieldNeighbours, uhInterDirNeighbours, numValidMergeCand, aiCandRank );
+  }
+
   UInt iteration;
   if ( rpcTempCU->isLosslessCoded(0))
   {
@@ -1280,7 +1341,7 @@ Void TEncCu::xCheckRDCostMerge2Nx2N( TComDataCU*& rpcBestCU, TComDataCU*& rpcTem
     for( UInt uiMergeCand = 0; uiMergeCand < numValidMergeCand; ++uiMergeCand )
     {
       {
-        if(!(uiNoResidual==1 && mergeCandBuffer[uiMergeCand]==1))
+        if(!(uiNoResidual==1 && mergeCandBuffer[uiMergeCand]==1) && !(iNumRDCands > 0 && aiCandRank[uiMergeCand] >= iNumRDCands))
         {
 
         if( !(bestIsSkip && uiNoResidual == 0) )
@@ -1320,6 +1381,11 @@ Void TEncCu::xCheckRDCostMerge2Nx2N( TComDataCU*& rpcBestCU, TComDataCU*& rpcTem
 #endif
           Int orgQP = rpcTempCU->getQP( 0 );
           xCheckDQP( rpcTempCU );
+          if ( iNumRDCands > 0 && rpcTempCU->getTotalCost() < dBestMergeCost )
+          {
+            dBestMergeCost = rpcTempCU->getTotalCost();
+            iBestMergeRank = aiCandRank[uiMergeCand];
+          }
           xCheckBestMode(rpcBestCU, rpcTempCU, uhDepth);
           rpcTempCU->initEstData( uhDepth, orgQP );
 
@@ -1364,6 +1430,77 @@ Void TEncCu::xCheckRDCostMerge2Nx2N( TComDataCU*& rpcBestCU, TComDataCU*& rpcTem
     }
   }
  }
+
+  if ( iBestMergeRank >= 0 )
+  {
+    m_auiMergeRankWins[iBestMergeRank]++;
+  }
+}
+
+/** rank the 2Nx2N merge candidates by the SATD of their luma prediction plus the cost of the merge index
+ * \param pcCU                   CU to be predicted, its merge and motion data are overwritten
+ * \param pcMvFieldNeighbours    motion of the merge candidates
+ * \param puhInterDirNeighbours  inter directions of the merge candidates
+ * \param iNumValidMergeCand     number of merge candidates
+ * \param piRank                 rank of each candidate, 0 for the lowest cost
+ * \returns Void
+ */
+Void TEncCu::xRankMergeCands( TComDataCU* pcCU, TComMvField* pcMvFieldNeighbours, UChar* puhInterDirNeighbours, Int iNumValidMergeCand, Int* piRank )
+{
+  UChar    uhDepth  = pcCU->getDepth( 0 );
+  TComYuv* pcOrgYuv = m_ppcOrigYuv[uhDepth];
+  TComYuv* pcPredYuv = m_ppcPredYuvTemp[uhDepth];
+  UInt     auiCost[MRG_MAX_NUM_CANDS];
+
+  m_pcRdCost->getMotionCost( 1, 0 );
+  pcCU->setPredModeSubParts( MODE_INTER, 0, uhDepth );
+  pcCU->setMergeFlagSubParts( true, 0, 0, uhDepth );
+  for( Int iMergeCand = 0; iMergeCand < iNumValidMergeCand; iMergeCand++ )
+  {
+    pcCU->setMergeIndexSubParts( iMergeCand, 0, 0, uhDepth );
+    pcCU->setInterDirSubParts( puhInterDirNeighbours[iMergeCand], 0, 0, uhDepth );
+    pcCU->getCUMvField( REF_PIC_LIST_0 )->setAllMvField( pcMvFieldNeighbours[0 + 2*iMergeCand], SIZE_2Nx2N, 0, 0 );
+    pcCU->getCUMvField( REF_PIC_LIST_1 )->setAllMvField( pcMvFieldNeighbours[1 + 2*iMergeCand], SIZE_2Nx2N, 0, 0 );
+    m_pcPredSearch->motionCompensation( pcCU, pcPredYuv );
+
+    UInt uiBits = iMergeCand + 1;
+    if ( iMergeCand == MRG_MAX_NUM_CANDS_SIGNALED - 1 )
+    {
+      uiBits--;
+    }
+    auiCost[iMergeCand] = m_pcRdCost->calcHAD( pcOrgYuv->getLumaAddr(), pcOrgYuv->getStride(), pcPredYuv->getLumaAddr(), pcPredYuv->getStride(),
+                                               pcCU->getWidth( 0 ), pcCU->getHeight( 0 ) )
+                        + m_pcRdCost->getCost( uiBits );
+  }
+
+  for( Int iMergeCand = 0; iMergeCand < iNumValidMergeCand; iMergeCand++ )
+  {
+    piRank[iMergeCand] = 0;
+    for( Int iOther = 0; iOther < iNumValidMergeCand; iOther++ )
+    {
+      if ( auiCost[iOther] < auiCost[iMergeCand] || ( auiCost[iOther] == auiCost[iMergeCand] && iOther < iMergeCand ) )
+      {
+        piRank[iMergeCand]++;
+      }
+    }
+  }
+}
+
+/** print how often the merge candidate of each SATD rank won the 2Nx2N merge decision
+ * \returns Void
+ */
+Void TEncCu::printMergeRankStats()
+{
+  UInt uiTotal = 0;
+  for( Int iRank = 0; iRank < MRG_MAX_NUM_CANDS; iRank++ )
+  {
+    uiTotal += m_auiMergeRankWins[iRank];
+  }
+  printf( "\nMerge decisions by SATD rank of the winning candidate (%d CUs):\n", uiTotal );
+  for( Int iRank = 0; iRank < MRG_MAX_NUM_CANDS; iRank++ )
+  {
+    printf( "  rank %d: %8d (%5.1f%%)\n", iRank, m_auiMergeRankWins[iRank], uiTotal ? 100.0 * m_auiMergeRankWins[iRank] / uiTotal : 0.0 );
+  }
 }
 
 
@@ -1459,6 +1596,92 @@ Void TEncCu::xCheckRDCostIntra( TComDataCU*& rpcBestCU, TComDataCU*& rpcTempCU,
   xCheckBestMode(rpcBestCU, rpcTempCU, uiDepth);
 }
 
+/** Check R-D costs of the intra partitionings of a CU: 2Nx2N, and NxN at the smallest CU size
+ * \param rpcBestCU pointer to best mode CU data structure
+ * \param rpcTempCU pointer to testing mode CU data structure
+ * \param uiDepth   CU depth
+ * \param iQP       QP of the CU
+ */
+Void TEncCu::xCheckRDCostIntraModes( TComDataCU*& rpcBestCU, TComDataCU*& rpcTempCU, UInt uiDepth, Int iQP )
+{
+  xCheckRDCostIntra( rpcBestCU, rpcTempCU, SIZE_2Nx2N );
+  rpcTempCU->initEstData( uiDepth, iQP );
+  if( uiDepth == g_uiMaxCUDepth - g_uiAddCUDepth )
+  {
+    if( rpcTempCU->getWidth(0) > ( 1 << rpcTempCU->getSlice()->getSPS()->getQuadtreeTULog2MinSize() ) )
+    {
+      xCheckRDCostIntra( rpcBestCU, rpcTempCU, SIZE_NxN   );
+      rpcTempCU->initEstData( uiDepth, iQP );
+    }
+  }
+}
+
+/** Start the intra mode search of a CU on the intra task.
+ * The task gets a copy of everything the intra search reads that the inter search may change afterwards:
+ * the initialized CU, the original samples, the CABAC state before the CU and the delta QP coding flag.
+ * \param pcTempCU  testing mode CU data structure, initialized for the CU
+ * \param uiDepth   CU depth
+ * \param iQP       QP of the CU
+ */
+Void TEncCu::xStartIntraTask( TComDataCU* pcTempCU, UInt uiDepth, Int iQP )
+{
+  TEncCu* pcCuEncoder = &m_pcIntraTask->m_cCuEncoder;
+
+  pcCuEncoder->m_ppcBestCU[uiDepth]->initEstDataFrom( pcTempCU );
+  pcCuEncoder->m_ppcTempCU[uiDepth]->initEstDataFrom( pcTempCU );
+  pcCuEncoder->m_ppcTempCU[uiDepth]->setIPCMFlag( 0, false );
+  pcCuEncoder->m_ppcTempCU[uiDepth]->setIPCMFlagSubParts( false, 0, uiDepth );
+  m_ppcOrigYuv[uiDepth]->copyToPartYuv( pcCuEncoder->m_ppcOrigYuv[uiDepth], 0 );
+  pcCuEncoder->m_pppcRDSbacCoder[uiDepth][CI_CURR_BEST]->load( m_pppcRDSbacCoder[uiDepth][CI_CURR_BEST] );
+  pcCuEncoder->setdQPFlag( getdQPFlag() );
+
+  m_pcIntraTask->m_uiDepth = uiDepth;
+  m_pcIntraTask->m_iQP     = iQP;
+  m_pcIntraTask->m_bCodeDQP = getdQPFlag();
+  m_cIntraQueue.submit( m_pcIntraTask );
+}
+
+/** Wait for the intra task and apply its result as if the intra modes had been checked at this point.
+ * The best intra mode replaces the best mode only if its cost is strictly lower, as in xCheckBestMode(),
+ * so the decision does not depend on the order in which the modes finished.
+ * The CABAC state the intra search ended with is taken over as well, since the split flag rate continues from it.
+ * \param rpcBestCU  pointer to best mode CU data structure
+ * \param rpcTempCU  pointer to testing mode CU data structure
+ * \param uiDepth    CU depth
+ * \param iQP        QP of the CU
+ * \param bUseResult apply the result, otherwise it is discarded
+ */
+Void TEncCu::xFinishIntraTask( TComDataCU*& rpcBestCU, TComDataCU*& rpcTempCU, UInt uiDepth, Int iQP, Bool bUseResult )
+{
+  m_cIntraQueue.wait( m_pcIntraTask );
+  if ( !bUseResult )
+  {
+    return;
+  }
+
+  if ( m_pcIntraTask->m_bCodeDQP != getdQPFlag() )
+  {
+    // the inter modes coded the delta QP the intra search assumed to be pending: search again
+    xCheckRDCostIntraModes( rpcBestCU, rpcTempCU, uiDepth, iQP );
+    return;
+  }
+
+  TEncCu*     pcCuEncoder = &m_pcIntraTask->m_cCuEncoder;
+  TComDataCU* pcIntraCU   = pcCuEncoder->m_ppcBestCU[uiDepth];
+
+  setdQPFlag( pcCuEncoder->getdQPFlag() );
+  m_pcRDGoOnSbacCoder->load( pcCuEncoder->m_pcRDGoOnSbacCoder );
+  if ( pcIntraCU->getTotalCost() < rpcBestCU->getTotalCost() )
+  {
+    rpcTempCU->initEstDataFrom( pcIntraCU );
+    pcCuEncoder->m_ppcPredYuvBest[uiDepth]->copyToPartYuv( m_ppcPredYuvTemp[uiDepth], 0 );
+    pcCuEncoder->m_ppcRecoYuvBest[uiDepth]->copyToPartYuv( m_ppcRecoYuvTemp[uiDepth], 0 );
+    m_pppcRDSbacCoder[uiDepth][CI_TEMP_BEST]->load( pcCuEncoder->m_pppcRDSbacCoder[uiDepth][CI_NEXT_BEST] );
+    xCheckBestMode( rpcBestCU, rpcTempCU, uiDepth );
+  }
+  rpcTempCU->initEstData( uiDepth, iQP );
+}
+
 /** Check R-D costs for a CU with PCM mode. 
  * \param rpcBestCU pointer to best mode CU data structure
  * \param rpcTempCU pointer to testing mode CU data structure
@@ -1861,4 +2084,124 @@ Void TEncCu::xLcuCollectARLStats(TComDataCU* rpcCU )
   m_pcTrQuant->getSliceNSamples()[LEVEL_RANGE] += numSamples[ LEVEL_RANGE ] ;
 }
 #endif
+
+// ====================================================================================================================
+// Intra search task
+// ====================================================================================================================
+
+/** Create the CU encoder and the search classes of the intra task.
+ * \param pcEncTop     encoder, provides the configuration
+ * \param uhTotalDepth total number of allowable depth
+ */
+Void TEncCuIntraTask::create( TEncTop* pcEncTop, UChar uhTotalDepth )
+{
+  m_cCuEncoder.create( uhTotalDepth, g_uiMaxCUWidth, g_uiMaxCUHeight );
+
+  m_pppcRDSbacCoder = new TEncSbac** [g_uiMaxCUDepth+1];
+#if FAST_BIT_EST
+  m_pppcBinCoderCABAC = new TEncBinCABACCounter** [g_uiMaxCUDepth+1];
+#else
+  m_pppcBinCoderCABAC = new TEncBinCABAC** [g_uiMaxCUDepth+1];
+#endif
+  for ( Int iDepth = 0; iDepth < g_uiMaxCUDepth+1; iDepth++ )
+  {
+    m_pppcRDSbacCoder[iDepth] = new TEncSbac* [CI_NUM];
+#if FAST_BIT_EST
+    m_pppcBinCoderCABAC[iDepth] = new TEncBinCABACCounter* [CI_NUM];
+#else
+    m_pppcBinCoderCABAC[iDepth] = new TEncBinCABAC* [CI_NUM];
+#endif
+    for ( Int iCIIdx = 0; iCIIdx < CI_NUM; iCIIdx++ )
+    {
+      m_pppcRDSbacCoder[iDepth][iCIIdx] = new TEncSbac;
+#if FAST_BIT_EST
+      m_pppcBinCoderCABAC[iDepth][iCIIdx] = new TEncBinCABACCounter;
+#else
+      m_pppcBinCoderCABAC[iDepth][iCIIdx] = new TEncBinCABAC;
+#endif
+      m_pppcRDSbacCoder[iDepth][iCIIdx]->init( m_pppcBinCoderCABAC[iDepth][iCIIdx] );
+    }
+  }
+  m_cRDGoOnSbacCoder.init( &m_cRDGoOnBinCoderCABAC );
+
+  m_cTrQuant.init( g_uiMaxCUWidth, g_uiMaxCUHeight, 1 << pcEncTop->getQuadtreeTULog2MaxSize(),
+                  0,
+                  NULL, NULL,
+                  NULL, pcEncTop->getUseRDOQ(), true
+                  ,pcEncTop->getUseTransformSkipFast()
+#if ADAPTIVE_QP_SELECTION
+                  , false
+#endif
+                  );
+  m_cSearch.init( pcEncTop, &m_cTrQuant, pcEncTop->getSearchRange(), pcEncTop->getSearchRange(), pcEncTop->getFastSearch(), 0, &m_cEntropyCoder, &m_cRdCost, m_pppcRDSbacCoder, &m_cRDGoOnSbacCoder );
+
+  TEncCu& rcCu = m_cCuEncoder;
+  rcCu.m_pcEncCfg          = pcEncTop;
+  rcCu.m_pcPrediction      = NULL;
+  rcCu.m_pcPredSearch      = &m_cSearch;
+  rcCu.m_pcTrQuant         = &m_cTrQuant;
+  rcCu.m_pcBitCounter      = &m_cBitCounter;
+  rcCu.m_pcRdCost          = &m_cRdCost;
+  rcCu.m_pcEntropyCoder    = &m_cEntropyCoder;
+  rcCu.m_pcCavlcCoder      = NULL;
+  rcCu.m_pcSbacCoder       = NULL;
+  rcCu.m_pcBinCABAC        = NULL;
+  rcCu.m_pppcRDSbacCoder   = m_pppcRDSbacCoder;
+  rcCu.m_pcRDGoOnSbacCoder = &m_cRDGoOnSbacCoder;
+  rcCu.m_bUseSBACRD        = true;
+  rcCu.m_pcRateCtrl        = pcEncTop->getRateCtrl();
+}
+
+Void TEncCuIntraTask::destroy()
+{
+  m_cCuEncoder.destroy();
+  for ( Int iDepth = 0; iDepth < g_uiMaxCUDepth+1; iDepth++ )
+  {
+    for ( Int iCIIdx = 0; iCIIdx < CI_NUM; iCIIdx++ )
+    {
+      delete m_pppcRDSbacCoder[iDepth][iCIIdx];
+      delete m_pppcBinCoderCABAC[iDepth][iCIIdx];
+    }
+    delete [] m_pppcRDSbacCoder[iDepth];
+    delete [] m_pppcBinCoderCABAC[iDepth];
+  }
+  delete [] m_pppcRDSbacCoder;
+  delete [] m_pppcBinCoderCABAC;
+}
+
+/** Copy the lambdas and the scaling list of the slice encoder and attach the RD coders to the slice.
+ * \param pcSlice   slice to be compressed
+ * \param pcRdCost  RD cost class of the slice encoder
+ * \param pcTrQuant quantizer of the slice encoder
+ */
+Void TEncCuIntraTask::initSlice( TComSlice* pcSlice, TComRdCost* pcRdCost, TComTrQuant* pcTrQuant )
+{
+  m_cRdCost.setLambda( pcRdCost->getLambda() );
+#if WEIGHTED_CHROMA_DISTORTION
+  m_cRdCost.setChromaDistortionWeight( pcRdCost->getChromaDistortionWeight() );
+#endif
+#if RDOQ_CHROMA_LAMBDA
+  m_cTrQuant.setLambda( pcTrQuant->getLambdaLuma(), pcTrQuant->getLambdaChroma() );
+#else
+  m_cTrQuant.setLambda( pcTrQuant->getLambda() );
+#endif
+  m_cTrQuant.setUseScalingList( pcTrQuant->getUseScalingList() );
+  if ( pcTrQuant->getUseScalingList() )
+  {
+    m_cTrQuant.setScalingList( pcSlice->getScalingList() );
+  }
+  else
+  {
+    m_cTrQuant.setFlatScalingList();
+  }
+
+  m_cEntropyCoder.setEntropyCoder( &m_cRDGoOnSbacCoder, pcSlice );
+  m_cEntropyCoder.setBitstream( &m_cBitCounter );
+  m_cRDGoOnBinCoderCABAC.setBinCountingEnableFlag( true );
+}
+
+Void TEncCuIntraTask::execute()
+{
+  m_cCuEncoder.xCheckRDCostIntraModes( m_cCuEncoder.m_ppcBestCU[m_uiDepth], m_cCuEncoder.m_ppcTempCU[m_uiDepth], m_uiDepth, m_iQP );
+}
 //! \}
@@ -45,6 +45,7 @@
 #include "TLibCommon/TComTrQuant.h"
 #include "TLibCommon/TComBitCounter.h"
 #include "TLibCommon/TComDataCU.h"
+#include "TLibCommon/TComThread.h"
 
 #include "TEncEntropy.h"
 #include "TEncSearch.h"
@@ -56,6 +57,7 @@ class TEncTop;
 class TEncSbac;
 class TEncCavlc;
 class TEncSlice;
+class TEncCuIntraTask;
 
 // ====================================================================================================================
 // Class definition
@@ -100,7 +102,19 @@ private:
   TEncSbac*               m_pcRDGoOnSbacCoder;
   Bool                    m_bUseSBACRD;
   TEncRateCtrl*           m_pcRateCtrl;
+
+  UInt                    m_auiMergeRankWins[MRG_MAX_NUM_CANDS]; ///< 2Nx2N merge decisions won by the candidate of each SATD rank
+  Double                  m_adSkipCost[ MAX_CU_DEPTH ];          ///< summed cost of the skipped CUs of each size in the picture (fast encoder)
+  Int                     m_aiSkipNum [ MAX_CU_DEPTH ];          ///< number of skipped CUs of each size in the picture (fast encoder)
+
+  // intra search of inter slices in parallel to the inter search
+  TEncCuIntraTask*        m_pcIntraTask;    ///< intra search task with its own CU encoder, NULL if the intra modes are searched sequentially
+  TComJobQueue            m_cIntraQueue;    ///< runs the intra search task on a second thread
+
+  friend class TEncCuIntraTask;
 public:
+  TEncCu();
+
   /// copy parameters from encoder class
   Void  init                ( TEncTop* pcEncTop );
   
@@ -116,7 +130,13 @@ public:
   /// CU encoding function
   Void  encodeCU            ( TComDataCU*    pcCU, Bool bForceTerminate = false  );
   
+  /// copy the slice level state of the search classes to the intra search task
+  Void  initIntraTask       ( TComSlice*     pcSlice );
+  
   Void setBitCounter        ( TComBitCounter* pcBitCounter ) { m_pcBitCounter = pcBitCounter; }
+  
+  /// print how often the merge candidate of each SATD rank won the merge decision
+  Void  printMergeRankStats ();
 protected:
   Void  finishCU            ( TComDataCU*  pcCU, UInt uiAbsPartIdx,           UInt uiDepth        );
 #if AMP_ENC_SPEEDUP
@@ -130,6 +150,7 @@ protected:
   Void  xCheckBestMode      ( TComDataCU*& rpcBestCU, TComDataCU*& rpcTempCU, UInt uiDepth        );
   
   Void  xCheckRDCostMerge2Nx2N( TComDataCU*& rpcBestCU, TComDataCU*& rpcTempCU, Bool *earlyDetectionSkipMode);
+  Void  xRankMergeCands     ( TComDataCU* pcCU, TComMvField* pcMvFieldNeighbours, UChar* puhInterDirNeighbours, Int iNumValidMergeCand, Int* piRank );
 
 #if AMP_MRG
   Void  xCheckRDCostInter   ( TComDataCU*& rpcBestCU, TComDataCU*& rpcTempCU, PartSize ePartSize, Bool bUseMRG = false  );
@@ -137,6 +158,9 @@ protected:
   Void  xCheckRDCostInter   ( TComDataCU*& rpcBestCU, TComDataCU*& rpcTempCU, PartSize ePartSize  );
 #endif
   Void  xCheckRDCostIntra   ( TComDataCU*& rpcBestCU, TComDataCU*& rpcTempCU, PartSize ePartSize  );
+  Void  xCheckRDCostIntraModes( TComDataCU*& rpcBestCU, TComDataCU*& rpcTempCU, UInt uiDepth, Int iQP );
+  Void  xStartIntraTask     ( TComDataCU*  pcTempCU, UInt uiDepth, Int iQP );
+  Void  xFinishIntraTask    ( TComDataCU*& rpcBestCU, TComDataCU*& rpcTempCU, UInt uiDepth, Int iQP, Bool bUseResult );
   Void  xCheckBestMode      ( TComDataCU*& rpcBestCU, TComDataCU*& rpcTempCU                      );
   Void  xCheckDQP           ( TComDataCU*  pcCU );
   
@@ -171,6 +195,37 @@ protected:
   Void  xFillPCMBuffer     ( TComDataCU*& pCU, TComYuv* pOrgYuv ); 
 };
 
+/// intra mode search of one CU depth, run by a CU encoder with its own search classes and RD coders
+class TEncCuIntraTask : public TComJob
+{
+public:
+  TEncCu                  m_cCuEncoder;
+  UInt                    m_uiDepth;        ///< depth of the searched CU
+  Int                     m_iQP;            ///< QP of the searched CU
+  Bool                    m_bCodeDQP;       ///< delta QP coding flag the search started with
+
+  Void  create              ( TEncTop* pcEncTop, UChar uhTotalDepth );
+  Void  destroy             ();
+  Void  initSlice           ( TComSlice* pcSlice, TComRdCost* pcRdCost, TComTrQuant* pcTrQuant );
+  Void  execute             ();
+
+private:
+  TEncSearch              m_cSearch;
+  TComTrQuant             m_cTrQuant;
+  TComRdCost              m_cRdCost;
+  TEncEntropy             m_cEntropyCoder;
+  TComBitCounter          m_cBitCounter;
+  TEncSbac***             m_pppcRDSbacCoder;
+  TEncSbac                m_cRDGoOnSbacCoder;
+#if FAST_BIT_EST
+  TEncBinCABACCounter***  m_pppcBinCoderCABAC;
+  TEncBinCABACCounter     m_cRDGoOnBinCoderCABAC;
+#else
+  TEncBinCABAC***         m_pppcBinCoderCABAC;
+  TEncBinCABAC            m_cRDGoOnBinCoderCABAC;
+#endif
+};
+
 //! \}
 
 #endif // __TENCMB__
@@ -72,6 +72,7 @@ TEncGOP::TEncGOP()
   m_iLastIDR            = 0;
   m_iGopSize            = 0;
   m_iNumPicCoded        = 0; //Niko
+  m_iNextGOPid          = 0;
   m_bFirst              = true;
   
   m_pcCfg               = NULL;
@@ -88,6 +89,11 @@ TEncGOP::TEncGOP()
   m_bRefreshPending     = 0;
   m_pocCRA            = 0;
 
+  m_pStatsFile          = NULL;
+
+  m_pcOutputIf          = NULL;
+  m_pcAccessUnits       = NULL;
+
   return;
 }
 
@@ -106,6 +112,13 @@ Void  TEncGOP::create( Int iWidth, Int iHeight, UInt iMaxCUWidth, UInt iMaxCUHei
 
 Void  TEncGOP::destroy()
 {
+  m_cMetricsQueue.destroy();
+
+  if ( m_pStatsFile )
+  {
+    fclose( m_pStatsFile );
+    m_pStatsFile = NULL;
+  }
 }
 
 Void TEncGOP::init ( TEncTop* pcTEncTop )
@@ -129,12 +142,40 @@ Void TEncGOP::init ( TEncTop* pcTEncTop )
   //--Adaptive Loop filter
   m_pcSAO                = pcTEncTop->getSAO();
   m_pcRateCtrl           = pcTEncTop->getRateCtrl();
+
+  m_cMetricsQueue.create( m_pcCfg->getUseAsyncMetrics() ? 1 : 0 );
+
+  if ( m_pcCfg->getStatsFile() )
+  {
+    m_pStatsFile = fopen( m_pcCfg->getStatsFile(), "w" );
+    if ( !m_pStatsFile )
+    {
+      fprintf( stderr, "\nfailed to open statistics file %s\n", m_pcCfg->getStatsFile() );
+      exit( EXIT_FAILURE );
+    }
+    ::memset( m_auiStatsLayerPics, 0, sizeof( m_auiStatsLayerPics ) );
+    ::memset( m_adStatsLayerBits,  0, sizeof( m_adStatsLayerBits  ) );
+    fprintf( m_pStatsFile, "# analysis %d\n", m_pcCfg->getUseAnalysisPass() ? 1 : 0 );
+    fprintf( m_pStatsFile, "# pic <POC> <TId> <type> <QP> <lambda> <lambdaModifier> <bits>\n" );
+  }
 }
 
 // ====================================================================================================================
 // Public member functions
 // ====================================================================================================================
-Void TEncGOP::compressGOP( Int iPOCLast, Int iNumPicRcvd, TComList<TComPic*>& rcListPic, TComList<TComPicYuv*>& rcListPicYuvRecOut, std::list<AccessUnit>& accessUnitsInGOP)
+/** Encode the pictures of one GOP
+ * \param iPOCLast POC of the last received picture
+ * \param iNumPicRcvd number of pictures of the GOP received so far
+ * \param rcListPic picture list
+ * \param rcListPicYuvRecOut reconstruction output buffers, may be empty when the reconstruction is not needed
+ * \param accessUnitsInGOP receives the access units in coding order
+ * \param bGOPComplete all pictures of the GOP have been received
+ *
+ * With bGOPComplete false only the GOP entries whose source pictures have arrived are coded, stopping at the
+ * first entry that is still missing; the next call continues from there. With an output interface set, every
+ * access unit is passed to it and removed from accessUnitsInGOP before the call returns.
+ */
+Void TEncGOP::compressGOP( Int iPOCLast, Int iNumPicRcvd, TComList<TComPic*>& rcListPic, TComList<TComPicYuv*>& rcListPicYuvRecOut, std::list<AccessUnit>& accessUnitsInGOP, Bool bGOPComplete )
 {
   TComPic*        pcPic;
   TComPicYuv*     pcPicYuvRecOut;
@@ -146,11 +187,16 @@ Void TEncGOP::compressGOP( Int iPOCLast, Int iNumPicRcvd, TComList<TComPic*>& rc
   TEncSbac* pcSbacCoders = NULL;
   TComOutputBitstream* pcSubstreamsOut = NULL;
 
-  xInitGOP( iPOCLast, iNumPicRcvd, rcListPic, rcListPicYuvRecOut );
+  if ( m_iNextGOPid == 0 )
+  {
+    xInitGOP( iPOCLast, iNumPicRcvd, rcListPic, rcListPicYuvRecOut );
   
-  m_iNumPicCoded = 0;
+    m_iNumPicCoded = 0;
+  }
+  m_pcAccessUnits = &accessUnitsInGOP;
 
-  for ( Int iGOPid=0; iGOPid < m_iGopSize; iGOPid++ )
+  Int iGOPid;
+  for ( iGOPid=m_iNextGOPid; iGOPid < m_iGopSize; iGOPid++ )
     {
       UInt uiColDir = 1;
       //-- For time output for each slice
@@ -212,6 +258,11 @@ Void TEncGOP::compressGOP( Int iPOCLast, Int iNumPicRcvd, TComList<TComPic*>& rc
       {
         continue;
       }
+      if ( !bGOPComplete && (Int)uiPOCCurr > iPOCLast )
+      {
+        // source picture not received yet
+        break;
+      }
         
       if(getNalUnitType(uiPOCCurr) == NAL_UNIT_CODED_SLICE_IDR)
       {
@@ -294,6 +345,7 @@ Void TEncGOP::compressGOP( Int iPOCLast, Int iNumPicRcvd, TComList<TComPic*>& rc
          pcSlice->createExplicitReferencePictureSetFromReference(rcListPic, pcSlice->getRPS());
       }
       pcSlice->applyReferencePictureSet(rcListPic, pcSlice->getRPS());
+      xReleaseUnusedPicData( rcListPic );
 
       if(pcSlice->getTLayer() > 0)
       {
@@ -688,6 +740,7 @@ Void TEncGOP::compressGOP( Int iPOCLast, Int iNumPicRcvd, TComList<TComPic*>& rc
         m_pcEntropyCoder->encodeVPS(m_pcEncTop->getVPS());
         writeRBSPTrailingBits(nalu.m_Bitstream);
         accessUnit.push_back(new NALUnitEBSP(nalu));
+        xNalUnitEncoded( pcPic, accessUnit );
 
 #if REMOVE_NAL_REF_FLAG
         nalu = NALUnit(NAL_UNIT_SPS);
@@ -698,6 +751,7 @@ Void TEncGOP::compressGOP( Int iPOCLast, Int iNumPicRcvd, TComList<TComPic*>& rc
         m_pcEntropyCoder->encodeSPS(pcSlice->getSPS());
         writeRBSPTrailingBits(nalu.m_Bitstream);
         accessUnit.push_back(new NALUnitEBSP(nalu));
+        xNalUnitEncoded( pcPic, accessUnit );
 
 #if REMOVE_NAL_REF_FLAG
         nalu = NALUnit(NAL_UNIT_PPS);
@@ -708,6 +762,7 @@ Void TEncGOP::compressGOP( Int iPOCLast, Int iNumPicRcvd, TComList<TComPic*>& rc
         m_pcEntropyCoder->encodePPS(pcSlice->getPPS());
         writeRBSPTrailingBits(nalu.m_Bitstream);
         accessUnit.push_back(new NALUnitEBSP(nalu));
+        xNalUnitEncoded( pcPic, accessUnit );
 
         m_bSeqFirst = false;
       }
@@ -984,6 +1039,7 @@ Void TEncGOP::compressGOP( Int iPOCLast, Int iNumPicRcvd, TComList<TComPic*>& rc
         Bool bNALUAlignedWrittenToList    = false; // used to ensure current NALU is not written more than once to the NALU list.
         xWriteTileLocationToSliceHeader(nalu, pcBitstreamRedirect, pcSlice);
         accessUnit.push_back(new NALUnitEBSP(nalu));
+        xNalUnitEncoded( pcPic, accessUnit );
         bNALUAlignedWrittenToList = true; 
         uiOneBitstreamPerSliceLength += nalu.m_Bitstream.getNumberOfWrittenBits(); // length of bitstream after byte-alignment
 
@@ -993,6 +1049,7 @@ Void TEncGOP::compressGOP( Int iPOCLast, Int iNumPicRcvd, TComList<TComPic*>& rc
           nalu.m_Bitstream.writeAlignZero();
         }
         accessUnit.push_back(new NALUnitEBSP(nalu));
+        xNalUnitEncoded( pcPic, accessUnit );
         uiOneBitstreamPerSliceLength += nalu.m_Bitstream.getNumberOfWrittenBits() + 24; // length of bitstream after byte-alignment + 3 byte startcode 0x000001
         }
 
@@ -1109,6 +1166,7 @@ Void TEncGOP::compressGOP( Int iPOCLast, Int iNumPicRcvd, TComList<TComPic*>& rc
             OutputNALUnit nalu(NAL_UNIT_APS, true);
             encodeAPS(&(vAPS[iCodedAPSIdx]), nalu.m_Bitstream, pcSliceForAPS);
             accessUnit.push_back(new NALUnitEBSP(nalu));
+        xNalUnitEncoded( pcPic, accessUnit );
 #endif
             processingState = ENCODE_SLICE;
           }
@@ -1141,68 +1199,25 @@ Void TEncGOP::compressGOP( Int iPOCLast, Int iNumPicRcvd, TComList<TComPic*>& rc
         pcPic->destroyNonDBFilterInfo();
       }
 
-      pcPic->compressMotion(); 
-      
-      //-- For time output for each slice
-      Double dEncTime = (double)(clock()-iBeforeTime) / CLOCKS_PER_SEC;
-
-      const char* digestStr = NULL;
-      if (m_pcCfg->getPictureDigestEnabled())
+      // finish the margins of the planes SAO did not process, so the reference is complete before it is used
+      if ( pcPic->getSlice(0)->isReferenced() )
       {
-        /* calculate MD5sum for entire reconstructed picture */
-        SEIpictureDigest sei_recon_picture_digest;
-        if(m_pcCfg->getPictureDigestEnabled() == 1)
-        {
-          sei_recon_picture_digest.method = SEIpictureDigest::MD5;
-          calcMD5(*pcPic->getPicYuvRec(), sei_recon_picture_digest.digest);
-          digestStr = digestToString(sei_recon_picture_digest.digest, 16);
-        }
-        else if(m_pcCfg->getPictureDigestEnabled() == 2)
+        pcPic->getPicYuvRec()->extendPicBorder();
+#if PEL8_ME
+        if ( g_uiBitDepth + g_uiBitIncrement == 8 )
         {
-          sei_recon_picture_digest.method = SEIpictureDigest::CRC;
-          calcCRC(*pcPic->getPicYuvRec(), sei_recon_picture_digest.digest);
-          digestStr = digestToString(sei_recon_picture_digest.digest, 2);
+          pcPic->getPicYuvRec()->copyToLuma8();
         }
-        else if(m_pcCfg->getPictureDigestEnabled() == 3)
-        {
-          sei_recon_picture_digest.method = SEIpictureDigest::CHECKSUM;
-          calcChecksum(*pcPic->getPicYuvRec(), sei_recon_picture_digest.digest);
-          digestStr = digestToString(sei_recon_picture_digest.digest, 4);
-        }
-#if REMOVE_NAL_REF_FLAG
-        OutputNALUnit nalu(NAL_UNIT_SEI, pcSlice->getTLayer());
-#else
-        OutputNALUnit nalu(NAL_UNIT_SEI, false, pcSlice->getTLayer());
 #endif
-
-        /* write the SEI messages */
-        m_pcEntropyCoder->setEntropyCoder(m_pcCavlcCoder, pcSlice);
-        m_pcEntropyCoder->setBitstream(&nalu.m_Bitstream);
-        m_pcEntropyCoder->encodeSEI(sei_recon_picture_digest);
-        writeRBSPTrailingBits(nalu.m_Bitstream);
-
-        /* insert the SEI message NALUnit before any Slice NALUnits */
-        AccessUnit::iterator it = find_if(accessUnit.begin(), accessUnit.end(), mem_fun(&NALUnit::isSlice));
-        accessUnit.insert(it, new NALUnitEBSP(nalu));
       }
 
-      xCalculateAddPSNR( pcPic, pcPic->getPicYuvRec(), accessUnit, dEncTime );
+      pcPic->compressMotion(); 
+      
+      //-- For time output for each slice
+      Double dEncTime = (double)(clock()-iBeforeTime) / CLOCKS_PER_SEC;
+
+      xSubmitPicMetrics( pcPic, accessUnit, dEncTime );
 
-      if (digestStr)
-      {
-        if(m_pcCfg->getPictureDigestEnabled() == 1)
-        {
-          printf(" [MD5:%s]", digestStr);
-        }
-        else if(m_pcCfg->getPictureDigestEnabled() == 2)
-        {
-          printf(" [CRC:%s]", digestStr);
-        }
-        else if(m_pcCfg->getPictureDigestEnabled() == 3)
-        {
-          printf(" [Checksum:%s]", digestStr);
-        }
-      }
       if(m_pcCfg->getUseRateCtrl())
       {
         unsigned  frameBits = m_vRVM_RP[m_vRVM_RP.size()-1];
@@ -1211,25 +1226,38 @@ Void TEncGOP::compressGOP( Int iPOCLast, Int iNumPicRcvd, TComList<TComPic*>& rc
 
 #if FIXED_ROUNDING_FRAME_MEMORY
       /* TODO: this should happen after copyToPic(pcPicYuvRecOut) */
+      m_cMetricsQueue.waitAll();
       pcPic->getPicYuvRec()->xFixedRoundingPic();
 #endif
-      pcPic->getPicYuvRec()->copyToPic(pcPicYuvRecOut);
+      if ( pcPicYuvRecOut )
+      {
+        pcPic->getPicYuvRec()->copyToPic(pcPicYuvRecOut);
+      }
       
       pcPic->setReconMark   ( true );
       m_bFirst = false;
       m_iNumPicCoded++;
 
-      /* logging: insert a newline at end of picture period */
-      printf("\n");
-      fflush(stdout);
+      /* logging: report the pictures whose metrics are already available */
+      xReportPicMetrics( false );
 
       delete[] pcSubstreamsOut;
   }
+  xReportPicMetrics( true );
+  m_pcAccessUnits = NULL;
+  delete pcBitstreamRedirect;
+
+  if ( iGOPid < m_iGopSize )
+  {
+    m_iNextGOPid = iGOPid;
+    return;
+  }
+  m_iNextGOPid = 0;
+
   if(m_pcCfg->getUseRateCtrl())
   {
     m_pcRateCtrl->updateRCGOPStatus();
   }
-  delete pcBitstreamRedirect;
 
   assert ( m_iNumPicCoded == iNumPicRcvd );
 }
@@ -1320,38 +1348,48 @@ Void TEncGOP::encodeAPS(TComAPS* pcAPS, TComOutputBitstream& APSbs, TComSlice* p
 
 Void TEncGOP::printOutSummary(UInt uiNumAllPicCoded)
 {
-  assert (uiNumAllPicCoded == m_gcAnalyzeAll.getNumPic());
+  assert (uiNumAllPicCoded == m_cAnalyzeAll.getNumPic());
   
     
   //--CFG_KDY
-  m_gcAnalyzeAll.setFrmRate( m_pcCfg->getFrameRate() );
-  m_gcAnalyzeI.setFrmRate( m_pcCfg->getFrameRate() );
-  m_gcAnalyzeP.setFrmRate( m_pcCfg->getFrameRate() );
-  m_gcAnalyzeB.setFrmRate( m_pcCfg->getFrameRate() );
+  m_cAnalyzeAll.setFrmRate( m_pcCfg->getFrameRate() );
+  m_cAnalyzeI.setFrmRate( m_pcCfg->getFrameRate() );
+  m_cAnalyzeP.setFrmRate( m_pcCfg->getFrameRate() );
+  m_cAnalyzeB.setFrmRate( m_pcCfg->getFrameRate() );
   
   //-- all
+  if ( m_pcCfg->getRendition() >= 0 )
+  {
+    printf( "\n\nRendition %d, QP %d", m_pcCfg->getRendition(), m_pcCfg->getQP() );
+    if ( m_pcCfg->getUseRateCtrl() )
+    {
+      printf( ", target bitrate %d", m_pcCfg->getTargetBitrate() );
+    }
+  }
   printf( "\n\nSUMMARY --------------------------------------------------------\n" );
-  m_gcAnalyzeAll.printOut('a');
+  m_cAnalyzeAll.printOut('a');
   
   printf( "\n\nI Slices--------------------------------------------------------\n" );
-  m_gcAnalyzeI.printOut('i');
+  m_cAnalyzeI.printOut('i');
   
   printf( "\n\nP Slices--------------------------------------------------------\n" );
-  m_gcAnalyzeP.printOut('p');
+  m_cAnalyzeP.printOut('p');
   
   printf( "\n\nB Slices--------------------------------------------------------\n" );
-  m_gcAnalyzeB.printOut('b');
+  m_cAnalyzeB.printOut('b');
   
 #if _SUMMARY_OUT_
-  m_gcAnalyzeAll.printSummaryOut();
+  m_cAnalyzeAll.printSummaryOut();
 #endif
 #if _SUMMARY_PIC_
-  m_gcAnalyzeI.printSummary('I');
-  m_gcAnalyzeP.printSummary('P');
-  m_gcAnalyzeB.printSummary('B');
+  m_cAnalyzeI.printSummary('I');
+  m_cAnalyzeP.printSummary('P');
+  m_cAnalyzeB.printSummary('B');
 #endif
 
   printf("\nRVM: %.3lf\n" , xCalculateRVM());
+
+  xWriteLayerStats();
 }
 
 Void TEncGOP::preLoopFilterPicAll( TComPic* pcPic, UInt64& ruiDist, UInt64& ruiBits )
@@ -1454,13 +1492,17 @@ Void TEncGOP::xGetBuffer( TComList<TComPic*>&       rcListPic,
 {
   Int i;
   //  Rec. output
-  TComList<TComPicYuv*>::iterator     iterPicYuvRec = rcListPicYuvRecOut.end();
-  for ( i = 0; i < iNumPicRcvd - iTimeOffset + 1; i++ )
+  rpcPicYuvRecOut = NULL;
+  if ( !rcListPicYuvRecOut.empty() )
   {
-    iterPicYuvRec--;
-  }
+    TComList<TComPicYuv*>::iterator     iterPicYuvRec = rcListPicYuvRecOut.end();
+    for ( i = 0; i < iNumPicRcvd - iTimeOffset + 1; i++ )
+    {
+      iterPicYuvRec--;
+    }
   
-  rpcPicYuvRecOut = *(iterPicYuvRec);
+    rpcPicYuvRecOut = *(iterPicYuvRec);
+  }
   
   //  Current pic.
   TComList<TComPic*>::iterator        iterPic       = rcListPic.begin();
@@ -1579,78 +1621,48 @@ static const char* nalUnitTypeToString(NalUnitType type)
 }
 #endif
 
-Void TEncGOP::xCalculateAddPSNR( TComPic* pcPic, TComPicYuv* pcPicD, const AccessUnit& accessUnit, Double dEncTime )
+Void TEncPicMetrics::execute()
 {
-  Int     x, y;
-  UInt64 uiSSDY  = 0;
-  UInt64 uiSSDU  = 0;
-  UInt64 uiSSDV  = 0;
-  
-  Double  dYPSNR  = 0.0;
-  Double  dUPSNR  = 0.0;
-  Double  dVPSNR  = 0.0;
-  
-  //===== calculate PSNR =====
-  Pel*  pOrg    = pcPic ->getPicYuvOrg()->getLumaAddr();
-  Pel*  pRec    = pcPicD->getLumaAddr();
-  Int   iStride = pcPicD->getStride();
-  
-  Int   iWidth;
-  Int   iHeight;
-  
-  iWidth  = pcPicD->getWidth () - m_pcEncTop->getPad(0);
-  iHeight = pcPicD->getHeight() - m_pcEncTop->getPad(1);
-  
-  Int   iSize   = iWidth*iHeight;
-  
-  for( y = 0; y < iHeight; y++ )
+  TComPicYuv* pcPicOrg = m_pcPic->getPicYuvOrg();
+  TComPicYuv* pcPicRec = m_pcPic->getPicYuvRec();
+  Int         iStride  = pcPicRec->getStride();
+
+  m_auiSSD[0] = calcSSD( pcPicOrg->getLumaAddr(), pcPicRec->getLumaAddr(), iStride,    m_iWidth,    m_iHeight    );
+  m_auiSSD[1] = calcSSD( pcPicOrg->getCbAddr(),   pcPicRec->getCbAddr(),   iStride>>1, m_iWidth>>1, m_iHeight>>1 );
+  m_auiSSD[2] = calcSSD( pcPicOrg->getCrAddr(),   pcPicRec->getCrAddr(),   iStride>>1, m_iWidth>>1, m_iHeight>>1 );
+
+  /* calculate the digest for entire reconstructed picture */
+  if (m_iDigestMethod == 1)
   {
-    for( x = 0; x < iWidth; x++ )
-    {
-      Int iDiff = (Int)( pOrg[x] - pRec[x] );
-      uiSSDY   += iDiff * iDiff;
-    }
-    pOrg += iStride;
-    pRec += iStride;
+    calcMD5(*pcPicRec, m_aucDigest);
   }
-  
-  iHeight >>= 1;
-  iWidth  >>= 1;
-  iStride >>= 1;
-  pOrg  = pcPic ->getPicYuvOrg()->getCbAddr();
-  pRec  = pcPicD->getCbAddr();
-  
-  for( y = 0; y < iHeight; y++ )
+  else if (m_iDigestMethod == 2)
   {
-    for( x = 0; x < iWidth; x++ )
-    {
-      Int iDiff = (Int)( pOrg[x] - pRec[x] );
-      uiSSDU   += iDiff * iDiff;
-    }
-    pOrg += iStride;
-    pRec += iStride;
+    calcCRC(*pcPicRec, m_aucDigest);
   }
-  
-  pOrg  = pcPic ->getPicYuvOrg()->getCrAddr();
-  pRec  = pcPicD->getCrAddr();
-  
-  for( y = 0; y < iHeight; y++ )
+  else if (m_iDigestMethod == 3)
   {
-    for( x = 0; x < iWidth; x++ )
-    {
-      Int iDiff = (Int)( pOrg[x] - pRec[x] );
-      uiSSDV   += iDiff * iDiff;
-    }
-    pOrg += iStride;
-    pRec += iStride;
+    calcChecksum(*pcPicRec, m_aucDigest);
   }
-  
-  unsigned int maxval = 255 * (1<<(g_uiBitDepth + g_uiBitIncrement -8));
-  Double fRefValueY = (double) maxval * maxval * iSize;
-  Double fRefValueC = fRefValueY / 4.0;
-  dYPSNR            = ( uiSSDY ? 10.0 * log10( fRefValueY / (Double)uiSSDY ) : 99.99 );
-  dUPSNR            = ( uiSSDU ? 10.0 * log10( fRefValueC / (Double)uiSSDU ) : 99.99 );
-  dVPSNR            = ( uiSSDV ? 10.0 * log10( fRefValueC / (Double)uiSSDV ) : 99.99 );
+}
+
+/** Capture everything needed to report a coded picture and hand the distortion and digest computation to the metrics queue
+ * \param pcPic coded picture
+ * \param accessUnit access unit of the picture, receives the picture digest SEI when the metrics are reported
+ * \param dEncTime encoding time of the picture
+ */
+Void TEncGOP::xSubmitPicMetrics( TComPic* pcPic, AccessUnit& accessUnit, Double dEncTime )
+{
+  TComSlice*      pcSlice   = pcPic->getSlice(0);
+  TEncPicMetrics* pcMetrics = new TEncPicMetrics;
+
+  pcMetrics->m_pcPic          = pcPic;
+  pcMetrics->m_pcAccessUnit   = &accessUnit;
+  pcMetrics->m_iWidth         = pcPic->getPicYuvRec()->getWidth () - m_pcEncTop->getPad(0);
+  pcMetrics->m_iHeight        = pcPic->getPicYuvRec()->getHeight() - m_pcEncTop->getPad(1);
+  pcMetrics->m_iDigestMethod  = m_pcCfg->getPictureDigestEnabled();
+  pcMetrics->m_iTLayer        = pcSlice->getTLayer();
+  pcMetrics->m_eSliceType     = pcSlice->getSliceType();
 
   /* calculate the size of the access unit, excluding:
    *  - any AnnexB contributions (start_code_prefix, zero_byte, etc.,)
@@ -1669,28 +1681,16 @@ Void TEncGOP::xCalculateAddPSNR( TComPic* pcPic, TComPicYuv* pcPicD, const Acces
 
   unsigned uibits = numRBSPBytes * 8;
   m_vRVM_RP.push_back( uibits );
+  pcMetrics->m_uiBits = uibits;
+  xWritePicStats( pcSlice, uibits );
 
-  //===== add PSNR =====
-  m_gcAnalyzeAll.addResult (dYPSNR, dUPSNR, dVPSNR, (Double)uibits);
-  TComSlice*  pcSlice = pcPic->getSlice(0);
-  if (pcSlice->isIntra())
-  {
-    m_gcAnalyzeI.addResult (dYPSNR, dUPSNR, dVPSNR, (Double)uibits);
-  }
-  if (pcSlice->isInterP())
-  {
-    m_gcAnalyzeP.addResult (dYPSNR, dUPSNR, dVPSNR, (Double)uibits);
-  }
-  if (pcSlice->isInterB())
-  {
-    m_gcAnalyzeB.addResult (dYPSNR, dUPSNR, dVPSNR, (Double)uibits);
-  }
-
+  /* the reference marking of the picture changes while the rest of the GOP is coded, so the log is captured now */
+  Char acLine[64];
   Char c = (pcSlice->isIntra() ? 'I' : pcSlice->isInterP() ? 'P' : 'B');
   if (!pcSlice->isReferenced()) c += 32;
 
 #if ADAPTIVE_QP_SELECTION
-  printf("POC %4d TId: %1d ( %c-SLICE, nQP %d QP %d ) %10d bits",
+  snprintf(acLine, sizeof(acLine), "POC %4d TId: %1d ( %c-SLICE, nQP %d QP %d ) %10d bits",
          pcSlice->getPOC(),
          pcSlice->getTLayer(),
          c,
@@ -1698,26 +1698,268 @@ Void TEncGOP::xCalculateAddPSNR( TComPic* pcPic, TComPicYuv* pcPicD, const Acces
          pcSlice->getSliceQp(),
          uibits );
 #else
-  printf("POC %4d TId: %1d ( %c-SLICE, QP %d ) %10d bits",
+  snprintf(acLine, sizeof(acLine), "POC %4d TId: %1d ( %c-SLICE, QP %d ) %10d bits",
          pcSlice->getPOC()-pcSlice->getLastIDR(),
          pcSlice->getTLayer(),
          c,
          pcSlice->getSliceQp(),
          uibits );
 #endif
+  pcMetrics->m_cLogPrefix = acLine;
 
-  printf(" [Y %6.4lf dB    U %6.4lf dB    V %6.4lf dB]", dYPSNR, dUPSNR, dVPSNR );
-  printf(" [ET %5.0f ]", dEncTime );
-  
+  snprintf(acLine, sizeof(acLine), " [ET %5.0f ]", dEncTime );
+  pcMetrics->m_cLogSuffix = acLine;
   for (Int iRefList = 0; iRefList < 2; iRefList++)
   {
-    printf(" [L%d ", iRefList);
+    snprintf(acLine, sizeof(acLine), " [L%d ", iRefList);
+    pcMetrics->m_cLogSuffix += acLine;
     for (Int iRefIndex = 0; iRefIndex < pcSlice->getNumRefIdx(RefPicList(iRefList)); iRefIndex++)
     {
-      printf ("%d ", pcSlice->getRefPOC(RefPicList(iRefList), iRefIndex)-pcSlice->getLastIDR());
+      snprintf(acLine, sizeof(acLine), "%d ", pcSlice->getRefPOC(RefPicList(iRefList), iRefIndex)-pcSlice->getLastIDR());
+      pcMetrics->m_cLogSuffix += acLine;
     }
-    printf("]");
+    pcMetrics->m_cLogSuffix += "]";
   }
+
+  m_cPendingMetrics.push_back( pcMetrics );
+  m_cMetricsQueue.submit( pcMetrics );
+}
+
+/** Report the pictures whose metrics are complete, in coding order
+ * \param bWait wait for all outstanding metrics instead of stopping at the first unfinished picture
+ *
+ * Inserts the picture digest SEI into the access unit, adds the PSNR to the analyzers and prints the picture log.
+ */
+Void TEncGOP::xReportPicMetrics( Bool bWait )
+{
+  while (!m_cPendingMetrics.empty())
+  {
+    TEncPicMetrics* pcMetrics = m_cPendingMetrics.front();
+    if (!bWait && !m_cMetricsQueue.isDone( pcMetrics ))
+    {
+      break;
+    }
+    m_cMetricsQueue.wait( pcMetrics );
+    m_cPendingMetrics.pop_front();
+
+    const char* digestStr = NULL;
+    if (pcMetrics->m_iDigestMethod)
+    {
+      SEIpictureDigest sei_recon_picture_digest;
+      if(pcMetrics->m_iDigestMethod == 1)
+      {
+        sei_recon_picture_digest.method = SEIpictureDigest::MD5;
+        digestStr = digestToString(pcMetrics->m_aucDigest, 16);
+      }
+      else if(pcMetrics->m_iDigestMethod == 2)
+      {
+        sei_recon_picture_digest.method = SEIpictureDigest::CRC;
+        digestStr = digestToString(pcMetrics->m_aucDigest, 2);
+      }
+      else if(pcMetrics->m_iDigestMethod == 3)
+      {
+        sei_recon_picture_digest.method = SEIpictureDigest::CHECKSUM;
+        digestStr = digestToString(pcMetrics->m_aucDigest, 4);
+      }
+      ::memcpy(sei_recon_picture_digest.digest, pcMetrics->m_aucDigest, sizeof(pcMetrics->m_aucDigest));
+#if REMOVE_NAL_REF_FLAG
+      OutputNALUnit nalu(NAL_UNIT_SEI, pcMetrics->m_iTLayer);
+#else
+      OutputNALUnit nalu(NAL_UNIT_SEI, false, pcMetrics->m_iTLayer);
+#endif
+
+      /* write the SEI messages */
+      m_pcEntropyCoder->setEntropyCoder(m_pcCavlcCoder, pcMetrics->m_pcPic->getSlice(0));
+      m_pcEntropyCoder->setBitstream(&nalu.m_Bitstream);
+      m_pcEntropyCoder->encodeSEI(sei_recon_picture_digest);
+      writeRBSPTrailingBits(nalu.m_Bitstream);
+
+      /* insert the SEI message NALUnit before any Slice NALUnits */
+      AccessUnit& accessUnit = *pcMetrics->m_pcAccessUnit;
+      AccessUnit::iterator it = find_if(accessUnit.begin(), accessUnit.end(), mem_fun(&NALUnit::isSlice));
+      accessUnit.insert(it, new NALUnitEBSP(nalu));
+    }
+
+    // the line is printed at once, renditions coded in parallel write to the same console
+    std::string cLine;
+    if (m_pcCfg->getRendition() >= 0)
+    {
+      Char acTag[16];
+      snprintf(acTag, sizeof(acTag), "[R%d] ", m_pcCfg->getRendition());
+      cLine = acTag;
+    }
+    xAddPSNR( pcMetrics, cLine );
+
+    if (m_pcOutputIf)
+    {
+      /* hand the access unit over as soon as it is final */
+      assert( m_pcAccessUnits && &m_pcAccessUnits->front() == pcMetrics->m_pcAccessUnit );
+      AccessUnit& accessUnit = *pcMetrics->m_pcAccessUnit;
+      Int iPOC = pcMetrics->m_pcPic->getPOC();
+      if (pcMetrics->m_iDigestMethod)
+      {
+        for (AccessUnit::const_iterator it = accessUnit.begin(); it != accessUnit.end(); it++)
+        {
+          m_pcOutputIf->nalUnitEncoded( iPOC, **it );
+        }
+      }
+      m_pcOutputIf->accessUnitEncoded( iPOC, accessUnit, pcMetrics->m_pcPic->getPicYuvRec() );
+      m_pcAccessUnits->pop_front();
+    }
+
+    if (digestStr)
+    {
+      if(pcMetrics->m_iDigestMethod == 1)
+      {
+        cLine += " [MD5:";
+      }
+      else if(pcMetrics->m_iDigestMethod == 2)
+      {
+        cLine += " [CRC:";
+      }
+      else if(pcMetrics->m_iDigestMethod == 3)
+      {
+        cLine += " [Checksum:";
+      }
+      cLine += digestStr;
+      cLine += "]";
+    }
+
+    /* logging: insert a newline at end of picture period */
+    cLine += "\n";
+    fputs(cLine.c_str(), stdout);
+    fflush(stdout);
+
+    delete pcMetrics;
+  }
+}
+
+/** Pass the NAL unit just appended to an access unit to the output interface
+ * \param pcPic picture being coded
+ * \param accessUnit access unit of the picture
+ *
+ * Only done while the access unit is being written when no picture digest SEI has to be inserted in front of the
+ * slices later, otherwise xReportPicMetrics() passes all NAL units of the completed access unit.
+ */
+Void TEncGOP::xNalUnitEncoded( TComPic* pcPic, AccessUnit& accessUnit )
+{
+  if (m_pcOutputIf && !m_pcCfg->getPictureDigestEnabled())
+  {
+    m_pcOutputIf->nalUnitEncoded( pcPic->getPOC(), *accessUnit.back() );
+  }
+}
+
+/** Free the CU data of the coded pictures that are no longer used for reference
+ * \param rcListPic picture list
+ *
+ * Such pictures only wait for their metrics and output, which use the sample buffers and the slices.
+ * The CU data is allocated again when TEncTop reuses the picture buffer.
+ */
+Void TEncGOP::xReleaseUnusedPicData( TComList<TComPic*>& rcListPic )
+{
+  for ( TComList<TComPic*>::iterator iterPic = rcListPic.begin(); iterPic != rcListPic.end(); iterPic++ )
+  {
+    TComPic* pcPic = *iterPic;
+    if ( pcPic->getReconMark() && !pcPic->getSlice(0)->isReferenced() )
+    {
+      pcPic->getPicSym()->releaseCUData();
+    }
+  }
+}
+
+/** Append the rate and lambda of a coded picture to the statistics file
+ * \param pcSlice first slice of the picture
+ * \param uiBits size of the picture in bits, excluding SEI NAL units
+ */
+Void TEncGOP::xWritePicStats( TComSlice* pcSlice, UInt uiBits )
+{
+  if ( !m_pStatsFile )
+  {
+    return;
+  }
+#if ALF_CHROMA_LAMBDA || SAO_CHROMA_LAMBDA
+  Double dLambda = pcSlice->getLambdaLuma();
+#else
+  Double dLambda = pcSlice->getLambda();
+#endif
+  UInt   uiTLayer        = pcSlice->getTLayer();
+  Double dLambdaModifier = 1.0;
+  Char   cType           = 'I';
+  if ( !pcSlice->isIntra() )
+  {
+    // the lambda modifier only applies to inter pictures
+    dLambdaModifier = m_pcCfg->getLambdaModifier( uiTLayer );
+    cType           = pcSlice->isInterP() ? 'P' : 'B';
+    m_auiStatsLayerPics[ uiTLayer ]++;
+    m_adStatsLayerBits [ uiTLayer ] += uiBits;
+  }
+  fprintf( m_pStatsFile, "pic %d %u %c %d %.6f %.7f %u\n", pcSlice->getPOC(), uiTLayer, cType, pcSlice->getSliceQp(), dLambda, dLambdaModifier, uiBits );
+}
+
+/** Append the average rate of the inter pictures of each temporal layer to the statistics file
+ */
+Void TEncGOP::xWriteLayerStats()
+{
+  if ( !m_pStatsFile )
+  {
+    return;
+  }
+  fprintf( m_pStatsFile, "# layer <TId> <pictures> <averageBits> <lambdaModifier>\n" );
+  for ( UInt uiTLayer = 0; uiTLayer < MAX_TLAYER; uiTLayer++ )
+  {
+    if ( m_auiStatsLayerPics[ uiTLayer ] )
+    {
+      fprintf( m_pStatsFile, "layer %u %u %.4f %.7f\n", uiTLayer, m_auiStatsLayerPics[ uiTLayer ],
+               m_adStatsLayerBits[ uiTLayer ] / m_auiStatsLayerPics[ uiTLayer ], m_pcCfg->getLambdaModifier( uiTLayer ) );
+    }
+  }
+  fflush( m_pStatsFile );
+}
+
+/** Add the PSNR of a picture to the analyzers and append it to the picture log
+ * \param pcMetrics metrics of the picture
+ * \param rcLine picture log line
+ */
+Void TEncGOP::xAddPSNR( TEncPicMetrics* pcMetrics, std::string& rcLine )
+{
+  Double  dYPSNR  = 0.0;
+  Double  dUPSNR  = 0.0;
+  Double  dVPSNR  = 0.0;
+
+  Int     iSize   = pcMetrics->m_iWidth*pcMetrics->m_iHeight;
+  UInt64  uiSSDY  = pcMetrics->m_auiSSD[0];
+  UInt64  uiSSDU  = pcMetrics->m_auiSSD[1];
+  UInt64  uiSSDV  = pcMetrics->m_auiSSD[2];
+
+  unsigned int maxval = 255 * (1<<(g_uiBitDepth + g_uiBitIncrement -8));
+  Double fRefValueY = (double) maxval * maxval * iSize;
+  Double fRefValueC = fRefValueY / 4.0;
+  dYPSNR            = ( uiSSDY ? 10.0 * log10( fRefValueY / (Double)uiSSDY ) : 99.99 );
+  dUPSNR            = ( uiSSDU ? 10.0 * log10( fRefValueC / (Double)uiSSDU ) : 99.99 );
+  dVPSNR            = ( uiSSDV ? 10.0 * log10( fRefValueC / (Double)uiSSDV ) : 99.99 );
+
+  UInt uibits = pcMetrics->m_uiBits;
+
+  //===== add PSNR =====
+  m_cAnalyzeAll.addResult (dYPSNR, dUPSNR, dVPSNR, (Double)uibits);
+  if (pcMetrics->m_eSliceType == I_SLICE)
+  {
+    m_cAnalyzeI.addResult (dYPSNR, dUPSNR, dVPSNR, (Double)uibits);
+  }
+  if (pcMetrics->m_eSliceType == P_SLICE)
+  {
+    m_cAnalyzeP.addResult (dYPSNR, dUPSNR, dVPSNR, (Double)uibits);
+  }
+  if (pcMetrics->m_eSliceType == B_SLICE)
+  {
+    m_cAnalyzeB.addResult (dYPSNR, dUPSNR, dVPSNR, (Double)uibits);
+  }
+
+  Char acPSNR[64];
+  snprintf(acPSNR, sizeof(acPSNR), " [Y %6.4lf dB    U %6.4lf dB    V %6.4lf dB]", dYPSNR, dUPSNR, dVPSNR );
+  rcLine += pcMetrics->m_cLogPrefix;
+  rcLine += acPSNR;
+  rcLine += pcMetrics->m_cLogSuffix;
 }
 
 /** Function for deciding the nal_unit_type.
@@ -1815,28 +2057,9 @@ Void TEncGOP::xWriteTileLocationToSliceHeader (OutputNALUnit& rNalu, TComOutputB
   rNalu.m_Bitstream.writeAlignOne();
 #endif
 
-  // Perform bitstream concatenation
-  if (rpcBitstreamRedirect->getNumberOfWrittenBits() > 0)
-  {
-    UInt uiBitCount  = rpcBitstreamRedirect->getNumberOfWrittenBits();
-    if (rpcBitstreamRedirect->getByteStreamLength()>0)
-    {
-      UChar *pucStart  =  reinterpret_cast<UChar*>(rpcBitstreamRedirect->getByteStream());
-      UInt uiWriteByteCount = 0;
-      while (uiWriteByteCount < (uiBitCount >> 3) )
-      {
-        UInt uiBits = (*pucStart);
-        rNalu.m_Bitstream.write(uiBits, 8);
-        pucStart++;
-        uiWriteByteCount++;
-      }
-    }
-    UInt uiBitsHeld = (uiBitCount & 0x07);
-    for (UInt uiIdx=0; uiIdx < uiBitsHeld; uiIdx++)
-    {
-      rNalu.m_Bitstream.write((rpcBitstreamRedirect->getHeldBits() & (1 << (7-uiIdx))) >> (7-uiIdx), 1);
-    }          
-  }
+  // Perform bitstream concatenation; the slice header is byte aligned, so the
+  // whole bytes of the redirected slice data are appended in one block
+  rNalu.m_Bitstream.addSubstream(rpcBitstreamRedirect);
 
   m_pcEntropyCoder->setBitstream(&rNalu.m_Bitstream);
 
@@ -39,6 +39,7 @@
 #define __TENCGOP__
 
 #include <list>
+#include <string>
 
 #include <stdlib.h>
 
@@ -47,6 +48,7 @@
 #include "TLibCommon/TComBitCounter.h"
 #include "TLibCommon/TComLoopFilter.h"
 #include "TLibCommon/AccessUnit.h"
+#include "TLibCommon/TComThread.h"
 #include "TEncAdaptiveLoopFilter.h"
 #include "TEncSampleAdaptiveOffset.h"
 #include "TEncSlice.h"
@@ -56,6 +58,7 @@
 
 #include "TEncAnalyze.h"
 #include "TEncRateCtrl.h"
+#include "TEncOutputIf.h"
 #include <vector>
 
 //! \ingroup TLibEncoder
@@ -67,6 +70,30 @@ class TEncTop;
 // Class definition
 // ====================================================================================================================
 
+/// post-encode metrics of one picture: PSNR distortion and picture digest
+/** Computed off the coding path by the metrics queue of TEncGOP; the results are reported and the
+ *  digest SEI is inserted in coding order once the job has finished.
+ */
+class TEncPicMetrics : public TComJob
+{
+public:
+  TComPic*    m_pcPic;
+  AccessUnit* m_pcAccessUnit;               ///< access unit that receives the picture digest SEI
+  Int         m_iWidth;                     ///< luma width without padding
+  Int         m_iHeight;                    ///< luma height without padding
+  Int         m_iDigestMethod;              ///< Checksum(3)/CRC(2)/MD5(1)/disable(0)
+  UInt        m_iTLayer;                    ///< temporal layer of the digest SEI NAL unit
+  SliceType   m_eSliceType;
+  UInt        m_uiBits;
+  std::string m_cLogPrefix;                 ///< picture log up to the PSNR values, captured at coding time
+  std::string m_cLogSuffix;                 ///< picture log after the PSNR values, captured at coding time
+
+  UInt64      m_auiSSD[3];                  ///< output: Y, Cb and Cr sum of squared differences
+  UChar       m_aucDigest[3][16];           ///< output: picture digest of the reconstruction
+
+  Void execute();
+};
+
 /// GOP encoder class
 class TEncGOP
 {
@@ -77,6 +104,7 @@ private:
   Int                     m_iLastIDR;
   Int                     m_iGopSize;
   Int                     m_iNumPicCoded;
+  Int                     m_iNextGOPid;             ///< first GOP entry not coded yet when a GOP is coded in several calls
   Bool                    m_bFirst;
   
   //  Access channel
@@ -110,6 +138,21 @@ private:
 
   std::vector<Int> m_vRVM_RP;
 
+  TComJobQueue                m_cMetricsQueue;      ///< computes picture metrics in the background
+  std::list<TEncPicMetrics*>  m_cPendingMetrics;    ///< metrics not yet reported, in coding order
+
+  TEncOutputIf*               m_pcOutputIf;         ///< receives each access unit once reported, NULL to return them per GOP
+  std::list<AccessUnit>*      m_pcAccessUnits;      ///< access units of the current compressGOP() call, in coding order
+
+  FILE*                   m_pStatsFile;                      ///< rate/lambda statistics output, NULL if not written
+  UInt                    m_auiStatsLayerPics[ MAX_TLAYER ]; ///< number of inter pictures per temporal layer
+  Double                  m_adStatsLayerBits [ MAX_TLAYER ]; ///< bits of the inter pictures per temporal layer
+
+  TEncAnalyze             m_cAnalyzeAll;                     ///< PSNR and rate of all pictures
+  TEncAnalyze             m_cAnalyzeI;                       ///< PSNR and rate of the I pictures
+  TEncAnalyze             m_cAnalyzeP;                       ///< PSNR and rate of the P pictures
+  TEncAnalyze             m_cAnalyzeB;                       ///< PSNR and rate of the B pictures
+
 public:
   TEncGOP();
   virtual ~TEncGOP();
@@ -118,11 +161,12 @@ public:
   Void  destroy     ();
   
   Void  init        ( TEncTop* pcTEncTop );
-  Void  compressGOP ( Int iPOCLast, Int iNumPicRcvd, TComList<TComPic*>& rcListPic, TComList<TComPicYuv*>& rcListPicYuvRec, std::list<AccessUnit>& accessUnitsInGOP );
+  Void  compressGOP ( Int iPOCLast, Int iNumPicRcvd, TComList<TComPic*>& rcListPic, TComList<TComPicYuv*>& rcListPicYuvRec, std::list<AccessUnit>& accessUnitsInGOP, Bool bGOPComplete = true );
   Void xWriteTileLocationToSliceHeader (OutputNALUnit& rNalu, TComOutputBitstream*& rpcBitstreamRedirect, TComSlice*& rpcSlice);
 
   
   Int   getGOPSize()          { return  m_iGopSize;  }
+  Void  setOutputIf( TEncOutputIf* pcOutputIf ) { m_pcOutputIf = pcOutputIf; }
   
   TComList<TComPic*>*   getListPic()      { return m_pcListPic; }
   
@@ -147,7 +191,13 @@ protected:
   Void  xInitGOP          ( Int iPOC, Int iNumPicRcvd, TComList<TComPic*>& rcListPic, TComList<TComPicYuv*>& rcListPicYuvRecOut );
   Void  xGetBuffer        ( TComList<TComPic*>& rcListPic, TComList<TComPicYuv*>& rcListPicYuvRecOut, Int iNumPicRcvd, Int iTimeOffset, TComPic*& rpcPic, TComPicYuv*& rpcPicYuvRecOut, UInt uiPOCCurr );
   
-  Void  xCalculateAddPSNR ( TComPic* pcPic, TComPicYuv* pcPicD, const AccessUnit&, Double dEncTime );
+  Void  xSubmitPicMetrics ( TComPic* pcPic, AccessUnit& accessUnit, Double dEncTime );
+  Void  xReportPicMetrics ( Bool bWait );
+  Void  xNalUnitEncoded   ( TComPic* pcPic, AccessUnit& accessUnit );
+  Void  xAddPSNR          ( TEncPicMetrics* pcMetrics, std::string& rcLine );
+  Void  xWritePicStats    ( TComSlice* pcSlice, UInt uiBits );
+  Void  xReleaseUnusedPicData ( TComList<TComPic*>& rcListPic );
+  Void  xWriteLayerStats  ();
   
   UInt64 xFindDistortionFrame (TComPicYuv* pcPic0, TComPicYuv* pcPic1);
 
@@ -0,0 +1,476 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.  
+ *
+ * Copyright (c) 2010-2012, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** \file     TEncLookahead.cpp
+    \brief    rate control lookahead class
+*/
+
+#include <math.h>
+#include <string.h>
+#include "TEncLookahead.h"
+
+//! \ingroup TLibEncoder
+//! \{
+
+#define LOOKAHEAD_BLK       8       ///< block size in half resolution samples
+#define LOOKAHEAD_RANGE     16      ///< motion search range in half resolution samples
+#define LOOKAHEAD_BLK_COST  1       ///< cost per 8-bit sample of coding a block apart from its residual
+
+// ====================================================================================================================
+// Constructor / destructor / create / destroy
+// ====================================================================================================================
+
+TEncLookahead::TEncLookahead()
+: m_iWidth      ( 0 )
+, m_iHeight     ( 0 )
+, m_iBlocksX    ( 0 )
+, m_iBlocksY    ( 0 )
+, m_iLCUBlocks  ( 1 )
+, m_iLCUsX      ( 0 )
+, m_iLCUsY      ( 0 )
+, m_iMaxPics    ( 0 )
+, m_bHasPrev    ( false )
+, m_pdPropagate ( NULL )
+{
+  m_apPlane[0] = NULL;
+  m_apPlane[1] = NULL;
+}
+
+TEncLookahead::~TEncLookahead()
+{
+}
+
+/** Allocate the analysis buffers
+ * \param iWidth source picture width
+ * \param iHeight source picture height
+ * \param uiMaxCUWidth LCU size
+ * \param iMaxPics number of pictures whose estimates are kept
+ */
+Void TEncLookahead::create( Int iWidth, Int iHeight, UInt uiMaxCUWidth, Int iMaxPics )
+{
+  m_iWidth     = iWidth  >> 1;
+  m_iHeight    = iHeight >> 1;
+  m_iBlocksX   = ( m_iWidth  + LOOKAHEAD_BLK - 1 ) / LOOKAHEAD_BLK;
+  m_iBlocksY   = ( m_iHeight + LOOKAHEAD_BLK - 1 ) / LOOKAHEAD_BLK;
+  m_iLCUBlocks = max( 1, Int( uiMaxCUWidth ) / ( 2 * LOOKAHEAD_BLK ) );
+  m_iLCUsX     = ( iWidth  + uiMaxCUWidth - 1 ) / uiMaxCUWidth;
+  m_iLCUsY     = ( iHeight + uiMaxCUWidth - 1 ) / uiMaxCUWidth;
+  m_iMaxPics   = iMaxPics;
+  m_bHasPrev   = false;
+  
+  m_apPlane[0]  = new Pel[ m_iWidth * m_iHeight ];
+  m_apPlane[1]  = new Pel[ m_iWidth * m_iHeight ];
+  m_pdPropagate = new Double[ m_iMaxPics * m_iBlocksX * m_iBlocksY ];
+}
+
+Void TEncLookahead::destroy()
+{
+  while ( !m_cPics.empty() )
+  {
+    TEncLookaheadPic* pcPic = m_cPics.front();
+    delete[] pcPic->m_piIntraCost;
+    delete[] pcPic->m_piInterCost;
+    delete[] pcPic->m_psMv;
+    delete pcPic;
+    m_cPics.pop_front();
+  }
+  delete[] m_apPlane[0];   m_apPlane[0]  = NULL;
+  delete[] m_apPlane[1];   m_apPlane[1]  = NULL;
+  delete[] m_pdPropagate;  m_pdPropagate = NULL;
+}
+
+// ====================================================================================================================
+// Public member functions
+// ====================================================================================================================
+
+/** Estimate the costs of a received source picture
+ * \param pcPic picture holding the POC and the half resolution luma of the source analysis
+ *
+ * Pictures have to be added in input order, the inter cost is measured against the previously added picture.
+ */
+Void TEncLookahead::addPicture( TEncPic* pcPic )
+{
+  ::memcpy( m_apPlane[0], pcPic->getAnalysis()->getHalfLuma(), sizeof(Pel) * m_iWidth * m_iHeight );
+  
+  Int iNumBlocks = m_iBlocksX * m_iBlocksY;
+  Int iBlkCost   = ( LOOKAHEAD_BLK * LOOKAHEAD_BLK * LOOKAHEAD_BLK_COST ) << ( g_uiBitDepth + g_uiBitIncrement - 8 );
+  TEncLookaheadPic* pcLAPic = new TEncLookaheadPic;
+  pcLAPic->m_iPOC        = pcPic->getPOC();
+  pcLAPic->m_piIntraCost = new Int  [ iNumBlocks ];
+  pcLAPic->m_piInterCost = new Int  [ iNumBlocks ];
+  pcLAPic->m_psMv        = new Short[ 2 * iNumBlocks ];
+  pcLAPic->m_dIntraCost  = 0;
+  pcLAPic->m_dCost       = 0;
+  
+  for ( Int iBlkY = 0, iBlk = 0; iBlkY < m_iBlocksY; iBlkY++ )
+  {
+    for ( Int iBlkX = 0; iBlkX < m_iBlocksX; iBlkX++, iBlk++ )
+    {
+      Int iIntra = xIntraCost( iBlkX, iBlkY );
+      Int iInter = iIntra;
+      Short* psMv = pcLAPic->m_psMv + 2 * iBlk;
+      psMv[0] = psMv[1] = 0;
+      if ( m_bHasPrev )
+      {
+        iInter = xInterCost( iBlkX, iBlkY, psMv, iBlkX > 0 ? psMv - 2 : NULL, iBlkY > 0 ? psMv - 2 * m_iBlocksX : NULL );
+      }
+      iIntra += iBlkCost;
+      iInter += iBlkCost;
+      pcLAPic->m_piIntraCost[iBlk] = iIntra;
+      pcLAPic->m_piInterCost[iBlk] = iInter;
+      pcLAPic->m_dIntraCost += iIntra;
+      pcLAPic->m_dCost      += min( iIntra, iInter );
+    }
+  }
+  
+  if ( !m_bHasPrev )
+  {
+    pcLAPic->m_dCost = 0;
+  }
+  m_cPics.push_back( pcLAPic );
+  if ( Int( m_cPics.size() ) > m_iMaxPics )
+  {
+    TEncLookaheadPic* pcOld = m_cPics.front();
+    delete[] pcOld->m_piIntraCost;
+    delete[] pcOld->m_piInterCost;
+    delete[] pcOld->m_psMv;
+    delete pcOld;
+    m_cPics.pop_front();
+  }
+  
+  std::swap( m_apPlane[0], m_apPlane[1] );
+  m_bHasPrev = true;
+}
+
+/** Get the estimated cost of a picture
+ * \param iPOC POC of the picture
+ * \param bIntra intra cost instead of the cost of the best of intra and inter prediction
+ * \returns estimated cost, 0 if the picture is not in the lookahead or has no inter cost as the first picture
+ */
+Double TEncLookahead::getCost( Int iPOC, Bool bIntra )
+{
+  TEncLookaheadPic* pcPic = xGetPic( iPOC );
+  if ( !pcPic )
+  {
+    return 0;
+  }
+  return bIntra ? pcPic->m_dIntraCost : pcPic->m_dCost;
+}
+
+/** Compute the QP offsets of a picture from the cost propagated back from the pictures after it
+ * \param iPOC POC of the picture
+ * \param dStrength QP offset per doubling of the cost including the propagated cost
+ * \param piLCUOffsets receives the QP offset of each LCU relative to the picture, in raster order
+ * \returns QP offset of the picture relative to the average picture of the lookahead window
+ */
+Double TEncLookahead::getQPOffsets( Int iPOC, Double dStrength, Int* piLCUOffsets )
+{
+  Int iNumLCUs = m_iLCUsX * m_iLCUsY;
+  for ( Int i = 0; i < iNumLCUs; i++ )
+  {
+    piLCUOffsets[i] = 0;
+  }
+  
+  Int iFirst = 0;
+  while ( iFirst < Int( m_cPics.size() ) && m_cPics[iFirst]->m_iPOC != iPOC )
+  {
+    iFirst++;
+  }
+  Int iNumPics = Int( m_cPics.size() ) - iFirst;
+  if ( iNumPics < 2 )
+  {
+    return 0;
+  }
+  
+  // propagate the inherited part of the cost of each picture to the blocks of the previous picture it predicts from
+  Int iNumBlocks = m_iBlocksX * m_iBlocksY;
+  memset( m_pdPropagate, 0, sizeof( Double ) * iNumPics * iNumBlocks );
+  for ( Int t = iNumPics - 1; t > 0; t-- )
+  {
+    TEncLookaheadPic* pcPic  = m_cPics[iFirst + t];
+    Double*           pdProp = m_pdPropagate + t * iNumBlocks;
+    Double*           pdDst  = m_pdPropagate + ( t - 1 ) * iNumBlocks;
+    
+    for ( Int iBlkY = 0, iBlk = 0; iBlkY < m_iBlocksY; iBlkY++ )
+    {
+      for ( Int iBlkX = 0; iBlkX < m_iBlocksX; iBlkX++, iBlk++ )
+      {
+        Int iIntra = pcPic->m_piIntraCost[iBlk];
+        Int iInter = pcPic->m_piInterCost[iBlk];
+        if ( iInter >= iIntra )
+        {
+          continue;
+        }
+        Double dAmount = ( iIntra + pdProp[iBlk] ) * ( 1.0 - Double( iInter ) / iIntra );
+        
+        // split between the up to four blocks covered by the reference area
+        Int iX  = iBlkX * LOOKAHEAD_BLK + pcPic->m_psMv[2 * iBlk];
+        Int iY  = iBlkY * LOOKAHEAD_BLK + pcPic->m_psMv[2 * iBlk + 1];
+        Int iX0 = iX >= 0 ? iX / LOOKAHEAD_BLK : -1;
+        Int iY0 = iY >= 0 ? iY / LOOKAHEAD_BLK : -1;
+        Int iFX = iX - iX0 * LOOKAHEAD_BLK;
+        Int iFY = iY - iY0 * LOOKAHEAD_BLK;
+        for ( Int j = 0; j < 2; j++ )
+        {
+          Int iRefY = iY0 + j;
+          Int iWY   = j ? iFY : LOOKAHEAD_BLK - iFY;
+          if ( iRefY < 0 || iRefY >= m_iBlocksY || !iWY )
+          {
+            continue;
+          }
+          for ( Int i = 0; i < 2; i++ )
+          {
+            Int iRefX = iX0 + i;
+            Int iWX   = i ? iFX : LOOKAHEAD_BLK - iFX;
+            if ( iRefX < 0 || iRefX >= m_iBlocksX || !iWX )
+            {
+              continue;
+            }
+            pdDst[iRefY * m_iBlocksX + iRefX] += dAmount * iWX * iWY / ( LOOKAHEAD_BLK * LOOKAHEAD_BLK );
+          }
+        }
+      }
+    }
+  }
+  
+  // average offsets of the pictures of the window, the last one has no propagated cost yet
+  Double dWindowOffset = 0;
+  Double dPicOffset    = 0;
+  for ( Int t = 0; t < iNumPics - 1; t++ )
+  {
+    TEncLookaheadPic* pcPic  = m_cPics[iFirst + t];
+    Double*           pdProp = m_pdPropagate + t * iNumBlocks;
+    Double            dSum   = 0;
+    for ( Int iBlk = 0; iBlk < iNumBlocks; iBlk++ )
+    {
+      Int iIntra = max( 1, pcPic->m_piIntraCost[iBlk] );
+      dSum -= dStrength * log( ( iIntra + pdProp[iBlk] ) / iIntra ) / log( 2.0 );
+    }
+    dWindowOffset += dSum / iNumBlocks;
+    if ( t == 0 )
+    {
+      dPicOffset = dSum / iNumBlocks;
+    }
+  }
+  dWindowOffset /= iNumPics - 1;
+  
+  // LCU offsets relative to the picture
+  TEncLookaheadPic* pcPic = m_cPics[iFirst];
+  for ( Int iLCUY = 0; iLCUY < m_iLCUsY; iLCUY++ )
+  {
+    for ( Int iLCUX = 0; iLCUX < m_iLCUsX; iLCUX++ )
+    {
+      Double dSum = 0;
+      Int    iNum = 0;
+      for ( Int iBlkY = iLCUY * m_iLCUBlocks; iBlkY < min( m_iBlocksY, ( iLCUY + 1 ) * m_iLCUBlocks ); iBlkY++ )
+      {
+        for ( Int iBlkX = iLCUX * m_iLCUBlocks; iBlkX < min( m_iBlocksX, ( iLCUX + 1 ) * m_iLCUBlocks ); iBlkX++, iNum++ )
+        {
+          Int iBlk   = iBlkY * m_iBlocksX + iBlkX;
+          Int iIntra = max( 1, pcPic->m_piIntraCost[iBlk] );
+          dSum -= dStrength * log( ( iIntra + m_pdPropagate[iBlk] ) / iIntra ) / log( 2.0 );
+        }
+      }
+      if ( iNum )
+      {
+        Double dOffset = dSum / iNum - dPicOffset;
+        piLCUOffsets[iLCUY * m_iLCUsX + iLCUX] = Int( floor( dOffset + 0.5 ) );
+      }
+    }
+  }
+  
+  return dPicOffset - dWindowOffset;
+}
+
+// ====================================================================================================================
+// Private member functions
+// ====================================================================================================================
+
+TEncLookaheadPic* TEncLookahead::xGetPic( Int iPOC )
+{
+  for ( std::deque<TEncLookaheadPic*>::iterator it = m_cPics.begin(); it != m_cPics.end(); it++ )
+  {
+    if ( (*it)->m_iPOC == iPOC )
+    {
+      return *it;
+    }
+  }
+  return NULL;
+}
+
+/** Smallest SAD of the DC, vertical and horizontal prediction from the neighbouring source samples
+ */
+Int TEncLookahead::xIntraCost( Int iBlkX, Int iBlkY )
+{
+  Int  iX0   = iBlkX * LOOKAHEAD_BLK;
+  Int  iY0   = iBlkY * LOOKAHEAD_BLK;
+  Int  iW    = min( LOOKAHEAD_BLK, m_iWidth  - iX0 );
+  Int  iH    = min( LOOKAHEAD_BLK, m_iHeight - iY0 );
+  Pel* pCur  = m_apPlane[0] + iY0 * m_iWidth + iX0;
+  Pel* pTop  = iY0 > 0 ? pCur - m_iWidth : NULL;
+  Pel* pLeft = iX0 > 0 ? pCur - 1        : NULL;
+  
+  Int iDC  = 0;
+  Int iNum = 0;
+  if ( pTop )
+  {
+    for ( Int x = 0; x < iW; x++ )
+    {
+      iDC += pTop[x];
+    }
+    iNum += iW;
+  }
+  if ( pLeft )
+  {
+    for ( Int y = 0; y < iH; y++ )
+    {
+      iDC += pLeft[y * m_iWidth];
+    }
+    iNum += iH;
+  }
+  iDC = iNum ? ( iDC + ( iNum >> 1 ) ) / iNum : 1 << ( g_uiBitDepth + g_uiBitIncrement - 1 );
+  
+  Int iCostDC = 0, iCostVer = 0, iCostHor = 0;
+  for ( Int y = 0; y < iH; y++ )
+  {
+    Pel* p = pCur + y * m_iWidth;
+    for ( Int x = 0; x < iW; x++ )
+    {
+      iCostDC += abs( p[x] - iDC );
+      if ( pTop )
+      {
+        iCostVer += abs( p[x] - pTop[x] );
+      }
+      if ( pLeft )
+      {
+        iCostHor += abs( p[x] - pLeft[y * m_iWidth] );
+      }
+    }
+  }
+  
+  Int iCost = iCostDC;
+  if ( pTop )
+  {
+    iCost = min( iCost, iCostVer );
+  }
+  if ( pLeft )
+  {
+    iCost = min( iCost, iCostHor );
+  }
+  return iCost;
+}
+
+/** SAD of a block against the previous picture, stopping early once iBestSAD is exceeded
+ */
+Int TEncLookahead::xSAD( Int iX0, Int iY0, Int iMvX, Int iMvY, Int iBestSAD )
+{
+  Int  iW   = min( LOOKAHEAD_BLK, m_iWidth  - iX0 );
+  Int  iH   = min( LOOKAHEAD_BLK, m_iHeight - iY0 );
+  Pel* pCur = m_apPlane[0] + iY0 * m_iWidth + iX0;
+  Pel* pRef = m_apPlane[1] + ( iY0 + iMvY ) * m_iWidth + iX0 + iMvX;
+  Int  iSAD = 0;
+  for ( Int y = 0; y < iH && iSAD < iBestSAD; y++ )
+  {
+    for ( Int x = 0; x < iW; x++ )
+    {
+      iSAD += abs( pCur[x] - pRef[x] );
+    }
+    pCur += m_iWidth;
+    pRef += m_iWidth;
+  }
+  return iSAD;
+}
+
+/** Motion search of a block in the previous picture: best of the zero, left and top vector refined by a diamond search
+ */
+Int TEncLookahead::xInterCost( Int iBlkX, Int iBlkY, Short* psMv, Short* psMvLeft, Short* psMvTop )
+{
+  Int iX0   = iBlkX * LOOKAHEAD_BLK;
+  Int iY0   = iBlkY * LOOKAHEAD_BLK;
+  Int iMinX = max( -LOOKAHEAD_RANGE, -iX0 );
+  Int iMaxX = min(  LOOKAHEAD_RANGE, m_iWidth  - min( LOOKAHEAD_BLK, m_iWidth  - iX0 ) - iX0 );
+  Int iMinY = max( -LOOKAHEAD_RANGE, -iY0 );
+  Int iMaxY = min(  LOOKAHEAD_RANGE, m_iHeight - min( LOOKAHEAD_BLK, m_iHeight - iY0 ) - iY0 );
+  
+  Int iBestX = 0, iBestY = 0;
+  Int iBest  = xSAD( iX0, iY0, 0, 0, MAX_INT );
+  Short* apsCand[2] = { psMvLeft, psMvTop };
+  for ( Int i = 0; i < 2; i++ )
+  {
+    if ( !apsCand[i] )
+    {
+      continue;
+    }
+    Int iMvX = Clip3( iMinX, iMaxX, Int( apsCand[i][0] ) );
+    Int iMvY = Clip3( iMinY, iMaxY, Int( apsCand[i][1] ) );
+    Int iSAD = xSAD( iX0, iY0, iMvX, iMvY, iBest );
+    if ( iSAD < iBest )
+    {
+      iBest  = iSAD;
+      iBestX = iMvX;
+      iBestY = iMvY;
+    }
+  }
+  
+  static const Int aiDiamond[4][2] = { { -1, 0 }, { 1, 0 }, { 0, -1 }, { 0, 1 } };
+  for ( Int iIter = 0; iIter < LOOKAHEAD_RANGE; iIter++ )
+  {
+    Int iCentreX = iBestX, iCentreY = iBestY;
+    for ( Int i = 0; i < 4; i++ )
+    {
+      Int iMvX = iCentreX + aiDiamond[i][0];
+      Int iMvY = iCentreY + aiDiamond[i][1];
+      if ( iMvX < iMinX || iMvX > iMaxX || iMvY < iMinY || iMvY > iMaxY )
+      {
+        continue;
+      }
+      Int iSAD = xSAD( iX0, iY0, iMvX, iMvY, iBest );
+      if ( iSAD < iBest )
+      {
+        iBest  = iSAD;
+        iBestX = iMvX;
+        iBestY = iMvY;
+      }
+    }
+    if ( iBestX == iCentreX && iBestY == iCentreY )
+    {
+      break;
+    }
+  }
+  
+  psMv[0] = Short( iBestX );
+  psMv[1] = Short( iBestY );
+  return iBest;
+}
+
+//! \}
@@ -0,0 +1,104 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.  
+ *
+ * Copyright (c) 2010-2012, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** \file     TEncLookahead.h
+    \brief    rate control lookahead class (header)
+*/
+
+#ifndef __TENCLOOKAHEAD__
+#define __TENCLOOKAHEAD__
+
+#include <deque>
+#include "TLibCommon/CommonDef.h"
+#include "TEncPic.h"
+
+//! \ingroup TLibEncoder
+//! \{
+
+// ====================================================================================================================
+// Class definition
+// ====================================================================================================================
+
+/// cost estimates of one source picture, on 8x8 blocks of the half resolution luma
+class TEncLookaheadPic
+{
+public:
+  Int     m_iPOC;
+  Int*    m_piIntraCost;                  ///< intra cost of each block
+  Int*    m_piInterCost;                  ///< cost of the best match in the previous picture, the intra cost if none
+  Short*  m_psMv;                         ///< x and y motion vector of each block in half resolution samples
+  Double  m_dIntraCost;                   ///< sum of the intra costs
+  Double  m_dCost;                        ///< sum of the smaller of intra and inter cost, 0 for the first picture
+};
+
+/// estimates the coding cost of the source pictures ahead of the encoder for the rate control
+/** Pictures are analyzed as they are received: intra and inter costs are estimated on the 2:1 downscaled luma, the
+ *  inter cost against the previous source picture. The QP offsets propagate the part of the cost that later pictures
+ *  inherit back to the pictures they reference, so that pictures that are referenced a lot get a lower QP.
+ */
+class TEncLookahead
+{
+private:
+  Int                             m_iWidth;             ///< width of the half resolution luma
+  Int                             m_iHeight;            ///< height of the half resolution luma
+  Int                             m_iBlocksX;           ///< number of blocks per row
+  Int                             m_iBlocksY;           ///< number of block rows
+  Int                             m_iLCUBlocks;         ///< blocks per LCU side
+  Int                             m_iLCUsX;             ///< number of LCUs per row
+  Int                             m_iLCUsY;             ///< number of LCU rows
+  Int                             m_iMaxPics;           ///< number of pictures kept
+  Pel*                            m_apPlane[2];         ///< half resolution luma of the current and the previous picture
+  Bool                            m_bHasPrev;           ///< m_apPlane[1] holds the previous picture
+  std::deque<TEncLookaheadPic*>   m_cPics;              ///< analyzed pictures in input order
+  Double*                         m_pdPropagate;        ///< propagated cost per block and picture of the window
+  
+  TEncLookaheadPic* xGetPic       ( Int iPOC );
+  Int   xIntraCost                ( Int iBlkX, Int iBlkY );
+  Int   xSAD                      ( Int iX0, Int iY0, Int iMvX, Int iMvY, Int iBestSAD );
+  Int   xInterCost                ( Int iBlkX, Int iBlkY, Short* psMv, Short* psMvLeft, Short* psMvTop );
+
+public:
+  TEncLookahead();
+  virtual ~TEncLookahead();
+  
+  Void    create                  ( Int iWidth, Int iHeight, UInt uiMaxCUWidth, Int iMaxPics );
+  Void    destroy                 ();
+  
+  Void    addPicture              ( TEncPic* pcPic );
+  Double  getCost                 ( Int iPOC, Bool bIntra );
+  Double  getQPOffsets            ( Int iPOC, Double dStrength, Int* piLCUOffsets );
+};
+
+//! \}
+
+#endif // __TENCLOOKAHEAD__
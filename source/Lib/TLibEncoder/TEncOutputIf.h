@@ -0,0 +1,80 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.  
+ *
+ * Copyright (c) 2010-2012, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** \file     TEncOutputIf.h
+    \brief    output interface of the low-latency push encoder
+*/
+
+#ifndef __TENCOUTPUTIF__
+#define __TENCOUTPUTIF__
+
+#include "TLibCommon/CommonDef.h"
+#include "TLibCommon/TComPicYuv.h"
+#include "TLibCommon/AccessUnit.h"
+#include "TLibCommon/NAL.h"
+
+//! \ingroup TLibEncoder
+//! \{
+
+// ====================================================================================================================
+// Class definition
+// ====================================================================================================================
+
+/// receives the coded data of the push interface of TEncTop as soon as it is available
+/** Access units are delivered in coding order, each one as soon as its picture has been coded (and, with the
+ *  picture digest enabled, its digest SEI has been inserted). No intermediate copies of the coded data are made:
+ *  the encoder hands out the NAL units it produced and the listener decides what to keep.
+ */
+class TEncOutputIf
+{
+public:
+  /// one NAL unit of picture iPOC has been written
+  /** Called right after each parameter set and slice NAL unit is produced when the picture digest SEI is
+   *  disabled, otherwise for all NAL units of the access unit in bitstream order just before accessUnitEncoded().
+   *  The NAL unit stays owned by the encoder and is only valid during the call.
+   */
+  virtual Void  nalUnitEncoded    ( Int iPOC, const NALUnitEBSP& rcNalu )                                 {}
+
+  /// access unit of picture iPOC is complete
+  /** The listener may take ownership of NAL units by removing them from rcAccessUnit (e.g. with splice()), the
+   *  NAL units left in it are deleted by the encoder after the call. pcPicYuvRec is the reconstruction inside the
+   *  encoder and is only valid during the call.
+   */
+  virtual Void  accessUnitEncoded ( Int iPOC, AccessUnit& rcAccessUnit, TComPicYuv* pcPicYuvRec )          = 0;
+
+  virtual ~TEncOutputIf() {}
+};
+
+//! \}
+
+#endif // __TENCOUTPUTIF__
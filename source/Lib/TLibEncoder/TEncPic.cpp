@@ -100,6 +100,171 @@ Void TEncPicQPAdaptationLayer::destroy()
   }
 }
 
+/** Copy the activities of a layer of the same geometry
+ * \param pcSrc layer of another picture holding the same source
+ * \return Void
+ */
+Void TEncPicQPAdaptationLayer::copyFrom( TEncPicQPAdaptationLayer* pcSrc )
+{
+  assert( pcSrc->m_uiNumAQPartInWidth == m_uiNumAQPartInWidth && pcSrc->m_uiNumAQPartInHeight == m_uiNumAQPartInHeight );
+  for ( UInt i = 0; i < m_uiNumAQPartInWidth * m_uiNumAQPartInHeight; i++ )
+  {
+    m_acTEncAQU[i] = pcSrc->m_acTEncAQU[i];
+  }
+  m_dAvgActivity = pcSrc->m_dAvgActivity;
+}
+
+/** Constructor
+ */
+TEncPicAnalysis::TEncPicAnalysis()
+: m_iWidth(0)
+, m_iHeight(0)
+, m_iNumBlkInWidth(0)
+, m_iNumBlkInHeight(0)
+, m_puiBlkSum(NULL)
+, m_puiBlkSumSq(NULL)
+, m_iNumBins(0)
+, m_pHalfLuma(NULL)
+, m_bValid(false)
+{
+  m_apuiHist[0] = m_apuiHist[1] = m_apuiHist[2] = NULL;
+}
+
+/** Destructor
+ */
+TEncPicAnalysis::~TEncPicAnalysis()
+{
+  destroy();
+}
+
+/** Allocate the statistics buffers
+ * \param iWidth Picture width
+ * \param iHeight Picture height
+ * \param bHalfLuma Keep a half resolution copy of the luma plane
+ * \return Void
+ */
+Void TEncPicAnalysis::create( Int iWidth, Int iHeight, Bool bHalfLuma )
+{
+  m_iWidth          = iWidth;
+  m_iHeight         = iHeight;
+  m_iNumBlkInWidth  = ( iWidth  + 3 ) >> 2;
+  m_iNumBlkInHeight = ( iHeight + 3 ) >> 2;
+  m_puiBlkSum       = new UInt[ m_iNumBlkInWidth * m_iNumBlkInHeight ];
+  m_puiBlkSumSq     = new UInt[ m_iNumBlkInWidth * m_iNumBlkInHeight ];
+  m_iNumBins        = 1 << ( g_uiBitDepth + g_uiBitIncrement );
+  for ( Int iComp = 0; iComp < 3; iComp++ )
+  {
+    m_apuiHist[iComp] = new UInt[ m_iNumBins ];
+  }
+  m_pHalfLuma       = bHalfLuma ? new Pel[ ( iWidth >> 1 ) * ( iHeight >> 1 ) ] : NULL;
+  m_bValid          = false;
+}
+
+/** Clean up
+ * \return Void
+ */
+Void TEncPicAnalysis::destroy()
+{
+  delete[] m_puiBlkSum;    m_puiBlkSum   = NULL;
+  delete[] m_puiBlkSumSq;  m_puiBlkSumSq = NULL;
+  for ( Int iComp = 0; iComp < 3; iComp++ )
+  {
+    delete[] m_apuiHist[iComp];
+    m_apuiHist[iComp] = NULL;
+  }
+  delete[] m_pHalfLuma;    m_pHalfLuma   = NULL;
+  m_bValid = false;
+}
+
+/** Aggregate the 4x4 block statistics of a luma area
+ * \param iX, iY top-left position of the area, a multiple of 4
+ * \param iWidth, iHeight size of the area, a multiple of 4 unless it ends at the picture boundary
+ * \param ruiSum sum of the luma samples
+ * \param ruiSumSq sum of the squared luma samples
+ * \return Void
+ */
+Void TEncPicAnalysis::getBlockSums( Int iX, Int iY, Int iWidth, Int iHeight, UInt64& ruiSum, UInt64& ruiSumSq )
+{
+  assert( ( iX & 3 ) == 0 && ( iY & 3 ) == 0 );
+  assert( ( iWidth  & 3 ) == 0 || iX + iWidth  == m_iWidth  );
+  assert( ( iHeight & 3 ) == 0 || iY + iHeight == m_iHeight );
+  
+  Int iBlkX0 = iX >> 2;
+  Int iBlkX1 = ( iX + iWidth  + 3 ) >> 2;
+  Int iBlkY1 = ( iY + iHeight + 3 ) >> 2;
+  ruiSum   = 0;
+  ruiSumSq = 0;
+  for ( Int iBlkY = iY >> 2; iBlkY < iBlkY1; iBlkY++ )
+  {
+    const UInt* puiSum   = m_puiBlkSum   + iBlkY * m_iNumBlkInWidth;
+    const UInt* puiSumSq = m_puiBlkSumSq + iBlkY * m_iNumBlkInWidth;
+    for ( Int iBlkX = iBlkX0; iBlkX < iBlkX1; iBlkX++ )
+    {
+      ruiSum   += puiSum  [iBlkX];
+      ruiSumSq += puiSumSq[iBlkX];
+    }
+  }
+}
+
+/** Sum of the samples of a plane
+ * \param iComp plane index (0: Y, 1: Cb, 2: Cr)
+ * \return sum of the samples
+ */
+Int64 TEncPicAnalysis::getPlaneSum( Int iComp )
+{
+  const UInt* puiHist = m_apuiHist[iComp];
+  Int64 iSum = 0;
+  for ( Int i = 1; i < m_iNumBins; i++ )
+  {
+    iSum += Int64( i ) * puiHist[i];
+  }
+  return iSum;
+}
+
+/** Sum of the absolute differences between the samples of a plane and a DC value
+ * \param iComp plane index (0: Y, 1: Cb, 2: Cr)
+ * \param iDC DC value
+ * \return sum of absolute differences
+ */
+Int64 TEncPicAnalysis::getPlaneAbsDev( Int iComp, Int64 iDC )
+{
+  const UInt* puiHist = m_apuiHist[iComp];
+  Int64 iAbsDev = 0;
+  for ( Int i = 0; i < m_iNumBins; i++ )
+  {
+    iAbsDev += ( i > iDC ? i - iDC : iDC - i ) * puiHist[i];
+  }
+  return iAbsDev;
+}
+
+/** Copy the statistics gathered on another picture holding the same source
+ * \param pcSrc valid statistics of the same size
+ * \returns false if pcSrc lacks a buffer of this analysis, which is then left invalid
+ */
+Bool TEncPicAnalysis::copyFrom( TEncPicAnalysis* pcSrc )
+{
+  assert( pcSrc->m_iWidth == m_iWidth && pcSrc->m_iHeight == m_iHeight && pcSrc->m_iNumBins == m_iNumBins );
+  m_bValid = false;
+  if ( !pcSrc->m_bValid || ( m_pHalfLuma && !pcSrc->m_pHalfLuma ) )
+  {
+    return false;
+  }
+  
+  const Int iNumBlk = m_iNumBlkInWidth * m_iNumBlkInHeight;
+  ::memcpy( m_puiBlkSum,   pcSrc->m_puiBlkSum,   sizeof(UInt) * iNumBlk );
+  ::memcpy( m_puiBlkSumSq, pcSrc->m_puiBlkSumSq, sizeof(UInt) * iNumBlk );
+  for ( Int iComp = 0; iComp < 3; iComp++ )
+  {
+    ::memcpy( m_apuiHist[iComp], pcSrc->m_apuiHist[iComp], sizeof(UInt) * m_iNumBins );
+  }
+  if ( m_pHalfLuma )
+  {
+    ::memcpy( m_pHalfLuma, pcSrc->m_pHalfLuma, sizeof(Pel) * getHalfWidth() * getHalfHeight() );
+  }
+  m_bValid = true;
+  return true;
+}
+
 /** Constructor
  */
 TEncPic::TEncPic()
@@ -149,7 +314,33 @@ Void TEncPic::destroy()
     delete[] m_acAQLayer;
     m_acAQLayer = NULL;
   }
+  m_cAnalysis.destroy();
   TComPic::destroy();
 }
+
+/** Take over the source analysis of another picture holding the same source, instead of analyzing it again
+ * \param pcSrc picture analyzed by an encoder of the same configuration
+ * \param bAQ copy the QP adaptation layers as well
+ * \returns false if the analysis of pcSrc does not cover this picture
+ */
+Bool TEncPic::copyAnalysisFrom( TEncPic* pcSrc, Bool bAQ )
+{
+  if ( !m_cAnalysis.copyFrom( pcSrc->getAnalysis() ) )
+  {
+    return false;
+  }
+  if ( bAQ )
+  {
+    if ( pcSrc->getMaxAQDepth() != m_uiMaxAQDepth )
+    {
+      return false;
+    }
+    for ( UInt d = 0; d < m_uiMaxAQDepth; d++ )
+    {
+      m_acAQLayer[d].copyFrom( pcSrc->getAQLayer( d ) );
+    }
+  }
+  return true;
+}
 //! \}
 
@@ -89,6 +89,50 @@ public:
   Double                 getAvgActivity()        { return m_dAvgActivity;        }
 
   Void                   setAvgActivity( Double d )  { m_dAvgActivity = d; }
+
+  Void                   copyFrom( TEncPicQPAdaptationLayer* pcSrc );
+};
+
+/// Source picture statistics gathered in a single pass at receipt and shared by the encoder modules
+class TEncPicAnalysis
+{
+private:
+  Int     m_iWidth;
+  Int     m_iHeight;
+  Int     m_iNumBlkInWidth;     ///< number of 4x4 luma blocks in a row
+  Int     m_iNumBlkInHeight;
+  UInt*   m_puiBlkSum;          ///< sum of the luma samples of each 4x4 block
+  UInt*   m_puiBlkSumSq;        ///< sum of the squared luma samples of each 4x4 block
+  Int     m_iNumBins;
+  UInt*   m_apuiHist[3];        ///< sample value histogram of each plane
+  Pel*    m_pHalfLuma;          ///< luma downscaled by 2x2 averaging, NULL if not requested
+  Bool    m_bValid;             ///< the statistics belong to the current source picture
+
+public:
+  TEncPicAnalysis();
+  virtual ~TEncPicAnalysis();
+
+  Void    create( Int iWidth, Int iHeight, Bool bHalfLuma );
+  Void    destroy();
+
+  Int     getNumBlkInWidth()          { return m_iNumBlkInWidth;  }
+  Int     getNumBlkInHeight()         { return m_iNumBlkInHeight; }
+  UInt*   getBlkSum()                 { return m_puiBlkSum;       }
+  UInt*   getBlkSumSq()               { return m_puiBlkSumSq;     }
+  Int     getNumBins()                { return m_iNumBins;        }
+  UInt*   getHist( Int iComp )        { return m_apuiHist[iComp]; }
+  Pel*    getHalfLuma()               { return m_pHalfLuma;       }
+  Int     getHalfWidth()              { return m_iWidth  >> 1;    }
+  Int     getHalfHeight()             { return m_iHeight >> 1;    }
+  Bool    isValid()                   { return m_bValid;          }
+  Void    setValid( Bool b )          { m_bValid = b;             }
+
+  Void    getBlockSums  ( Int iX, Int iY, Int iWidth, Int iHeight, UInt64& ruiSum, UInt64& ruiSumSq );
+  Int     getNumSamples ( Int iComp ) { return iComp == 0 ? m_iWidth * m_iHeight : ( m_iWidth >> 1 ) * ( m_iHeight >> 1 ); }
+  Int64   getPlaneSum   ( Int iComp );
+  Int64   getPlaneAbsDev( Int iComp, Int64 iDC );
+
+  Bool    copyFrom      ( TEncPicAnalysis* pcSrc );
 };
 
 /// Picture class including local image characteristics information for QP adaptation
@@ -97,6 +141,7 @@ class TEncPic : public TComPic
 private:
   TEncPicQPAdaptationLayer* m_acAQLayer;
   UInt                      m_uiMaxAQDepth;
+  TEncPicAnalysis           m_cAnalysis;
 
 public:
   TEncPic();
@@ -107,6 +152,9 @@ public:
 
   TEncPicQPAdaptationLayer* getAQLayer( UInt uiDepth )  { return &m_acAQLayer[uiDepth]; }
   UInt                      getMaxAQDepth()             { return m_uiMaxAQDepth;        }
+  TEncPicAnalysis*          getAnalysis()               { return &m_cAnalysis;          }
+
+  Bool                      copyAnalysisFrom( TEncPic* pcSrc, Bool bAQ );
 };
 
 //! \}
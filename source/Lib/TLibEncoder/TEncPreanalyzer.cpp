@@ -40,6 +40,10 @@
 
 #include "TEncPreanalyzer.h"
 
+#if HAS_SSE2
+#include <emmintrin.h>
+#endif
+
 using namespace std;
 
 //! \ingroup TLibEncoder
@@ -57,20 +61,37 @@ TEncPreanalyzer::~TEncPreanalyzer()
 {
 }
 
-/** Analyze source picture and compute local image characteristics used for QP adaptation
+/** Gather the statistics of a source picture shared by the encoder modules
  * \param pcEPic Picture object to be analyzed
  * \return Void
+ *
+ * The luma plane is read once, in stripes of four lines: the 4x4 block sums and sums of squares, the
+ * histogram and the optional half resolution plane are produced while a stripe is in cache. The
+ * adaptive QP, the weighted prediction estimation and the rate control lookahead work on the results.
+ */
+Void TEncPreanalyzer::xAnalyze( TEncPic* pcEPic )
+{
+  TComPicYuv*      pcPicYuv   = pcEPic->getPicYuvOrg();
+  TEncPicAnalysis* pcAnalysis = pcEPic->getAnalysis();
+
+  xAnalyzeLuma( pcPicYuv, pcAnalysis );
+  xAnalyzeChroma( pcPicYuv->getCbAddr(), pcPicYuv->getCStride(), pcPicYuv->getWidth() >> 1, pcPicYuv->getHeight() >> 1, pcAnalysis->getHist(1) );
+  xAnalyzeChroma( pcPicYuv->getCrAddr(), pcPicYuv->getCStride(), pcPicYuv->getWidth() >> 1, pcPicYuv->getHeight() >> 1, pcAnalysis->getHist(2) );
+  pcAnalysis->setValid( true );
+}
+
+/** Compute local image characteristics used for QP adaptation from the 4x4 block statistics
+ * \param pcEPic Picture object analyzed by xAnalyze()
+ * \return Void
  */
 Void TEncPreanalyzer::xPreanalyze( TEncPic* pcEPic )
 {
-  TComPicYuv* pcPicYuv = pcEPic->getPicYuvOrg();
-  const Int iWidth = pcPicYuv->getWidth();
-  const Int iHeight = pcPicYuv->getHeight();
-  const Int iStride = pcPicYuv->getStride();
+  TEncPicAnalysis* pcAnalysis = pcEPic->getAnalysis();
+  const Int iWidth = pcEPic->getPicYuvOrg()->getWidth();
+  const Int iHeight = pcEPic->getPicYuvOrg()->getHeight();
 
   for ( UInt d = 0; d < pcEPic->getMaxAQDepth(); d++ )
   {
-    const Pel* pLineY = pcPicYuv->getLumaAddr();
     TEncPicQPAdaptationLayer* pcAQLayer = pcEPic->getAQLayer(d);
     const UInt uiAQPartWidth = pcAQLayer->getAQPartWidth();
     const UInt uiAQPartHeight = pcAQLayer->getAQPartHeight();
@@ -80,45 +101,20 @@ Void TEncPreanalyzer::xPreanalyze( TEncPic* pcEPic )
     for ( UInt y = 0; y < iHeight; y += uiAQPartHeight )
     {
       const UInt uiCurrAQPartHeight = min(uiAQPartHeight, iHeight-y);
+      const UInt uiHalfHeight = uiCurrAQPartHeight>>1;
       for ( UInt x = 0; x < iWidth; x += uiAQPartWidth, pcAQU++ )
       {
         const UInt uiCurrAQPartWidth = min(uiAQPartWidth, iWidth-x);
-        const Pel* pBlkY = &pLineY[x];
-        UInt64 uiSum[4] = {0, 0, 0, 0};
-        UInt64 uiSumSq[4] = {0, 0, 0, 0};
-        UInt uiNumPixInAQPart = 0;
-        UInt by = 0;
-        for ( ; by < uiCurrAQPartHeight>>1; by++ )
-        {
-          UInt bx = 0;
-          for ( ; bx < uiCurrAQPartWidth>>1; bx++, uiNumPixInAQPart++ )
-          {
-            uiSum  [0] += pBlkY[bx];
-            uiSumSq[0] += pBlkY[bx] * pBlkY[bx];
-          }
-          for ( ; bx < uiCurrAQPartWidth; bx++, uiNumPixInAQPart++ )
-          {
-            uiSum  [1] += pBlkY[bx];
-            uiSumSq[1] += pBlkY[bx] * pBlkY[bx];
-          }
-          pBlkY += iStride;
-        }
-        for ( ; by < uiCurrAQPartHeight; by++ )
-        {
-          UInt bx = 0;
-          for ( ; bx < uiCurrAQPartWidth>>1; bx++, uiNumPixInAQPart++ )
-          {
-            uiSum  [2] += pBlkY[bx];
-            uiSumSq[2] += pBlkY[bx] * pBlkY[bx];
-          }
-          for ( ; bx < uiCurrAQPartWidth; bx++, uiNumPixInAQPart++ )
-          {
-            uiSum  [3] += pBlkY[bx];
-            uiSumSq[3] += pBlkY[bx] * pBlkY[bx];
-          }
-          pBlkY += iStride;
-        }
+        const UInt uiHalfWidth = uiCurrAQPartWidth>>1;
+        const UInt uiNumPixInAQPart = uiCurrAQPartWidth * uiCurrAQPartHeight;
+        UInt64 uiSum[4];
+        UInt64 uiSumSq[4];
+        pcAnalysis->getBlockSums( x,               y,              uiHalfWidth,                     uiHalfHeight,                      uiSum[0], uiSumSq[0] );
+        pcAnalysis->getBlockSums( x + uiHalfWidth, y,              uiCurrAQPartWidth - uiHalfWidth, uiHalfHeight,                      uiSum[1], uiSumSq[1] );
+        pcAnalysis->getBlockSums( x,               y+uiHalfHeight, uiHalfWidth,                     uiCurrAQPartHeight - uiHalfHeight, uiSum[2], uiSumSq[2] );
+        pcAnalysis->getBlockSums( x + uiHalfWidth, y+uiHalfHeight, uiCurrAQPartWidth - uiHalfWidth, uiCurrAQPartHeight - uiHalfHeight, uiSum[3], uiSumSq[3] );
 
+        // the moments of each quarter are normalized by the sample count of the whole part
         Double dMinVar = DBL_MAX;
         for ( Int i=0; i<4; i++)
         {
@@ -130,12 +126,130 @@ Void TEncPreanalyzer::xPreanalyze( TEncPic* pcEPic )
         pcAQU->setActivity( dActivity );
         dSumAct += dActivity;
       }
-      pLineY += iStride * uiCurrAQPartHeight;
     }
 
     const Double dAvgAct = dSumAct / (pcAQLayer->getNumAQPartInWidth() * pcAQLayer->getNumAQPartInHeight());
     pcAQLayer->setAvgActivity( dAvgAct );
   }
 }
+
+// ====================================================================================================================
+// Private member functions
+// ====================================================================================================================
+
+/** Single pass over the luma plane
+ * \param pcPicYuv source picture
+ * \param pcAnalysis statistics to fill
+ * \return Void
+ */
+Void TEncPreanalyzer::xAnalyzeLuma( TComPicYuv* pcPicYuv, TEncPicAnalysis* pcAnalysis )
+{
+  const Int iWidth  = pcPicYuv->getWidth();
+  const Int iHeight = pcPicYuv->getHeight();
+  const Int iStride = pcPicYuv->getStride();
+  const Int iBlkStride = pcAnalysis->getNumBlkInWidth();
+  UInt* puiHist = pcAnalysis->getHist(0);
+  Pel*  pHalf   = pcAnalysis->getHalfLuma();
+  const Int iHalfWidth  = pcAnalysis->getHalfWidth();
+  const Int iHalfHeight = pcAnalysis->getHalfHeight();
+
+  ::memset( puiHist, 0, sizeof(UInt) * pcAnalysis->getNumBins() );
+
+  const Pel* pLine = pcPicYuv->getLumaAddr();
+  for ( Int y = 0, iBlkY = 0; y < iHeight; y += 4, iBlkY++, pLine += 4 * iStride )
+  {
+    const Int iRows = min( 4, iHeight - y );
+    UInt* puiSum   = pcAnalysis->getBlkSum()   + iBlkY * iBlkStride;
+    UInt* puiSumSq = pcAnalysis->getBlkSumSq() + iBlkY * iBlkStride;
+
+    // 4x4 block moments
+    Int x = 0;
+#if HAS_SSE2
+    if ( iRows == 4 )
+    {
+      const __m128i vOne = _mm_set1_epi16( 1 );
+      for ( ; x + 8 <= iWidth; x += 8 )
+      {
+        __m128i r0 = _mm_loadu_si128( (const __m128i*)( pLine + x ) );
+        __m128i r1 = _mm_loadu_si128( (const __m128i*)( pLine + x +     iStride ) );
+        __m128i r2 = _mm_loadu_si128( (const __m128i*)( pLine + x + 2 * iStride ) );
+        __m128i r3 = _mm_loadu_si128( (const __m128i*)( pLine + x + 3 * iStride ) );
+        __m128i vSum   = _mm_madd_epi16( _mm_add_epi16( _mm_add_epi16( r0, r1 ), _mm_add_epi16( r2, r3 ) ), vOne );
+        __m128i vSumSq = _mm_add_epi32( _mm_add_epi32( _mm_madd_epi16( r0, r0 ), _mm_madd_epi16( r1, r1 ) ),
+                                        _mm_add_epi32( _mm_madd_epi16( r2, r2 ), _mm_madd_epi16( r3, r3 ) ) );
+        // add the neighbouring 32-bit lanes: lane 0 holds the left block, lane 2 the right one
+        vSum   = _mm_add_epi32( vSum,   _mm_srli_epi64( vSum,   32 ) );
+        vSumSq = _mm_add_epi32( vSumSq, _mm_srli_epi64( vSumSq, 32 ) );
+        puiSum  [ x >> 2     ] = _mm_cvtsi128_si32( vSum );
+        puiSum  [(x >> 2) + 1] = _mm_cvtsi128_si32( _mm_srli_si128( vSum, 8 ) );
+        puiSumSq[ x >> 2     ] = _mm_cvtsi128_si32( vSumSq );
+        puiSumSq[(x >> 2) + 1] = _mm_cvtsi128_si32( _mm_srli_si128( vSumSq, 8 ) );
+      }
+    }
+#endif
+    for ( ; x < iWidth; x += 4 )
+    {
+      const Int iCols = min( 4, iWidth - x );
+      UInt uiSum = 0;
+      UInt uiSumSq = 0;
+      for ( Int by = 0; by < iRows; by++ )
+      {
+        const Pel* pBlk = pLine + by * iStride + x;
+        for ( Int bx = 0; bx < iCols; bx++ )
+        {
+          uiSum   += pBlk[bx];
+          uiSumSq += pBlk[bx] * pBlk[bx];
+        }
+      }
+      puiSum  [x >> 2] = uiSum;
+      puiSumSq[x >> 2] = uiSumSq;
+    }
+
+    // histogram
+    for ( Int by = 0; by < iRows; by++ )
+    {
+      const Pel* pRow = pLine + by * iStride;
+      for ( x = 0; x < iWidth; x++ )
+      {
+        puiHist[ pRow[x] ]++;
+      }
+    }
+
+    // half resolution plane
+    if ( pHalf )
+    {
+      for ( Int hy = y >> 1; hy < min( ( y + iRows ) >> 1, iHalfHeight ); hy++ )
+      {
+        const Pel* pLine0 = pcPicYuv->getLumaAddr() + 2 * hy * iStride;
+        const Pel* pLine1 = pLine0 + iStride;
+        Pel* pDst = pHalf + hy * iHalfWidth;
+        for ( x = 0; x < iHalfWidth; x++ )
+        {
+          pDst[x] = ( pLine0[2 * x] + pLine0[2 * x + 1] + pLine1[2 * x] + pLine1[2 * x + 1] + 2 ) >> 2;
+        }
+      }
+    }
+  }
+}
+
+/** Histogram of a chroma plane
+ * \param pSrc top-left sample of the plane
+ * \param iStride plane stride
+ * \param iWidth plane width
+ * \param iHeight plane height
+ * \param puiHist histogram to fill
+ * \return Void
+ */
+Void TEncPreanalyzer::xAnalyzeChroma( Pel* pSrc, Int iStride, Int iWidth, Int iHeight, UInt* puiHist )
+{
+  ::memset( puiHist, 0, sizeof(UInt) * ( 1 << ( g_uiBitDepth + g_uiBitIncrement ) ) );
+  for ( Int y = 0; y < iHeight; y++, pSrc += iStride )
+  {
+    for ( Int x = 0; x < iWidth; x++ )
+    {
+      puiHist[ pSrc[x] ]++;
+    }
+  }
+}
 //! \}
 
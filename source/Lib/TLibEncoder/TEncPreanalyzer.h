@@ -54,7 +54,12 @@ public:
   TEncPreanalyzer();
   virtual ~TEncPreanalyzer();
 
+  Void xAnalyze   ( TEncPic* pcPic );
   Void xPreanalyze( TEncPic* pcPic );
+
+private:
+  Void xAnalyzeLuma  ( TComPicYuv* pcPicYuv, TEncPicAnalysis* pcAnalysis );
+  Void xAnalyzeChroma( Pel* pSrc, Int iStride, Int iWidth, Int iHeight, UInt* puiHist );
 };
 
 //! \}
@@ -51,6 +51,12 @@ using namespace std;
 #define MAD_PRED_Y1             1.0
 #define MAD_PRED_Y2             0.0
 
+#define LOOKAHEAD_QP_STRENGTH   2.0     ///< QP offset per doubling of the cost inherited by later pictures
+#define LOOKAHEAD_MIN_RATIO     2.0     ///< smallest complexity ratio between two frames taken as a change of content
+#define LOOKAHEAD_MAX_RATIO     16.0    ///< largest complexity ratio between two frames taken into account
+#define LOOKAHEAD_MAX_DELTA_QP  10      ///< largest extra QP step of a referenced frame at a complexity change
+#define LOOKAHEAD_MAX_GOP_QP    6       ///< largest QP correction of the first frame of a GOP
+
 enum MAD_HISOTRY {
   MAD_PPPrevious = 0,
   MAD_PPrevious  = 1,
@@ -261,9 +267,17 @@ Void  TEncRateCtrl::create(Int sizeIntraPeriod, Int sizeGOP, Int frameRate, Int
   m_costNonRefAvgWeighting   = 0.0;
   m_costAvgbpp               = 0.0;  
   m_activeUnitLevelOn        = false;
+  m_pcLookahead              = NULL;
+  m_currPOC                  = 0;
+  m_prevRefPOC               = -1;
 
   m_pcFrameData              = new FrameData   [sizeGOP+1];         initFrameData(qp);
   m_pcLCUData                = new LCUData     [m_numUnitInFrame];  initUnitData (qp);
+  m_piLCUQPOffset            = new Int         [m_numUnitInFrame];
+  for(Int i = 0; i < m_numUnitInFrame; i++)
+  {
+    m_piLCUQPOffset[i] = 0;
+  }
 
   for(Int i = 0, addressUnit = 0; i < m_sourceHeightInLCU*maxCUHeight; i += maxCUHeight)  
   {
@@ -292,6 +306,11 @@ Void  TEncRateCtrl::destroy()
     delete [] m_pcLCUData;
     m_pcLCUData = NULL;
   }
+  if(m_piLCUQPOffset)
+  {
+    delete [] m_piLCUQPOffset;
+    m_piLCUQPOffset = NULL;
+  }
 }
 
 Void  TEncRateCtrl::initFrameData   (Int qp)
@@ -318,7 +337,7 @@ Void  TEncRateCtrl::initUnitData    (Int qp)
   }
 }
 
-Int  TEncRateCtrl::getFrameQP(Bool isReferenced, Int POC)
+Int  TEncRateCtrl::getFrameQP(Bool isReferenced, Int POC, SliceType eSliceType)
 {
   Int numofReferenced = 0;
   Int finalQP = 0;
@@ -326,6 +345,25 @@ Int  TEncRateCtrl::getFrameQP(Bool isReferenced, Int POC)
 
   m_indexPOCInGOP = (POC%m_sizeGOP) == 0 ? m_sizeGOP : (POC%m_sizeGOP);
   pcFrameData     = &m_pcFrameData[m_indexPOCInGOP];
+  m_currPOC       = POC;
+
+  // complexity of this frame relative to the last referenced frame and QP offset from the references it receives
+  Double costRatio         = 1.0;
+  Double lookaheadQPOffset = 0.0;
+  if(m_pcLookahead)
+  {
+    // the inter costs are taken against the previous picture, which only models the references of low-delay coding
+    costRatio         = xGetLookaheadRatio(POC, m_prevRefPOC, eSliceType == I_SLICE || !m_isLowdelay);
+    lookaheadQPOffset = m_pcLookahead->getQPOffsets(POC, LOOKAHEAD_QP_STRENGTH, m_piLCUQPOffset);
+    if(!isReferenced)
+    {
+      lookaheadQPOffset = 0.0;
+      for(Int i = 0; i < m_numUnitInFrame; i++)
+      {
+        m_piLCUQPOffset[i] = 0;
+      }
+    }
+  }
     
   if(m_indexFrame != 0)
   {
@@ -339,6 +377,29 @@ Int  TEncRateCtrl::getFrameQP(Bool isReferenced, Int POC)
       Double targetBitsOccupancy  = (m_currBitrate/(Double)m_frameRate) + gamma*(m_targetBufLevel-m_occupancyVB - (m_initialOVB/(Double)m_frameRate));
       Double targetBitsLeftBudget = ((m_costRefAvgWeighting*m_remainingBitsInGOP)/((m_costRefAvgWeighting*numRemainingRefFrames)+(m_costNonRefAvgWeighting*numRemainingNRefFrames)));
 
+      if(m_pcLookahead)
+      {
+        // share of the GOP budget following the complexity of this frame relative to the frames of its GOP
+        Double costGOP = 0.0;
+        Int    numGOP  = 0;
+        for(Int idx = 1; idx <= m_sizeGOP; idx++)
+        {
+          Double cost = m_pcLookahead->getCost(POC - m_indexPOCInGOP + idx, !m_isLowdelay);
+          if(cost > 0)
+          {
+            costGOP += cost;
+            numGOP++;
+          }
+        }
+        Double cost = m_pcLookahead->getCost(POC, !m_isLowdelay);
+        if(numGOP > 0 && costGOP > 0 && cost > 0)
+        {
+          targetBitsLeftBudget *= max(1.0/LOOKAHEAD_MAX_RATIO, min(LOOKAHEAD_MAX_RATIO, cost*numGOP/costGOP));
+        }
+        // the propagation offset moves bits between the frames of the GOP instead of shifting the QP the next frames are clamped to
+        targetBitsLeftBudget *= max(1.0/LOOKAHEAD_MAX_RATIO, min(LOOKAHEAD_MAX_RATIO, pow(2.0, -lookaheadQPOffset/6.0)));
+      }
+
       m_targetBits = (Int)(beta * targetBitsLeftBudget + (1-beta) * targetBitsOccupancy);
   
       if(m_targetBits <= 0 || m_remainingBitsInGOP <= 0)
@@ -347,9 +408,10 @@ Int  TEncRateCtrl::getFrameQP(Bool isReferenced, Int POC)
       }
       else
       {
-        Double costPredMAD   = m_cMADLinearModel.getMAD();
-        Int    qpLowerBound = m_pcFrameData[m_indexPrevPOCInGOP].m_qp-2;
-        Int    qpUpperBound = m_pcFrameData[m_indexPrevPOCInGOP].m_qp+2;
+        Double costPredMAD   = m_cMADLinearModel.getMAD() * costRatio;
+        Int    deltaQP       = xGetLookaheadDeltaQP(costRatio, LOOKAHEAD_MAX_DELTA_QP);
+        Int    qpLowerBound = m_pcFrameData[m_indexPrevPOCInGOP].m_qp-2 + min(0, deltaQP);
+        Int    qpUpperBound = m_pcFrameData[m_indexPrevPOCInGOP].m_qp+2 + max(0, deltaQP);
         finalQP = m_cPixelURQQuadraticModel.getQP(m_pcFrameData[m_indexPrevPOCInGOP].m_qp, m_targetBits, m_numOfPixels, costPredMAD);
         finalQP = max(qpLowerBound, min(qpUpperBound, finalQP));
         m_activeUnitLevelOn    = true;
@@ -411,13 +473,14 @@ Int  TEncRateCtrl::getFrameQP(Bool isReferenced, Int POC)
         finalQP += 2;
       }
     }
+    finalQP += xGetLookaheadDeltaQP(costRatio, LOOKAHEAD_MAX_GOP_QP);
     m_indexRefFrame++;
   }
   finalQP = max(MIN_QP, min(MAX_QP, finalQP));
 
   for(Int indexLCU = 0 ; indexLCU < m_numUnitInFrame; indexLCU++)
   {
-    m_pcLCUData[indexLCU].m_qp = finalQP;
+    m_pcLCUData[indexLCU].m_qp = m_pcLookahead ? max(MIN_QP, min(MAX_QP, finalQP + m_piLCUQPOffset[indexLCU])) : finalQP;
   }
 
   pcFrameData->m_isReferenced = isReferenced;
@@ -430,7 +493,8 @@ Bool  TEncRateCtrl::calculateUnitQP ()
 {
   if(!m_activeUnitLevelOn || m_indexLCU == 0)
   {
-    return false;
+    // the LCU QPs carry the lookahead offsets, so the lambda has to follow them
+    return m_pcLookahead != NULL;
   }
   Int upperQPBound, lowerQPBound, finalQP;
   Int    colQP        = m_pcLCUData[m_indexLCU].m_qp;
@@ -463,6 +527,15 @@ Bool  TEncRateCtrl::calculateUnitQP ()
     finalQP = m_cPixelURQQuadraticModel.getQP(colQP, targetBits, m_pcLCUData[m_indexLCU].m_pixels, colMAD);
   }
   
+  if(m_pcLookahead)
+  {
+    // keep the offset of this LCU against the offsets of its neighbours
+    Int offset          = m_piLCUQPOffset[m_indexLCU];
+    Int neighbourOffset = ( m_indexLCU >= m_sourceWidthInLCU ) ? ((m_piLCUQPOffset[m_indexLCU-1] + m_piLCUQPOffset[m_indexLCU - m_sourceWidthInLCU])>>1) : m_piLCUQPOffset[m_indexLCU-1];
+    finalQP      += offset;
+    upperQPBound += offset - neighbourOffset;
+    lowerQPBound += offset - neighbourOffset;
+  }
   finalQP = max(lowerQPBound, min(upperQPBound, finalQP));
   m_pcLCUData[m_indexLCU].m_qp = max(MIN_QP, min(MAX_QP, finalQP));
   
@@ -600,6 +673,7 @@ Void  TEncRateCtrl::updateFrameData(UInt64 actualFrameBits)
   if(m_pcFrameData[m_indexPOCInGOP].m_isReferenced)
   {
     m_indexPrevPOCInGOP = m_indexPOCInGOP;
+    m_prevRefPOC        = m_currPOC;
     m_cMADLinearModel.updateMADHistory(m_pcFrameData[m_indexPOCInGOP].m_costMAD);
   }
 }
@@ -630,6 +704,37 @@ Void  TEncRateCtrl::updateLCUData(TComDataCU* pcCU, UInt64 actualLCUBits, Int qp
   m_pcLCUData[m_indexLCU++].m_bits    = (Int)actualLCUBits;
 }
 
+/** Complexity ratio of two frames from the lookahead cost estimates
+ * \param POC frame to be coded
+ * \param refPOC frame the ratio is taken against
+ * \param isIntra compare the intra costs instead of the costs with inter prediction
+ * \returns ratio of the costs limited to LOOKAHEAD_MAX_RATIO, 1 if either frame has no estimate or the ratio is
+ *          within LOOKAHEAD_MIN_RATIO, which is left to the rate control models
+ */
+Double TEncRateCtrl::xGetLookaheadRatio(Int POC, Int refPOC, Bool isIntra)
+{
+  Double cost    = m_pcLookahead->getCost(POC, isIntra);
+  Double costRef = refPOC < 0 ? 0.0 : m_pcLookahead->getCost(refPOC, isIntra);
+  if(cost <= 0 || costRef <= 0)
+  {
+    return 1.0;
+  }
+  Double ratio = cost/costRef;
+  if(ratio < LOOKAHEAD_MIN_RATIO && ratio > 1.0/LOOKAHEAD_MIN_RATIO)
+  {
+    return 1.0;
+  }
+  return max(1.0/LOOKAHEAD_MAX_RATIO, min(LOOKAHEAD_MAX_RATIO, ratio));
+}
+
+/** QP step that keeps the bits of a frame constant when its complexity changes by a ratio
+ */
+Int TEncRateCtrl::xGetLookaheadDeltaQP(Double ratio, Int maxDeltaQP)
+{
+  Int deltaQP = (Int)floor(6.0*log(ratio)/log(2.0) + 0.5);
+  return max(-maxDeltaQP, min(maxDeltaQP, deltaQP));
+}
+
 Double TEncRateCtrl::xAdjustmentBits(Int& reductionBits, Int& compensationBits)
 {
   Double adjustment  = ADJUSTMENT_FACTOR*reductionBits;
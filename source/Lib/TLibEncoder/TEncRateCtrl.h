@@ -45,6 +45,7 @@
 
 #include "../TLibCommon/CommonDef.h"
 #include "../TLibCommon/TComDataCU.h"
+#include "TEncLookahead.h"
 
 #include <vector>
 #include <algorithm>
@@ -157,6 +158,14 @@ private:
 
   MADLinearModel              m_cMADLinearModel;
   PixelBaseURQQuadraticModel  m_cPixelURQQuadraticModel;
+
+  TEncLookahead*  m_pcLookahead;          ///< cost estimates of the pictures ahead, NULL without lookahead
+  Int*            m_piLCUQPOffset;        ///< lookahead QP offset of each LCU relative to the frame QP
+  Int             m_currPOC;
+  Int             m_prevRefPOC;           ///< POC of the last coded referenced frame, -1 if none
+
+  Double        xGetLookaheadRatio    (Int POC, Int refPOC, Bool isIntra);
+  Int           xGetLookaheadDeltaQP  (Double ratio, Int maxDeltaQP);
   
 public:
   TEncRateCtrl         () {};
@@ -167,7 +176,7 @@ public:
 
   Void          initFrameData         (Int qp = 0);
   Void          initUnitData          (Int qp = 0);
-  Int           getFrameQP            (Bool isReferenced, Int POC);
+  Int           getFrameQP            (Bool isReferenced, Int POC, SliceType eSliceType);
   Bool          calculateUnitQP       ();
   Int           getUnitQP             ()                                          { return m_pcLCUData[m_indexLCU].m_qp;  }
   Void          updateRCGOPStatus     ();
@@ -177,6 +186,7 @@ public:
   Void          updateFrameData       (UInt64 actualFrameBits);
   Double        xAdjustmentBits       (Int& reductionBits, Int& compensationBits);
   Int           getGOPId              ()                                          { return m_indexFrame; }
+  Void          setLookahead          (TEncLookahead* pcLookahead)                { m_pcLookahead = pcLookahead; }
 };
 #endif
 
@@ -0,0 +1,375 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.  
+ *
+ * Copyright (c) 2010-2012, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** \file     TEncSadCache.cpp
+    \brief    integer-pel SAD cache shared by the partition searches of a CU
+*/
+
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+#include "TLibCommon/TComRom.h"
+#include "TLibCommon/TComRdCost.h"
+#include "TEncSadCache.h"
+
+#if HAS_SSE2
+#include <emmintrin.h>
+#endif
+
+//! \ingroup TLibEncoder
+//! \{
+
+TEncSadCache::TEncSadCache()
+: m_puiScratch    ( NULL )
+, m_uiEntrySize   ( 0 )
+, m_uiStamp       ( 1 )
+, m_piOrgY        ( NULL )
+, m_iOrgStride    ( 0 )
+, m_iPOC          ( 0 )
+, m_uiCUAddr      ( 0 )
+, m_uiAbsZorderIdx( 0 )
+, m_uiCUWidth     ( 0 )
+, m_iSubSize      ( 0 )
+, m_pcCurrTable   ( NULL )
+, m_piRefY        ( NULL )
+, m_iRefStride    ( 0 )
+, m_iPartX0       ( 0 )
+, m_iPartY0       ( 0 )
+, m_iPartX1       ( 0 )
+, m_iPartY1       ( 0 )
+, m_iSubShift     ( 0 )
+#if PEL8_ME
+, m_piOrgY8       ( NULL )
+, m_iOrgStride8   ( 0 )
+, m_piRefY8       ( NULL )
+#endif
+{
+  ::memset( m_apcTable, 0, sizeof( m_apcTable ) );
+}
+
+TEncSadCache::~TEncSadCache()
+{
+  destroy();
+}
+
+/** Create the cache. The tables of the reference pictures are allocated on first use.
+ */
+Void TEncSadCache::create()
+{
+  destroy();
+  m_uiEntrySize = 1 + 2 * SAD_CACHE_GRID * SAD_CACHE_GRID;
+  m_puiScratch  = new UInt[ m_uiEntrySize ];
+  m_piOrgY      = NULL;
+}
+
+Void TEncSadCache::destroy()
+{
+  for ( Int iList = 0; iList < 2; iList++ )
+  {
+    for ( Int iRefIdx = 0; iRefIdx < SAD_CACHE_MAX_REF; iRefIdx++ )
+    {
+      SadTable* pcTable = m_apcTable[iList][iRefIdx];
+      if ( pcTable )
+      {
+        delete[] pcTable->puiKey;
+        delete[] pcTable->puiStamp;
+        delete[] pcTable->puiSad;
+        delete pcTable;
+        m_apcTable[iList][iRefIdx] = NULL;
+      }
+    }
+  }
+  delete[] m_puiScratch;
+  m_puiScratch  = NULL;
+  m_pcCurrTable = NULL;
+}
+
+/** Start the search of a CU. All cached SADs are dropped unless the CU is the one searched last.
+ * \param iPOC            POC of the current picture
+ * \param uiCUAddr        LCU address
+ * \param uiAbsZorderIdx  z-order index of the CU in the LCU
+ * \param uiCUWidth       CU width (and height)
+ * \param piOrgY          original luma samples at the CU origin
+ * \param iOrgStride      stride of piOrgY
+ */
+Void TEncSadCache::initCU( Int iPOC, UInt uiCUAddr, UInt uiAbsZorderIdx, UInt uiCUWidth, Pel* piOrgY, Int iOrgStride )
+{
+  m_pcCurrTable = NULL;
+  if ( piOrgY == m_piOrgY && iOrgStride == m_iOrgStride && iPOC == m_iPOC && uiCUAddr == m_uiCUAddr
+    && uiAbsZorderIdx == m_uiAbsZorderIdx && uiCUWidth == m_uiCUWidth )
+  {
+    return;
+  }
+
+  if ( ++m_uiStamp == 0 )
+  {
+    // generation counter wrapped: free all entries explicitly
+    for ( Int iList = 0; iList < 2; iList++ )
+    {
+      for ( Int iRefIdx = 0; iRefIdx < SAD_CACHE_MAX_REF; iRefIdx++ )
+      {
+        if ( m_apcTable[iList][iRefIdx] )
+        {
+          ::memset( m_apcTable[iList][iRefIdx]->puiStamp, 0, sizeof(UInt) << SAD_CACHE_LOG2_ENTRIES );
+          m_apcTable[iList][iRefIdx]->uiStamp = 0;
+        }
+      }
+    }
+    m_uiStamp = 1;
+  }
+
+  m_piOrgY         = piOrgY;
+  m_iOrgStride     = iOrgStride;
+  m_iPOC           = iPOC;
+  m_uiCUAddr       = uiCUAddr;
+  m_uiAbsZorderIdx = uiAbsZorderIdx;
+  m_uiCUWidth      = uiCUWidth;
+  m_iSubSize       = uiCUWidth / SAD_CACHE_GRID;
+}
+
+/** Select the reference picture of the following getSad() calls.
+ * \param iRefList    reference picture list
+ * \param iRefIdx     reference index
+ * \param piRefY      reference luma samples at the CU origin
+ * \param iRefStride  stride of piRefY
+ * \returns false if the SADs of this CU and reference picture are not cached
+ */
+Bool TEncSadCache::setReference( Int iRefList, Int iRefIdx, Pel* piRefY, Int iRefStride )
+{
+  if ( m_piOrgY == NULL || m_iSubSize < SAD_CACHE_MIN_SUB_SIZE || iRefIdx < 0 || iRefIdx >= SAD_CACHE_MAX_REF )
+  {
+    return false;
+  }
+
+  SadTable*& rpcTable = m_apcTable[iRefList][iRefIdx];
+  if ( rpcTable == NULL )
+  {
+    rpcTable           = new SadTable;
+    rpcTable->piRefY   = NULL;
+    rpcTable->uiStamp  = 0;
+    rpcTable->uiNumUsed= 0;
+    rpcTable->puiKey   = new UInt[ 1 << SAD_CACHE_LOG2_ENTRIES ];
+    rpcTable->puiStamp = new UInt[ 1 << SAD_CACHE_LOG2_ENTRIES ];
+    rpcTable->puiSad   = new UInt[ m_uiEntrySize << SAD_CACHE_LOG2_ENTRIES ];
+    ::memset( rpcTable->puiStamp, 0, sizeof(UInt) << SAD_CACHE_LOG2_ENTRIES );
+  }
+
+  if ( rpcTable->uiStamp != m_uiStamp )
+  {
+    rpcTable->uiStamp   = m_uiStamp;
+    rpcTable->uiNumUsed = 0;
+  }
+  else if ( rpcTable->piRefY != piRefY )
+  {
+    // a different picture under the same reference index within one CU
+    ::memset( rpcTable->puiStamp, 0, sizeof(UInt) << SAD_CACHE_LOG2_ENTRIES );
+    rpcTable->uiNumUsed = 0;
+  }
+  rpcTable->piRefY = piRefY;
+
+  m_pcCurrTable = rpcTable;
+  m_piRefY      = piRefY;
+  m_iRefStride  = iRefStride;
+#if PEL8_ME
+  m_piRefY8     = NULL;
+#endif
+  return true;
+}
+
+#if PEL8_ME
+/** Compute the missing SADs of the current reference picture on 8-bit copies of the samples, see TComPicYuv::copyToLuma8().
+ * \param piOrgY8     8-bit original samples at the CU origin
+ * \param iOrgStride8 stride of piOrgY8
+ * \param piRefY8     8-bit reference samples at the CU origin, with the stride passed to setReference()
+ */
+Void TEncSadCache::setPel8( const UChar* piOrgY8, Int iOrgStride8, const UChar* piRefY8 )
+{
+  m_piOrgY8     = piOrgY8;
+  m_iOrgStride8 = iOrgStride8;
+  m_piRefY8     = piRefY8;
+}
+#endif
+
+/** Select the partition of the following getSad() calls.
+ * \param iOffsetX   horizontal offset of the partition in the CU
+ * \param iOffsetY   vertical offset of the partition in the CU
+ * \param iWidth     partition width
+ * \param iHeight    partition height
+ * \param iSubShift  1 for the subsampled SAD of the fast encoder, which only uses the even rows
+ */
+Void TEncSadCache::setPartition( Int iOffsetX, Int iOffsetY, Int iWidth, Int iHeight, Int iSubShift )
+{
+  assert( iOffsetX % m_iSubSize == 0 && iOffsetY % m_iSubSize == 0 );
+  assert( iWidth   % m_iSubSize == 0 && iHeight  % m_iSubSize == 0 );
+  m_iPartX0   = iOffsetX / m_iSubSize;
+  m_iPartY0   = iOffsetY / m_iSubSize;
+  m_iPartX1   = ( iOffsetX + iWidth  ) / m_iSubSize;
+  m_iPartY1   = ( iOffsetY + iHeight ) / m_iSubSize;
+  m_iSubShift = iSubShift;
+}
+
+/** Luma SAD of the current partition at an integer motion vector, identical to the SAD functions of TComRdCost.
+ * \param iMvX  horizontal motion vector in integer samples
+ * \param iMvY  vertical motion vector in integer samples
+ * \returns SAD
+ */
+UInt TEncSadCache::getSad( Int iMvX, Int iMvY )
+{
+  UInt* puiEntry = xGetEntry( iMvX, iMvY );
+  UInt& ruiValid = puiEntry[0];
+  UInt  uiSum    = 0;
+
+  for ( Int iY = m_iPartY0; iY < m_iPartY1; iY++ )
+  {
+    Int   iSub   = iY * SAD_CACHE_GRID + m_iPartX0;
+    UInt* puiSub = puiEntry + 1 + 2 * iSub;
+    for ( Int iX = m_iPartX0; iX < m_iPartX1; iX++, iSub++, puiSub += 2 )
+    {
+      if ( ( ruiValid & ( 1u << ( 2 * iSub ) ) ) == 0 )
+      {
+        puiSub[0] = xGetSubSad( iX, iY, iMvX, iMvY, 0 );
+        ruiValid |= 1u << ( 2 * iSub );
+      }
+      uiSum += puiSub[0];
+      if ( m_iSubShift == 0 )
+      {
+        if ( ( ruiValid & ( 2u << ( 2 * iSub ) ) ) == 0 )
+        {
+          puiSub[1] = xGetSubSad( iX, iY, iMvX, iMvY, 1 );
+          ruiValid |= 2u << ( 2 * iSub );
+        }
+        uiSum += puiSub[1];
+      }
+    }
+  }
+
+  uiSum <<= m_iSubShift;
+  return ( uiSum >> g_uiBitIncrement );
+}
+
+// ====================================================================================================================
+// Private member functions
+// ====================================================================================================================
+
+/** Find or insert the entry of a motion vector in the table of the current reference picture.
+ * \param iMvX  horizontal motion vector in integer samples
+ * \param iMvY  vertical motion vector in integer samples
+ * \returns entry; the scratch entry if the table is full
+ */
+UInt* TEncSadCache::xGetEntry( Int iMvX, Int iMvY )
+{
+  const UInt uiMask = ( 1 << SAD_CACHE_LOG2_ENTRIES ) - 1;
+  const UInt uiKey  = ( (UInt)iMvX & 0xffff ) | ( (UInt)iMvY << 16 );
+  UInt       uiIdx  = ( uiKey * 2654435761u ) >> ( 32 - SAD_CACHE_LOG2_ENTRIES );
+  SadTable*  pcTable= m_pcCurrTable;
+
+  while ( pcTable->puiStamp[uiIdx] == m_uiStamp )
+  {
+    if ( pcTable->puiKey[uiIdx] == uiKey )
+    {
+      return pcTable->puiSad + uiIdx * m_uiEntrySize;
+    }
+    uiIdx = ( uiIdx + 1 ) & uiMask;
+  }
+
+  UInt* puiEntry = m_puiScratch;
+  if ( pcTable->uiNumUsed < ( 3u << SAD_CACHE_LOG2_ENTRIES ) / 4 )
+  {
+    pcTable->puiStamp[uiIdx] = m_uiStamp;
+    pcTable->puiKey  [uiIdx] = uiKey;
+    pcTable->uiNumUsed++;
+    puiEntry = pcTable->puiSad + uiIdx * m_uiEntrySize;
+  }
+  puiEntry[0] = 0;
+  return puiEntry;
+}
+
+/** Raw SAD of every second row of a sub-block.
+ * \param iSubX       horizontal sub-block index in the CU
+ * \param iSubY       vertical sub-block index in the CU
+ * \param iMvX        horizontal motion vector in integer samples
+ * \param iMvY        vertical motion vector in integer samples
+ * \param iRowOffset  0 for the even rows, 1 for the odd rows
+ * \returns SAD before bit-depth scaling
+ */
+UInt TEncSadCache::xGetSubSad( Int iSubX, Int iSubY, Int iMvX, Int iMvY, Int iRowOffset )
+{
+  Int  iStrideOrg = m_iOrgStride << 1;
+  Int  iStrideRef = m_iRefStride << 1;
+  Int  iRefOffset = ( iSubY * m_iSubSize + iMvY + iRowOffset ) * m_iRefStride + iSubX * m_iSubSize + iMvX;
+
+#if PEL8_ME
+  if ( m_piRefY8 )
+  {
+    const UChar* piOrg8 = m_piOrgY8 + ( iSubY * m_iSubSize + iRowOffset ) * m_iOrgStride8 + iSubX * m_iSubSize;
+    return calcSAD8( piOrg8, m_iOrgStride8 << 1, m_piRefY8 + iRefOffset, iStrideRef, m_iSubSize, m_iSubSize >> 1 );
+  }
+#endif
+  Pel* piOrg = m_piOrgY + ( iSubY * m_iSubSize + iRowOffset ) * m_iOrgStride + iSubX * m_iSubSize;
+  Pel* piRef = m_piRefY + iRefOffset;
+
+#if HAS_SSE2
+  const __m128i cOne = _mm_set1_epi16( 1 );
+  const __m128i cZero= _mm_setzero_si128();
+  __m128i cSum       = _mm_setzero_si128();
+  for ( Int iRows = m_iSubSize >> 1; iRows != 0; iRows-- )
+  {
+    for ( Int iX = 0; iX < m_iSubSize; iX += 8 )
+    {
+      __m128i cDiff = _mm_sub_epi16( _mm_loadu_si128( (const __m128i*)( piOrg + iX ) ), _mm_loadu_si128( (const __m128i*)( piRef + iX ) ) );
+      cDiff = _mm_max_epi16( cDiff, _mm_sub_epi16( cZero, cDiff ) );
+      cSum  = _mm_add_epi32( cSum, _mm_madd_epi16( cDiff, cOne ) );
+    }
+    piOrg += iStrideOrg;
+    piRef += iStrideRef;
+  }
+  cSum = _mm_add_epi32( cSum, _mm_shuffle_epi32( cSum, _MM_SHUFFLE( 1, 0, 3, 2 ) ) );
+  cSum = _mm_add_epi32( cSum, _mm_shuffle_epi32( cSum, _MM_SHUFFLE( 2, 3, 0, 1 ) ) );
+  return (UInt)_mm_cvtsi128_si32( cSum );
+#else
+  UInt uiSum      = 0;
+  for ( Int iRows = m_iSubSize >> 1; iRows != 0; iRows-- )
+  {
+    for ( Int iX = 0; iX < m_iSubSize; iX++ )
+    {
+      uiSum += abs( piOrg[iX] - piRef[iX] );
+    }
+    piOrg += iStrideOrg;
+    piRef += iStrideRef;
+  }
+  return uiSum;
+#endif
+}
+
+//! \}
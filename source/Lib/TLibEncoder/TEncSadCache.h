@@ -0,0 +1,130 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.  
+ *
+ * Copyright (c) 2010-2012, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** \file     TEncSadCache.h
+    \brief    integer-pel SAD cache shared by the partition searches of a CU (header)
+*/
+
+#ifndef __TENCSADCACHE__
+#define __TENCSADCACHE__
+
+#include "TLibCommon/CommonDef.h"
+
+//! \ingroup TLibEncoder
+//! \{
+
+// ====================================================================================================================
+// Constants
+// ====================================================================================================================
+
+#define SAD_CACHE_GRID              4           ///< number of sub-blocks per CU side
+#define SAD_CACHE_MIN_SUB_SIZE      8           ///< smallest cached sub-block; smaller CUs use the plain SAD functions
+#define SAD_CACHE_LOG2_ENTRIES      12          ///< log2 of the number of cached positions per reference picture
+#define SAD_CACHE_MAX_REF           33          ///< number of reference indices per list that can be cached
+
+// ====================================================================================================================
+// Class definition
+// ====================================================================================================================
+
+/// integer-pel SAD cache for one CU
+/** The CU is split into a 4x4 grid of sub-blocks, so every partition shape, including the AMP ones, is a union of
+ *  sub-blocks. For each tested integer motion vector of a reference picture the raw SADs of the even and odd rows of
+ *  every sub-block are kept, so the SAD of any partition at a position already probed by another partition search
+ *  (or by an earlier QP pass over the same CU) is obtained by summation. Sub-block SADs are computed lazily, so a
+ *  partition never pays for the rest of the CU. CUs below 32x32 are not cached: their 4x4 sub-blocks cost more in
+ *  bookkeeping than the SAD itself.
+ */
+class TEncSadCache
+{
+private:
+  /// cached positions of one reference picture
+  struct SadTable
+  {
+    Pel*  piRefY;                             ///< reference picture at the CU origin the table was filled for
+    UInt  uiStamp;                            ///< CU generation the table was filled for
+    UInt  uiNumUsed;                          ///< number of occupied entries
+    UInt* puiKey;                             ///< packed motion vector of each entry
+    UInt* puiStamp;                           ///< CU generation of each entry; entries of older CUs are free
+    UInt* puiSad;                             ///< per entry: mask of valid SADs, then even/odd row SADs of the sub-blocks
+  };
+
+  SadTable* m_apcTable[2][SAD_CACHE_MAX_REF]; ///< tables per reference list and index, allocated on first use
+  UInt*     m_puiScratch;                     ///< entry used when the table of a reference picture is full
+  UInt      m_uiEntrySize;                    ///< number of UInts per entry
+  UInt      m_uiStamp;                        ///< current CU generation
+
+  // current CU
+  Pel*      m_piOrgY;                         ///< original samples at the CU origin
+  Int       m_iOrgStride;
+  Int       m_iPOC;
+  UInt      m_uiCUAddr;
+  UInt      m_uiAbsZorderIdx;
+  UInt      m_uiCUWidth;
+  Int       m_iSubSize;                       ///< sub-block width and height
+
+  // current reference and partition
+  SadTable* m_pcCurrTable;
+  Pel*      m_piRefY;
+  Int       m_iRefStride;
+  Int       m_iPartX0, m_iPartY0;             ///< first sub-block of the partition
+  Int       m_iPartX1, m_iPartY1;             ///< sub-block after the last one of the partition
+  Int       m_iSubShift;                      ///< 1 when only the even rows are used (subsampled SAD)
+#if PEL8_ME
+  const UChar* m_piOrgY8;                     ///< 8-bit original samples at the CU origin, NULL when the Pel samples are used
+  Int       m_iOrgStride8;
+  const UChar* m_piRefY8;                     ///< 8-bit reference samples at the CU origin, with stride m_iRefStride
+#endif
+
+  UInt*     xGetEntry     ( Int iMvX, Int iMvY );
+  UInt      xGetSubSad    ( Int iSubX, Int iSubY, Int iMvX, Int iMvY, Int iRowOffset );
+
+public:
+  TEncSadCache();
+  virtual ~TEncSadCache();
+
+  Void  create            ();
+  Void  destroy           ();
+
+  Void  initCU            ( Int iPOC, UInt uiCUAddr, UInt uiAbsZorderIdx, UInt uiCUWidth, Pel* piOrgY, Int iOrgStride );
+  Bool  setReference      ( Int iRefList, Int iRefIdx, Pel* piRefY, Int iRefStride );
+#if PEL8_ME
+  Void  setPel8           ( const UChar* piOrgY8, Int iOrgStride8, const UChar* piRefY8 );
+#endif
+  Void  setPartition      ( Int iOffsetX, Int iOffsetY, Int iWidth, Int iHeight, Int iSubShift );
+
+  UInt  getSad            ( Int iMvX, Int iMvY );
+};
+
+//! \}
+
+#endif // __TENCSADCACHE__
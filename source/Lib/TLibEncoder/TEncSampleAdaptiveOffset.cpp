@@ -40,6 +40,10 @@
 #include <stdio.h>
 #include <math.h>
 
+#if HAS_SSE2
+#include <emmintrin.h>
+#endif
+
 //! \ingroup TLibEncoder
 //! \{
 
@@ -58,6 +62,9 @@ TEncSampleAdaptiveOffset::TEncSampleAdaptiveOffset()
   m_dCostPartBest = NULL; 
   m_iDistOrg = NULL;      
   m_iTypePartBest = NULL; 
+  m_iStatsThreads = 0;
+  m_pcStatsRows = NULL;
+  m_piCuStats = NULL;
 #if SAO_ENCODING_CHOICE_CHROMA
   m_depthSaoRate[0][0] = 0;
   m_depthSaoRate[0][1] = 0;
@@ -77,6 +84,9 @@ TEncSampleAdaptiveOffset::~TEncSampleAdaptiveOffset()
 // Constants
 // ====================================================================================================================
 
+#define NUM_SAO_EO_TYPES              4     ///< edge offset types SAO_EO_0 .. SAO_EO_3
+#define NUM_SAO_EDGE_TYPES            5     ///< edge types of one sample: sum of the two neighbour signs plus 2
+
 
 // ====================================================================================================================
 // Tables
@@ -458,6 +468,12 @@ Void TEncSampleAdaptiveOffset::destroyEncBuffer()
 
   delete [] m_pppcRDSbacCoder;
   delete [] m_pppcBinCoderCABAC;
+
+  m_cStatsQueue.destroy();
+  delete [] m_pcStatsRows;
+  m_pcStatsRows = NULL;
+  delete [] m_piCuStats;
+  m_piCuStats = NULL;
 }
 
 /** create Encoder Buffer for SAO
@@ -522,6 +538,13 @@ Void TEncSampleAdaptiveOffset::createEncBuffer()
       m_pppcRDSbacCoder   [iDepth][iCIIdx]->init( m_pppcBinCoderCABAC [iDepth][iCIIdx] );
     }
   }
+
+  if (m_iStatsThreads > 0)
+  {
+    m_cStatsQueue.create(m_iStatsThreads);
+    m_pcStatsRows = new TEncSaoStatsRow[m_iNumCuInHeight];
+    m_piCuStats   = new Int64[m_iNumCuInWidth * m_iNumCuInHeight * 3 * 2 * MAX_NUM_SAO_TYPE * MAX_NUM_SAO_CLASS];
+  }
 }
 
 /** Start SAO encoder
@@ -857,6 +880,89 @@ Void TEncSampleAdaptiveOffset::calcSaoStatsCu(Int iAddr, Int iPartIdx, Int iYCbC
  * \param  iAddr,  iPartIdx,  iYCbCr
  */
 Void TEncSampleAdaptiveOffset::calcSaoStatsCuOrg(Int iAddr, Int iPartIdx, Int iYCbCr)
+{
+  xCalcSaoStatsCuOrg(iAddr, iYCbCr, m_iOffsetOrg[iPartIdx], m_iCount[iPartIdx]);
+}
+
+#if HAS_SSE2
+/** sum of the four 32-bit lanes
+ */
+static inline Int xHorizontalSum(__m128i v)
+{
+  v = _mm_add_epi32(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2)));
+  v = _mm_add_epi32(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(2, 3, 0, 1)));
+  return _mm_cvtsi128_si32(v);
+}
+#endif
+
+/** Accumulate edge offset statistics of one row of samples
+ * \param pRec reconstructed samples of the row
+ * \param pOrg original samples of the row
+ * \param iOffset distance to the two neighbours along the edge direction
+ * \param iStartX first sample
+ * \param iEndX one past the last sample
+ * \param aiDiff sum of original minus reconstructed samples per edge type
+ * \param aiCount number of samples per edge type
+ *
+ * The edge type is computed directly from both neighbours, so rows can be processed in any order and
+ * from several threads at once.
+ */
+static Void xCalcSaoStatsEoRow(const Pel* pRec, const Pel* pOrg, Int iOffset, Int iStartX, Int iEndX, Int64* aiDiff, Int64* aiCount)
+{
+  Int x = iStartX;
+#if HAS_SSE2
+  if (iEndX - x >= 8)
+  {
+    const __m128i vOne = _mm_set1_epi16(1);
+    __m128i avDiff [NUM_SAO_EDGE_TYPES];
+    __m128i avCount[NUM_SAO_EDGE_TYPES];
+    __m128i avEdge [NUM_SAO_EDGE_TYPES];
+    for (Int i = 0; i < NUM_SAO_EDGE_TYPES; i++)
+    {
+      avDiff [i] = _mm_setzero_si128();
+      avCount[i] = _mm_setzero_si128();
+      avEdge [i] = _mm_set1_epi16((Short)(i - 2));
+    }
+    for (; x + 8 <= iEndX; x += 8)
+    {
+      __m128i vRec   = _mm_loadu_si128((const __m128i*)(pRec + x));
+      __m128i vLeft  = _mm_loadu_si128((const __m128i*)(pRec + x - iOffset));
+      __m128i vRight = _mm_loadu_si128((const __m128i*)(pRec + x + iOffset));
+      __m128i vDiff  = _mm_sub_epi16(_mm_loadu_si128((const __m128i*)(pOrg + x)), vRec);
+      // sign(rec - neighbour) is (neighbour > rec) - (rec > neighbour) with all-ones compare masks
+      __m128i vEdge  = _mm_add_epi16(_mm_sub_epi16(_mm_cmpgt_epi16(vLeft,  vRec), _mm_cmpgt_epi16(vRec, vLeft )),
+                                     _mm_sub_epi16(_mm_cmpgt_epi16(vRight, vRec), _mm_cmpgt_epi16(vRec, vRight)));
+      for (Int i = 0; i < NUM_SAO_EDGE_TYPES; i++)
+      {
+        __m128i vMask = _mm_cmpeq_epi16(vEdge, avEdge[i]);
+        avDiff [i] = _mm_add_epi32(avDiff[i], _mm_madd_epi16(_mm_and_si128(vMask, vDiff), vOne));
+        avCount[i] = _mm_sub_epi16(avCount[i], vMask);
+      }
+    }
+    for (Int i = 0; i < NUM_SAO_EDGE_TYPES; i++)
+    {
+      aiDiff [i] += xHorizontalSum(avDiff[i]);
+      aiCount[i] += xHorizontalSum(_mm_madd_epi16(avCount[i], vOne));
+    }
+  }
+#endif
+  for (; x < iEndX; x++)
+  {
+    Int iEdgeType = xSign(pRec[x] - pRec[x-iOffset]) + xSign(pRec[x] - pRec[x+iOffset]) + 2;
+    aiDiff [iEdgeType] += (pOrg[x] - pRec[x]);
+    aiCount[iEdgeType] ++;
+  }
+}
+
+/** Calculate SAO statistics for one LCU without non-crossing slice
+ * \param  iAddr LCU address
+ * \param  iYCbCr color component
+ * \param  ppStats statistics buffer
+ * \param  ppCount counter buffer
+ *
+ * The band offset and all four edge offset classes are gathered in a single pass over the LCU.
+ */
+Void TEncSampleAdaptiveOffset::xCalcSaoStatsCuOrg(Int iAddr, Int iYCbCr, Int64** ppStats, Int64** ppCount)
 {
   Int x,y;
   TComDataCU *pTmpCu = m_pcPic->getCU(iAddr);
@@ -871,15 +977,9 @@ Void TEncSampleAdaptiveOffset::calcSaoStatsCuOrg(Int iAddr, Int iPartIdx, Int iY
   UInt uiTPelY   = pTmpCu->getCUPelY();
   UInt uiRPelX;
   UInt uiBPelY;
-  Int64* iStats;
-  Int64* iCount;
   Int iClassIdx;
   Int iPicWidthTmp;
   Int iPicHeightTmp;
-  Int iStartX;
-  Int iStartY;
-  Int iEndX;
-  Int iEndY;
 
   Int iIsChroma = (iYCbCr!=0)? 1:0;
   Int numSkipLine = iIsChroma? 2:4;
@@ -911,213 +1011,137 @@ Void TEncSampleAdaptiveOffset::calcSaoStatsCuOrg(Int iAddr, Int iPartIdx, Int iY
 
   iStride    =  (iYCbCr == 0)? m_pcPic->getStride(): m_pcPic->getCStride();
 
-//if(iSaoType == BO_0 || iSaoType == BO_1)
-  {
-    iStats = m_iOffsetOrg[iPartIdx][SAO_BO];
-    iCount = m_iCount    [iPartIdx][SAO_BO];
-
-    pOrg = getPicYuvAddr(m_pcPic->getPicYuvOrg(), iYCbCr, iAddr);
-    pRec = getPicYuvAddr(m_pcPic->getPicYuvRec(), iYCbCr, iAddr);
-
+  // sample ranges: BO and EO_1 keep the picture edge columns, EO_0/2/3 drop them; EO_1/2/3 drop the picture edge rows
 #if SAO_SKIP_RIGHT
-    iEndX   = (uiRPelX == iPicWidthTmp) ? iLcuWidth : iLcuWidth-numSkipLineRight;
+  Int iEndXFull = (uiRPelX == iPicWidthTmp) ? iLcuWidth   : iLcuWidth-numSkipLineRight;
+  Int iEndXEo   = (uiRPelX == iPicWidthTmp) ? iLcuWidth-1 : iLcuWidth-numSkipLineRight;
+#else
+  Int iEndXFull = iLcuWidth;
+  Int iEndXEo   = (uiRPelX == iPicWidthTmp) ? iLcuWidth-1 : iLcuWidth;
 #endif
+  Int iStartXEo = (uiLPelX == 0) ? 1 : 0;
+  Int iEndYBo   = (uiBPelY == iPicHeightTmp) ? iLcuHeight : iLcuHeight-numSkipLine;
+  Int iEndYEo0  = iLcuHeight-numSkipLine;
+  Int iStartYEo = (uiTPelY == 0) ? 1 : 0;
+  Int iEndYEo   = (uiBPelY == iPicHeightTmp) ? iLcuHeight-1 : iLcuHeight-numSkipLine;
+  Int iEndY     = std::max(iEndYBo, std::max(iEndYEo0, iEndYEo));
+
+  // distance to the edge offset neighbours: horizontal, vertical, 135 degree and 45 degree
+  const Int aiEoOffset[NUM_SAO_EO_TYPES] = { 1, iStride, iStride+1, iStride-1 };
+  Int64 aaiDiff [NUM_SAO_EO_TYPES][NUM_SAO_EDGE_TYPES];
+  Int64 aaiCount[NUM_SAO_EO_TYPES][NUM_SAO_EDGE_TYPES];
+  memset(aaiDiff,  0, sizeof(aaiDiff));
+  memset(aaiCount, 0, sizeof(aaiCount));
+
+  Int64* iStatsBo = ppStats[SAO_BO];
+  Int64* iCountBo = ppCount[SAO_BO];
+
+  pOrg = getPicYuvAddr(m_pcPic->getPicYuvOrg(), iYCbCr, iAddr);
+  pRec = getPicYuvAddr(m_pcPic->getPicYuvRec(), iYCbCr, iAddr);
 
-    iEndY   = (uiBPelY == iPicHeightTmp) ? iLcuHeight : iLcuHeight-numSkipLine;
-    for (y=0; y<iEndY; y++)
+  for (y=0; y<iEndY; y++)
+  {
+    if (y < iEndYBo)
     {
-#if SAO_SKIP_RIGHT
-      for (x=0; x<iEndX; x++)
-#else
-      for (x=0; x<iLcuWidth; x++)
-#endif
+      for (x=0; x<iEndXFull; x++)
       {
         iClassIdx = m_lumaTableBo[pRec[x]];
         if (iClassIdx)
         {
-          iStats[iClassIdx] += (pOrg[x] - pRec[x]); 
-          iCount[iClassIdx] ++;
+          iStatsBo[iClassIdx] += (pOrg[x] - pRec[x]); 
+          iCountBo[iClassIdx] ++;
         }
       }
-      pOrg += iStride;
-      pRec += iStride;
     }
-
+    if (y < iEndYEo0)
+    {
+      xCalcSaoStatsEoRow(pRec, pOrg, aiEoOffset[SAO_EO_0], iStartXEo, iEndXEo, aaiDiff[SAO_EO_0], aaiCount[SAO_EO_0]);
+    }
+    if (y >= iStartYEo && y < iEndYEo)
+    {
+      xCalcSaoStatsEoRow(pRec, pOrg, aiEoOffset[SAO_EO_1], 0,         iEndXFull, aaiDiff[SAO_EO_1], aaiCount[SAO_EO_1]);
+      xCalcSaoStatsEoRow(pRec, pOrg, aiEoOffset[SAO_EO_2], iStartXEo, iEndXEo,   aaiDiff[SAO_EO_2], aaiCount[SAO_EO_2]);
+      xCalcSaoStatsEoRow(pRec, pOrg, aiEoOffset[SAO_EO_3], iStartXEo, iEndXEo,   aaiDiff[SAO_EO_3], aaiCount[SAO_EO_3]);
+    }
+    pOrg += iStride;
+    pRec += iStride;
   }
-  Int iSignLeft;
-  Int iSignRight;
-  Int iSignDown;
-  Int iSignDown1;
-  Int iSignDown2;
-
-  UInt uiEdgeType;
 
-//if (iSaoType == EO_0  || iSaoType == EO_1 || iSaoType == EO_2 || iSaoType == EO_3)
+  for (Int iTypeIdx = 0; iTypeIdx < NUM_SAO_EO_TYPES; iTypeIdx++)
   {
-  //if (iSaoType == EO_0)
+    for (Int iEdgeType = 0; iEdgeType < NUM_SAO_EDGE_TYPES; iEdgeType++)
     {
-      iStats = m_iOffsetOrg[iPartIdx][SAO_EO_0];
-      iCount = m_iCount    [iPartIdx][SAO_EO_0];
-
-      pOrg = getPicYuvAddr(m_pcPic->getPicYuvOrg(), iYCbCr, iAddr);
-      pRec = getPicYuvAddr(m_pcPic->getPicYuvRec(), iYCbCr, iAddr);
-
-      iStartX = (uiLPelX == 0) ? 1 : 0;
-#if SAO_SKIP_RIGHT
-      iEndX   = (uiRPelX == iPicWidthTmp) ? iLcuWidth-1 : iLcuWidth-numSkipLineRight;
-#else
-      iEndX   = (uiRPelX == iPicWidthTmp) ? iLcuWidth-1 : iLcuWidth;
-#endif
-      for (y=0; y<iLcuHeight-numSkipLine; y++)
-      {
-        iSignLeft = xSign(pRec[iStartX] - pRec[iStartX-1]);
-        for (x=iStartX; x< iEndX; x++)
-        {
-          iSignRight =  xSign(pRec[x] - pRec[x+1]); 
-          uiEdgeType =  iSignRight + iSignLeft + 2;
-          iSignLeft  = -iSignRight;
-
-          iStats[m_auiEoTable[uiEdgeType]] += (pOrg[x] - pRec[x]);
-          iCount[m_auiEoTable[uiEdgeType]] ++;
-        }
-        pOrg += iStride;
-        pRec += iStride;
-      }
+      ppStats[SAO_EO_0+iTypeIdx][m_auiEoTable[iEdgeType]] += aaiDiff [iTypeIdx][iEdgeType];
+      ppCount[SAO_EO_0+iTypeIdx][m_auiEoTable[iEdgeType]] += aaiCount[iTypeIdx][iEdgeType];
     }
+  }
+}
 
-  //if (iSaoType == EO_1)
-    {
-      iStats = m_iOffsetOrg[iPartIdx][SAO_EO_1];
-      iCount = m_iCount    [iPartIdx][SAO_EO_1];
-
-      pOrg = getPicYuvAddr(m_pcPic->getPicYuvOrg(), iYCbCr, iAddr);
-      pRec = getPicYuvAddr(m_pcPic->getPicYuvRec(), iYCbCr, iAddr);
-
-      iStartY = (uiTPelY == 0) ? 1 : 0;
-#if SAO_SKIP_RIGHT
-      iEndX   = (uiRPelX == iPicWidthTmp) ? iLcuWidth : iLcuWidth-numSkipLineRight;
-#endif
-      iEndY   = (uiBPelY == iPicHeightTmp) ? iLcuHeight-1 : iLcuHeight-numSkipLine;
-      if (uiTPelY == 0)
-      {
-        pOrg += iStride;
-        pRec += iStride;
-      }
+/** Calculate SAO statistics of all LCUs in one LCU row into the per-LCU statistics buffer
+ * \param  iRow LCU row
+ * \param  bLuma gather luma statistics
+ * \param  bChroma gather Cb and Cr statistics
+ */
+Void TEncSampleAdaptiveOffset::calcSaoStatsRow(Int iRow, Bool bLuma, Bool bChroma)
+{
+  Int64* apStats[MAX_NUM_SAO_TYPE];
+  Int64* apCount[MAX_NUM_SAO_TYPE];
 
-      for (x=0; x< iLcuWidth; x++)
+  for (Int iAddr = iRow*m_iNumCuInWidth; iAddr < (iRow+1)*m_iNumCuInWidth; iAddr++)
+  {
+    for (Int iYCbCr = 0; iYCbCr < 3; iYCbCr++)
+    {
+      if (iYCbCr == 0 ? !bLuma : !bChroma)
       {
-        m_iUpBuff1[x] = xSign(pRec[x] - pRec[x-iStride]);
+        continue;
       }
-      for (y=iStartY; y<iEndY; y++)
+      Int64* piStats = xGetCuStats(iAddr, iYCbCr);
+      memset(piStats, 0, sizeof(Int64) * 2 * MAX_NUM_SAO_TYPE * MAX_NUM_SAO_CLASS);
+      for (Int iTypeIdx = 0; iTypeIdx < MAX_NUM_SAO_TYPE; iTypeIdx++)
       {
-#if SAO_SKIP_RIGHT
-        for (x=0; x<iEndX; x++)
-#else
-        for (x=0; x<iLcuWidth; x++)
-#endif
-        {
-          iSignDown     =  xSign(pRec[x] - pRec[x+iStride]); 
-          uiEdgeType    =  iSignDown + m_iUpBuff1[x] + 2;
-          m_iUpBuff1[x] = -iSignDown;
-
-          iStats[m_auiEoTable[uiEdgeType]] += (pOrg[x] - pRec[x]);
-          iCount[m_auiEoTable[uiEdgeType]] ++;
-        }
-        pOrg += iStride;
-        pRec += iStride;
+        apStats[iTypeIdx] = piStats + iTypeIdx * MAX_NUM_SAO_CLASS;
+        apCount[iTypeIdx] = piStats + (MAX_NUM_SAO_TYPE + iTypeIdx) * MAX_NUM_SAO_CLASS;
       }
+      xCalcSaoStatsCuOrg(iAddr, iYCbCr, apStats, apCount);
     }
-  //if (iSaoType == EO_2)
-    {
-      iStats = m_iOffsetOrg[iPartIdx][SAO_EO_2];
-      iCount = m_iCount    [iPartIdx][SAO_EO_2];
-
-      pOrg = getPicYuvAddr(m_pcPic->getPicYuvOrg(), iYCbCr, iAddr);
-      pRec = getPicYuvAddr(m_pcPic->getPicYuvRec(), iYCbCr, iAddr);
-
-      iStartX = (uiLPelX == 0) ? 1 : 0;
-#if SAO_SKIP_RIGHT
-      iEndX   = (uiRPelX == iPicWidthTmp) ? iLcuWidth-1 : iLcuWidth-numSkipLineRight;
-#else
-      iEndX   = (uiRPelX == iPicWidthTmp) ? iLcuWidth-1 : iLcuWidth;
-#endif
+  }
+}
 
-      iStartY = (uiTPelY == 0) ? 1 : 0;
-      iEndY   = (uiBPelY == iPicHeightTmp) ? iLcuHeight-1 : iLcuHeight-numSkipLine;
-      if (uiTPelY == 0)
-      {
-        pOrg += iStride;
-        pRec += iStride;
-      }
+Void TEncSaoStatsRow::execute()
+{
+  m_pcSao->calcSaoStatsRow(m_iRow, m_bLuma, m_bChroma);
+}
 
-      for (x=iStartX; x<iEndX; x++)
-      {
-        m_iUpBuff1[x] = xSign(pRec[x] - pRec[x-iStride-1]);
-      }
-      for (y=iStartY; y<iEndY; y++)
-      {
-        iSignDown2 = xSign(pRec[iStride+iStartX] - pRec[iStartX-1]);
-        for (x=iStartX; x<iEndX; x++)
-        {
-          iSignDown1      =  xSign(pRec[x] - pRec[x+iStride+1]) ;
-          uiEdgeType      =  iSignDown1 + m_iUpBuff1[x] + 2;
-          m_iUpBufft[x+1] = -iSignDown1; 
-          iStats[m_auiEoTable[uiEdgeType]] += (pOrg[x] - pRec[x]);
-          iCount[m_auiEoTable[uiEdgeType]] ++;
-        }
-        m_iUpBufft[iStartX] = iSignDown2;
-        ipSwap     = m_iUpBuff1;
-        m_iUpBuff1 = m_iUpBufft;
-        m_iUpBufft = ipSwap;
+/** Gather the SAO statistics of all LCU rows of the picture in parallel
+ * \param  bLuma gather luma statistics
+ * \param  bChroma gather Cb and Cr statistics
+ */
+Void TEncSampleAdaptiveOffset::xCalcSaoStatsRows(Bool bLuma, Bool bChroma)
+{
+  for (Int iRow = 0; iRow < m_iNumCuInHeight; iRow++)
+  {
+    m_pcStatsRows[iRow].m_pcSao   = this;
+    m_pcStatsRows[iRow].m_iRow    = iRow;
+    m_pcStatsRows[iRow].m_bLuma   = bLuma;
+    m_pcStatsRows[iRow].m_bChroma = bChroma;
+    m_cStatsQueue.submit(&m_pcStatsRows[iRow]);
+  }
+  m_cStatsQueue.waitAll();
+}
 
-        pRec += iStride;
-        pOrg += iStride;
-      }
-    } 
-  //if (iSaoType == EO_3  )
+/** Copy the gathered SAO statistics of one LCU into the statistics of a partition
+ * \param  iAddr,  iPartIdx,  iYCbCr
+ */
+Void TEncSampleAdaptiveOffset::xLoadCuStats(Int iAddr, Int iPartIdx, Int iYCbCr)
+{
+  Int64* piStats = xGetCuStats(iAddr, iYCbCr);
+  for (Int iTypeIdx = 0; iTypeIdx < MAX_NUM_SAO_TYPE; iTypeIdx++)
+  {
+    for (Int iClassIdx = 0; iClassIdx < MAX_NUM_SAO_CLASS; iClassIdx++)
     {
-      iStats = m_iOffsetOrg[iPartIdx][SAO_EO_3];
-      iCount = m_iCount    [iPartIdx][SAO_EO_3];
-
-      pOrg = getPicYuvAddr(m_pcPic->getPicYuvOrg(), iYCbCr, iAddr);
-      pRec = getPicYuvAddr(m_pcPic->getPicYuvRec(), iYCbCr, iAddr);
-
-      iStartX = (uiLPelX == 0) ? 1 : 0;
-#if SAO_SKIP_RIGHT
-      iEndX   = (uiRPelX == iPicWidthTmp) ? iLcuWidth-1 : iLcuWidth-numSkipLineRight;
-#else
-      iEndX   = (uiRPelX == iPicWidthTmp) ? iLcuWidth-1 : iLcuWidth;
-#endif
-
-      iStartY = (uiTPelY == 0) ? 1 : 0;
-      iEndY   = (uiBPelY == iPicHeightTmp) ? iLcuHeight-1 : iLcuHeight-numSkipLine;
-      if (iStartY == 1)
-      {
-        pOrg += iStride;
-        pRec += iStride;
-      }
-
-      for (x=iStartX-1; x<iEndX; x++)
-      {
-        m_iUpBuff1[x] = xSign(pRec[x] - pRec[x-iStride+1]);
-      }
-
-      for (y=iStartY; y<iEndY; y++)
-      {
-        for (x=iStartX; x<iEndX; x++)
-        {
-          iSignDown1      =  xSign(pRec[x] - pRec[x+iStride-1]) ;
-          uiEdgeType      =  iSignDown1 + m_iUpBuff1[x] + 2;
-          m_iUpBuff1[x-1] = -iSignDown1; 
-          iStats[m_auiEoTable[uiEdgeType]] += (pOrg[x] - pRec[x]);
-          iCount[m_auiEoTable[uiEdgeType]] ++;
-        }
-        m_iUpBuff1[iEndX-1] = xSign(pRec[iEndX-1 + iStride] - pRec[iEndX]);
-
-        pRec += iStride;
-        pOrg += iStride;
-      } 
-    } 
+      m_iOffsetOrg[iPartIdx][iTypeIdx][iClassIdx] += piStats[iTypeIdx * MAX_NUM_SAO_CLASS + iClassIdx];
+      m_iCount    [iPartIdx][iTypeIdx][iClassIdx] += piStats[(MAX_NUM_SAO_TYPE + iTypeIdx) * MAX_NUM_SAO_CLASS + iClassIdx];
+    }
   }
 }
 
@@ -1525,6 +1549,17 @@ Void TEncSampleAdaptiveOffset::rdoSaoUnitAll(SAOParam *saoParam, Double lambda,
 #endif
 #endif
 
+  // with statistics threads the statistics of all LCU rows are gathered in parallel before the serial decisions
+  Bool bRowStats = m_iStatsThreads > 0 && !m_bUseNIF;
+  if (bRowStats)
+  {
+#if SAO_TYPE_SHARING
+    xCalcSaoStatsRows(saoParam->bSaoFlag[0], saoParam->bSaoFlag[1]);
+#else
+    xCalcSaoStatsRows(saoParam->bSaoFlag[0], saoParam->bSaoFlag[1] || saoParam->bSaoFlag[2]);
+#endif
+  }
+
   for (idxY = 0; idxY< frameHeightInCU; idxY++)
   {
     for (idxX = 0; idxX< frameWidthInCU; idxX++)
@@ -1614,7 +1649,14 @@ Void TEncSampleAdaptiveOffset::rdoSaoUnitAll(SAOParam *saoParam, Double lambda,
 #endif
 #endif
         {
-          calcSaoStatsCu(addr, compIdx,  compIdx);
+          if (bRowStats)
+          {
+            xLoadCuStats(addr, compIdx, compIdx);
+          }
+          else
+          {
+            calcSaoStatsCu(addr, compIdx,  compIdx);
+          }
 
 #if SAO_TYPE_SHARING
        }
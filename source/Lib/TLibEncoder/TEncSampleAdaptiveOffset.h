@@ -44,6 +44,7 @@
 #include "TEncEntropy.h"
 #include "TEncSbac.h"
 #include "TLibCommon/TComBitCounter.h"
+#include "TLibCommon/TComThread.h"
 
 //! \ingroup TLibEncoder
 //! \{
@@ -52,6 +53,20 @@
 // Class definition
 // ====================================================================================================================
 
+class TEncSampleAdaptiveOffset;
+
+/// SAO statistics of all CTUs in one CTU row, gathered by the statistics queue of TEncSampleAdaptiveOffset
+class TEncSaoStatsRow : public TComJob
+{
+public:
+  TEncSampleAdaptiveOffset* m_pcSao;
+  Int                       m_iRow;         ///< CTU row index
+  Bool                      m_bLuma;        ///< gather luma statistics
+  Bool                      m_bChroma;      ///< gather Cb and Cr statistics
+
+  Void execute();
+};
+
 class TEncSampleAdaptiveOffset : public TComSampleAdaptiveOffset
 {
 private:
@@ -85,6 +100,15 @@ private:
   Double  m_depth0SaoRate;
 #endif
 #endif
+  Int              m_iStatsThreads;         ///< number of threads gathering SAO statistics per CTU row (0: gather during the RDO)
+  TComJobQueue     m_cStatsQueue;           ///< gathers SAO statistics of CTU rows in parallel
+  TEncSaoStatsRow* m_pcStatsRows;           ///< one statistics job per CTU row
+  Int64*           m_piCuStats;             ///< statistics per CTU and component: [addr][YCbCr][offsetOrg/count][type][class]
+
+  Void  xCalcSaoStatsCuOrg  ( Int iAddr, Int iYCbCr, Int64** ppStats, Int64** ppCount );
+  Int64* xGetCuStats        ( Int iAddr, Int iYCbCr ) { return m_piCuStats + ( iAddr * 3 + iYCbCr ) * 2 * MAX_NUM_SAO_TYPE * MAX_NUM_SAO_CLASS; }
+  Void  xCalcSaoStatsRows   ( Bool bLuma, Bool bChroma );
+  Void  xLoadCuStats        ( Int iAddr, Int iPartIdx, Int iYCbCr );
 
 public:
   TEncSampleAdaptiveOffset         ();
@@ -109,6 +133,7 @@ public:
   Void calcSaoStatsCu(Int iAddr, Int iPartIdx, Int iYCbCr);
   Void calcSaoStatsBlock( Pel* pRecStart, Pel* pOrgStart, Int stride, Int64** ppStats, Int64** ppCount, UInt width, UInt height, Bool* pbBorderAvail);
   Void calcSaoStatsCuOrg(Int iAddr, Int iPartIdx, Int iYCbCr);
+  Void calcSaoStatsRow(Int iRow, Bool bLuma, Bool bChroma);
   Void destroyEncBuffer();
   Void createEncBuffer();
   Void assignSaoUnitSyntax(SaoLcuParam* saoLcuParam,  SAOQTPart* saoPart, Bool &oneUnitFlag, Int yCbCr);
@@ -131,6 +156,10 @@ public:
   inline Int64 estSaoTypeDist(Int compIdx, Int typeIdx, Int shift, Double lambda, Int *currentDistortionTableBo, Double *currentRdCostTableBo);
   Void setMaxNumOffsetsPerPic(Int iVal) {m_maxNumOffsetsPerPic = iVal; }
   Int  getMaxNumOffsetsPerPic() {return m_maxNumOffsetsPerPic; }
+  Void setStatsThreads(Int iVal) {m_iStatsThreads = iVal; }
+  Int  getStatsThreads() {return m_iStatsThreads; }
+  Int64** getStatsOffsetOrg(Int iPartIdx) {return m_iOffsetOrg[iPartIdx]; }  ///< sum of original minus reconstructed samples [type][class]
+  Int64** getStatsCount    (Int iPartIdx) {return m_iCount[iPartIdx]; }      ///< number of samples [type][class]
 };
 
 //! \}
@@ -99,6 +99,15 @@ TEncSearch::TEncSearch()
   m_pcEncCfg = NULL;
   m_pcEntropyCoder = NULL;
   m_pTempPel = NULL;
+  m_bUseTableRateEst = false;
+  m_bUseSadCache = false;
+  m_pcSharedAnalysis = NULL;
+  m_bHasMotionSeed   = false;
+#if PEL8_ME
+  m_piOrgY8       = NULL;
+  m_iOrgStride8   = 0;
+  m_piRefY8       = NULL;
+#endif
   m_pSharedPredTransformSkip[0] = m_pSharedPredTransformSkip[1] = m_pSharedPredTransformSkip[2] = NULL;
   m_pcQTTempTUCoeffY   = NULL;
   m_pcQTTempTUCoeffCb  = NULL;
@@ -173,6 +182,7 @@ TEncSearch::~TEncSearch()
   delete[] m_puhQTTempTransformSkipFlag[2];
   m_pcQTTempTransformSkipTComYuv.destroy();
   m_tmpYuvPred.destroy();
+  m_cSadCache.destroy();
 }
 
 void TEncSearch::init(TEncCfg*      pcEncCfg,
@@ -200,6 +210,10 @@ void TEncSearch::init(TEncCfg*      pcEncCfg,
   m_pcRDGoOnSbacCoder   = pcRDGoOnSbacCoder;
   
   m_bUseSBACRD          = pppcRDSbacCoder ? true : false;
+#if FAST_BIT_EST
+  m_bUseTableRateEst    = m_bUseSBACRD && m_pcEncCfg->getUseTableRateEst();
+#endif
+  xResetCoeffRateTables();
   
   for (Int iDir = 0; iDir < 2; iDir++)
   {
@@ -282,6 +296,8 @@ void TEncSearch::init(TEncCfg*      pcEncCfg,
   m_puhQTTempTransformSkipFlag[1] = new UChar  [uiNumPartitions];
   m_puhQTTempTransformSkipFlag[2] = new UChar  [uiNumPartitions];
   m_tmpYuvPred.create(MAX_CU_SIZE, MAX_CU_SIZE);
+  m_cSadCache.create();
+  m_bUseSadCache = false;
 }
 
 #if FASTME_SMOOTHER_MV
@@ -309,30 +325,59 @@ const Bool bStarRefinementStop      = 0;
 const UInt uiStarRefinementRounds   = 2;  /* star refinement stop X rounds after best match (must be >=1) */  \
 
 
+#if PEL8_ME
+/** SAD of the current integer search on the 8-bit samples, equal to the SAD function of m_cDistParam
+ * \param iRefOffset offset of the tested position from m_piRefY8
+ * \returns SAD
+ */
+__inline UInt TEncSearch::xGetSAD8( Int iRefOffset )
+{
+  Int  iSubShift = m_cDistParam.iSubShift;
+  UInt uiSad     = calcSAD8( m_piOrgY8, m_iOrgStride8 << iSubShift, m_piRefY8 + iRefOffset, m_cDistParam.iStrideCur << iSubShift,
+                             m_cDistParam.iCols, m_cDistParam.iRows >> iSubShift );
+  return ( uiSad << iSubShift ) >> g_uiBitIncrement;
+}
+
+#endif
 __inline Void TEncSearch::xTZSearchHelp( TComPattern* pcPatternKey, IntTZSearchStruct& rcStruct, const Int iSearchX, const Int iSearchY, const UChar ucPointNr, const UInt uiDistance )
 {
   UInt  uiSad;
   
   Pel*  piRefSrch;
   
-  piRefSrch = rcStruct.piRefY + iSearchY * rcStruct.iYStride + iSearchX;
-  
-  //-- jclee for using the SAD function pointer
-  m_pcRdCost->setDistParam( pcPatternKey, piRefSrch, rcStruct.iYStride,  m_cDistParam );
-  
-  // fast encoder decision: use subsampled SAD when rows > 8 for integer ME
-  if ( m_pcEncCfg->getUseFastEnc() )
+  if ( m_bUseSadCache )
   {
-    if ( m_cDistParam.iRows > 8 )
+    // distortion, shared with the other partition searches of this CU
+    uiSad = m_cSadCache.getSad( iSearchX, iSearchY );
+  }
+  else
+  {
+    piRefSrch = rcStruct.piRefY + iSearchY * rcStruct.iYStride + iSearchX;
+    
+    //-- jclee for using the SAD function pointer
+    m_pcRdCost->setDistParam( pcPatternKey, piRefSrch, rcStruct.iYStride,  m_cDistParam );
+    
+    // fast encoder decision: use subsampled SAD when rows > 8 for integer ME
+    if ( m_pcEncCfg->getUseFastEnc() )
     {
-      m_cDistParam.iSubShift = 1;
+      if ( m_cDistParam.iRows > 8 )
+      {
+        m_cDistParam.iSubShift = 1;
+      }
     }
-  }
 
-  setDistParamComp(0);  // Y component
+    setDistParamComp(0);  // Y component
 
-  // distortion
-  uiSad = m_cDistParam.DistFunc( &m_cDistParam );
+    // distortion
+#if PEL8_ME
+    if ( m_piOrgY8 )
+    {
+      uiSad = xGetSAD8( iSearchY * rcStruct.iYStride + iSearchX );
+    }
+    else
+#endif
+    uiSad = m_cDistParam.DistFunc( &m_cDistParam );
+  }
   
   // motion cost
   uiSad += m_pcRdCost->getCost( iSearchX, iSearchY );
@@ -882,7 +927,293 @@ TEncSearch::xEncCoeffQT( TComDataCU*  pcCU,
   }
   pcCoeff += uiCoeffOffset;
   
-  m_pcEntropyCoder->encodeCoeffNxN( pcCU, pcCoeff, uiAbsPartIdx, uiWidth, uiHeight, uiFullDepth, eTextType );
+  xEncodeCoeffNxN( pcCU, pcCoeff, uiAbsPartIdx, uiWidth, uiHeight, uiFullDepth, eTextType );
+}
+
+/** code the coefficients of a TU for a rough RD decision
+ * \param pcCU CU data
+ * \param pcCoef coefficients of the TU
+ * \param uiAbsPartIdx part index of the TU
+ * \param uiWidth TU width
+ * \param uiHeight TU height
+ * \param uiDepth TU depth
+ * \param eTType texture type
+ * \returns Void
+ *
+ * With table rate estimation the bits are looked up in the context bit tables of the CU search and added to the
+ * bit counter of the RD coder, so the contexts are not adapted by the coefficients of rejected candidates.
+ */
+Void TEncSearch::xEncodeCoeffNxN( TComDataCU* pcCU, TCoeff* pcCoef, UInt uiAbsPartIdx, UInt uiWidth, UInt uiHeight, UInt uiDepth, TextType eTType )
+{
+#if FAST_BIT_EST
+  if( m_bUseTableRateEst )
+  {
+    m_pcRDGoOnSbacCoder->getEncBinIf()->getTEncBinCABAC()->addFracBits( xGetCoeffFracBits( pcCU, pcCoef, uiAbsPartIdx, uiWidth, uiHeight, eTType ) );
+    return;
+  }
+#endif
+  m_pcEntropyCoder->encodeCoeffNxN( pcCU, pcCoef, uiAbsPartIdx, uiWidth, uiHeight, uiDepth, eTType );
+}
+
+/** estimate the rate of the coefficients of a TU from the context bit tables
+ * \param pcCU CU data
+ * \param pcCoef coefficients of the TU
+ * \param uiAbsPartIdx part index of the TU
+ * \param uiWidth TU width
+ * \param uiHeight TU height
+ * \param eTType texture type
+ * \returns rate in 1/32768 bit units
+ *
+ * Walks the syntax of TEncSbac::codeCoeffNxN(), but takes the bits of each bin from tables estimated once per CU
+ * search from the CI_CURR_BEST coder, without adapting the contexts. The transform skip flag counts as one bit.
+ */
+UInt64 TEncSearch::xGetCoeffFracBits( TComDataCU* pcCU, TCoeff* pcCoef, UInt uiAbsPartIdx, UInt uiWidth, UInt uiHeight, TextType eTType )
+{
+  if( uiWidth > pcCU->getSlice()->getSPS()->getMaxTrSize() )
+  {
+    uiWidth  = pcCU->getSlice()->getSPS()->getMaxTrSize();
+    uiHeight = pcCU->getSlice()->getSPS()->getMaxTrSize();
+  }
+  
+  UInt uiNumSig = TEncEntropy::countNonZeroCoeffs( pcCoef, uiWidth * uiHeight );
+  if( uiNumSig == 0 )
+  {
+    return 0;
+  }
+  
+  UInt64 uiBits = 0;
+#if PPS_TS_FLAG
+  if( pcCU->getSlice()->getPPS()->getUseTransformSkip() && uiWidth == 4 && uiHeight == 4 && !pcCU->getCUTransquantBypass( uiAbsPartIdx ) )
+#else
+  if( pcCU->getSlice()->getSPS()->getUseTransformSkip() && uiWidth == 4 && uiHeight == 4 && !pcCU->getCUTransquantBypass( uiAbsPartIdx ) )
+#endif
+  {
+    uiBits += 32768;
+  }
+  eTType = eTType == TEXT_LUMA ? TEXT_LUMA : TEXT_CHROMA;
+  
+  const UInt uiLog2BlockSize = g_aucConvertToBit[ uiWidth ] + 2;
+  const UInt uiTable         = ( eTType == TEXT_LUMA ? 0 : 1 );
+  estBitsSbacStruct* pcEstBits = &m_acCoeffRateTable[ uiLog2BlockSize - 2 ][ uiTable ];
+  if( !m_abCoeffRateTableValid[ uiLog2BlockSize - 2 ][ uiTable ] )
+  {
+    m_pppcRDSbacCoder[ pcCU->getDepth( 0 ) ][ CI_CURR_BEST ]->estBit( pcEstBits, uiWidth, uiHeight, eTType );
+    m_abCoeffRateTableValid[ uiLog2BlockSize - 2 ][ uiTable ] = true;
+  }
+  
+  UInt uiScanIdx = pcCU->getCoefScanIdx( uiAbsPartIdx, uiWidth, eTType == TEXT_LUMA, pcCU->isIntra( uiAbsPartIdx ) );
+  if( uiScanIdx == SCAN_ZIGZAG )
+  {
+    uiScanIdx = SCAN_DIAG;
+  }
+  Int blockType = uiLog2BlockSize;
+  if( uiWidth != uiHeight )
+  {
+    uiScanIdx = SCAN_DIAG;
+    blockType = 4;
+  }
+  const UInt* scan   = g_auiSigLastScan[ uiScanIdx ][ uiLog2BlockSize - 1 ];
+  const UInt* scanCG = g_auiSigLastScan[ uiScanIdx ][ uiLog2BlockSize > 3 ? uiLog2BlockSize - 2 - 1 : 0 ];
+  if( uiLog2BlockSize == 3 )
+  {
+    scanCG = g_sigLastScan8x8[ uiScanIdx ];
+  }
+  else if( uiLog2BlockSize == 5 )
+  {
+    scanCG = g_sigLastScanCG32x32;
+  }
+  const Bool beValid = !pcCU->getCUTransquantBypass( uiAbsPartIdx ) && pcCU->getSlice()->getPPS()->getSignHideFlag() > 0;
+  
+  //===== last position and coefficient group map =====
+  UInt uiSigCoeffGroupFlag[ MLS_GRP_NUM ];
+  static const UInt uiShift = MLS_CG_SIZE >> 1;
+  const UInt uiNumBlkSide = uiWidth >> uiShift;
+  ::memset( uiSigCoeffGroupFlag, 0, sizeof(UInt) * MLS_GRP_NUM );
+  
+  Int scanPosLast = -1;
+  Int posLast;
+  do
+  {
+    posLast = scan[ ++scanPosLast ];
+    UInt uiPosY = posLast >> uiLog2BlockSize;
+    UInt uiPosX = posLast - ( uiPosY << uiLog2BlockSize );
+    if( pcCoef[ posLast ] )
+    {
+      uiSigCoeffGroupFlag[ uiNumBlkSide * ( uiPosY >> uiShift ) + ( uiPosX >> uiShift ) ] = 1;
+      uiNumSig--;
+    }
+  }
+  while( uiNumSig > 0 );
+  
+  UInt uiPosLastY = posLast >> uiLog2BlockSize;
+  UInt uiPosLastX = posLast - ( uiPosLastY << uiLog2BlockSize );
+  if( uiScanIdx == SCAN_VER )
+  {
+    swap( uiPosLastX, uiPosLastY );
+  }
+  UInt uiGroupIdxX = g_uiGroupIdx[ uiPosLastX ];
+  UInt uiGroupIdxY = g_uiGroupIdx[ uiPosLastY ];
+  uiBits += pcEstBits->lastXBits[ uiGroupIdxX ] + pcEstBits->lastYBits[ uiGroupIdxY ];
+  if( uiGroupIdxX > 3 )
+  {
+    uiBits += ( ( uiGroupIdxX - 2 ) >> 1 ) << 15;
+  }
+  if( uiGroupIdxY > 3 )
+  {
+    uiBits += ( ( uiGroupIdxY - 2 ) >> 1 ) << 15;
+  }
+  
+  //===== significance, levels and signs per coefficient group =====
+  const Int iLastScanSet = scanPosLast >> LOG2_SCAN_SET_SIZE;
+  UInt c1          = 1;
+  Int  iScanPosSig = scanPosLast;
+  for( Int iSubSet = iLastScanSet; iSubSet >= 0; iSubSet-- )
+  {
+    Int  numNonZero    = 0;
+    Int  iSubPos       = iSubSet << LOG2_SCAN_SET_SIZE;
+    UInt uiGoRiceParam = 0;
+    Int  absCoeff[16];
+    Int  lastNZPosInCG = -1, firstNZPosInCG = SCAN_SET_SIZE;
+    
+    if( iScanPosSig == scanPosLast )
+    {
+      absCoeff[ 0 ]  = abs( pcCoef[ posLast ] );
+      numNonZero     = 1;
+      lastNZPosInCG  = iScanPosSig;
+      firstNZPosInCG = iScanPosSig;
+      iScanPosSig--;
+    }
+    
+    Int iCGBlkPos = scanCG[ iSubSet ];
+    Int iCGPosY   = iCGBlkPos / uiNumBlkSide;
+    Int iCGPosX   = iCGBlkPos - ( iCGPosY * uiNumBlkSide );
+    if( iSubSet == iLastScanSet || iSubSet == 0 )
+    {
+      uiSigCoeffGroupFlag[ iCGBlkPos ] = 1;
+    }
+    else
+    {
+      UInt uiCtxSig = TComTrQuant::getSigCoeffGroupCtxInc( uiSigCoeffGroupFlag, iCGPosX, iCGPosY, uiScanIdx, uiWidth, uiHeight );
+      uiBits += pcEstBits->significantCoeffGroupBits[ uiCtxSig ][ uiSigCoeffGroupFlag[ iCGBlkPos ] != 0 ];
+    }
+    
+    if( uiSigCoeffGroupFlag[ iCGBlkPos ] )
+    {
+      Int patternSigCtx = TComTrQuant::calcPatternSigCtx( uiSigCoeffGroupFlag, iCGPosX, iCGPosY, uiWidth, uiHeight );
+      for( ; iScanPosSig >= iSubPos; iScanPosSig-- )
+      {
+        UInt uiBlkPos = scan[ iScanPosSig ];
+        UInt uiPosY   = uiBlkPos >> uiLog2BlockSize;
+        UInt uiPosX   = uiBlkPos - ( uiPosY << uiLog2BlockSize );
+        UInt uiSig    = ( pcCoef[ uiBlkPos ] != 0 );
+        if( iScanPosSig > iSubPos || iSubSet == 0 || numNonZero )
+        {
+#if REMOVAL_8x2_2x8_CG
+          UInt uiCtxSig = TComTrQuant::getSigCtxInc( patternSigCtx, uiScanIdx, uiPosX, uiPosY, blockType, uiWidth, uiHeight, eTType );
+#else
+          UInt uiCtxSig = TComTrQuant::getSigCtxInc( patternSigCtx, uiPosX, uiPosY, blockType, uiWidth, uiHeight, eTType );
+#endif
+          uiBits += pcEstBits->significantBits[ uiCtxSig ][ uiSig ];
+        }
+        if( uiSig )
+        {
+          absCoeff[ numNonZero++ ] = abs( pcCoef[ uiBlkPos ] );
+          if( lastNZPosInCG == -1 )
+          {
+            lastNZPosInCG = iScanPosSig;
+          }
+          firstNZPosInCG = iScanPosSig;
+        }
+      }
+    }
+    else
+    {
+      iScanPosSig = iSubPos - 1;
+    }
+    
+    if( numNonZero > 0 )
+    {
+      UInt uiCtxSet = ( iSubSet > 0 && eTType == TEXT_LUMA ) ? 2 : 0;
+      if( c1 == 0 )
+      {
+        uiCtxSet++;
+      }
+      c1 = 1;
+      
+      Int numC1Flag      = min( numNonZero, C1FLAG_NUMBER );
+      Int firstC2FlagIdx = -1;
+      for( Int idx = 0; idx < numC1Flag; idx++ )
+      {
+        UInt uiSymbol = absCoeff[ idx ] > 1;
+        uiBits += pcEstBits->m_greaterOneBits[ 4 * uiCtxSet + c1 ][ uiSymbol ];
+        if( uiSymbol )
+        {
+          c1 = 0;
+          if( firstC2FlagIdx == -1 )
+          {
+            firstC2FlagIdx = idx;
+          }
+        }
+        else if( ( c1 < 3 ) && ( c1 > 0 ) )
+        {
+          c1++;
+        }
+      }
+      if( c1 == 0 && firstC2FlagIdx != -1 )
+      {
+        uiBits += pcEstBits->m_levelAbsBits[ uiCtxSet ][ absCoeff[ firstC2FlagIdx ] > 2 ];
+      }
+      
+      Bool signHidden = beValid && ( lastNZPosInCG - firstNZPosInCG >= SBH_THRESHOLD );
+      uiBits += UInt64( signHidden ? numNonZero - 1 : numNonZero ) << 15;
+      
+      Int iFirstCoeff2 = 1;
+      if( c1 == 0 || numNonZero > C1FLAG_NUMBER )
+      {
+        for( Int idx = 0; idx < numNonZero; idx++ )
+        {
+          UInt baseLevel = ( idx < C1FLAG_NUMBER ) ? ( 2 + iFirstCoeff2 ) : 1;
+          if( absCoeff[ idx ] >= baseLevel )
+          {
+            // length of the code written by TEncSbac::xWriteCoefRemainExGolomb()
+            UInt uiSymbol = absCoeff[ idx ] - baseLevel;
+            if( uiSymbol < ( COEF_REMAIN_BIN_REDUCTION << uiGoRiceParam ) )
+            {
+              uiBits += UInt64( ( uiSymbol >> uiGoRiceParam ) + 1 + uiGoRiceParam ) << 15;
+            }
+            else
+            {
+              UInt uiLength = uiGoRiceParam;
+              uiSymbol -= COEF_REMAIN_BIN_REDUCTION << uiGoRiceParam;
+              while( uiSymbol >= ( 1u << uiLength ) )
+              {
+                uiSymbol -= 1 << ( uiLength++ );
+              }
+              uiBits += UInt64( COEF_REMAIN_BIN_REDUCTION + uiLength + 1 - uiGoRiceParam + uiLength ) << 15;
+            }
+            if( absCoeff[ idx ] > 3 * ( 1 << uiGoRiceParam ) )
+            {
+              uiGoRiceParam = min<UInt>( uiGoRiceParam + 1, 4 );
+            }
+          }
+          if( absCoeff[ idx ] >= 2 )
+          {
+            iFirstCoeff2 = 0;
+          }
+        }
+      }
+    }
+  }
+  
+  return uiBits;
+}
+
+/** invalidate the context bit tables of the previous CU search
+ * \returns Void
+ */
+Void TEncSearch::xResetCoeffRateTables()
+{
+  ::memset( m_abCoeffRateTableValid, 0, sizeof( m_abCoeffRateTableValid ) );
 }
 
 
@@ -2476,6 +2807,7 @@ TEncSearch::estIntraPredQT( TComDataCU* pcCU,
                            UInt&       ruiDistC,
                            Bool        bLumaOnly )
 {
+  xResetCoeffRateTables();
   UInt    uiDepth        = pcCU->getDepth(0);
   UInt    uiNumPU        = pcCU->getNumPartInter();
   UInt    uiInitTrDepth  = pcCU->getPartitionSize(0) == SIZE_2Nx2N ? 0 : 1;
@@ -2810,6 +3142,7 @@ TEncSearch::estIntraPredChromaQT( TComDataCU* pcCU,
                                  TComYuv*    pcRecoYuv,
                                  UInt        uiPreCalcDistC )
 {
+  xResetCoeffRateTables();
   UInt    uiDepth     = pcCU->getDepth(0);
   UInt    uiBestMode  = 0;
   UInt    uiBestDist  = 0;
@@ -4172,6 +4505,19 @@ Void TEncSearch::xMotionEstimation( TComDataCU* pcCU, TComYuv* pcYuvOrg, Int iPa
   m_pcRdCost->setCostScale  ( 2 );
 
   setWpScalingDistParam( pcCU, iRefIdxPred, eRefPicList );
+#if PEL8_ME
+  // the key of an unweighted uni-prediction search is the original, so 8-bit copies can be searched
+  {
+    TComPicYuv* pcOrgPicYuv = pcCU->getPic()->getPicYuvOrg();
+    TComPicYuv* pcRefPicYuv = pcCU->getSlice()->getRefPic( eRefPicList, iRefIdxPred )->getPicYuvRec();
+    if ( !bBi && !m_cDistParam.bApplyWeight && pcOrgPicYuv->getLumaAddr8() && pcRefPicYuv->getLumaAddr8() )
+    {
+      m_piOrgY8     = pcOrgPicYuv->getLumaAddr8( pcCU->getAddr(), pcCU->getZorderIdxInCU() + uiPartAddr );
+      m_iOrgStride8 = pcOrgPicYuv->getStride();
+      m_piRefY8     = pcRefPicYuv->getLumaAddr8( pcCU->getAddr(), pcCU->getZorderIdxInCU() + uiPartAddr );
+    }
+  }
+#endif
   //  Do integer search
   if ( !m_iFastSearch || bBi )
   {
@@ -4179,9 +4525,44 @@ Void TEncSearch::xMotionEstimation( TComDataCU* pcCU, TComYuv* pcYuvOrg, Int iPa
   }
   else
   {
+    // unweighted uni-prediction searches of the partitions of a CU probe largely the same positions
+    m_bUseSadCache = !m_cDistParam.bApplyWeight;
+    if ( m_bUseSadCache )
+    {
+      TComPicYuv* pcRefPicYuv = pcCU->getSlice()->getRefPic( eRefPicList, iRefIdxPred )->getPicYuvRec();
+      m_cSadCache.initCU( pcCU->getSlice()->getPOC(), pcCU->getAddr(), pcCU->getZorderIdxInCU(), pcCU->getWidth( 0 ),
+                          pcYuvOrg->getLumaAddr(), pcYuvOrg->getStride() );
+      m_bUseSadCache = m_cSadCache.setReference( eRefPicList, iRefIdxPred,
+                                                 pcRefPicYuv->getLumaAddr( pcCU->getAddr(), pcCU->getZorderIdxInCU() ), iRefStride );
+      if ( m_bUseSadCache )
+      {
+#if PEL8_ME
+        if ( m_piOrgY8 )
+        {
+          m_cSadCache.setPel8( pcCU->getPic()->getPicYuvOrg()->getLumaAddr8( pcCU->getAddr(), pcCU->getZorderIdxInCU() ), m_iOrgStride8,
+                               pcRefPicYuv->getLumaAddr8( pcCU->getAddr(), pcCU->getZorderIdxInCU() ) );
+        }
+#endif
+        m_cSadCache.setPartition( g_auiRasterToPelX[ g_auiZscanToRaster[ uiPartAddr ] ], g_auiRasterToPelY[ g_auiZscanToRaster[ uiPartAddr ] ],
+                                  iRoiWidth, iRoiHeight, ( m_pcEncCfg->getUseFastEnc() && iRoiHeight > 8 ) ? 1 : 0 );
+      }
+    }
+    // integer motion of the source block, estimated once for all renditions of the source
+    if ( m_pcSharedAnalysis )
+    {
+      Int iPosX = pcCU->getCUPelX() + g_auiRasterToPelX[ g_auiZscanToRaster[ uiPartAddr ] ] + ( iRoiWidth  >> 1 );
+      Int iPosY = pcCU->getCUPelY() + g_auiRasterToPelY[ g_auiZscanToRaster[ uiPartAddr ] ] + ( iRoiHeight >> 1 );
+      m_bHasMotionSeed = m_pcSharedAnalysis->getMotionSeed( pcCU->getPic(), pcCU->getSlice()->getRefPic( eRefPicList, iRefIdxPred ), iPosX, iPosY, m_cMotionSeed );
+    }
     rcMv = *pcMvPred;
     xPatternSearchFast  ( pcCU, pcPatternKey, piRefY, iRefStride, &cMvSrchRngLT, &cMvSrchRngRB, rcMv, ruiCost );
+    m_bUseSadCache   = false;
+    m_bHasMotionSeed = false;
   }
+#if PEL8_ME
+  m_piOrgY8 = NULL;
+  m_piRefY8 = NULL;
+#endif
   
   m_pcRdCost->getMotionCost( 1, 0 );
   m_pcRdCost->setCostScale ( 1 );
@@ -4261,6 +4642,13 @@ Void TEncSearch::xPatternSearch( TComPattern* pcPatternKey, Pel* piRefY, Int iRe
 
       setDistParamComp(0);
 
+#if PEL8_ME
+      if ( m_piOrgY8 )
+      {
+        uiSad = xGetSAD8( y * iRefStride + x );
+      }
+      else
+#endif
       uiSad = m_cDistParam.DistFunc( &m_cDistParam );
       
       // motion cost
@@ -4338,6 +4726,16 @@ Void TEncSearch::xTZSearch( TComDataCU* pcCU, TComPattern* pcPatternKey, Pel* pi
     xTZSearchHelp( pcPatternKey, cStruct, 0, 0, 0, 0 );
   }
   
+  // test whether the source motion shared by the renditions is a better start point
+  if ( m_bHasMotionSeed )
+  {
+    TComMv cMv = m_cMotionSeed;
+    pcCU->clipMv( cMv );
+    cMv >>= 2;
+    xTZSearchHelp( pcPatternKey, cStruct, Clip3( iSrchRngHorLeft, iSrchRngHorRight,  Int( cMv.getHor() ) ),
+                                          Clip3( iSrchRngVerTop,  iSrchRngVerBottom, Int( cMv.getVer() ) ), 0, 0 );
+  }
+  
   // start search
   Int  iDist = 0;
   Int  iStartX = cStruct.iBestX;
@@ -4529,6 +4927,7 @@ Void TEncSearch::encodeResAndCalcRdInterCU( TComDataCU* pcCU, TComYuv* pcYuvOrg,
   {
     return;
   }
+  xResetCoeffRateTables();
   
   Bool      bHighPass    = pcCU->getSlice()->getDepth() ? true : false;
   UInt      uiBits       = 0, uiBitsBest = 0;
@@ -4941,7 +5340,7 @@ Void TEncSearch::xEstimateResidualQT( TComDataCU* pcCU, UInt uiQuadrant, UInt ui
       m_pcEntropyCoder->encodeQtCbf( pcCU, uiAbsPartIdx, TEXT_LUMA,     uiTrMode );
     }
     
-    m_pcEntropyCoder->encodeCoeffNxN( pcCU, pcCoeffCurrY, uiAbsPartIdx,  trWidth,  trHeight,    uiDepth, TEXT_LUMA );
+    xEncodeCoeffNxN( pcCU, pcCoeffCurrY, uiAbsPartIdx,  trWidth,  trHeight,    uiDepth, TEXT_LUMA );
     const UInt uiSingleBitsY = m_pcEntropyCoder->getNumberOfWrittenBits();
     
     UInt uiSingleBitsU = 0;
@@ -4951,13 +5350,13 @@ Void TEncSearch::xEstimateResidualQT( TComDataCU* pcCU, UInt uiQuadrant, UInt ui
       {
         m_pcEntropyCoder->encodeQtCbf   ( pcCU, uiAbsPartIdx, TEXT_CHROMA_U, uiTrMode );
       }
-      m_pcEntropyCoder->encodeCoeffNxN( pcCU, pcCoeffCurrU, uiAbsPartIdx, trWidthC, trHeightC, uiDepth, TEXT_CHROMA_U );
+      xEncodeCoeffNxN( pcCU, pcCoeffCurrU, uiAbsPartIdx, trWidthC, trHeightC, uiDepth, TEXT_CHROMA_U );
       uiSingleBitsU = m_pcEntropyCoder->getNumberOfWrittenBits() - uiSingleBitsY;
       
       {
         m_pcEntropyCoder->encodeQtCbf   ( pcCU, uiAbsPartIdx, TEXT_CHROMA_V, uiTrMode );
       }
-      m_pcEntropyCoder->encodeCoeffNxN( pcCU, pcCoeffCurrV, uiAbsPartIdx, trWidthC, trHeightC, uiDepth, TEXT_CHROMA_V );
+      xEncodeCoeffNxN( pcCU, pcCoeffCurrV, uiAbsPartIdx, trWidthC, trHeightC, uiDepth, TEXT_CHROMA_V );
       uiSingleBitsV = m_pcEntropyCoder->getNumberOfWrittenBits() - ( uiSingleBitsY + uiSingleBitsU );
     }
     
@@ -5314,7 +5713,7 @@ Void TEncSearch::xEstimateResidualQT( TComDataCU* pcCU, UInt uiQuadrant, UInt ui
       {
         m_pcEntropyCoder->resetBits();
         m_pcEntropyCoder->encodeQtCbf( pcCU, uiAbsPartIdx, TEXT_LUMA, uiTrMode );
-        m_pcEntropyCoder->encodeCoeffNxN( pcCU, pcCoeffCurrY, uiAbsPartIdx, trWidth, trHeight, uiDepth, TEXT_LUMA );
+        xEncodeCoeffNxN( pcCU, pcCoeffCurrY, uiAbsPartIdx, trWidth, trHeight, uiDepth, TEXT_LUMA );
         const UInt uiTsSingleBitsY = m_pcEntropyCoder->getNumberOfWrittenBits();
 
         m_pcTrQuant->setQPforQuant( pcCU->getQP( 0 ), TEXT_LUMA, pcCU->getSlice()->getSPS()->getQpBDOffsetY(), 0 );
@@ -5429,7 +5828,7 @@ Void TEncSearch::xEstimateResidualQT( TComDataCU* pcCU, UInt uiQuadrant, UInt ui
       if( uiAbsSumTransformSkipU )
       {
         m_pcEntropyCoder->encodeQtCbf   ( pcCU, uiAbsPartIdx, TEXT_CHROMA_U, uiTrMode );
-        m_pcEntropyCoder->encodeCoeffNxN( pcCU, pcCoeffCurrU, uiAbsPartIdx, trWidthC, trHeightC, uiDepth, TEXT_CHROMA_U );
+        xEncodeCoeffNxN( pcCU, pcCoeffCurrU, uiAbsPartIdx, trWidthC, trHeightC, uiDepth, TEXT_CHROMA_U );
         uiSingleBitsU = m_pcEntropyCoder->getNumberOfWrittenBits();    
 
 #if CHROMA_QP_EXTENSION
@@ -5477,7 +5876,7 @@ Void TEncSearch::xEstimateResidualQT( TComDataCU* pcCU, UInt uiQuadrant, UInt ui
       if( uiAbsSumTransformSkipV )
       {
         m_pcEntropyCoder->encodeQtCbf   ( pcCU, uiAbsPartIdx, TEXT_CHROMA_V, uiTrMode );
-        m_pcEntropyCoder->encodeCoeffNxN( pcCU, pcCoeffCurrV, uiAbsPartIdx, trWidthC, trHeightC, uiDepth, TEXT_CHROMA_V );
+        xEncodeCoeffNxN( pcCU, pcCoeffCurrV, uiAbsPartIdx, trWidthC, trHeightC, uiDepth, TEXT_CHROMA_V );
         uiSingleBitsV = m_pcEntropyCoder->getNumberOfWrittenBits() - uiSingleBitsU;
 
         if( !uiAbsSumTransformSkipU )
@@ -5558,12 +5957,12 @@ Void TEncSearch::xEstimateResidualQT( TComDataCU* pcCU, UInt uiQuadrant, UInt ui
       m_pcEntropyCoder->encodeQtCbf( pcCU, uiAbsPartIdx, TEXT_LUMA,     uiTrMode );
     }
 
-    m_pcEntropyCoder->encodeCoeffNxN( pcCU, pcCoeffCurrY, uiAbsPartIdx, trWidth, trHeight,    uiDepth, TEXT_LUMA );
+    xEncodeCoeffNxN( pcCU, pcCoeffCurrY, uiAbsPartIdx, trWidth, trHeight,    uiDepth, TEXT_LUMA );
 
     if( bCodeChroma )
     {
-      m_pcEntropyCoder->encodeCoeffNxN( pcCU, pcCoeffCurrU, uiAbsPartIdx, trWidthC, trHeightC, uiDepth, TEXT_CHROMA_U );
-      m_pcEntropyCoder->encodeCoeffNxN( pcCU, pcCoeffCurrV, uiAbsPartIdx, trWidthC, trHeightC, uiDepth, TEXT_CHROMA_V );
+      xEncodeCoeffNxN( pcCU, pcCoeffCurrU, uiAbsPartIdx, trWidthC, trHeightC, uiDepth, TEXT_CHROMA_U );
+      xEncodeCoeffNxN( pcCU, pcCoeffCurrV, uiAbsPartIdx, trWidthC, trHeightC, uiDepth, TEXT_CHROMA_V );
     }
 
     uiSingleBits = m_pcEntropyCoder->getNumberOfWrittenBits();
@@ -5751,7 +6150,7 @@ Void TEncSearch::xEncodeResidualQT( TComDataCU* pcCU, UInt uiAbsPartIdx, const U
 #if !REMOVE_NSQT
         pcCU->getNSQTSize( uiTrMode, uiAbsPartIdx, trWidth, trHeight );
 #endif
-        m_pcEntropyCoder->encodeCoeffNxN( pcCU, pcCoeffCurrY, uiAbsPartIdx, trWidth, trHeight,    uiDepth, TEXT_LUMA );
+        xEncodeCoeffNxN( pcCU, pcCoeffCurrY, uiAbsPartIdx, trWidth, trHeight,    uiDepth, TEXT_LUMA );
       }
       if( bCodeChroma )
       {
@@ -5762,11 +6161,11 @@ Void TEncSearch::xEncodeResidualQT( TComDataCU* pcCU, UInt uiAbsPartIdx, const U
 #endif
         if( eType == TEXT_CHROMA_U && pcCU->getCbf( uiAbsPartIdx, TEXT_CHROMA_U, uiTrMode ) )
         {
-          m_pcEntropyCoder->encodeCoeffNxN( pcCU, pcCoeffCurrU, uiAbsPartIdx, trWidth, trHeight, uiDepth, TEXT_CHROMA_U );
+          xEncodeCoeffNxN( pcCU, pcCoeffCurrU, uiAbsPartIdx, trWidth, trHeight, uiDepth, TEXT_CHROMA_U );
         }
         if( eType == TEXT_CHROMA_V && pcCU->getCbf( uiAbsPartIdx, TEXT_CHROMA_V, uiTrMode ) )
         {
-          m_pcEntropyCoder->encodeCoeffNxN( pcCU, pcCoeffCurrV, uiAbsPartIdx, trWidth, trHeight, uiDepth, TEXT_CHROMA_V );
+          xEncodeCoeffNxN( pcCU, pcCoeffCurrV, uiAbsPartIdx, trWidth, trHeight, uiDepth, TEXT_CHROMA_V );
         }
       }
     }
@@ -48,6 +48,8 @@
 #include "TEncEntropy.h"
 #include "TEncSbac.h"
 #include "TEncCfg.h"
+#include "TEncSadCache.h"
+#include "TEncSharedAnalysis.h"
 
 //! \ingroup TLibEncoder
 //! \{
@@ -114,7 +116,20 @@ protected:
   TEncSbac***     m_pppcRDSbacCoder;
   TEncSbac*       m_pcRDGoOnSbacCoder;
   Bool            m_bUseSBACRD;
+  Bool              m_bUseTableRateEst;             ///< price the coefficients of rough RD decisions from m_acCoeffRateTable
+  estBitsSbacStruct m_acCoeffRateTable[4][2];       ///< context bit tables of the current CU search, [log2 TU size - 2][luma/chroma]
+  Bool              m_abCoeffRateTableValid[4][2];  ///< table was estimated since the last xResetCoeffRateTables()
   DistParam       m_cDistParam;
+  TEncSadCache    m_cSadCache;          ///< integer-pel SADs shared by the partition searches of a CU
+  Bool            m_bUseSadCache;       ///< current integer search takes its SADs from m_cSadCache
+#if PEL8_ME
+  UChar*          m_piOrgY8;            ///< 8-bit original samples of the current integer search, NULL when it uses Pel samples
+  Int             m_iOrgStride8;        ///< stride of m_piOrgY8
+  UChar*          m_piRefY8;            ///< 8-bit reference samples at the searched partition, with the stride of the Pel samples
+#endif
+  TEncSharedAnalysis* m_pcSharedAnalysis; ///< source motion shared by the renditions, NULL if none
+  Bool            m_bHasMotionSeed;     ///< m_cMotionSeed is a start point of the current integer search
+  TComMv          m_cMotionSeed;        ///< source motion of the searched partition in quarter samples
   
   // Misc.
   Pel*            m_pTempPel;
@@ -161,6 +176,9 @@ protected:
   
   // sub-functions for ME
   __inline Void xTZSearchHelp         ( TComPattern* pcPatternKey, IntTZSearchStruct& rcStruct, const Int iSearchX, const Int iSearchY, const UChar ucPointNr, const UInt uiDistance );
+#if PEL8_ME
+  __inline UInt xGetSAD8              ( Int iRefOffset );
+#endif
   __inline Void xTZ2PointSearch       ( TComPattern* pcPatternKey, IntTZSearchStruct& rcStrukt, TComMv* pcMvSrchRngLT, TComMv* pcMvSrchRngRB );
   __inline Void xTZ8PointSquareSearch ( TComPattern* pcPatternKey, IntTZSearchStruct& rcStrukt, TComMv* pcMvSrchRngLT, TComMv* pcMvSrchRngRB, const Int iStartX, const Int iStartY, const Int iDist );
   __inline Void xTZ8PointDiamondSearch( TComPattern* pcPatternKey, IntTZSearchStruct& rcStrukt, TComMv* pcMvSrchRngLT, TComMv* pcMvSrchRngRB, const Int iStartX, const Int iStartY, const Int iDist );
@@ -209,6 +227,7 @@ public:
   
   /// set ME search range
   Void setAdaptiveSearchRange   ( Int iDir, Int iRefIdx, Int iSearchRange) { m_aaiAdaptSR[iDir][iRefIdx] = iSearchRange; }
+  Void setSharedAnalysis        ( TEncSharedAnalysis* p ) { m_pcSharedAnalysis = p; }
   
   Void xEncPCM    (TComDataCU* pcCU, UInt uiAbsPartIdx, Pel* piOrg, Pel* piPCM, Pel* piPred, Pel* piResi, Pel* piReco, UInt uiStride, UInt uiWidth, UInt uiHeight, TextType eText);
   Void IPCMSearch (TComDataCU* pcCU, TComYuv* pcOrgYuv, TComYuv*& rpcPredYuv, TComYuv*& rpcResiYuv, TComYuv*& rpcRecoYuv );
@@ -229,6 +248,20 @@ protected:
                                     UInt         uiAbsPartIdx,
                                     TextType     eTextType,
                                     Bool         bRealCoeff );
+  Void  xEncodeCoeffNxN           ( TComDataCU*  pcCU,
+                                    TCoeff*      pcCoef,
+                                    UInt         uiAbsPartIdx,
+                                    UInt         uiWidth,
+                                    UInt         uiHeight,
+                                    UInt         uiDepth,
+                                    TextType     eTType );
+  UInt64 xGetCoeffFracBits        ( TComDataCU*  pcCU,
+                                    TCoeff*      pcCoef,
+                                    UInt         uiAbsPartIdx,
+                                    UInt         uiWidth,
+                                    UInt         uiHeight,
+                                    TextType     eTType );
+  Void  xResetCoeffRateTables     ();
   Void  xEncIntraHeader           ( TComDataCU*  pcCU,
                                     UInt         uiTrDepth,
                                     UInt         uiAbsPartIdx,
@@ -0,0 +1,278 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.  
+ *
+ * Copyright (c) 2010-2012, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+/** \file     TEncSharedAnalysis.cpp
+    \brief    source analysis shared by the encoders of several renditions
+*/
+
+#include <stdlib.h>
+#include "TEncSharedAnalysis.h"
+
+//! \ingroup TLibEncoder
+//! \{
+
+// ====================================================================================================================
+// Constructor / destructor / create / destroy
+// ====================================================================================================================
+
+TEncSharedAnalysis::TEncSharedAnalysis()
+: m_iWidth       ( 0 )
+, m_iHeight      ( 0 )
+, m_iBlocksX     ( 0 )
+, m_iBlocksY     ( 0 )
+, m_iSearchRange ( 0 )
+, m_pcSourcePic  ( NULL )
+{
+}
+
+TEncSharedAnalysis::~TEncSharedAnalysis()
+{
+  destroy();
+}
+
+/** Set the geometry of the shared analysis
+ * \param iWidth source picture width
+ * \param iHeight source picture height
+ * \param iSearchRange range of the source motion search in integer samples
+ */
+Void TEncSharedAnalysis::create( Int iWidth, Int iHeight, Int iSearchRange )
+{
+  m_iWidth       = iWidth;
+  m_iHeight      = iHeight;
+  m_iBlocksX     = ( iWidth  + MOTION_SEED_BLK - 1 ) / MOTION_SEED_BLK;
+  m_iBlocksY     = ( iHeight + MOTION_SEED_BLK - 1 ) / MOTION_SEED_BLK;
+  m_iSearchRange = iSearchRange;
+  m_pcSourcePic  = NULL;
+}
+
+Void TEncSharedAnalysis::destroy()
+{
+  releaseMotionSeeds();
+  m_pcSourcePic = NULL;
+}
+
+// ====================================================================================================================
+// Public member functions
+// ====================================================================================================================
+
+/** Take over the analysis of the published source picture
+ * \param pcPic received picture holding the same source
+ * \param bAQ copy the QP adaptation activities as well
+ * \returns false if the picture has to be analyzed, it is then published after the analysis
+ */
+Bool TEncSharedAnalysis::copyAnalysis( TEncPic* pcPic, Bool bAQ )
+{
+  if ( !m_pcSourcePic || m_pcSourcePic == pcPic || m_pcSourcePic->getSlice(0)->getPOC() != pcPic->getSlice(0)->getPOC() )
+  {
+    return false;
+  }
+  return pcPic->copyAnalysisFrom( m_pcSourcePic, bAQ );
+}
+
+/** Integer motion of the source block covering a position, estimated once for all renditions
+ * \param pcPic picture being coded
+ * \param pcRefPic reference picture of the search
+ * \param iX, iY luma position in the picture
+ * \param rcMv motion vector in quarter samples
+ * \returns false if no motion is available for the position
+ */
+Bool TEncSharedAnalysis::getMotionSeed( TComPic* pcPic, TComPic* pcRefPic, Int iX, Int iY, TComMv& rcMv )
+{
+  if ( iX < 0 || iY < 0 || iX >= m_iWidth || iY >= m_iHeight )
+  {
+    return false;
+  }
+  
+  Int iPOC    = pcPic->getPOC();
+  Int iRefPOC = pcRefPic->getPOC();
+  TEncMotionSeedField* pcField = NULL;
+  {
+    TComLock cLock( m_cMutex );
+    for ( std::list<TEncMotionSeedField*>::iterator it = m_cFields.begin(); it != m_cFields.end(); it++ )
+    {
+      if ( (*it)->m_iPOC == iPOC && (*it)->m_iRefPOC == iRefPOC )
+      {
+        pcField = *it;
+        break;
+      }
+    }
+    if ( pcField )
+    {
+      while ( !pcField->m_bDone )
+      {
+        m_cFieldDone.wait( m_cMutex );
+      }
+    }
+    else
+    {
+      pcField = new TEncMotionSeedField;
+      pcField->m_iPOC    = iPOC;
+      pcField->m_iRefPOC = iRefPOC;
+      pcField->m_bDone   = false;
+      pcField->m_pcMv    = new TComMv[ m_iBlocksX * m_iBlocksY ];
+      m_cFields.push_back( pcField );
+    }
+  }
+  
+  if ( !pcField->m_bDone )
+  {
+    // estimated outside the lock, the other renditions only wait for this field
+    xEstimateField( pcField, pcPic->getPicYuvOrg(), pcRefPic->getPicYuvOrg() );
+    TComLock cLock( m_cMutex );
+    pcField->m_bDone = true;
+    m_cFieldDone.broadcast();
+  }
+  
+  rcMv = pcField->m_pcMv[ ( iY / MOTION_SEED_BLK ) * m_iBlocksX + iX / MOTION_SEED_BLK ];
+  rcMv <<= 2;
+  return true;
+}
+
+/** Free the motion fields, once no encoder codes a picture
+ */
+Void TEncSharedAnalysis::releaseMotionSeeds()
+{
+  TComLock cLock( m_cMutex );
+  for ( std::list<TEncMotionSeedField*>::iterator it = m_cFields.begin(); it != m_cFields.end(); it++ )
+  {
+    delete[] (*it)->m_pcMv;
+    delete *it;
+  }
+  m_cFields.clear();
+}
+
+// ====================================================================================================================
+// Private member functions
+// ====================================================================================================================
+
+/** Estimate the motion of all blocks of a source picture in raster order
+ */
+Void TEncSharedAnalysis::xEstimateField( TEncMotionSeedField* pcField, TComPicYuv* pcOrg, TComPicYuv* pcRef )
+{
+  for ( Int iBlkY = 0; iBlkY < m_iBlocksY; iBlkY++ )
+  {
+    for ( Int iBlkX = 0; iBlkX < m_iBlocksX; iBlkX++ )
+    {
+      xSearchBlock( pcOrg, pcRef, iBlkX, iBlkY, pcField->m_pcMv + iBlkY * m_iBlocksX + iBlkX );
+    }
+  }
+}
+
+Int TEncSharedAnalysis::xSAD( Pel* pCur, Pel* pRef, Int iStride, Int iW, Int iH, Int iBestSAD )
+{
+  Int iSAD = 0;
+  for ( Int y = 0; y < iH && iSAD < iBestSAD; y++ )
+  {
+    for ( Int x = 0; x < iW; x++ )
+    {
+      iSAD += abs( pCur[x] - pRef[x] );
+    }
+    pCur += iStride;
+    pRef += iStride;
+  }
+  return iSAD;
+}
+
+/** Motion search of a block: best of the zero, left and top vector refined by a diamond search of decreasing step
+ */
+Void TEncSharedAnalysis::xSearchBlock( TComPicYuv* pcOrg, TComPicYuv* pcRef, Int iBlkX, Int iBlkY, TComMv* pcMv )
+{
+  Int  iX0     = iBlkX * MOTION_SEED_BLK;
+  Int  iY0     = iBlkY * MOTION_SEED_BLK;
+  Int  iW      = min( MOTION_SEED_BLK, m_iWidth  - iX0 );
+  Int  iH      = min( MOTION_SEED_BLK, m_iHeight - iY0 );
+  Int  iStride = pcOrg->getStride();
+  Pel* pCur    = pcOrg->getLumaAddr() + iY0 * iStride + iX0;
+  Pel* pRef    = pcRef->getLumaAddr() + iY0 * iStride + iX0;
+  
+  // the displaced block stays inside the picture
+  Int iMinX = max( -m_iSearchRange, -iX0 );
+  Int iMaxX = min(  m_iSearchRange, m_iWidth  - iW - iX0 );
+  Int iMinY = max( -m_iSearchRange, -iY0 );
+  Int iMaxY = min(  m_iSearchRange, m_iHeight - iH - iY0 );
+  
+  Int iBestX = 0, iBestY = 0;
+  Int iBest  = xSAD( pCur, pRef, iStride, iW, iH, MAX_INT );
+  TComMv* apcCand[2] = { iBlkX > 0 ? pcMv - 1 : NULL, iBlkY > 0 ? pcMv - m_iBlocksX : NULL };
+  for ( Int i = 0; i < 2; i++ )
+  {
+    if ( !apcCand[i] )
+    {
+      continue;
+    }
+    Int iMvX = Clip3( iMinX, iMaxX, Int( apcCand[i]->getHor() ) );
+    Int iMvY = Clip3( iMinY, iMaxY, Int( apcCand[i]->getVer() ) );
+    Int iSAD = xSAD( pCur, pRef + iMvY * iStride + iMvX, iStride, iW, iH, iBest );
+    if ( iSAD < iBest )
+    {
+      iBest  = iSAD;
+      iBestX = iMvX;
+      iBestY = iMvY;
+    }
+  }
+  
+  static const Int aiDiamond[4][2] = { { -1, 0 }, { 1, 0 }, { 0, -1 }, { 0, 1 } };
+  for ( Int iStep = 8; iStep > 0; iStep >>= 1 )
+  {
+    for ( Int iIter = 0; iIter < m_iSearchRange; iIter++ )
+    {
+      Int iCentreX = iBestX, iCentreY = iBestY;
+      for ( Int i = 0; i < 4; i++ )
+      {
+        Int iMvX = iCentreX + aiDiamond[i][0] * iStep;
+        Int iMvY = iCentreY + aiDiamond[i][1] * iStep;
+        if ( iMvX < iMinX || iMvX > iMaxX || iMvY < iMinY || iMvY > iMaxY )
+        {
+          continue;
+        }
+        Int iSAD = xSAD( pCur, pRef + iMvY * iStride + iMvX, iStride, iW, iH, iBest );
+        if ( iSAD < iBest )
+        {
+          iBest  = iSAD;
+          iBestX = iMvX;
+          iBestY = iMvY;
+        }
+      }
+      if ( iBestX == iCentreX && iBestY == iCentreY )
+      {
+        break;
+      }
+    }
+  }
+  
+  pcMv->setHor( iBestX );
+  pcMv->setVer( iBestY );
+}
+
+//! \}
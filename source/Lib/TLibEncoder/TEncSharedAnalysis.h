@@ -0,0 +1,112 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.  
+ *
+ * Copyright (c) 2010-2012, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+/** \file     TEncSharedAnalysis.h
+    \brief    source analysis shared by the encoders of several renditions (header)
+*/
+
+#ifndef __TENCSHAREDANALYSIS__
+#define __TENCSHAREDANALYSIS__
+
+#include <list>
+#include "TLibCommon/CommonDef.h"
+#include "TLibCommon/TComMv.h"
+#include "TLibCommon/TComThread.h"
+#include "TEncPic.h"
+
+//! \ingroup TLibEncoder
+//! \{
+
+#define MOTION_SEED_BLK     16      ///< block size of the source motion fields
+
+// ====================================================================================================================
+// Class definition
+// ====================================================================================================================
+
+/// integer motion of the blocks of one source picture towards one reference picture
+class TEncMotionSeedField
+{
+public:
+  Int     m_iPOC;
+  Int     m_iRefPOC;
+  Bool    m_bDone;                        ///< the motion has been estimated, m_pcMv may be read without the lock
+  TComMv* m_pcMv;                         ///< motion of each block in integer samples, in raster order
+};
+
+/// analysis of the source pictures that does not depend on the rate, shared by the encoders of several renditions
+/** The renditions code the same source with the same configuration apart from the QP or target bitrate. The first
+ *  encoder receiving a picture analyzes it and publishes it, the others take over its statistics and QP adaptation
+ *  activities, and with them the input of the weighted prediction estimation. Source pictures are received one after
+ *  the other by all encoders before any of them codes it.
+ *
+ *  The motion fields are estimated on the source luma while the renditions are coded in parallel: the first encoder
+ *  that asks for the motion between two pictures estimates it, encoders asking meanwhile wait for the result. Their
+ *  integer vectors serve as an additional start point of the fast motion search of the renditions after the first,
+ *  so that the first rendition is coded as it would be on its own.
+ */
+class TEncSharedAnalysis
+{
+private:
+  Int                               m_iWidth;
+  Int                               m_iHeight;
+  Int                               m_iBlocksX;           ///< number of blocks per row
+  Int                               m_iBlocksY;           ///< number of block rows
+  Int                               m_iSearchRange;       ///< motion search range in integer samples
+  TEncPic*                          m_pcSourcePic;        ///< analyzed picture of the latest received source picture, NULL if none
+  
+  TComMutex                         m_cMutex;             ///< guards m_cFields
+  TComCondition                     m_cFieldDone;         ///< signalled when a motion field has been estimated
+  std::list<TEncMotionSeedField*>   m_cFields;            ///< motion fields of the current coding step
+  
+  Void  xEstimateField            ( TEncMotionSeedField* pcField, TComPicYuv* pcOrg, TComPicYuv* pcRef );
+  Int   xSAD                      ( Pel* pCur, Pel* pRef, Int iStride, Int iW, Int iH, Int iBestSAD );
+  Void  xSearchBlock              ( TComPicYuv* pcOrg, TComPicYuv* pcRef, Int iBlkX, Int iBlkY, TComMv* pcMv );
+
+public:
+  TEncSharedAnalysis();
+  virtual ~TEncSharedAnalysis();
+  
+  Void  create                    ( Int iWidth, Int iHeight, Int iSearchRange );
+  Void  destroy                   ();
+  
+  Void  setSourcePic              ( TEncPic* pcPic )        { m_pcSourcePic = pcPic; }
+  Bool  copyAnalysis              ( TEncPic* pcPic, Bool bAQ );
+  
+  Bool  getMotionSeed             ( TComPic* pcPic, TComPic* pcRefPic, Int iX, Int iY, TComMv& rcMv );
+  Void  releaseMotionSeeds        ();
+};
+
+//! \}
+
+#endif // __TENCSHAREDANALYSIS__
@@ -247,7 +247,7 @@ Void TEncSlice::initEncSlice( TComPic* pcPic, Int iPOCLast, UInt uiPOCCurr, Int
   }
   if ( m_pcCfg->getUseRateCtrl())
   {
-    dQP = m_pcRateCtrl->getFrameQP(rpcSlice->isReferenced(), rpcSlice->getPOC());
+    dQP = m_pcRateCtrl->getFrameQP(rpcSlice->isReferenced(), rpcSlice->getPOC(), eSliceType);
   }
   // ------------------------------------------------------------------------------------------------------------------
   // Lambda computation
@@ -721,6 +721,7 @@ Void TEncSlice::compressSlice( TComPic*& rpcPic )
     }
   }
 #endif
+  m_pcCuEncoder->initIntraTask( pcSlice );
   TEncTop* pcEncTop = (TEncTop*) m_pcCfg;
   TEncSbac**** ppppcRDSbacCoders    = pcEncTop->getRDSbacCoders();
   TComBitCounter* pcBitCounters     = pcEncTop->getBitCounters();
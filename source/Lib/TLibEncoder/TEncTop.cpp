@@ -56,6 +56,7 @@ TEncTop::TEncTop()
   m_uiNumAllPicCoded  =  0;
   m_pppcRDSbacCoder   =  NULL;
   m_pppcBinCoderCABAC =  NULL;
+  m_pcSharedAnalysis  =  NULL;
   m_cRDGoOnSbacCoder.init( &m_cRDGoOnBinCoderCABAC );
 #if ENC_DEC_TRACE
   g_hTrace = fopen( "TraceEnc.txt", "wb" );
@@ -99,6 +100,7 @@ Void TEncTop::create ()
   {
     m_cEncSAO.setSaoLcuBasedOptimization(getSaoLcuBasedOptimization());
     m_cEncSAO.setMaxNumOffsetsPerPic(getMaxNumOffsetsPerPic());
+    m_cEncSAO.setStatsThreads(getSaoStatsThreads());
     m_cEncSAO.create( getSourceWidth(), getSourceHeight(), g_uiMaxCUWidth, g_uiMaxCUHeight, g_uiMaxCUDepth );
     m_cEncSAO.createEncBuffer();
   }
@@ -133,6 +135,12 @@ Void TEncTop::create ()
   }
 #endif
   m_cRateCtrl.create(getIntraPeriod(), getGOPSize(), getFrameRate(), getTargetBitrate(), getQP(), getNumLCUInUnit(), getSourceWidth(), getSourceHeight(), g_uiMaxCUWidth, g_uiMaxCUHeight);
+  if ( getUseRateCtrl() && getRCLookahead() > 0 )
+  {
+    // keep the estimates of the coded GOP, the GOP before it for the references and the pictures ahead
+    m_cLookahead.create( getSourceWidth(), getSourceHeight(), g_uiMaxCUWidth, 2 * getGOPSize() + getRCLookahead() + 2 );
+    m_cRateCtrl.setLookahead( &m_cLookahead );
+  }
   // if SBAC-based RD optimization is used
   if( m_bUseSBACRD )
   {
@@ -245,6 +253,7 @@ Void TEncTop::destroy ()
 #endif
   m_cLoopFilter.        destroy();
   m_cRateCtrl.          destroy();
+  m_cLookahead.         destroy();
   // SBAC RD
   if( m_bUseSBACRD )
   {
@@ -337,6 +346,8 @@ Void TEncTop::init()
   
   // initialize encoder search class
   m_cSearch.init( this, &m_cTrQuant, m_iSearchRange, m_bipredSearchRange, m_iFastSearch, 0, &m_cEntropyCoder, &m_cRdCost, getRDSbacCoder(), getRDGoOnSbacCoder() );
+  // the first rendition codes as it would on its own, only the further renditions start at the shared motion
+  m_cSearch.setSharedAnalysis( getUseMotionSeeds() && getRendition() > 0 ? m_pcSharedAnalysis : NULL );
 
   m_iMaxRefPicNum = 0;
 }
@@ -361,46 +372,59 @@ Void TEncTop::deletePicBuffer()
 }
 
 /**
- - Application has picture buffer list with size of GOP + 1
+ - Application has picture buffer list with size of GOP + RCLookahead
  - Picture buffer list acts like as ring buffer
  - End of the list has the latest picture
  .
  \param   bEos                true if end-of-sequence is reached
- \param   pcPicYuvOrg         original YUV picture
+ \param   pcPicYuvOrg         original YUV picture, NULL if it has been passed to receivePicture()
  \retval  rcListPicYuvRecOut  list of reconstruction YUV pictures
  \retval  rcListBitstreamOut  list of output bitstreams
  \retval  iNumEncoded         number of encoded pictures
  */
 Void TEncTop::encode( bool bEos, TComPicYuv* pcPicYuvOrg, TComList<TComPicYuv*>& rcListPicYuvRecOut, std::list<AccessUnit>& accessUnitsOut, Int& iNumEncoded )
 {
-  TComPic* pcPicCurr = NULL;
+  if ( pcPicYuvOrg )
+  {
+    xReceivePicture( pcPicYuvOrg );
+  }
   
-  // get original YUV
-  xGetNewPicBuffer( pcPicCurr );
-  pcPicYuvOrg->copyToPic( pcPicCurr->getPicYuvOrg() );
+  // compress GOP
+  iNumEncoded = xCompressGOPs( bEos, false, rcListPicYuvRecOut, accessUnitsOut );
   
-  // compute image characteristics
-  if ( getUseAdaptiveQP() )
+  // the summaries of a multi-rendition encoding are printed by printSummary() once all renditions are coded
+  if ( bEos && getRendition() < 0 )
   {
-    m_cPreanalyzer.xPreanalyze( dynamic_cast<TEncPic*>( pcPicCurr ) );
+    xPrintOutSummary();
   }
-  
-  if ( m_iPOCLast != 0 && ( m_iNumPicRcvd != m_iGOPSize && m_iGOPSize ) && !bEos )
+}
+
+/**
+ - Low-latency variant of encode(): the pictures of a GOP are coded as soon as their source pictures have been
+   received, and every access unit is passed to the output interface set with setOutputIf() before this function
+   returns
+ - Access units are not collected per GOP and the reconstruction is only passed to the output interface
+ .
+ \param   pcPicYuvOrg  original YUV picture, may be NULL with bEos to flush the pictures received so far
+ \param   bEos         end-of-sequence flag
+ */
+Void TEncTop::encode( TComPicYuv* pcPicYuvOrg, Bool bEos )
+{
+  if ( pcPicYuvOrg )
   {
-    iNumEncoded = 0;
-    return;
+    xReceivePicture( pcPicYuvOrg );
   }
   
-  // compress GOP
-  m_cGOPEncoder.compressGOP(m_iPOCLast, m_iNumPicRcvd, m_cListPic, rcListPicYuvRecOut, accessUnitsOut);
+  TComList<TComPicYuv*> cListPicYuvRecOut;  // no copy: the reconstruction is passed to the output interface
+  std::list<AccessUnit> cAccessUnits;
   
-  iNumEncoded         = m_iNumPicRcvd;
-  m_iNumPicRcvd       = 0;
-  m_uiNumAllPicCoded += iNumEncoded;
+  xCompressGOPs( bEos, true, cListPicYuvRecOut, cAccessUnits );
+  assert( cAccessUnits.empty() );             // output interface not set
   
-  if (bEos)
+  // the summaries of a multi-rendition encoding are printed by printSummary() once all renditions are coded
+  if ( bEos && getRendition() < 0 )
   {
-    m_cGOPEncoder.printOutSummary (m_uiNumAllPicCoded);
+    xPrintOutSummary();
   }
 }
 
@@ -408,6 +432,108 @@ Void TEncTop::encode( bool bEos, TComPicYuv* pcPicYuvOrg, TComList<TComPicYuv*>&
 // Protected member functions
 // ====================================================================================================================
 
+/** Store a source picture in a new picture buffer and run the analyses done at receipt
+ * \param pcPicYuvOrg original YUV picture
+ */
+Void TEncTop::xReceivePicture( TComPicYuv* pcPicYuvOrg )
+{
+  TComPic* pcPicCurr = NULL;
+  
+  // get original YUV
+  xGetNewPicBuffer( pcPicCurr );
+  pcPicYuvOrg->copyToPic( pcPicCurr->getPicYuvOrg() );
+#if PEL8_ME
+  if ( g_uiBitDepth + g_uiBitIncrement == 8 )
+  {
+    pcPicCurr->getPicYuvOrg()->copyToLuma8();
+  }
+#endif
+  
+  // compute image characteristics, or take them over from the encoder of another rendition
+  TEncPic* pcEPic = static_cast<TEncPic*>( pcPicCurr );
+  pcEPic->getAnalysis()->setValid( false );
+  if ( getUseAdaptiveQP() || getUseWP() || getWPBiPred() || ( getUseRateCtrl() && getRCLookahead() > 0 ) )
+  {
+    if ( !m_pcSharedAnalysis || !m_pcSharedAnalysis->copyAnalysis( pcEPic, getUseAdaptiveQP() ) )
+    {
+      m_cPreanalyzer.xAnalyze( pcEPic );
+      if ( getUseAdaptiveQP() )
+      {
+        m_cPreanalyzer.xPreanalyze( pcEPic );
+      }
+      if ( m_pcSharedAnalysis )
+      {
+        m_pcSharedAnalysis->setSourcePic( pcEPic );
+      }
+    }
+  }
+  if ( getUseRateCtrl() && getRCLookahead() > 0 )
+  {
+    m_cLookahead.addPicture( pcEPic );
+  }
+}
+
+/** Code the GOPs whose source pictures have been received
+ * \param bEos end-of-sequence flag, codes all received pictures
+ * \param bPartial code the pictures of an incomplete GOP that have been received so far
+ * \retval rcListPicYuvRecOut list of reconstruction YUV pictures, the latest received picture at the end
+ * \retval accessUnitsOut list of output access units
+ * \returns number of pictures of the completed GOPs
+ *
+ * With the rate control lookahead a GOP is only coded once the RCLookahead pictures following it have been
+ * received, so the pictures of up to one GOP plus the lookahead are pending at any time.
+ */
+Int TEncTop::xCompressGOPs( Bool bEos, Bool bPartial, TComList<TComPicYuv*>& rcListPicYuvRecOut, std::list<AccessUnit>& accessUnitsOut )
+{
+  Int iNumEncoded = 0;
+  Int iLookahead  = getUseRateCtrl() ? getRCLookahead() : 0;
+  
+  while ( m_iNumPicRcvd > 0 )
+  {
+    // the first picture is coded as a GOP of its own
+    Int  iGOPSize     = ( m_iPOCLast - m_iNumPicRcvd + 1 == 0 || !m_iGOPSize ) ? 1 : m_iGOPSize;
+    Int  iNumAvail    = bEos ? m_iNumPicRcvd : m_iNumPicRcvd - iLookahead;
+    Bool bGOPComplete = iNumAvail >= iGOPSize || bEos;
+    if ( !bGOPComplete && !bPartial )
+    {
+      break;
+    }
+    Int iNumPicGOP = min( iNumAvail, iGOPSize );
+    if ( iNumPicGOP <= 0 )
+    {
+      break;
+    }
+    
+    // the pictures received after the GOP are not passed on
+    Int iNumPending = m_iNumPicRcvd - iNumPicGOP;
+    TComList<TComPicYuv*> cListPicYuvRecGOP = rcListPicYuvRecOut;
+    for ( Int i = 0; i < iNumPending && !cListPicYuvRecGOP.empty(); i++ )
+    {
+      cListPicYuvRecGOP.pop_back();
+    }
+    
+    m_cGOPEncoder.compressGOP( m_iPOCLast - iNumPending, iNumPicGOP, m_cListPic, cListPicYuvRecGOP, accessUnitsOut, bGOPComplete );
+    if ( !bGOPComplete )
+    {
+      break;
+    }
+    
+    iNumEncoded        += iNumPicGOP;
+    m_iNumPicRcvd      -= iNumPicGOP;
+    m_uiNumAllPicCoded += iNumPicGOP;
+  }
+  return iNumEncoded;
+}
+
+Void TEncTop::xPrintOutSummary()
+{
+  m_cGOPEncoder.printOutSummary (m_uiNumAllPicCoded);
+  if ( getMergeRDCands() > 0 )
+  {
+    m_cCuEncoder.printMergeRankStats();
+  }
+}
+
 /**
  - Application has picture buffer list with size of GOP + 1
  - Picture buffer list acts like as ring buffer
@@ -419,32 +545,28 @@ Void TEncTop::xGetNewPicBuffer ( TComPic*& rpcPic )
 {
   TComSlice::sortPicList(m_cListPic);
   
-  if (m_cListPic.size() >= (UInt)(m_iGOPSize + getMaxDecPicBuffering(MAX_TLAYER-1) + 2) )
+  if (m_cListPic.size() >= (UInt)(m_iGOPSize + getMaxDecPicBuffering(MAX_TLAYER-1) + 2 + ( getUseRateCtrl() ? getRCLookahead() : 0 )) )
   {
     TComList<TComPic*>::iterator iterPic  = m_cListPic.begin();
     Int iSize = Int( m_cListPic.size() );
     for ( Int i = 0; i < iSize; i++ )
     {
       rpcPic = *(iterPic++);
-      if(rpcPic->getSlice(0)->isReferenced() == false)
+      // pictures received but not coded yet are kept as well
+      if(rpcPic->getSlice(0)->isReferenced() == false && rpcPic->getReconMark())
       {
         break;
       }
     }
+    // the CU data is released once a picture is no longer used for reference
+    rpcPic->getPicSym()->restoreCUData();
   }
   else
   {
-    if ( getUseAdaptiveQP() )
-    {
-      TEncPic* pcEPic = new TEncPic;
-      pcEPic->create( m_iSourceWidth, m_iSourceHeight, g_uiMaxCUWidth, g_uiMaxCUHeight, g_uiMaxCUDepth, m_cPPS.getMaxCuDQPDepth()+1 );
-      rpcPic = pcEPic;
-    }
-    else
-    {
-      rpcPic = new TComPic;
-      rpcPic->create( m_iSourceWidth, m_iSourceHeight, g_uiMaxCUWidth, g_uiMaxCUHeight, g_uiMaxCUDepth );
-    }
+    TEncPic* pcEPic = new TEncPic;
+    pcEPic->create( m_iSourceWidth, m_iSourceHeight, g_uiMaxCUWidth, g_uiMaxCUHeight, g_uiMaxCUDepth, getUseAdaptiveQP() ? m_cPPS.getMaxCuDQPDepth()+1 : 0 );
+    pcEPic->getAnalysis()->create( m_iSourceWidth, m_iSourceHeight, getUseRateCtrl() && getRCLookahead() > 0 );
+    rpcPic = pcEPic;
 #if REMOVE_APS
     rpcPic->getPicSym()->allocSaoParam(&m_cEncSAO);
 #endif
@@ -56,7 +56,9 @@
 #include "TEncAdaptiveLoopFilter.h"
 #include "TEncSampleAdaptiveOffset.h"
 #include "TEncPreanalyzer.h"
+#include "TEncLookahead.h"
 #include "TEncRateCtrl.h"
+#include "TEncSharedAnalysis.h"
 //! \ingroup TLibEncoder
 //! \{
 
@@ -124,17 +126,22 @@ private:
 
   // quality control
   TEncPreanalyzer         m_cPreanalyzer;                 ///< image characteristics analyzer for TM5-step3-like adaptive QP
+  TEncLookahead           m_cLookahead;                   ///< cost estimates of the received pictures for the rate control
 
   TComScalingList         m_scalingList;                 ///< quantization matrix information
   TEncRateCtrl            m_cRateCtrl;                    ///< Rate control class
+  TEncSharedAnalysis*     m_pcSharedAnalysis;             ///< source analysis shared with the encoders of other renditions, NULL if none
   
 protected:
   Void  xGetNewPicBuffer  ( TComPic*& rpcPic );           ///< get picture buffer which will be processed
+  Void  xReceivePicture   ( TComPicYuv* pcPicYuvOrg );    ///< store and analyze a source picture
+  Int   xCompressGOPs     ( Bool bEos, Bool bPartial, TComList<TComPicYuv*>& rcListPicYuvRecOut, std::list<AccessUnit>& accessUnitsOut );
   Void  xInitSPS          ();                             ///< initialize SPS from encoder options
   Void  xInitPPS          ();                             ///< initialize PPS from encoder options
   
   Void  xInitPPSforTiles  ();
   Void  xInitRPS          ();                             ///< initialize PPS from encoder options
+  Void  xPrintOutSummary  ();                             ///< print the summary at the end of the sequence
 
 public:
   TEncTop();
@@ -186,6 +193,8 @@ public:
 #endif
   Void selectReferencePictureSet(TComSlice* slice, Int POCCurr, Int GOPid,TComList<TComPic*>& listPic );
   TComScalingList*        getScalingList        () { return  &m_scalingList;         }
+  Void                    setOutputIf           ( TEncOutputIf* pcOutputIf ) { m_cGOPEncoder.setOutputIf( pcOutputIf ); }
+  Void                    setSharedAnalysis     ( TEncSharedAnalysis* p )    { m_pcSharedAnalysis = p; }  ///< set before init()
   // -------------------------------------------------------------------------------------------------------------------
   // encoder function
   // -------------------------------------------------------------------------------------------------------------------
@@ -193,6 +202,15 @@ public:
   /// encode several number of pictures until end-of-sequence
   Void encode( bool bEos, TComPicYuv* pcPicYuvOrg, TComList<TComPicYuv*>& rcListPicYuvRecOut,
               std::list<AccessUnit>& accessUnitsOut, Int& iNumEncoded );  
+
+  /// encode one picture, passing each access unit to the output interface as soon as it has been coded
+  Void encode( TComPicYuv* pcPicYuvOrg, Bool bEos );
+
+  /// store and analyze a source picture ahead of an encode() call without picture
+  Void receivePicture( TComPicYuv* pcPicYuvOrg )  { xReceivePicture( pcPicYuvOrg ); }
+
+  /// print the summary of a rendition, which encode() leaves out at the end of the sequence
+  Void printSummary  ()                           { xPrintOutSummary(); }
 };
 
 //! \}
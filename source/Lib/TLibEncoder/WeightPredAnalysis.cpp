@@ -40,6 +40,7 @@
 #include "../TLibCommon/TComPic.h"
 #include "../TLibCommon/TComPicYuv.h"
 #include "WeightPredAnalysis.h"
+#include "TEncPic.h"
 
 #define ABS(a)    ((a) < 0 ? - (a) : (a))
 #define DTHRESH (0.99)
@@ -70,38 +71,19 @@ WeightPredAnalysis::WeightPredAnalysis()
  */
 Bool  WeightPredAnalysis::xCalcACDCParamSlice(TComSlice *slice)
 {
-  //===== calculate AC/DC value =====
-  TComPicYuv*   pPic = slice->getPic()->getPicYuvOrg();
-  Int   iSample  = 0;
-
-  // calculate DC/AC value for Y
-  Pel*  pOrg    = pPic->getLumaAddr();
-  Int64  iOrgDCY = xCalcDCValueSlice(slice, pOrg, &iSample);
-  Int64  iOrgNormDCY = ((iOrgDCY+(iSample>>1)) / iSample);
-  pOrg = pPic->getLumaAddr();
-  Int64  iOrgACY  = xCalcACValueSlice(slice, pOrg, iOrgNormDCY);
-
-  // calculate DC/AC value for Cb
-  pOrg = pPic->getCbAddr();
-  Int64  iOrgDCCb = xCalcDCValueUVSlice(slice, pOrg, &iSample);
-  Int64  iOrgNormDCCb = ((iOrgDCCb+(iSample>>1)) / (iSample));
-  pOrg = pPic->getCbAddr();
-  Int64  iOrgACCb  = xCalcACValueUVSlice(slice, pOrg, iOrgNormDCCb);
-
-  // calculate DC/AC value for Cr
-  pOrg = pPic->getCrAddr();
-  Int64  iOrgDCCr = xCalcDCValueUVSlice(slice, pOrg, &iSample);
-  Int64  iOrgNormDCCr = ((iOrgDCCr+(iSample>>1)) / (iSample));
-  pOrg = pPic->getCrAddr();
-  Int64  iOrgACCr  = xCalcACValueUVSlice(slice, pOrg, iOrgNormDCCr);
+  //===== take the AC/DC values from the source picture analysis =====
+  TEncPicAnalysis* pcAnalysis = static_cast<TEncPic*>(slice->getPic())->getAnalysis();
+  assert( pcAnalysis->isValid() );
 
   wpACDCParam weightACDCParam[3];
-  weightACDCParam[0].iAC = iOrgACY;
-  weightACDCParam[0].iDC = iOrgNormDCY;
-  weightACDCParam[1].iAC = iOrgACCb;
-  weightACDCParam[1].iDC = iOrgNormDCCb;
-  weightACDCParam[2].iAC = iOrgACCr;
-  weightACDCParam[2].iDC = iOrgNormDCCr;
+  for ( Int iComp = 0; iComp < 3; iComp++ )
+  {
+    Int    iSample   = pcAnalysis->getNumSamples(iComp);
+    Int64  iOrgDC    = pcAnalysis->getPlaneSum(iComp);
+    Int64  iOrgNormDC = ((iOrgDC+(iSample>>1)) / iSample);
+    weightACDCParam[iComp].iAC = pcAnalysis->getPlaneAbsDev(iComp, iOrgNormDC);
+    weightACDCParam[iComp].iDC = iOrgNormDC;
+  }
 
   slice->setWpAcDcParam(weightACDCParam);
   return (true);
@@ -365,127 +347,6 @@ Bool WeightPredAnalysis::xSelectWP(TComSlice *slice, wpScalingParam weightPredTa
   return (true);
 }
 
-/** calculate DC value of original image for luma. 
- * \param TComSlice *slice
- * \param Pel *pPel
- * \param Int *iSample
- * \returns Int64
- */
-Int64 WeightPredAnalysis::xCalcDCValueSlice(TComSlice *slice, Pel *pPel, Int *iSample)
-{
-  TComPicYuv* pPic = slice->getPic()->getPicYuvOrg();
-  Int iStride = pPic->getStride();
-
-  *iSample = 0;
-  Int iWidth  = pPic->getWidth();
-  Int iHeight = pPic->getHeight();
-  *iSample = iWidth*iHeight;
-  Int64 iDC = xCalcDCValue(pPel, iWidth, iHeight, iStride);
-
-  return (iDC);
-}
-
-/** calculate AC value of original image for luma. 
- * \param TComSlice *slice
- * \param Pel *pPel
- * \param Int iDC
- * \returns Int64
- */
-Int64 WeightPredAnalysis::xCalcACValueSlice(TComSlice *slice, Pel *pPel, Int64 iDC)
-{
-  TComPicYuv* pPic = slice->getPic()->getPicYuvOrg();
-  Int iStride = pPic->getStride();
-
-  Int iWidth  = pPic->getWidth();
-  Int iHeight = pPic->getHeight();
-  Int64 iAC = xCalcACValue(pPel, iWidth, iHeight, iStride, iDC);
-
-  return (iAC);
-}
-
-/** calculate DC value of original image for chroma. 
- * \param TComSlice *slice
- * \param Pel *pPel
- * \param Int *iSample
- * \returns Int64
- */
-Int64 WeightPredAnalysis::xCalcDCValueUVSlice(TComSlice *slice, Pel *pPel, Int *iSample)
-{
-  TComPicYuv* pPic = slice->getPic()->getPicYuvOrg();
-  Int iCStride = pPic->getCStride();
-
-  *iSample = 0;
-  Int iWidth  = pPic->getWidth()>>1;
-  Int iHeight = pPic->getHeight()>>1;
-  *iSample = iWidth*iHeight;
-  Int64 iDC = xCalcDCValue(pPel, iWidth, iHeight, iCStride);
-
-  return (iDC);
-}
-
-/** calculate AC value of original image for chroma. 
- * \param TComSlice *slice
- * \param Pel *pPel
- * \param Int iDC
- * \returns Int64
- */
-Int64 WeightPredAnalysis::xCalcACValueUVSlice(TComSlice *slice, Pel *pPel, Int64 iDC)
-{
-  TComPicYuv* pPic = slice->getPic()->getPicYuvOrg();
-  Int iCStride = pPic->getCStride();
-
-  Int iWidth  = pPic->getWidth()>>1;
-  Int iHeight = pPic->getHeight()>>1;
-  Int64 iAC = xCalcACValue(pPel, iWidth, iHeight, iCStride, iDC);
-
-  return (iAC);
-}
-
-/** calculate DC value. 
- * \param Pel *pPel
- * \param Int iWidth
- * \param Int iHeight
- * \param Int iStride
- * \returns Int64
- */
-Int64 WeightPredAnalysis::xCalcDCValue(Pel *pPel, Int iWidth, Int iHeight, Int iStride)
-{
-  Int x, y;
-  Int64 iDC = 0;
-  for( y = 0; y < iHeight; y++ )
-  {
-    for( x = 0; x < iWidth; x++ )
-    {
-      iDC += (Int)( pPel[x] );
-    }
-    pPel += iStride;
-  }
-  return (iDC);
-}
-
-/** calculate AC value. 
- * \param Pel *pPel
- * \param Int iWidth
- * \param Int iHeight
- * \param Int iStride
- * \param Int iDC
- * \returns Int64
- */
-Int64 WeightPredAnalysis::xCalcACValue(Pel *pPel, Int iWidth, Int iHeight, Int iStride, Int64 iDC)
-{
-  Int x, y;
-  Int64 iAC = 0;
-  for( y = 0; y < iHeight; y++ )
-  {
-    for( x = 0; x < iWidth; x++ )
-    {
-      iAC += abs( (Int)pPel[x] - (Int)iDC );
-    }
-    pPel += iStride;
-  }
-  return (iAC);
-}
-
 /** calculate SAD values for both WP version and non-WP version. 
  * \param Pel *pOrgPel
  * \param Pel *pRefPel
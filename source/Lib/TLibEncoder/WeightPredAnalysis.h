@@ -47,14 +47,8 @@ class  WeightPredAnalysis
   Bool  m_weighted_bipred_flag;
   wpScalingParam  m_wp[2][MAX_NUM_REF][3];
 
-  Int64   xCalcDCValueSlice(TComSlice *slice, Pel *pPel,Int *iSample);
-  Int64   xCalcACValueSlice(TComSlice *slice, Pel *pPel, Int64 iDC);
-  Int64   xCalcDCValueUVSlice(TComSlice *slice, Pel *pPel, Int *iSample);
-  Int64   xCalcACValueUVSlice(TComSlice *slice, Pel *pPel, Int64 iDC);
   Int64   xCalcSADvalueWPSlice(TComSlice *slice, Pel *pOrgPel, Pel *pRefPel, Int iDenom, Int iWeight, Int iOffset);
 
-  Int64   xCalcDCValue(Pel *pPel, Int iWidth, Int iHeight, Int iStride);
-  Int64   xCalcACValue(Pel *pPel, Int iWidth, Int iHeight, Int iStride, Int64 iDC);
   Int64   xCalcSADvalueWP(Pel *pOrgPel, Pel *pRefPel, Int iWidth, Int iHeight, Int iOrgStride, Int iRefStride, Int iDenom, Int iWeight, Int iOffset);
   Bool    xSelectWP(TComSlice *slice, wpScalingParam weightPredTable[2][MAX_NUM_REF][3], Int iDenom);
 #if WP_PARAM_RANGE_LIMIT